@@ -0,0 +1,113 @@
+#include <toml.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// measure the throughput of toml::to_json and toml::from_json in the plain
+// and typed (toml-test) formats. toml::format is measured as a reference.
+//
+// The input has many tables that contain values of all the types and a long
+// array, like a large data file.
+
+namespace
+{
+
+std::string make_input(const std::size_t n_tables, const std::size_t n_array)
+{
+    std::ostringstream oss;
+    for(std::size_t i=0; i<n_tables; ++i)
+    {
+        oss << "[table" << i << "]\n";
+        oss << "name    = \"item \\\"" << i << "\\\"\\n\"\n";
+        oss << "id      = " << i << '\n';
+        oss << "ratio   = " << static_cast<double>(i) / 7.0 << '\n';
+        oss << "enabled = " << ((i % 2 == 0) ? "true" : "false") << '\n';
+        oss << "updated = 2020-01-01T00:00:00.123Z\n";
+        oss << "tags    = [\"a\", \"b\", \"c\"]\n";
+    }
+    oss << "[large]\n";
+    oss << "values = [";
+    for(std::size_t i=0; i<n_array; ++i)
+    {
+        oss << i << ", ";
+    }
+    oss << "]\n";
+    return oss.str();
+}
+
+using clock_type = std::chrono::steady_clock;
+
+template<typename F>
+void run(const char* name, const std::size_t bytes, const int n_iter, F&& f)
+{
+    std::size_t checksum = 0;
+    const auto start = clock_type::now();
+    for(int i=0; i<n_iter; ++i)
+    {
+        checksum += f();
+    }
+    const auto stop = clock_type::now();
+
+    const auto sec = std::chrono::duration<double>(stop - start).count() / n_iter;
+    std::cout << std::setw(24) << std::left << name
+              << std::setw(10) << std::right << std::fixed << std::setprecision(2)
+              << sec * 1000.0 << " [ms], "
+              << std::setw(10) << std::right
+              << static_cast<double>(bytes) / sec / 1024.0 / 1024.0 << " [MB/s]"
+              << " (checksum: " << checksum << ")" << std::endl;
+}
+
+} // anonymous
+
+int main(int argc, char** argv)
+{
+    const std::size_t n_tables = (argc > 1) ? std::stoul(argv[1]) : 50000;
+    const std::size_t n_array  = (argc > 2) ? std::stoul(argv[2]) : 10000;
+    const int         n_iter   = 5;
+
+    const auto input = make_input(n_tables, n_array);
+    std::istringstream iss(input);
+    const auto data = toml::parse(iss, "bench.toml");
+
+    toml::json_options plain;
+    toml::json_options typed;
+    typed.format = toml::json_format::typed;
+
+    const auto plain_json = toml::to_json(data, plain);
+    const auto typed_json = toml::to_json(data, typed);
+
+    std::cout << "TOML: " << input.size()      << " bytes, "
+              << "JSON: " << plain_json.size() << " bytes (plain), "
+              << typed_json.size()             << " bytes (typed)" << std::endl;
+
+    // the throughput is measured in the size of the output or the input.
+    run("toml::format", input.size(), n_iter, [&]() {
+            return toml::format(data).size();
+        });
+    run("to_json (plain)", plain_json.size(), n_iter, [&]() {
+            std::string str;
+            str.reserve(plain_json.size());
+            toml::to_json(data, [&str](const char* p, std::size_t n) {str.append(p, n);}, plain);
+            return str.size();
+        });
+    run("to_json (typed)", typed_json.size(), n_iter, [&]() {
+            std::string str;
+            str.reserve(typed_json.size());
+            toml::to_json(data, [&str](const char* p, std::size_t n) {str.append(p, n);}, typed);
+            return str.size();
+        });
+    run("toml::parse", input.size(), n_iter, [&]() {
+            std::istringstream is(input);
+            return toml::parse(is, "bench.toml").size();
+        });
+    run("from_json (plain)", plain_json.size(), n_iter, [&]() {
+            return toml::from_json(plain_json, plain).size();
+        });
+    run("from_json (typed)", typed_json.size(), n_iter, [&]() {
+            return toml::from_json(typed_json, typed).size();
+        });
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include <toml.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// compare table containers: toml::flat_table, toml::ordered_table,
+// std::unordered_map, std::map, and toml::frozen_table (via toml::freeze).
+//
+// The input has many small tables (like most of the config files) and a large
+// table. It measures the time to load (parse, and freeze if needed) and the
+// time to look up all the keys.
+
+namespace
+{
+
+std::string make_input(const std::size_t n_tables, const std::size_t n_keys,
+                       const std::size_t n_large)
+{
+    std::ostringstream oss;
+    for(std::size_t i=0; i<n_tables; ++i)
+    {
+        oss << "[table" << i << "]\n";
+        for(std::size_t j=0; j<n_keys; ++j)
+        {
+            oss << "key" << j << " = " << i * n_keys + j << '\n';
+        }
+    }
+    oss << "[large]\n";
+    for(std::size_t i=0; i<n_large; ++i)
+    {
+        oss << "key" << i << " = " << i << '\n';
+    }
+    return oss.str();
+}
+
+template<template<typename ...> class Table>
+struct parser
+{
+    using value_type = toml::basic_value<toml::discard_comments, Table>;
+
+    value_type operator()() const
+    {
+        std::istringstream iss(input);
+        return toml::parse<toml::discard_comments, Table>(iss, "bench.toml");
+    }
+    const std::string& input;
+};
+
+struct freezer
+{
+    using value_type = toml::basic_value<toml::discard_comments, toml::frozen_table>;
+
+    value_type operator()() const
+    {
+        return toml::freeze(parser<toml::ordered_table>{input}());
+    }
+    const std::string& input;
+};
+
+template<typename Loader>
+void run(const char* name, const Loader& load,
+         const std::vector<std::string>& table_keys,
+         const std::vector<std::string>& keys,
+         const std::vector<std::string>& large_keys, const int n_iter)
+{
+    using value_type = typename Loader::value_type;
+    using clock_type = std::chrono::steady_clock;
+
+    value_type data;
+    const auto load_start = clock_type::now();
+    for(int i=0; i<n_iter; ++i)
+    {
+        data = load();
+    }
+    const auto load_stop = clock_type::now();
+
+    std::int64_t sum = 0;
+    const auto find_start = clock_type::now();
+    for(int i=0; i<n_iter; ++i)
+    {
+        for(const auto& tk : table_keys)
+        {
+            const auto& tab = toml::find(data, tk);
+            for(const auto& k : keys)
+            {
+                sum += toml::find(tab, k).as_integer();
+            }
+        }
+        const auto& large = toml::find(data, "large");
+        for(const auto& k : large_keys)
+        {
+            sum += toml::find(large, k).as_integer();
+        }
+    }
+    const auto find_stop = clock_type::now();
+
+    using msec = std::chrono::duration<double, std::milli>;
+    std::cout << std::setw(20) << std::left << name
+              << " load: " << std::setw(10) << std::right << std::fixed
+              << std::setprecision(2) << msec(load_stop - load_start).count() / n_iter
+              << " [ms], find: " << std::setw(10) << std::right
+              << msec(find_stop - find_start).count() / n_iter << " [ms]"
+              << " (checksum: " << sum << ")" << std::endl;
+}
+
+} // anonymous
+
+int main(int argc, char** argv)
+{
+    const std::size_t n_tables = (argc > 1) ? std::stoul(argv[1]) : 10000;
+    const std::size_t n_keys   = (argc > 2) ? std::stoul(argv[2]) : 8;
+    const std::size_t n_large  = (argc > 3) ? std::stoul(argv[3]) : 10000;
+    const int         n_iter   = 5;
+
+    const auto input = make_input(n_tables, n_keys, n_large);
+
+    std::vector<std::string> table_keys, keys, large_keys;
+    for(std::size_t i=0; i<n_tables; ++i) {table_keys.push_back("table" + std::to_string(i));}
+    for(std::size_t i=0; i<n_keys;   ++i) {keys      .push_back("key"   + std::to_string(i));}
+    for(std::size_t i=0; i<n_large;  ++i) {large_keys.push_back("key"   + std::to_string(i));}
+
+    std::cout << n_tables << " tables with " << n_keys << " keys, and a table with "
+              << n_large << " keys" << std::endl;
+
+    run("toml::flat_table",    parser<toml::flat_table   >{input}, table_keys, keys, large_keys, n_iter);
+    run("toml::ordered_table", parser<toml::ordered_table>{input}, table_keys, keys, large_keys, n_iter);
+    run("std::unordered_map",  parser<std::unordered_map >{input}, table_keys, keys, large_keys, n_iter);
+    run("std::map",            parser<std::map           >{input}, table_keys, keys, large_keys, n_iter);
+    run("toml::frozen_table",  freezer{input},                     table_keys, keys, large_keys, n_iter);
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <toml.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+// operator== regards NaN as different from itself, so floatings are compared
+// by their values or, for NaNs, by their signs. Comments are compared too.
+template<typename Value>
+bool same_value(const Value& lhs, const Value& rhs)
+{
+    if(lhs.type() != rhs.type() || lhs.comments() != rhs.comments())
+    {
+        return false;
+    }
+    switch(lhs.type())
+    {
+        case toml::value_t::floating:
+        {
+            const auto l = lhs.as_floating();
+            const auto r = rhs.as_floating();
+            if(std::isnan(l) || std::isnan(r))
+            {
+                return std::isnan(l) && std::isnan(r) &&
+                       std::signbit(l) == std::signbit(r);
+            }
+            return l == r && std::signbit(l) == std::signbit(r);
+        }
+        case toml::value_t::array:
+        {
+            const auto& la = lhs.as_array();
+            const auto& ra = rhs.as_array();
+            if(la.size() != ra.size()) {return false;}
+            for(std::size_t i=0; i<la.size(); ++i)
+            {
+                if(!same_value(la.at(i), ra.at(i))) {return false;}
+            }
+            return true;
+        }
+        case toml::value_t::table:
+        {
+            const auto& lt = lhs.as_table();
+            const auto& rt = rhs.as_table();
+            if(lt.size() != rt.size()) {return false;}
+            for(const auto& kv : lt)
+            {
+                if(rt.count(kv.first) == 0 || !same_value(kv.second, rt.at(kv.first)))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        default: {return lhs == rhs;}
+    }
+}
+
+template<typename Comment>
+bool check(const std::string& filename, const char* label)
+{
+    const auto data = toml::parse<Comment>(filename);
+
+    std::ostringstream oss;
+    toml::save_binary(data, oss);
+    std::istringstream iss(oss.str());
+    const auto loaded = toml::load_binary<Comment>(iss);
+
+    if(!same_value(data, loaded))
+    {
+        std::cerr << "============================================================\n";
+        std::cerr << "result (" << label << ") different: " << filename << std::endl;
+        std::cerr << "------------------------------------------------------------\n";
+        std::cerr << "# loaded\n";
+        std::cerr << loaded;
+        std::cerr << "------------------------------------------------------------\n";
+        std::cerr << "# data\n";
+        std::cerr << data;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc != 2)
+    {
+        std::cerr << "usage: ./check_binary [filename]" << std::endl;
+        return 1;
+    }
+
+    const std::string filename(argv[1]);
+    if(!check<toml::discard_comments >(filename, "w/o comment")) {return 1;}
+    if(!check<toml::preserve_comments>(filename, "w/  comment")) {return 1;}
+    return 0;
+}
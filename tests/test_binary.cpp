@@ -0,0 +1,205 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <sstream>
+
+namespace
+{
+const std::string document(
+    "# the title\n"
+    "title = \"binary\" # inline\n"
+    "literal = 'C:\\Users'\n"
+    "integer = -42\n"
+    "large = 9223372036854775807\n"
+    "floating = 3.14\n"
+    "infinity = -inf\n"
+    "boolean = true\n"
+    "odt = 1979-05-27T07:32:00.999999-07:00\n"
+    "ldt = 1979-05-27T07:32:00\n"
+    "ld = 1979-05-27\n"
+    "lt = 00:32:00.123\n"
+    "ints = [1, 2, 3]\n"
+    "floats = [1.5, -2.5]\n"
+    "mixed = [1, \"two\", [3.0], {four = 4}]\n"
+    "empty = []\n"
+    "inline = {a = 1, b.c = \"d\"}\n"
+    "[table]\n"
+    "key = \"value\"\n"
+    "[table.sub]\n"
+    "x = 1\n"
+    "[[aot]]\n"
+    "name = \"first\"\n"
+    "[[aot]]\n"
+    "name = \"second\"\n"
+    );
+
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+toml::basic_value<C, T, A> round_trip(const toml::basic_value<C, T, A>& v,
+        const toml::binary_options& opts = toml::binary_options{})
+{
+    std::ostringstream oss;
+    toml::save_binary(v, oss, opts);
+    std::istringstream iss(oss.str());
+    return toml::load_binary<C, T, A>(iss);
+}
+
+std::string to_binary(const toml::value& v)
+{
+    std::ostringstream oss;
+    toml::save_binary(v, oss);
+    return oss.str();
+}
+toml::value from_binary(const std::string& bin)
+{
+    std::istringstream iss(bin);
+    return toml::load_binary(iss);
+}
+
+// stops reading halfway, as a file truncated while it is read would.
+struct truncated_buf : std::stringbuf
+{
+    explicit truncated_buf(const std::string& str): std::stringbuf(str) {}
+
+    std::streamsize xsgetn(char_type* s, std::streamsize n) override
+    {
+        return std::stringbuf::xsgetn(s, n / 2);
+    }
+};
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_binary_round_trip)
+{
+    std::istringstream iss(document);
+    const auto v = toml::parse(iss, "document.toml");
+    const auto u = from_binary(to_binary(v));
+    BOOST_TEST(u == v);
+    BOOST_CHECK(toml::find(u, "title").as_string().kind == toml::string_t::basic);
+    BOOST_CHECK(toml::find(u, "literal").as_string().kind == toml::string_t::literal);
+}
+
+BOOST_AUTO_TEST_CASE(test_binary_comments)
+{
+    std::istringstream iss(document);
+    const auto v = toml::parse<toml::preserve_comments>(iss, "document.toml");
+
+    const auto u = round_trip(v);
+    BOOST_TEST(u == v);
+    BOOST_TEST_REQUIRE(toml::find(u, "title").comments().size() == 2u);
+    BOOST_TEST(toml::find(u, "title").comments().at(0) == " the title");
+    BOOST_TEST(toml::find(u, "title").comments().at(1) == " inline");
+
+    toml::binary_options opts;
+    opts.comments = false;
+    const auto w = round_trip(v, opts);
+    BOOST_TEST(toml::find(w, "title").comments().empty());
+    BOOST_TEST(toml::find<std::string>(w, "title") == "binary");
+}
+
+BOOST_AUTO_TEST_CASE(test_binary_locations)
+{
+    std::istringstream iss(document);
+    const auto v = toml::parse(iss, "document.toml");
+    const auto u = from_binary(to_binary(v));
+
+    const auto loc = toml::find(u, "table", "sub", "x").location();
+    BOOST_TEST(loc.file_name() == "document.toml");
+    BOOST_TEST(loc.line() == toml::find(v, "table", "sub", "x").location().line());
+    BOOST_TEST(loc.column() == toml::find(v, "table", "sub", "x").location().column());
+
+    const auto ints = toml::find(u, "ints").location();
+    BOOST_TEST(ints.line() == 13u);
+
+    toml::binary_options opts;
+    opts.locations = false;
+    const auto w = round_trip(v, opts);
+    BOOST_TEST(w == v);
+    BOOST_TEST(toml::find(w, "ints").location().file_name() == "unknown file");
+}
+
+BOOST_AUTO_TEST_CASE(test_binary_constructed_value)
+{
+    const toml::value v{{"a", 42}, {"b", toml::array{1, "x", 3.0}},
+                        {"c", toml::table{{"d", toml::local_date(2020, toml::month_t::Jan, 1)}}}};
+    BOOST_TEST(from_binary(to_binary(v)) == v);
+}
+
+BOOST_AUTO_TEST_CASE(test_binary_ordered_table)
+{
+    using ordered_value = toml::basic_value<toml::discard_comments, toml::ordered_table>;
+    std::istringstream iss("z = 1\ny = 2\nx = 3\n");
+    const auto v = toml::parse<toml::discard_comments, toml::ordered_table>(iss);
+    const ordered_value u = round_trip(v);
+    BOOST_TEST(u == v);
+    BOOST_TEST(toml::format(u) == toml::format(v));
+}
+
+BOOST_AUTO_TEST_CASE(test_binary_broken)
+{
+    std::istringstream iss(document);
+    const auto bin = to_binary(toml::parse(iss, "document.toml"));
+
+    // not a binary
+    BOOST_CHECK_THROW(from_binary("title = \"toml\"\n"), toml::binary_error);
+
+    // truncated
+    BOOST_CHECK_THROW(from_binary(bin.substr(0, bin.size() - 1)), toml::binary_error);
+    BOOST_CHECK_THROW(from_binary(bin.substr(0, 16)), toml::binary_error);
+
+    // checksum mismatch
+    {
+        auto broken = bin;
+        broken.back() = static_cast<char>(broken.back() ^ 0x01);
+        BOOST_CHECK_THROW(from_binary(broken), toml::binary_error);
+    }
+    // another version
+    {
+        auto broken = bin;
+        broken.at(8) = static_cast<char>(broken.at(8) + 1);
+        BOOST_CHECK_THROW(from_binary(broken), toml::binary_error);
+    }
+    // too deeply nested arrays
+    {
+        toml::value deep(toml::array{});
+        for(int i=0; i<100; ++i)
+        {
+            deep = toml::value(toml::array{deep});
+        }
+        BOOST_CHECK_THROW(from_binary(to_binary(deep)), toml::binary_error);
+    }
+    // a date out of range, with a valid checksum
+    {
+        toml::binary_options opts;
+        opts.comments  = false;
+        opts.locations = false;
+        std::ostringstream oss;
+        toml::save_binary(toml::value(toml::local_date(2000, toml::month_t::Jan, 1)), oss, opts);
+
+        auto broken = oss.str();
+        broken.at(35) = 12; // month
+        const auto hash = toml::detail::binary_format::checksum(
+                broken.data() + 32, broken.data() + broken.size());
+        for(std::size_t i=0; i<8; ++i)
+        {
+            broken.at(24 + i) = static_cast<char>((hash >> (8 * i)) & 0xFFu);
+        }
+        BOOST_CHECK_THROW(from_binary(broken), toml::binary_error);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_binary_file)
+{
+    std::istringstream iss(document);
+    const auto v = toml::parse(iss, "document.toml");
+    toml::save_binary(v, "tmp_binary.toml.bin");
+    BOOST_TEST(toml::load_binary("tmp_binary.toml.bin") == v);
+
+    BOOST_CHECK_THROW(toml::load_binary("there_is_no_such_file.bin"), std::ios_base::failure);
+}
+
+BOOST_AUTO_TEST_CASE(test_binary_short_read)
+{
+    truncated_buf buf(to_binary(toml::value(toml::table{{"a", 42}})));
+    std::istream is(&buf);
+    BOOST_CHECK_THROW(toml::load_binary(is), std::ios_base::failure);
+}
@@ -0,0 +1,188 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+std::vector<std::string> to_strings(const std::vector<toml::key_path>& paths)
+{
+    std::vector<std::string> strs;
+    for(const auto& p : paths) {strs.push_back(p.str());}
+    return strs;
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_config_handle_reload)
+{
+    const std::string fname("tmp_config_handle_reload.toml");
+    {
+        std::ofstream ofs(fname, std::ios_base::binary);
+        ofs << "a = 1\nb = [1, 2]\n[server]\nport = 8080\nhost = \"localhost\"\n";
+    }
+
+    toml::config_handle conf(fname);
+    const auto before = conf.snapshot();
+    BOOST_TEST(conf.generation() == 0u);
+    BOOST_TEST(toml::find<int>(*before, "server", "port") == 8080);
+
+    {
+        std::ofstream ofs(fname, std::ios_base::binary);
+        ofs << "a = 1\nb = [1, 2, 3]\nc = true\n[server]\nport = 8081\n";
+    }
+    const auto changed = conf.reload();
+
+    const std::vector<std::string> expected{"b[2]", "c", "server.host", "server.port"};
+    BOOST_TEST(to_strings(changed) == expected);
+    BOOST_TEST(conf.generation() == 1u);
+
+    // the old snapshot is not changed
+    BOOST_TEST(toml::find<int>(*before, "server", "port") == 8080);
+    BOOST_TEST(toml::find<int>(*conf.snapshot(), "server", "port") == 8081);
+
+    // nothing changed
+    const auto current = conf.snapshot();
+    BOOST_TEST(conf.reload().empty());
+    BOOST_TEST(conf.snapshot().get() == current.get());
+    BOOST_TEST(conf.generation() == 1u);
+
+    std::remove(fname.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_config_handle_failure)
+{
+    const std::string fname("tmp_config_handle_failure.toml");
+    {
+        std::ofstream ofs(fname, std::ios_base::binary);
+        ofs << "a = 1\n";
+    }
+
+    toml::config_handle conf(fname);
+    const auto before = conf.snapshot();
+
+    {
+        std::ofstream ofs(fname, std::ios_base::binary);
+        ofs << "a = \n";
+    }
+    BOOST_CHECK_THROW(conf.reload(), toml::syntax_error);
+    BOOST_TEST(conf.snapshot().get() == before.get());
+    BOOST_TEST(conf.generation() == 0u);
+
+    std::remove(fname.c_str());
+    BOOST_CHECK_THROW(conf.reload(), std::ios_base::failure);
+    BOOST_TEST(conf.snapshot().get() == before.get());
+
+    BOOST_CHECK_THROW(toml::config_handle("tmp_config_handle_nonexistent.toml"),
+                      std::ios_base::failure);
+}
+
+BOOST_AUTO_TEST_CASE(test_config_handle_callback)
+{
+    toml::config_handle conf("unused.toml", toml::value(toml::table{{"a", 1}}));
+
+    std::size_t called = 0;
+    std::vector<std::string> paths;
+    conf.on_reload([&](const toml::config_handle::snapshot_type& now,
+                       const std::vector<toml::key_path>& changed) {
+        ++called;
+        paths = to_strings(changed);
+        BOOST_TEST(toml::find<int>(*now, "a") == 2);
+    });
+
+    conf.publish(toml::value(toml::table{{"a", 2}}));
+    BOOST_TEST(called == 1u);
+    BOOST_TEST(paths == std::vector<std::string>{"a"});
+
+    conf.publish(toml::value(toml::table{{"a", 2}}));
+    BOOST_TEST(called == 1u);
+
+    conf.publish(toml::value(toml::table{{"a", 2}, {"b", toml::table{{"c d", 3}}}}));
+    BOOST_TEST(called == 2u);
+    BOOST_TEST(paths == std::vector<std::string>{"b"});
+}
+
+BOOST_AUTO_TEST_CASE(test_config_handle_reentrant_callback)
+{
+    toml::config_handle conf("unused.toml", toml::value(toml::table{{"a", 1}}));
+
+    std::vector<int> seen;
+    std::vector<std::uint64_t> generations;
+    conf.on_reload([&](const toml::config_handle::snapshot_type& now,
+                       const std::vector<toml::key_path>&) {
+        const auto a = toml::find<int>(*now, "a");
+        seen.push_back(a);
+        generations.push_back(conf.generation());
+        if(a < 3)
+        {
+            // does not deadlock
+            conf.publish(toml::value(toml::table{{"a", a + 1}}));
+        }
+    });
+
+    conf.publish(toml::value(toml::table{{"a", 2}}));
+    BOOST_TEST(seen == (std::vector<int>{2, 3}));
+    BOOST_TEST(generations == (std::vector<std::uint64_t>{1, 2}));
+    BOOST_TEST(conf.generation() == 2u);
+    BOOST_TEST(toml::find<int>(*conf.snapshot(), "a") == 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_config_handle_several_handles)
+{
+    // a thread keeps the last snapshot, but not across handles
+    toml::config_handle a("unused.toml", toml::value(toml::table{{"x", 1}}));
+    toml::config_handle b("unused.toml", toml::value(toml::table{{"x", 2}}));
+    for(int i=0; i<2; ++i)
+    {
+        BOOST_TEST(toml::find<int>(*a.snapshot(), "x") == 1);
+        BOOST_TEST(toml::find<int>(*b.snapshot(), "x") == 2);
+    }
+    BOOST_TEST(a.snapshot().get() == a.snapshot().get());
+
+    b.publish(toml::value(toml::table{{"x", 3}}));
+    BOOST_TEST(toml::find<int>(*a.snapshot(), "x") == 1);
+    BOOST_TEST(toml::find<int>(*b.snapshot(), "x") == 3);
+
+    // a snapshot taken in a thread is updated after a publish in another one
+    std::thread([&b]() {
+        b.publish(toml::value(toml::table{{"x", 4}}));
+    }).join();
+    BOOST_TEST(toml::find<int>(*b.snapshot(), "x") == 4);
+}
+
+BOOST_AUTO_TEST_CASE(test_config_handle_concurrent)
+{
+    toml::config_handle conf("unused.toml",
+            toml::value(toml::table{{"x", 0}, {"y", 0}}));
+
+    std::atomic<bool> done(false);
+    std::atomic<std::size_t> inconsistent(0);
+    std::vector<std::thread> readers;
+    for(std::size_t i=0; i<4; ++i)
+    {
+        readers.emplace_back([&conf, &done, &inconsistent]() {
+            while(!done.load())
+            {
+                const auto snap = conf.snapshot();
+                if(toml::find<int>(*snap, "x") != toml::find<int>(*snap, "y"))
+                {
+                    ++inconsistent;
+                }
+            }
+        });
+    }
+    for(int i=1; i<=200; ++i)
+    {
+        conf.publish(toml::value(toml::table{{"x", i}, {"y", i}}));
+    }
+    done.store(true);
+    for(auto& t : readers) {t.join();}
+
+    BOOST_TEST(inconsistent.load() == 0u);
+    BOOST_TEST(conf.generation() == 200u);
+    BOOST_TEST(toml::find<int>(*conf.snapshot(), "x") == 200);
+}
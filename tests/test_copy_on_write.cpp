@@ -0,0 +1,126 @@
+#define TOML11_COPY_ON_WRITE
+#define TOML11_PACK_HOMOGENEOUS_ARRAYS
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <sstream>
+
+namespace
+{
+toml::value parse_string(const std::string& str)
+{
+    std::istringstream iss(str);
+    return toml::parse(iss, "test_copy_on_write.toml");
+}
+
+template<typename Value>
+toml::table const* table_address(const Value& v)
+{
+    return std::addressof(v.as_table());
+}
+template<typename Value>
+toml::array const* array_address(const Value& v)
+{
+    return std::addressof(v.as_array());
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_copy_shares_contents)
+{
+    const auto data = parse_string(
+        "[server]\n"
+        "host = \"example.com\"\n"
+        "ports = [8080, 8081]\n"
+        "[client]\n"
+        "names = [\"a\", \"b\"]\n"
+        );
+    const toml::value copied = data;
+    BOOST_CHECK(table_address(copied) == table_address(data));
+
+    const toml::value server = toml::find(data, "server");
+    BOOST_CHECK(table_address(server) == table_address(toml::find(data, "server")));
+
+    const toml::value names = toml::find(data, "client", "names");
+    BOOST_CHECK(array_address(names) == array_address(toml::find(data, "client", "names")));
+
+    const toml::value ports = toml::find(data, "server", "ports");
+    BOOST_TEST(ports.is_packed_array());
+    BOOST_CHECK(array_address(ports) == array_address(toml::find(data, "server", "ports")));
+}
+
+BOOST_AUTO_TEST_CASE(test_modification_clones_path)
+{
+    const auto data = parse_string(
+        "[server]\n"
+        "host = \"example.com\"\n"
+        "port = 8080\n"
+        "[client]\n"
+        "names = [\"a\", \"b\"]\n"
+        "ints  = [1, 2, 3]\n"
+        );
+    toml::value copied = data;
+    copied["server"]["port"] = 9090;
+
+    BOOST_TEST(toml::find<int>(data,   "server", "port") == 8080);
+    BOOST_TEST(toml::find<int>(copied, "server", "port") == 9090);
+    BOOST_CHECK(table_address(copied) != table_address(data));
+
+    // not modified. still shared.
+    const toml::value& ccopied = copied;
+    BOOST_CHECK(table_address(toml::find(ccopied, "client")) ==
+                table_address(toml::find(data,    "client")));
+
+    copied["client"]["names"].push_back("c");
+    copied["client"]["ints"].push_back(4);
+    BOOST_TEST(toml::find(data,   "client", "names").size() == 2u);
+    BOOST_TEST(toml::find(data,   "client", "ints" ).size() == 3u);
+    BOOST_TEST(toml::find(ccopied, "client", "names").size() == 3u);
+    BOOST_TEST(toml::find(ccopied, "client", "ints" ).size() == 4u);
+    BOOST_TEST(toml::find(data, "client", "ints").is_packed_array());
+}
+
+BOOST_AUTO_TEST_CASE(test_non_const_reference_stops_sharing)
+{
+    auto data = parse_string("a = 1\n[b]\nc = 2\n");
+
+    auto& tab = data.as_table();
+    const toml::value copied = data;
+    tab["x"] = 42;
+    BOOST_TEST( data  .contains("x"));
+    BOOST_TEST(!copied.contains("x"));
+
+    auto& b = toml::find(data, "b");
+    const toml::value copied2 = data;
+    b["y"] = 43;
+    BOOST_TEST( toml::find(data,    "b").contains("y"));
+    BOOST_TEST(!toml::find(copied2, "b").contains("y"));
+
+    // copies of a copy are shared again
+    const toml::value copied3 = copied2;
+    BOOST_CHECK(table_address(copied3) == table_address(copied2));
+}
+
+BOOST_AUTO_TEST_CASE(test_detach_source_keeps_sharing)
+{
+    auto data = parse_string("a = 1\n[b]\nc = [\"x\", \"y\"]\n");
+    toml::detach_source(data);
+
+    const toml::value copied = data;
+    BOOST_CHECK(table_address(copied) == table_address(data));
+    BOOST_CHECK(array_address(toml::find(copied, "b", "c")) ==
+                array_address(toml::find(data,   "b", "c")));
+}
+
+BOOST_AUTO_TEST_CASE(test_merge_keeps_sharing)
+{
+    auto dst = parse_string("a = 1\n[b]\nc = [\"x\", \"y\"]\n");
+    toml::merge(dst, parse_string("[b]\nd = 2\n"));
+    const auto& cdst = dst; // non-const find would stop sharing
+    BOOST_TEST(toml::find<int>(cdst, "b", "d") == 2);
+
+    const toml::value copied = dst;
+    BOOST_CHECK(table_address(copied) == table_address(dst));
+    BOOST_CHECK(table_address(toml::find(copied, "b")) ==
+                table_address(toml::find(dst,    "b")));
+}
@@ -0,0 +1,71 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <sstream>
+
+namespace
+{
+toml::basic_value<toml::preserve_comments> parse_string(const std::string& str)
+{
+    std::istringstream iss(str);
+    return toml::parse<toml::preserve_comments>(iss, "detach.toml");
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_detach_source_keeps_locations)
+{
+    auto data = parse_string(
+        "# comment\n"
+        "a = 42\n"
+        "[table]\n"
+        "b   = \"foo\" # inline\n"
+        "  c = [1, 2, 3]\n"
+        );
+    const auto a_loc = toml::find(data, "a").location();
+    const auto b_loc = toml::find(data, "table", "b").location();
+    const auto c_loc = toml::find(data, "table", "c").location();
+    const auto e_loc = toml::find(data, "table", "c").at(2).location();
+    const auto before = toml::memory_usage(data);
+
+    toml::detach_source(data);
+
+    const auto check = [](const toml::source_location& lhs, const toml::source_location& rhs) {
+        BOOST_TEST(lhs.file_name() == rhs.file_name());
+        BOOST_TEST(lhs.line()      == rhs.line());
+        BOOST_TEST(lhs.column()    == rhs.column());
+        BOOST_TEST(lhs.region()    == rhs.region());
+    };
+    check(toml::find(data, "a").location(),             a_loc);
+    check(toml::find(data, "table", "b").location(),    b_loc);
+    check(toml::find(data, "table", "c").location(),    c_loc);
+    check(toml::find(data, "table", "c").at(2).location(), e_loc);
+    BOOST_TEST(toml::find(data, "table", "c").location().column() == 7u);
+
+    // values and comments are not changed
+    BOOST_TEST(toml::find<int>(data, "a") == 42);
+    BOOST_TEST(toml::find(data, "a").comments().size() == 1u);
+    BOOST_TEST(toml::find(data, "table", "b").comments().front() == " inline");
+
+    const auto after = toml::memory_usage(data);
+    BOOST_TEST(after.sources == 0u);
+    BOOST_TEST(after.regions < before.regions);
+}
+
+BOOST_AUTO_TEST_CASE(test_detach_source_error_message)
+{
+    auto data = parse_string("a = 42\nb = \"foo\"\n");
+    toml::detach_source(data);
+
+    try
+    {
+        toml::find<std::string>(data, "a");
+        BOOST_ERROR("type_error is not thrown");
+    }
+    catch(const toml::type_error& err)
+    {
+        const std::string what(err.what());
+        BOOST_TEST(what.find("detach.toml") != std::string::npos);
+        BOOST_TEST(what.find("1 | column 5: the actual type is integer") != std::string::npos);
+    }
+}
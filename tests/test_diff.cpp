@@ -0,0 +1,133 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <limits>
+#include <map>
+
+namespace
+{
+template<typename Value>
+std::map<std::string, toml::diff_kind>
+kinds_of(const std::vector<toml::diff_entry<Value>>& entries)
+{
+    std::map<std::string, toml::diff_kind> kinds;
+    for(const auto& e : entries) {kinds[e.path.str()] = e.kind;}
+    return kinds;
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_diff_tables)
+{
+    std::istringstream lhs_iss(
+        "a = 1\n"
+        "b = \"foo\"\n"
+        "c = 3.14\n"
+        "[server]\n"
+        "host = \"localhost\"\n"
+        "port = 8080\n"
+        "[server.tls]\n"
+        "enabled = true\n");
+    std::istringstream rhs_iss(
+        "a = 1\n"
+        "b = \"bar\"\n"
+        "d = 2020-01-01\n"
+        "# comments are not compared\n"
+        "[server]\n"
+        "host = \"localhost\"\n"
+        "port = \"8080\"\n"
+        "tls = false\n");
+    const auto lhs = toml::parse(lhs_iss, "test.toml");
+    const auto rhs = toml::parse(rhs_iss, "test.toml");
+
+    const auto d = toml::diff(lhs, rhs);
+    const std::map<std::string, toml::diff_kind> expected{
+        {"b",           toml::diff_kind::replace},
+        {"c",           toml::diff_kind::remove },
+        {"d",           toml::diff_kind::add    },
+        {"server.port", toml::diff_kind::replace},
+        {"server.tls",  toml::diff_kind::replace},
+    };
+    BOOST_TEST(d.size() == expected.size());
+    BOOST_CHECK(kinds_of(d) == expected);
+
+    for(const auto& e : d)
+    {
+        if(e.path.str() == "server.port")
+        {
+            BOOST_TEST(e.value.as_string() == "8080");
+        }
+        if(e.path.str() == "c")
+        {
+            BOOST_TEST(e.value.is_uninitialized());
+        }
+    }
+
+    BOOST_TEST(toml::diff(lhs, lhs).empty());
+    std::istringstream formatted_iss(toml::format(rhs));
+    BOOST_TEST(toml::diff(rhs, toml::parse(formatted_iss, "test.toml")).empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_diff_arrays)
+{
+    std::istringstream lhs_iss("a = [1, 2, 3, 4]\nb = [{x = 1}, {x = 2}]\nc = [1, 2]\n");
+    std::istringstream rhs_iss("a = [1, 5]\nb = [{x = 1}, {x = 3}, {x = 4}]\nc = [1, 2]\n");
+    const auto lhs = toml::parse(lhs_iss, "test.toml");
+    const auto rhs = toml::parse(rhs_iss, "test.toml");
+
+    const auto d = toml::diff(lhs, rhs);
+    BOOST_REQUIRE(d.size() == 5u);
+
+    const std::map<std::string, toml::diff_kind> expected{
+        {"a[1]",   toml::diff_kind::replace},
+        {"a[3]",   toml::diff_kind::remove },
+        {"a[2]",   toml::diff_kind::remove },
+        {"b[1].x", toml::diff_kind::replace},
+        {"b[2]",   toml::diff_kind::add    },
+    };
+    BOOST_CHECK(kinds_of(d) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(test_diff_nan)
+{
+    const toml::value lhs(toml::table{{"a", std::numeric_limits<double>::quiet_NaN()}});
+    const toml::value rhs(toml::table{{"a", std::numeric_limits<double>::quiet_NaN()}});
+    BOOST_TEST(toml::diff(lhs, rhs).empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_apply_patch)
+{
+    std::istringstream lhs_iss(
+        "a = [1, 2, 3, 4]\n"
+        "b = [{x = 1}, {x = 2}]\n"
+        "c = \"removed\"\n"
+        "[t]\n"
+        "x = 1\n"
+        "y = {z = [1, 2]}\n");
+    std::istringstream rhs_iss(
+        "a = [1, 5]\n"
+        "b = [{x = 1}, {x = 3}, {x = 4, y = 5}]\n"
+        "d = \"added\"\n"
+        "[t]\n"
+        "x = [1]\n"
+        "y = {z = [1, 2, 3], w = 0}\n");
+    const auto lhs = toml::parse(lhs_iss, "test.toml");
+    const auto rhs = toml::parse(rhs_iss, "test.toml");
+
+    {
+        auto v = lhs;
+        toml::apply_patch(v, toml::diff(lhs, rhs));
+        BOOST_CHECK(v == rhs);
+    }
+    {
+        auto v = rhs;
+        auto patch = toml::diff(rhs, lhs);
+        toml::apply_patch(v, std::move(patch));
+        BOOST_CHECK(v == lhs);
+    }
+    {
+        auto v = toml::value(toml::table{{"a", 1}});
+        const auto patch = toml::diff(lhs, rhs);
+        BOOST_CHECK_THROW(toml::apply_patch(v, patch), std::out_of_range);
+    }
+}
@@ -825,3 +825,45 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_get_toml_offset_datetime, value_type, test_va
         BOOST_TEST(tm.tm_sec ==            0);
     }
 }
+
+namespace
+{
+std::size_t& hash_count()
+{
+    static std::size_t count = 0;
+    return count;
+}
+struct counting_hash
+{
+    std::size_t operator()(const std::string& k) const
+    {
+        hash_count() += 1;
+        return std::hash<std::string>{}(k);
+    }
+};
+template<typename K, typename T>
+using counting_table = std::unordered_map<K, T, counting_hash>;
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_find_hashes_key_once)
+{
+    using value_type = toml::basic_value<toml::discard_comments, counting_table, std::vector>;
+    value_type v{{"a", value_type{{"b", 42}}}};
+    const value_type& cv = v;
+
+    hash_count() = 0;
+    BOOST_TEST(toml::find<int>(cv, "a", "b") == 42);
+    BOOST_TEST(hash_count() == 2u);
+
+    hash_count() = 0;
+    BOOST_TEST(toml::find(v, "a").at("b").as_integer() == 42);
+    BOOST_TEST(hash_count() == 2u);
+
+    hash_count() = 0;
+    BOOST_TEST(toml::find_or<int>(cv, "a", "b", 0) == 42);
+    BOOST_TEST(hash_count() == 2u);
+
+    hash_count() = 0;
+    BOOST_TEST(toml::find_or<int>(cv, "a", "c", 0) == 0);
+    BOOST_TEST(hash_count() == 2u);
+}
@@ -0,0 +1,150 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <map>
+#include <sstream>
+#include <string>
+
+BOOST_AUTO_TEST_CASE(test_flat_table_container)
+{
+    toml::flat_table<std::string, int> tab;
+    BOOST_TEST(tab.empty());
+
+    // enough elements to build the hash index
+    for(int i=0; i<100; ++i)
+    {
+        const auto inserted = tab.insert(std::make_pair(std::to_string(i), i));
+        BOOST_TEST(inserted.second);
+    }
+    BOOST_TEST(tab.size() == 100u);
+    BOOST_TEST(!tab.insert(std::make_pair(std::string("42"), 0)).second);
+    BOOST_TEST(tab.at("42") == 42);
+
+    for(int i=0; i<100; ++i)
+    {
+        BOOST_TEST(tab.count(std::to_string(i)) == 1u);
+        BOOST_TEST(tab.at(std::to_string(i)) == i);
+    }
+    BOOST_TEST(tab.count("100") == 0u);
+    BOOST_CHECK(tab.find("100") == tab.end());
+    BOOST_CHECK_THROW(tab.at("100"), std::out_of_range);
+
+    // elements are kept in the order of insertion
+    int expected = 0;
+    for(const auto& kv : tab)
+    {
+        BOOST_TEST(kv.second == expected);
+        ++expected;
+    }
+
+    BOOST_TEST(tab.erase("10") == 1u);
+    BOOST_TEST(tab.erase("10") == 0u);
+    BOOST_TEST(tab.size() == 99u);
+    BOOST_TEST(tab.count("10") == 0u);
+    BOOST_TEST(tab.at("99") == 99);
+
+    tab["foo"] = 123;
+    BOOST_TEST(tab.at("foo") == 123);
+    BOOST_TEST(tab["bar"] == 0);
+    BOOST_TEST(tab.size() == 101u);
+
+    const auto copied = tab;
+    BOOST_CHECK(copied == tab);
+    tab["foo"] = 0;
+    BOOST_CHECK(copied != tab);
+
+    tab.clear();
+    BOOST_TEST(tab.empty());
+    BOOST_TEST(tab.count("foo") == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_flat_table_value)
+{
+    using value_type = toml::basic_value<toml::discard_comments, toml::flat_table>;
+
+    const std::string file(
+        "a = 42\n"
+        "b = \"baz\"\n"
+        "c.d = [1, 2, 3]\n"
+        "[e]\n"
+        "f = 3.14\n"
+        "[e.g]\n"
+        "h = true\n"
+        "[[i]]\n"
+        "j = 1\n"
+        "[[i]]\n"
+        "j = 2\n"
+        );
+    std::istringstream iss(file);
+    const auto v = toml::parse<toml::discard_comments, toml::flat_table>(iss);
+    static_assert(std::is_same<decltype(v), const value_type>::value, "");
+
+    BOOST_TEST(toml::find<int>(v, "a") == 42);
+    BOOST_TEST(toml::find<std::string>(v, "b") == "baz");
+    BOOST_TEST(toml::find<std::vector<int>>(v, "c", "d").size() == 3u);
+    BOOST_TEST(toml::find<double>(v, "e", "f") == 3.14);
+    BOOST_TEST(toml::find<bool>(v, "e", "g", "h") == true);
+    BOOST_TEST(toml::find<int>(toml::find(v, "i").at(1), "j") == 2);
+
+    const auto e = toml::find<std::map<std::string, toml::value>>(v, "e");
+    BOOST_TEST(e.size() == 2u);
+
+    // keys are serialized in the order of definition
+    std::ostringstream oss;
+    oss << v;
+    const std::string serialized = oss.str();
+    BOOST_TEST(serialized.find("a = 42") < serialized.find("b = \"baz\""));
+
+    std::istringstream iss2(serialized);
+    const auto v2 = toml::parse<toml::discard_comments, toml::flat_table>(iss2);
+    BOOST_CHECK(v == v2);
+}
+
+BOOST_AUTO_TEST_CASE(test_flat_table_large_table)
+{
+    std::string file;
+    for(int i=0; i<1000; ++i)
+    {
+        file += "key" + std::to_string(i) + " = " + std::to_string(i) + "\n";
+    }
+    std::istringstream iss(file);
+    const auto v = toml::parse<toml::discard_comments, toml::flat_table>(iss);
+    BOOST_TEST(v.size() == 1000u);
+    for(int i=0; i<1000; ++i)
+    {
+        BOOST_TEST(toml::find<int>(v, "key" + std::to_string(i)) == i);
+    }
+
+    std::istringstream dup("a = 1\nb = 2\na = 3\n");
+    BOOST_CHECK_THROW((toml::parse<toml::discard_comments, toml::flat_table>(dup)),
+                      toml::syntax_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_flat_table_erase_many)
+{
+    toml::flat_table<std::string, int> tab;
+    for(int i=0; i<1000; ++i)
+    {
+        tab.emplace(std::to_string(i), i);
+    }
+    // the index is updated without rebuilding it
+    for(int i=0; i<1000; i+=3)
+    {
+        BOOST_TEST(tab.erase(std::to_string(i)) == 1u);
+    }
+    BOOST_TEST(tab.size() == 666u);
+    for(int i=0; i<1000; ++i)
+    {
+        const auto found = tab.find(std::to_string(i));
+        if(i % 3 == 0)
+        {
+            BOOST_TEST((found == tab.end()));
+        }
+        else
+        {
+            BOOST_TEST_REQUIRE((found != tab.end()));
+            BOOST_TEST(found->second == i);
+        }
+    }
+}
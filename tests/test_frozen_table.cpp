@@ -0,0 +1,105 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace
+{
+struct is_integer_visitor
+{
+    bool operator()(const toml::integer&) const noexcept {return true;}
+    template<typename T>
+    bool operator()(const T&) const noexcept {return false;}
+};
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_frozen_table_container)
+{
+    std::vector<std::pair<std::string, int>> kvs;
+    for(int i=0; i<1000; ++i)
+    {
+        kvs.emplace_back("key" + std::to_string(i), i);
+    }
+    const toml::frozen_table<std::string, int> tab(kvs.begin(), kvs.end());
+    BOOST_TEST(tab.size() == 1000u);
+    for(int i=0; i<1000; ++i)
+    {
+        BOOST_TEST(tab.at("key" + std::to_string(i)) == i);
+    }
+    BOOST_TEST(tab.count("key1000") == 0u);
+    BOOST_TEST(tab.count("") == 0u);
+    BOOST_CHECK(tab.find("foo") == tab.end());
+    BOOST_CHECK_THROW(tab.at("foo"), std::out_of_range);
+
+    // keeps the order of construction
+    int expected = 0;
+    for(const auto& kv : tab)
+    {
+        BOOST_TEST(kv.second == expected);
+        ++expected;
+    }
+
+    // the first one is kept if keys are duplicated
+    const toml::frozen_table<std::string, int> dup{{"a", 1}, {"b", 2}, {"a", 3}};
+    BOOST_TEST(dup.size() == 2u);
+    BOOST_TEST(dup.at("a") == 1);
+    BOOST_TEST(dup.at("b") == 2);
+
+    const toml::frozen_table<std::string, int> empty;
+    BOOST_TEST(empty.count("a") == 0u);
+    BOOST_CHECK(empty.find("a") == empty.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_freeze)
+{
+    std::istringstream iss(
+        "# comment\n"
+        "title = \"TOML\"\n"
+        "[server]\n"
+        "host = \"example.com\" # host name\n"
+        "port = 8080\n"
+        "ratios = [1.0, 0.5]\n"
+        "[[fruits]]\n"
+        "name = \"apple\"\n"
+        "[[fruits]]\n"
+        "name = \"banana\"\n"
+        );
+    const auto data = toml::parse<toml::preserve_comments>(iss);
+    const auto frozen = toml::freeze(data);
+
+    using frozen_type = toml::basic_value<toml::preserve_comments, toml::frozen_table>;
+    BOOST_TEST(frozen.is_table());
+    BOOST_TEST(toml::find<std::string>(frozen, "title") == "TOML");
+    BOOST_TEST(toml::find<int>(frozen, "server", "port") == 8080);
+    BOOST_TEST(toml::find<std::string>(frozen, "fruits", 1, "name") == "banana");
+    BOOST_TEST(toml::find_or<int>(frozen, "server", "timeout", 30) == 30);
+    BOOST_CHECK_THROW(toml::find(frozen, "client"), std::out_of_range);
+
+    const auto ratios = toml::find<std::vector<double>>(frozen, "server", "ratios");
+    BOOST_TEST(ratios.size() == 2u);
+    BOOST_TEST(ratios.at(1) == 0.5);
+
+    const auto server = toml::find<std::map<std::string, frozen_type>>(frozen, "server");
+    BOOST_TEST(server.size() == 3u);
+
+    // comments and locations are kept
+    const auto& host = toml::find(frozen, "server", "host");
+    BOOST_TEST(host.comments().size() == 1u);
+    BOOST_TEST(host.comments().front() == " host name");
+    BOOST_TEST(host.location().line() == 4u);
+
+    BOOST_TEST( toml::visit(is_integer_visitor{}, toml::find(frozen, "server", "port")));
+    BOOST_TEST(!toml::visit(is_integer_visitor{}, toml::find(frozen, "server", "host")));
+
+    // can be serialized
+    std::ostringstream oss;
+    oss << std::setw(80) << frozen;
+    std::istringstream iss2(oss.str());
+    BOOST_CHECK(toml::parse<toml::preserve_comments>(iss2) == data);
+
+    BOOST_CHECK(frozen == toml::freeze(data));
+}
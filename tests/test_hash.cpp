@@ -0,0 +1,178 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+const std::string document(
+    "a = 1\n"
+    "b = [1, 2.0, \"three\", 1979-05-27T07:32:00Z]\n"
+    "[t]\n"
+    "x = 1979-05-27\n"
+    "y = 07:32:00\n"
+    "z = 1979-05-27T07:32:00\n"
+    );
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_structural_hash_equivalent)
+{
+    std::istringstream iss(document);
+    const auto a = toml::parse(iss, "test.toml");
+
+    // the same content in another order, with comments
+    const std::string reordered(
+        "# comments are not hashed\n"
+        "t = {y = 07:32:00, x = 1979-05-27, z = 1979-05-27T07:32:00}\n"
+        "b = [1, 2.0, \"three\", 1979-05-27T07:32:00Z]\n"
+        "a = 1 # comment\n");
+    {
+        std::istringstream reordered_iss(reordered);
+        BOOST_TEST(toml::structural_hash(a) ==
+                   toml::structural_hash(toml::parse(reordered_iss, "test.toml")));
+    }
+
+    // another table type
+    {
+        std::istringstream ordered_iss(document);
+        const auto ordered = toml::parse<toml::preserve_comments, toml::ordered_table>(
+                ordered_iss, "test.toml");
+        BOOST_TEST(toml::structural_hash(a) == toml::structural_hash(ordered));
+    }
+    {
+        std::istringstream ordered_iss(reordered);
+        const auto ordered = toml::parse<toml::preserve_comments, toml::ordered_table>(
+                ordered_iss, "test.toml");
+        BOOST_TEST(toml::structural_hash(a) == toml::structural_hash(ordered));
+    }
+
+    // the hash does not depend on the platform or the process
+    BOOST_TEST(toml::structural_hash(a) == 0xFB18F19DEC873953ull);
+
+    // 0.0 == -0.0
+    BOOST_TEST(toml::structural_hash(toml::value(0.0)) ==
+               toml::structural_hash(toml::value(-0.0)));
+}
+
+BOOST_AUTO_TEST_CASE(test_structural_hash_different)
+{
+    const std::vector<std::string> docs{
+        "a = 1\n",
+        "a = 2\n",
+        "b = 1\n",
+        "a = 1.0\n",
+        "a = \"1\"\n",
+        "a = '1'\n",
+        "a = true\n",
+        "a = [1]\n",
+        "a = [[1]]\n",
+        "a = [1, 2]\n",
+        "a = [2, 1]\n",
+        "a = {}\n",
+        "a = {b = 1}\n",
+        "a.b.c = 1\n",
+        "a = 1\nb = 1\n",
+        "a = 1979-05-27\n",
+        "a = 1979-05-28\n",
+        "a = 07:32:00\n",
+        "a = 07:32:00.001\n",
+        "a = 1979-05-27T07:32:00\n",
+        "a = 1979-05-27T07:32:00Z\n",
+        "a = 1979-05-27T07:32:00+09:00\n",
+        "",
+    };
+    std::unordered_set<std::uint64_t> hashes;
+    for(const auto& doc : docs)
+    {
+        std::istringstream iss(doc);
+        hashes.insert(toml::structural_hash(toml::parse(iss, "test.toml")));
+    }
+    BOOST_TEST(hashes.size() == docs.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_std_hash)
+{
+    std::istringstream iss1(document);
+    std::istringstream iss2(document);
+    std::istringstream iss3("a = 1\n");
+    std::istringstream iss4("a = 1 # comment\n");
+
+    std::unordered_set<toml::value> set;
+    set.insert(toml::parse(iss1, "test.toml"));
+    set.insert(toml::parse(iss2, "test.toml"));
+    set.insert(toml::parse(iss3, "test.toml"));
+    BOOST_TEST(set.size() == 2u);
+    BOOST_TEST(set.count(toml::parse(iss4, "test.toml")) == 1u);
+
+    std::unordered_set<toml::local_date> dates{
+        toml::local_date(2000, toml::month_t::Jan, 1),
+        toml::local_date(2000, toml::month_t::Jan, 1),
+        toml::local_date(2000, toml::month_t::Jan, 2)
+    };
+    BOOST_TEST(dates.size() == 2u);
+
+    BOOST_TEST(std::hash<toml::local_time>{}(toml::local_time(7, 32, 0)) ==
+               std::hash<toml::local_time>{}(toml::local_time(7, 32, 0)));
+    BOOST_TEST(std::hash<toml::offset_datetime>{}(toml::offset_datetime(
+                   toml::local_date(2000, toml::month_t::Jan, 1),
+                   toml::local_time(0, 0, 0), toml::time_offset(9, 0))) !=
+               std::hash<toml::offset_datetime>{}(toml::offset_datetime(
+                   toml::local_date(2000, toml::month_t::Jan, 1),
+                   toml::local_time(0, 0, 0), toml::time_offset(0, 0))));
+}
+
+BOOST_AUTO_TEST_CASE(test_structurally_equal_nan)
+{
+    std::istringstream iss("a = nan\nb = [nan]\n");
+    const auto v = toml::parse(iss, "test.toml");
+    const auto c = v;
+
+    // operator== follows IEEE 754 whether or not the copy shares the content
+    BOOST_CHECK(!(v == c));
+    BOOST_CHECK(toml::detail::structurally_equal(v, c));
+}
+
+BOOST_AUTO_TEST_CASE(test_hashed_value)
+{
+    std::istringstream iss_a(document);
+    std::istringstream iss_b(document);
+    std::istringstream iss_c("a = 1\n");
+    const toml::hashed_value<toml::value> a(toml::parse(iss_a, "test.toml"));
+    const toml::hashed_value<toml::value> b(toml::parse(iss_b, "test.toml"));
+    const toml::hashed_value<toml::value> c(toml::parse(iss_c, "test.toml"));
+    const auto copy = a;
+
+    BOOST_TEST(a.hash() == toml::structural_hash(a.value()));
+    BOOST_TEST(copy.shared() == a.shared());
+    BOOST_CHECK(a == copy);
+    BOOST_CHECK(a == b);
+    BOOST_CHECK(a != c);
+    BOOST_TEST(toml::find<int>(*a, "a") == 1);
+    BOOST_TEST(a->is_table());
+
+    std::unordered_map<toml::hashed_value<toml::value>, int> map;
+    map[a] = 1;
+    map[b] = 2;
+    map[c] = 3;
+    BOOST_TEST(map.size() == 2u);
+    BOOST_TEST(map.at(copy) == 2);
+
+    const auto ptr = std::make_shared<const toml::value>(a.value());
+    const toml::hashed_value<toml::value> d(ptr);
+    BOOST_TEST(d.shared() == ptr);
+    BOOST_CHECK(d == a);
+
+    // equality matches the hash: NaN equals NaN and comments are ignored
+    std::istringstream iss_nan1("a = nan # comment\nb = [1.0, nan]\n");
+    std::istringstream iss_nan2("a = nan\nb = [1.0, nan]\n");
+    const toml::hashed_value<toml::value> nan1(toml::parse(iss_nan1, "test.toml"));
+    const toml::hashed_value<toml::value> nan2(toml::parse(iss_nan2, "test.toml"));
+    BOOST_TEST(nan1.hash() == nan2.hash());
+    BOOST_CHECK(nan1 == nan2);
+    map[nan1] = 4;
+    BOOST_TEST(map.count(nan2) == 1u);
+    BOOST_TEST(map.at(nan2) == 4);
+}
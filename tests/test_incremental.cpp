@@ -0,0 +1,264 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <random>
+
+namespace
+{
+using ordered_value    = toml::basic_value<toml::preserve_comments, toml::ordered_table>;
+using ordered_document = toml::basic_incremental_document<toml::preserve_comments, toml::ordered_table>;
+
+const std::string document(
+    "# file comment\n"
+    "\n"
+    "title = \"incremental\"\n"
+    "owner.name = \"Tom\"\n"
+    "\n"
+    "[server]\n"
+    "host = \"localhost\"\n"
+    "port = 8080\n"
+    "\n"
+    "# comment for tls\n"
+    "[server.tls]\n"
+    "enabled = true\n"
+    "\n"
+    "[database]\n"
+    "ports = [8000, 8001, 8002]\n"
+    "data = [ [\"delta\", \"phi\"], [3.14] ]\n"
+    "# \"\"\"\n" // closes a string opened in [server.tls] in the test below
+    "\n"
+    "[[products]]\n"
+    "name = \"Hammer\"\n"
+    "\n"
+    "[[products]]\n"
+    "name = \"Nail\"\n"
+    "\n"
+    "[clients]\n"
+    "str = '''\n"
+    "[not a header]\n"
+    "'''\n"
+    );
+
+// the values, comments and locations should be the same as toml::parse.
+template<typename Value>
+bool same_locations(const Value& lhs, const Value& rhs)
+{
+    const auto l = lhs.location();
+    const auto r = rhs.location();
+    if(l.line() != r.line() || l.column() != r.column() || l.region() != r.region())
+    {
+        return false;
+    }
+    if(lhs.is_table())
+    {
+        for(const auto& kv : lhs.as_table())
+        {
+            if(!same_locations(kv.second, rhs.as_table().at(kv.first))) {return false;}
+        }
+    }
+    else if(lhs.is_array())
+    {
+        for(std::size_t i=0; i<lhs.as_array().size(); ++i)
+        {
+            if(!same_locations(lhs.as_array().at(i), rhs.as_array().at(i))) {return false;}
+        }
+    }
+    return true;
+}
+
+std::size_t offset_of(const std::string& str, const std::string& sub)
+{
+    const auto pos = str.find(sub);
+    BOOST_REQUIRE(pos != std::string::npos);
+    return pos;
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_incremental_construct)
+{
+    const ordered_document doc(document, "test.toml");
+    std::istringstream iss(document);
+    const auto expected = toml::parse<toml::preserve_comments, toml::ordered_table>(iss, "test.toml");
+
+    BOOST_TEST(doc.content() == document);
+    BOOST_TEST(doc.sections() == 7u);
+    BOOST_TEST(doc.reparsed_sections() == 7u);
+    BOOST_CHECK(doc.value() == expected);
+    BOOST_TEST(same_locations(doc.value(), expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_incremental_edit_value)
+{
+    toml::incremental_document doc(document, "test.toml");
+
+    const auto pos = offset_of(document, "8080");
+    doc.edit(pos, 4, "12345");
+
+    // [database] and the following tables are not parsed again.
+    BOOST_TEST(doc.reparsed_sections() <= 3u);
+    BOOST_TEST(toml::find<int>(doc.value(), "server", "port") == 12345);
+    BOOST_TEST(toml::find<bool>(doc.value(), "server", "tls", "enabled") == true);
+    BOOST_TEST(toml::find<std::string>(doc.value(), "products", 1, "name") == "Nail");
+
+    std::string expected(document);
+    expected.replace(pos, 4, "12345");
+    BOOST_TEST(doc.content() == expected);
+    std::istringstream iss(expected);
+    BOOST_CHECK(doc.value() == toml::parse(iss, "test.toml"));
+}
+
+BOOST_AUTO_TEST_CASE(test_incremental_locations)
+{
+    ordered_document doc(document, "test.toml");
+
+    // adds lines at the top. the values below should be moved.
+    doc.edit(0, 0, "a = 1\nb = 2\n\n");
+    const auto& name = toml::find(doc.value(), "products", 1, "name");
+    BOOST_TEST(name.location().line() == 26u);
+    BOOST_TEST(name.location().line_str() == "name = \"Nail\"");
+    std::istringstream iss(doc.content());
+    BOOST_TEST(same_locations(doc.value(),
+        toml::parse<toml::preserve_comments, toml::ordered_table>(iss, "test.toml")));
+}
+
+BOOST_AUTO_TEST_CASE(test_incremental_headers)
+{
+    ordered_document doc(document, "test.toml");
+
+    // rename a header
+    {
+        const auto content = doc.content();
+        doc.edit(offset_of(content, "[database]") + 1, 8, "storage");
+        BOOST_TEST(!doc.value().contains("database"));
+        BOOST_TEST(toml::find<int>(doc.value(), "storage", "ports", 0) == 8000);
+        std::istringstream iss(doc.content());
+        const auto expected = toml::parse<toml::preserve_comments, toml::ordered_table>(iss, "test.toml");
+        BOOST_CHECK(doc.value() == expected);
+    }
+    // remove a header. its body is merged into the previous table
+    {
+        const auto content = doc.content();
+        doc.edit(offset_of(content, "[storage]"), 10, "");
+        BOOST_TEST(doc.sections() == 6u);
+        BOOST_TEST(toml::find<int>(doc.value(), "server", "tls", "ports", 1) == 8001);
+        std::istringstream iss(doc.content());
+        const auto expected = toml::parse<toml::preserve_comments, toml::ordered_table>(iss, "test.toml");
+        BOOST_CHECK(doc.value() == expected);
+    }
+    // add a header in the middle of a table
+    {
+        const auto content = doc.content();
+        doc.edit(offset_of(content, "ports"), 0, "[storage]\n");
+        BOOST_TEST(doc.sections() == 7u);
+        BOOST_TEST(toml::find<int>(doc.value(), "storage", "ports", 2) == 8002);
+        std::istringstream iss(doc.content());
+        const auto expected = toml::parse<toml::preserve_comments, toml::ordered_table>(iss, "test.toml");
+        BOOST_CHECK(doc.value() == expected);
+    }
+    // append an array of tables
+    {
+        doc.edit(doc.size(), 0, "[[products]]\nname = \"Screw\"\n");
+        BOOST_TEST(toml::find(doc.value(), "products").size() == 3u);
+        std::istringstream iss(doc.content());
+        const auto expected = toml::parse<toml::preserve_comments, toml::ordered_table>(iss, "test.toml");
+        BOOST_CHECK(doc.value() == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_incremental_multiline_string)
+{
+    ordered_document doc(document, "test.toml");
+
+    // opening a multi-line string swallows the following headers
+    const auto content = doc.content();
+    const auto pos = offset_of(content, "enabled = true") + 10;
+    doc.edit(pos, 4, "\"\"\"");
+    BOOST_TEST(!doc.value().contains("database"));
+    BOOST_TEST(doc.value().contains("clients"));
+    {
+        std::istringstream iss(doc.content());
+        const auto expected = toml::parse<toml::preserve_comments, toml::ordered_table>(iss, "test.toml");
+        BOOST_CHECK(doc.value() == expected);
+    }
+
+    doc.edit(pos, 3, "true");
+    BOOST_TEST(doc.content() == document);
+    std::istringstream iss(document);
+    const auto expected = toml::parse<toml::preserve_comments, toml::ordered_table>(iss, "test.toml");
+    BOOST_CHECK(doc.value() == expected);
+    BOOST_TEST(same_locations(doc.value(), expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_incremental_errors)
+{
+    ordered_document doc(document, "test.toml");
+    const auto before = doc.value();
+
+    // defines [server] twice
+    BOOST_CHECK_THROW(doc.edit(offset_of(document, "[database]") + 1, 8, "server"),
+                      toml::syntax_error);
+    // defines [server.tls] twice in different sections
+    BOOST_CHECK_THROW(doc.edit(offset_of(document, "[database]"), 0, "[server.tls]\n"),
+                      toml::syntax_error);
+    BOOST_CHECK_THROW(doc.edit(offset_of(document, "port = "), 0, "="),
+                      toml::syntax_error);
+    BOOST_CHECK_THROW(doc.edit(doc.size(), 1, ""), std::out_of_range);
+
+    BOOST_TEST(doc.content() == document);
+    BOOST_CHECK(doc.value() == before);
+
+    BOOST_CHECK_THROW(toml::incremental_document("a = "), toml::syntax_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_incremental_random_edits)
+{
+    const std::vector<std::string> snippets{
+        "", "\n", "#", "[", "]", "=", "\"", "'''", "\"\"\"", " = 1\n",
+        "\n[a]\n", "\n[[products]]\n", "\n[server.tls]\n", "x.y = 2\n",
+        "\n[server]\n", "title = 1\n"
+    };
+
+    std::mt19937 rng(123456789);
+    ordered_document doc(document, "test.toml");
+    std::size_t accepted = 0;
+    for(std::size_t i=0; i<1000; ++i)
+    {
+        const auto content = doc.content();
+        const auto offset  = std::uniform_int_distribution<std::size_t>(0, content.size())(rng);
+        const auto length  = (std::min)(content.size() - offset,
+                std::uniform_int_distribution<std::size_t>(0, 4)(rng));
+        const auto& text = snippets.at(std::uniform_int_distribution<std::size_t>(
+                0, snippets.size() - 1)(rng));
+
+        std::string edited(content);
+        edited.replace(offset, length, text);
+
+        bool valid = true;
+        ordered_value expected;
+        try
+        {
+            std::istringstream iss(edited);
+            expected = toml::parse<toml::preserve_comments, toml::ordered_table>(iss, "test.toml");
+        }
+        catch(const toml::syntax_error&)
+        {
+            valid = false;
+        }
+
+        if(valid)
+        {
+            doc.edit(offset, length, text);
+            BOOST_TEST(doc.content() == edited);
+            BOOST_CHECK(doc.value() == expected);
+            BOOST_TEST(same_locations(doc.value(), expected));
+            ++accepted;
+        }
+        else
+        {
+            BOOST_CHECK_THROW(doc.edit(offset, length, text), toml::syntax_error);
+            BOOST_TEST(doc.content() == content);
+        }
+    }
+    BOOST_TEST(accepted > 100u);
+}
@@ -0,0 +1,186 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+using ordered_value = toml::basic_value<toml::discard_comments, toml::ordered_table>;
+
+ordered_value parse_ordered(const std::string& str)
+{
+    std::istringstream iss(str);
+    return toml::parse<toml::discard_comments, toml::ordered_table>(iss, "test.toml");
+}
+
+toml::json_options typed_options()
+{
+    toml::json_options opts;
+    opts.format = toml::json_format::typed;
+    return opts;
+}
+
+const std::string document(
+    "# comments are not written\n"
+    "title = \"TOML \\\"example\\\"\\n\\u0001\\u00e9\"\n"
+    "int = -9223372036854775808\n"
+    "flt = [1.0, 0.1, -2.5e-10, inf, nan]\n"
+    "bool = true\n"
+    "odt = 1979-05-27T07:32:00.999999-07:00\n"
+    "ldt = 1979-05-27T07:32:00\n"
+    "ld  = 1979-05-27\n"
+    "lt  = 00:32:00.5\n"
+    "[owner]\n"
+    "name = \"Tom\"\n"
+    "[[points]]\n"
+    "x = 1\n"
+    "[[points]]\n"
+    "x = 2\n");
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_to_json_plain)
+{
+    const auto data = parse_ordered(document);
+    BOOST_TEST(toml::to_json(data) ==
+        "{\"title\":\"TOML \\\"example\\\"\\n\\u0001\xC3\xA9\","
+        "\"int\":-9223372036854775808,"
+        "\"flt\":[1.0,0.1,-2.5e-10,null,null],"
+        "\"bool\":true,"
+        "\"odt\":\"1979-05-27T07:32:00.999999-07:00\","
+        "\"ldt\":\"1979-05-27T07:32:00\","
+        "\"ld\":\"1979-05-27\","
+        "\"lt\":\"00:32:00.500\","
+        "\"owner\":{\"name\":\"Tom\"},"
+        "\"points\":[{\"x\":1},{\"x\":2}]}");
+}
+
+BOOST_AUTO_TEST_CASE(test_to_json_typed)
+{
+    const auto data = parse_ordered(
+        "a = 42\n"
+        "b = [3.14, -inf, nan]\n"
+        "c = \"s\"\n"
+        "d = false\n"
+        "e = 2000-01-01T00:00:00Z\n"
+        "f = 2000-01-01T00:00:00\n"
+        "g = 2000-01-01\n"
+        "h = 12:34:56\n");
+    BOOST_TEST(toml::to_json(data, typed_options()) ==
+        "{\"a\":{\"type\":\"integer\",\"value\":\"42\"},"
+        "\"b\":[{\"type\":\"float\",\"value\":\"3.14\"},"
+              "{\"type\":\"float\",\"value\":\"-inf\"},"
+              "{\"type\":\"float\",\"value\":\"nan\"}],"
+        "\"c\":{\"type\":\"string\",\"value\":\"s\"},"
+        "\"d\":{\"type\":\"bool\",\"value\":\"false\"},"
+        "\"e\":{\"type\":\"datetime\",\"value\":\"2000-01-01T00:00:00Z\"},"
+        "\"f\":{\"type\":\"datetime-local\",\"value\":\"2000-01-01T00:00:00\"},"
+        "\"g\":{\"type\":\"date-local\",\"value\":\"2000-01-01\"},"
+        "\"h\":{\"type\":\"time-local\",\"value\":\"12:34:56\"}}");
+}
+
+BOOST_AUTO_TEST_CASE(test_to_json_sinks)
+{
+    // a large document is passed to the sink in several chunks.
+    std::ostringstream oss;
+    // one element per line; the parser is slow for a very long line.
+    oss << "a = [\n";
+    for(int i=0; i<1000; ++i) {oss << "\"" << std::string(static_cast<std::size_t>(i % 17), 'x') << "\",\n";}
+    oss << "]\n";
+    const auto data = parse_ordered(oss.str());
+    const auto expected = toml::to_json(data);
+
+    std::size_t n_chunks = 0;
+    std::string chunks;
+    toml::to_json(data, [&](const char* p, std::size_t n) {
+            chunks.append(p, n);
+            ++n_chunks;
+        });
+    BOOST_TEST(chunks == expected);
+    BOOST_TEST(n_chunks > 1u);
+
+    std::ostringstream os;
+    toml::to_json(data, os);
+    BOOST_TEST(os.str() == expected);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_round_trip)
+{
+    const auto data = parse_ordered(document);
+    {
+        const auto json = toml::to_json(data, typed_options());
+        const auto read = toml::from_json<toml::discard_comments, toml::ordered_table>(
+                json, typed_options());
+        BOOST_TEST(toml::to_json(read, typed_options()) == json);
+
+        BOOST_TEST(toml::find<std::string>(read, "title") == "TOML \"example\"\n\x01\xC3\xA9");
+        BOOST_TEST(toml::find<toml::integer>(read, "int") ==
+                   (std::numeric_limits<toml::integer>::min)());
+        BOOST_TEST(toml::find(read, "odt").as_offset_datetime() ==
+                   toml::find(data, "odt").as_offset_datetime());
+        BOOST_TEST(toml::find(read, "lt").as_local_time() ==
+                   toml::find(data, "lt").as_local_time());
+        BOOST_TEST(std::isnan(toml::find<double>(read, "flt", 4)));
+    }
+    {
+        const auto read = toml::from_json<toml::discard_comments, toml::ordered_table>(
+                "{\"a\": [1, 1.0, 1e2, -0, 0.1, 9223372036854775808, \"x\\/\\ud83d\\ude00\"],"
+                " \"b\" : { } , \"c\": [ ], \"d\": false}");
+        BOOST_TEST(toml::find<toml::integer>(read, "a", 0) == 1);
+        BOOST_TEST(toml::find(read, "a", 1).is_floating());
+        BOOST_TEST(toml::find<double>(read, "a", 2) == 100.0);
+        BOOST_TEST(toml::find(read, "a", 3).is_integer());
+        BOOST_TEST(toml::find<double>(read, "a", 4) == 0.1);
+        BOOST_TEST(toml::find(read, "a", 5).is_floating());
+        BOOST_TEST(toml::find<std::string>(read, "a", 6) == "x/\xF0\x9F\x98\x80");
+        BOOST_TEST(toml::find(read, "b").as_table().empty());
+        BOOST_TEST(toml::find(read, "c").as_array().empty());
+        BOOST_TEST(toml::find<bool>(read, "d") == false);
+
+        // plain JSON keeps the types except datetimes, NaN and infinity
+        const auto plain = toml::to_json(parse_ordered(
+            "int = 1\nflt = [1.0, 0.5]\nld = 1979-05-27\n[t]\ns = \"x\"\n"));
+        std::istringstream iss(plain);
+        const auto reread = toml::from_json<toml::discard_comments, toml::ordered_table>(iss);
+        BOOST_TEST(toml::to_json(reread) == plain);
+        BOOST_TEST(toml::find(reread, "int").is_integer());
+        BOOST_TEST(toml::find(reread, "flt", 0).is_floating());
+        BOOST_TEST(toml::find(reread, "ld").is_string());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_from_json_errors)
+{
+    BOOST_CHECK_THROW(toml::from_json(""),                  toml::syntax_error);
+    BOOST_CHECK_THROW(toml::from_json("{\"a\": 1,}"),       toml::syntax_error);
+    BOOST_CHECK_THROW(toml::from_json("{\"a\": 1} x"),      toml::syntax_error);
+    BOOST_CHECK_THROW(toml::from_json("{\"a\": 1, \"a\": 2}"), toml::syntax_error);
+    BOOST_CHECK_THROW(toml::from_json("{\"a\": null}"),     toml::syntax_error);
+    BOOST_CHECK_THROW(toml::from_json("{\"a\": 01}"),       toml::syntax_error);
+    BOOST_CHECK_THROW(toml::from_json("{\"a\": \"\\x\"}"),  toml::syntax_error);
+    BOOST_CHECK_THROW(toml::from_json("{\"a\": \"\\ud83d\"}"), toml::syntax_error);
+    BOOST_CHECK_THROW(toml::from_json("{\"a\": \"\n\"}"),   toml::syntax_error);
+    BOOST_CHECK_THROW(toml::from_json("{\"a\": tru}"),      toml::syntax_error);
+    BOOST_CHECK_THROW(toml::from_json("[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[["
+                                      "[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[]"), toml::syntax_error);
+    BOOST_CHECK_THROW(toml::from_json(
+        "{\"a\": {\"type\": \"integer\", \"value\": \"1.5\"}}", typed_options()),
+        toml::syntax_error);
+
+    try
+    {
+        toml::from_json("{\n  \"a\": 1,\n  \"b\": nul\n}");
+        BOOST_TEST(false);
+    }
+    catch(const toml::syntax_error& err)
+    {
+        BOOST_TEST(err.location().line() == 3u);
+    }
+
+    // an object with "type" and "value" that are not a typed value
+    const auto v = toml::from_json(
+        "{\"a\": {\"type\": \"table\", \"value\": \"x\"}}", typed_options());
+    BOOST_TEST(toml::find<std::string>(v, "a", "type") == "table");
+}
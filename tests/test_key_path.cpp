@@ -0,0 +1,128 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <limits>
+#include <sstream>
+#include <type_traits>
+
+namespace
+{
+toml::value parse_string(const std::string& str)
+{
+    std::istringstream iss(str);
+    return toml::parse(iss, "key_path.toml");
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_key_path_parse)
+{
+    {
+        const auto path = toml::key_path::parse("server.listeners[2].port");
+        BOOST_TEST(path.size() == 4u);
+        BOOST_TEST(path.segments().at(0).as_key() == "server");
+        BOOST_TEST(path.segments().at(1).as_key() == "listeners");
+        BOOST_TEST(path.segments().at(2).is_index());
+        BOOST_TEST(path.segments().at(2).as_index() == 2u);
+        BOOST_TEST(path.segments().at(3).as_key() == "port");
+        BOOST_TEST(path.str() == "server.listeners[2].port");
+    }
+    {
+        const auto path = toml::key_path::parse("a . \"b.c\" . 'd'[0] [1]");
+        BOOST_TEST(path.size() == 5u);
+        BOOST_TEST(path.segments().at(1).as_key() == "b.c");
+        BOOST_TEST(path.segments().at(2).as_key() == "d");
+        BOOST_TEST(path.segments().at(4).as_index() == 1u);
+        BOOST_TEST(path.str() == "a.\"b.c\".d[0][1]");
+    }
+    {
+        const toml::key_path path{"server", "listeners", 0, "port"};
+        BOOST_TEST(path.str() == "server.listeners[0].port");
+    }
+    BOOST_TEST(toml::key_path::parse("").empty());
+
+    // the components are not parsed
+    BOOST_TEST(toml::key_path::parse("a.b").size() == 2u);
+    BOOST_TEST(toml::key_path{"a.b"}.size() == 1u);
+    BOOST_TEST(toml::key_path{"a.b"}.segments().at(0).as_key() == "a.b");
+    BOOST_TEST(toml::key_path{"a.b"}.str() == "\"a.b\"");
+    BOOST_TEST(!(std::is_constructible<toml::key_path, std::string>::value));
+
+    BOOST_CHECK_THROW(toml::key_path::parse("a."),    toml::syntax_error);
+    BOOST_CHECK_THROW(toml::key_path::parse("a..b"),  toml::syntax_error);
+    BOOST_CHECK_THROW(toml::key_path::parse("a[b]"),  toml::syntax_error);
+    BOOST_CHECK_THROW(toml::key_path::parse("a[1"),   toml::syntax_error);
+    BOOST_CHECK_THROW(toml::key_path::parse("a b"),   toml::syntax_error);
+
+    // the index overflows std::size_t
+    BOOST_CHECK_THROW(toml::key_path::parse("a[99999999999999999999999]"), toml::syntax_error);
+    const auto max_index = std::to_string((std::numeric_limits<std::size_t>::max)());
+    BOOST_TEST(toml::key_path::parse("a[" + max_index + "]").str() == "a[" + max_index + "]");
+}
+
+BOOST_AUTO_TEST_CASE(test_key_path_find)
+{
+    auto data = parse_string(
+        "[server]\n"
+        "listeners = [{port = 80}, {port = 443}, {port = 8080}]\n"
+        "name = \"foo\"\n"
+        );
+    const auto port = toml::key_path::parse("server.listeners[2].port");
+    const auto name = toml::key_path::parse("server.name");
+
+    const auto& cdata = data;
+    BOOST_TEST(toml::find<int>(cdata, port) == 8080);
+    BOOST_TEST(toml::find<std::string>(cdata, name) == "foo");
+    BOOST_TEST(toml::find(cdata, toml::key_path::parse("server.listeners")).size() == 3u);
+    BOOST_TEST(toml::find(cdata, toml::key_path::parse("")).is_table());
+
+    toml::find(data, port) = 8000;
+    BOOST_TEST(toml::find<int>(data, "server", "listeners", 2, "port") == 8000);
+
+    BOOST_CHECK_THROW(toml::find(cdata, toml::key_path::parse("server.host")),         std::out_of_range);
+    BOOST_CHECK_THROW(toml::find(cdata, toml::key_path::parse("server.listeners[3]")), std::out_of_range);
+    BOOST_CHECK_THROW(toml::find(cdata, toml::key_path::parse("server.name.first")),   toml::type_error);
+    BOOST_CHECK_THROW(toml::find<int>(cdata, name),                              toml::type_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_key_path_lookup)
+{
+    const auto data = parse_string(
+        "[server]\n"
+        "listeners = [{port = 80}, {port = 443}]\n"
+        );
+    const auto port = toml::key_path::parse("server.listeners[1].port");
+
+    const toml::value* found = port.lookup(data);
+    BOOST_TEST_REQUIRE(found != nullptr);
+    BOOST_TEST(found->as_integer() == 443);
+
+    BOOST_CHECK(toml::key_path::parse("server.listeners[2]").lookup(data) == nullptr);
+    BOOST_CHECK(toml::key_path::parse("server.host").lookup(data)         == nullptr);
+    BOOST_CHECK(toml::key_path::parse("server[0]").lookup(data)           == nullptr);
+    BOOST_CHECK(toml::key_path::parse("server.listeners.port").lookup(data) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_key_path_cache)
+{
+    auto data = parse_string("a = {b = 1}\n");
+    auto path = toml::key_path::parse("a.b");
+
+    const toml::value* first = path.lookup(data, 1);
+    BOOST_TEST_REQUIRE(first != nullptr);
+    BOOST_TEST(first->as_integer() == 1);
+    BOOST_CHECK(path.lookup(data, 1) == first);
+
+    // modify the document and bump the generation
+    data.as_table()["a"] = toml::table{{"b", 2}};
+    const toml::value* second = path.lookup(data, 2);
+    BOOST_TEST_REQUIRE(second != nullptr);
+    BOOST_TEST(second->as_integer() == 2);
+
+    // another document
+    const auto other = parse_string("a = {c = 3}\n");
+    BOOST_CHECK(path.lookup(other, 2) == nullptr);
+
+    path.clear_cache();
+    BOOST_TEST(path.lookup(data, 2)->as_integer() == 2);
+}
@@ -0,0 +1,188 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <map>
+
+namespace
+{
+const std::string defaults(
+    "title = \"service\"\n"
+    "ports = [8080, 8081]\n"
+    "[server]\n"
+    "host = \"localhost\"\n"
+    "port = 8080\n"
+    "timeout = 30\n"
+    "[server.tls]\n"
+    "enabled = false\n"
+    "[log]\n"
+    "level = \"info\"\n");
+
+const std::string host(
+    "ports = [9090]\n"
+    "[server]\n"
+    "port = 9090\n"
+    "[server.tls]\n"
+    "enabled = true\n"
+    "cert = \"host.pem\"\n");
+
+const std::string overrides(
+    "log = \"stderr\"\n"
+    "[server]\n"
+    "timeout = 5\n");
+
+toml::layered_view make_view()
+{
+    std::istringstream defaults_iss(defaults);
+    std::istringstream host_iss(host);
+    std::istringstream overrides_iss(overrides);
+
+    toml::layered_view view;
+    view.add_layer(std::make_shared<const toml::value>(
+            toml::parse(defaults_iss, "defaults.toml")), "defaults.toml");
+    view.add_layer(std::make_shared<const toml::value>(
+            toml::parse(host_iss, "host.toml")), "host.toml");
+    view.add_layer(std::make_shared<const toml::value>(
+            toml::parse(overrides_iss, "overrides.toml")), "overrides.toml");
+    return view;
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_layered_view_find)
+{
+    const auto view = make_view();
+    BOOST_TEST(view.size() == 3u);
+
+    BOOST_TEST(view.find<std::string>("title")        == "service");
+    BOOST_TEST(view.find<int>("server", "port")       == 9090);
+    BOOST_TEST(view.find<int>("server", "timeout")    == 5);
+    BOOST_TEST(view.find<std::string>("server", "host") == "localhost");
+    BOOST_TEST(view.find<bool>("server", "tls", "enabled") == true);
+    BOOST_TEST(view.find<int>(toml::key_path::parse("server.port")) == 9090);
+
+    // arrays are replaced as a whole
+    BOOST_TEST(view.find<std::vector<int>>("ports") == (std::vector<int>{9090}));
+    BOOST_TEST(view.find<int>("ports", 0) == 9090);
+    BOOST_TEST(!view.contains("ports", 1));
+
+    // the value is not copied
+    BOOST_TEST(std::addressof(view.find("server", "port")) ==
+               std::addressof(toml::find(*view.layers().at(1).document, "server", "port")));
+    {
+        std::istringstream iss(host);
+        const auto doc = toml::parse(iss, "host.toml");
+        toml::layered_view borrowed;
+        borrowed.add_layer(doc, "host.toml");
+        BOOST_TEST(std::addressof(borrowed.find("server", "port")) ==
+                   std::addressof(toml::find(doc, "server", "port")));
+    }
+    {
+        // a temporary document is moved into the view
+        toml::layered_view owning;
+        {
+            std::istringstream iss(host);
+            owning.add_layer(toml::parse(iss, "host.toml"), "host.toml");
+        }
+        BOOST_TEST(owning.layers().at(0).document.use_count() == 1);
+        BOOST_TEST(owning.contains("server", "port"));
+        BOOST_TEST(owning.find<int>("server", "port") == 9090);
+    }
+
+    // a string in a higher layer hides the table in the lower layer
+    BOOST_TEST(view.find<std::string>("log") == "stderr");
+    BOOST_TEST(!view.contains("log", "level"));
+    BOOST_CHECK_THROW(view.find("log", "level"), std::out_of_range);
+
+    BOOST_TEST(view.contains("server", "tls", "cert"));
+    BOOST_TEST(!view.contains("server", "tls", "key"));
+    BOOST_TEST(view.lookup(toml::key_path::parse("server.tls.key")) == nullptr);
+    BOOST_CHECK_THROW(view.find<int>("server", "tls", "key"), std::out_of_range);
+
+    // a merged table is converted as a whole
+    const auto server = view.find<std::map<std::string, toml::value>>("server");
+    BOOST_TEST(server.size() == 4u);
+    BOOST_TEST(toml::get<int>(server.at("port"))    == 9090);
+    BOOST_TEST(toml::get<int>(server.at("timeout")) == 5);
+    BOOST_TEST(toml::get<std::string>(server.at("host")) == "localhost");
+}
+
+BOOST_AUTO_TEST_CASE(test_layered_view_source)
+{
+    const auto view = make_view();
+
+    BOOST_TEST(view.source("title")->name == "defaults.toml");
+    BOOST_TEST(view.source("title")->index == 0u);
+    BOOST_TEST(view.source("server", "port")->name    == "host.toml");
+    BOOST_TEST(view.source("server", "timeout")->name == "overrides.toml");
+    BOOST_TEST(view.source("server", "tls", "cert")->index == 1u);
+    BOOST_TEST(view.source("server")->name == "overrides.toml");
+    BOOST_TEST(view.source("server", "tls", "key") == nullptr);
+
+    // the location points to the file of the layer
+    BOOST_TEST(view.find("server", "port").location().file_name() == "host.toml");
+}
+
+BOOST_AUTO_TEST_CASE(test_layered_view_subview)
+{
+    const auto view = make_view();
+
+    const auto tls = view.subview(toml::key_path::parse("server.tls"));
+    BOOST_TEST(tls.size() == 2u);
+    BOOST_TEST(tls.find<bool>("enabled") == true);
+    BOOST_TEST(tls.find<std::string>("cert") == "host.pem");
+    BOOST_TEST(tls.source("enabled")->name  == "host.toml");
+    BOOST_TEST(tls.source("enabled")->index == 1u);
+
+    BOOST_CHECK_THROW(view.subview(toml::key_path::parse("title")), toml::type_error);
+    BOOST_CHECK_THROW(view.subview(toml::key_path::parse("none")),  std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(test_layered_view_flatten)
+{
+    const auto view = make_view();
+
+    std::istringstream expected_iss(
+        "title = \"service\"\n"
+        "ports = [9090]\n"
+        "log = \"stderr\"\n"
+        "[server]\n"
+        "host = \"localhost\"\n"
+        "port = 9090\n"
+        "timeout = 5\n"
+        "[server.tls]\n"
+        "enabled = true\n"
+        "cert = \"host.pem\"\n");
+    const auto expected = toml::parse(expected_iss, "expected.toml");
+    BOOST_TEST(view.flatten() == expected);
+    BOOST_TEST(view.flatten(toml::key_path::parse("server.tls")) ==
+               toml::find(expected, "server", "tls"));
+    BOOST_TEST(view.flatten(toml::key_path::parse("server.port")) == toml::value(9090));
+
+    BOOST_TEST(toml::layered_view().flatten() == toml::value(toml::table{}));
+}
+
+BOOST_AUTO_TEST_CASE(test_layered_view_ordered)
+{
+    using view_type = toml::basic_layered_view<toml::discard_comments, toml::ordered_table>;
+    using value_type = view_type::value_type;
+
+    std::istringstream lower("b = 1\na = 2\n[t]\nz = 1\n");
+    std::istringstream upper("c = 3\na = 4\n[t]\ny = 2\n");
+
+    view_type view;
+    view.add_layer(std::make_shared<const value_type>(
+            toml::parse<toml::discard_comments, toml::ordered_table>(lower, "lower.toml")), "lower");
+    view.add_layer(std::make_shared<const value_type>(
+            toml::parse<toml::discard_comments, toml::ordered_table>(upper, "upper.toml")), "upper");
+
+    // the keys are in the order they first appear from the lowest layer
+    const auto flat = view.flatten();
+    std::vector<std::string> keys;
+    for(const auto& kv : flat.as_table()) {keys.push_back(kv.first);}
+    BOOST_TEST(keys == (std::vector<std::string>{"b", "a", "t", "c"}));
+    BOOST_TEST(toml::find<int>(flat, "a") == 4);
+
+    keys.clear();
+    for(const auto& kv : toml::find(flat, "t").as_table()) {keys.push_back(kv.first);}
+    BOOST_TEST(keys == (std::vector<std::string>{"z", "y"}));
+}
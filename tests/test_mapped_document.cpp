@@ -0,0 +1,165 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+const std::string document(
+    "title = \"mapped\"\n"
+    "literal = 'C:\\Users'\n"
+    "integer = -42\n"
+    "floating = 3.14\n"
+    "boolean = true\n"
+    "odt = 1979-05-27T07:32:00.999999-07:00\n"
+    "ldt = 1979-05-27T07:32:00\n"
+    "ld = 1979-05-27\n"
+    "lt = 00:32:00.123\n"
+    "ints = [1, 2, 3]\n"
+    "mixed = [1, \"two\", [3.0], {four = 4}]\n"
+    "empty = []\n"
+    "\"quoted key\" = 1\n"
+    "[table]\n"
+    "key = \"value\"\n"
+    "[table.sub]\n"
+    "x = 1\n"
+    "[[records]]\n"
+    "id = 0\n"
+    "name = \"first\"\n"
+    "[[records]]\n"
+    "id = 1\n"
+    "name = \"second\"\n"
+    );
+
+std::string to_mapped(const toml::value& v)
+{
+    std::ostringstream oss;
+    toml::save_mapped(v, oss);
+    return oss.str();
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_mapped_document_find)
+{
+    std::istringstream iss(document);
+    const auto v   = toml::parse(iss, "document.toml");
+    const auto buf = to_mapped(v);
+    const toml::mapped_document doc(buf.data(), buf.size());
+    const auto root = doc.root();
+
+    BOOST_TEST(root.is_table());
+    BOOST_TEST(root.size() == v.size());
+    BOOST_TEST(toml::find<std::string>(root, "title") == "mapped");
+    BOOST_TEST(std::string(toml::find(root, "title").string_data()) == "mapped");
+    BOOST_CHECK(toml::find(root, "literal").string_kind() == toml::string_t::literal);
+    BOOST_TEST(toml::find<int>(root, "integer") == -42);
+    BOOST_TEST(toml::find<double>(root, "floating") == 3.14);
+    BOOST_TEST(toml::find<bool>(root, "boolean") == true);
+    BOOST_TEST(toml::find<int>(root, "quoted key") == 1);
+    BOOST_TEST(toml::find<toml::offset_datetime>(root, "odt") == toml::find<toml::offset_datetime>(v, "odt"));
+    BOOST_TEST(toml::find<toml::local_datetime>(root, "ldt") == toml::find<toml::local_datetime>(v, "ldt"));
+    BOOST_TEST(toml::find<toml::local_date>(root, "ld") == toml::find<toml::local_date>(v, "ld"));
+    BOOST_TEST(toml::find<toml::local_time>(root, "lt") == toml::find<toml::local_time>(v, "lt"));
+
+    BOOST_TEST(toml::find(root, "ints").size() == 3u);
+    BOOST_TEST(toml::find<int>(root, "ints", 2) == 3);
+    BOOST_TEST(toml::find<std::string>(root, "mixed", 1) == "two");
+    BOOST_TEST(toml::find<double>(root, "mixed", 2, 0) == 3.0);
+    BOOST_TEST(toml::find<int>(root, "mixed", 3, "four") == 4);
+    BOOST_TEST(toml::find(root, "empty").size() == 0u);
+    BOOST_TEST(toml::find<std::string>(root, "table", "key") == "value");
+    BOOST_TEST(toml::find<int>(root, "table", "sub", "x") == 1);
+    BOOST_TEST(toml::find<std::string>(root, "records", 1, "name") == "second");
+
+    // keys are sorted
+    const auto table = toml::find(root, "table");
+    BOOST_TEST(table.key_at(0) == "key");
+    BOOST_TEST(table.key_at(1) == "sub");
+    BOOST_TEST(table.value_at(0).as_string() == "value");
+
+    BOOST_TEST(root.contains("table"));
+    BOOST_TEST(!root.contains("nothing"));
+    BOOST_TEST(!root.contains("tabl"));
+    BOOST_TEST(!root.contains("tablex"));
+}
+
+BOOST_AUTO_TEST_CASE(test_mapped_document_errors)
+{
+    std::istringstream iss(document);
+    const auto buf = to_mapped(toml::parse(iss, "document.toml"));
+    const toml::mapped_document doc(buf.data(), buf.size());
+    const auto root = doc.root();
+
+    BOOST_CHECK_THROW(toml::find(root, "nothing"), std::out_of_range);
+    BOOST_CHECK_THROW(toml::find(root, "ints", 3),  std::out_of_range);
+    BOOST_CHECK_THROW(toml::find<int>(root, "title"), toml::type_error);
+    BOOST_CHECK_THROW(toml::find(root, "title", 0), toml::type_error);
+
+    // not a mapped document
+    const std::string text("title = \"toml\"\n# padding padding padding padding padding\n");
+    BOOST_CHECK_THROW(toml::mapped_document(text.data(), text.size()), toml::binary_error);
+
+    // truncated
+    BOOST_CHECK_THROW(toml::mapped_document(buf.data(), buf.size() - 8), toml::binary_error);
+
+    // a string whose length overflows 32 bits with the terminator
+    {
+        auto str = to_mapped(toml::value("x"));
+        const std::uint32_t len = 0xFFFFFFFFu;
+        const std::uint64_t off = str.size();
+        std::memcpy(&str[36], &len, 4);
+        std::memcpy(&str[40], &off, 8);
+        const toml::mapped_document broken(str.data(), str.size());
+        BOOST_CHECK_THROW(broken.root().as_string(), toml::binary_error);
+    }
+    // a string without the terminator
+    {
+        auto str = to_mapped(toml::value("x"));
+        std::size_t off = 0;
+        std::memcpy(&off, &str[40], sizeof(off));
+        str[off + 1] = 'y';
+        const toml::mapped_document broken(str.data(), str.size());
+        BOOST_CHECK_THROW(broken.root().string_data(), toml::binary_error);
+        BOOST_CHECK_THROW(broken.root().as_string(),   toml::binary_error);
+    }
+    // an array that contains itself
+    {
+        auto ary = to_mapped(toml::value(toml::array{1}));
+        const std::uint64_t off = 32;
+        std::memcpy(&ary[40], &off, 8);
+        const toml::mapped_document broken(ary.data(), ary.size());
+        BOOST_CHECK_THROW(broken.root().to_value(), toml::binary_error);
+        BOOST_CHECK_THROW(broken.root().at(0),      toml::binary_error);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_mapped_document_to_value)
+{
+    std::istringstream iss(document);
+    const auto v   = toml::parse(iss, "document.toml");
+    const auto buf = to_mapped(v);
+    const toml::mapped_document doc(buf.data(), buf.size());
+
+    BOOST_TEST(doc.root().to_value() == v);
+    BOOST_TEST(toml::get<toml::value>(toml::find(doc.root(), "table")) == toml::find(v, "table"));
+}
+
+BOOST_AUTO_TEST_CASE(test_mapped_document_file)
+{
+    std::istringstream iss(document);
+    const auto v = toml::parse(iss, "document.toml");
+    toml::save_mapped(v, "tmp_mapped_document.tomlmd");
+
+    toml::mapped_document doc("tmp_mapped_document.tomlmd");
+    BOOST_TEST(toml::find<std::string>(doc.root(), "records", 0, "name") == "first");
+
+    // moving a document keeps the views valid
+    const auto records = toml::find(doc.root(), "records");
+    toml::mapped_document moved(std::move(doc));
+    BOOST_TEST(toml::find<int>(records, 1, "id") == 1);
+    BOOST_TEST(moved.root().to_value() == v);
+
+    BOOST_CHECK_THROW(toml::mapped_document("there_is_no_such_file.tomlmd"), std::ios_base::failure);
+}
@@ -0,0 +1,64 @@
+#define TOML11_COUNT_LIVE_VALUES
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <sstream>
+
+BOOST_AUTO_TEST_CASE(test_memory_usage_of_parsed_value)
+{
+    const std::string file(
+        "# the title\n"
+        "title = \"a string that is long enough not to be stored inline\"\n"
+        "[server]\n"
+        "host  = \"example.com\"\n"
+        "port  = 8080\n"
+        "ratio = 0.5\n"
+        "names = [\"a\", \"b\", \"c\"]\n"
+        );
+    std::istringstream iss(file);
+    const auto data = toml::parse<toml::preserve_comments>(iss, "usage.toml");
+
+    const auto usage = toml::memory_usage(data);
+    BOOST_TEST(usage.scalars    >= 2 * sizeof(data));
+    BOOST_TEST(usage.strings    >= 5 * sizeof(data) + 50);
+    BOOST_TEST(usage.containers >= 3 * sizeof(data));
+    BOOST_TEST(usage.regions    >  0u);
+    BOOST_TEST(usage.sources    >= file.size());
+    BOOST_TEST(usage.comments   >  0u);
+    BOOST_TEST(usage.total() == usage.scalars + usage.strings + usage.containers +
+                                usage.regions + usage.sources + usage.comments);
+
+    // the source buffer is shared and counted once
+    const toml::basic_value<toml::preserve_comments> twice(
+        toml::basic_value<toml::preserve_comments>::array_type{data, data});
+    const auto usage2 = toml::memory_usage(twice);
+    BOOST_TEST(usage2.sources == usage.sources);
+    BOOST_TEST(usage2.regions == usage.regions);
+    BOOST_TEST(usage2.strings == usage.strings * 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_usage_of_constructed_value)
+{
+    const toml::value v(toml::table{{"a", 1}, {"b", toml::array{1.0, 2.0}}});
+    const auto usage = toml::memory_usage(v);
+    BOOST_TEST(usage.scalars    == 3 * sizeof(v));
+    BOOST_TEST(usage.containers >= 2 * sizeof(v));
+    BOOST_TEST(usage.strings  == 0u);
+    BOOST_TEST(usage.regions  == 0u);
+    BOOST_TEST(usage.sources  == 0u);
+    BOOST_TEST(usage.comments == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_live_value_count)
+{
+    const std::size_t before = toml::live_value_count();
+    {
+        const toml::value v(toml::array{1, 2, 3});
+        BOOST_TEST(toml::live_value_count() == before + 4);
+
+        const toml::value w = v;
+        BOOST_TEST(toml::live_value_count() == before + 8);
+    }
+    BOOST_TEST(toml::live_value_count() == before);
+}
@@ -0,0 +1,208 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+namespace
+{
+using value_type = toml::basic_value<toml::preserve_comments>;
+
+const std::string base_str(
+    "title = \"service\"\n"
+    "ports = [8080, 8081]\n"
+    "# the server\n"
+    "[server]\n"
+    "host = \"localhost\"\n"
+    "port = 8080 # default port\n"
+    "[[plugins]]\n"
+    "name = \"auth\"\n"
+    "enabled = false\n"
+    "[[plugins]]\n"
+    "name = \"cache\"\n"
+    "size = 100\n");
+
+const std::string override_str(
+    "ports = [9090]\n"
+    "[server]\n"
+    "port = 9090 # overridden\n"
+    "[server.tls]\n"
+    "cert = \"host.pem\"\n"
+    "[[plugins]]\n"
+    "name = \"cache\"\n"
+    "size = 200\n"
+    "[[plugins]]\n"
+    "name = \"metrics\"\n"
+    "[[plugins]]\n"
+    "enabled = true\n");
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_merge_tables)
+{
+    std::istringstream dst_iss(base_str);
+    std::istringstream src_iss(override_str);
+    auto dst = toml::parse<toml::preserve_comments>(dst_iss, "base.toml");
+    toml::merge(dst, toml::parse<toml::preserve_comments>(src_iss, "override.toml"));
+
+    BOOST_TEST(toml::find<std::string>(dst, "title") == "service");
+    BOOST_TEST(toml::find<std::string>(dst, "server", "host") == "localhost");
+    BOOST_TEST(toml::find<std::string>(dst, "server", "tls", "cert") == "host.pem");
+
+    // the value in src wins with its comments and location
+    const auto& port = toml::find(dst, "server", "port");
+    BOOST_TEST(toml::get<int>(port) == 9090);
+    BOOST_TEST(port.comments().size() == 1u);
+    BOOST_TEST(port.comments().front() == " overridden");
+    BOOST_TEST(port.location().file_name() == "override.toml");
+
+    // a table in both keeps the comments and location of dst
+    const auto& server = toml::find(dst, "server");
+    BOOST_TEST(server.comments().size() == 1u);
+    BOOST_TEST(server.comments().front() == " the server");
+    BOOST_TEST(server.location().file_name() == "base.toml");
+
+    // arrays are replaced by default
+    BOOST_TEST(toml::find<std::vector<int>>(dst, "ports") == (std::vector<int>{9090}));
+    BOOST_TEST(toml::find(dst, "plugins").size() == 3u);
+
+    // a value that is not a table replaces a table
+    toml::merge(dst, value_type(value_type::table_type{{"server", "disabled"}}));
+    BOOST_TEST(toml::find<std::string>(dst, "server") == "disabled");
+    toml::merge(dst, value_type(42));
+    BOOST_TEST(dst == value_type(42));
+}
+
+BOOST_AUTO_TEST_CASE(test_merge_arrays)
+{
+    std::istringstream override_iss(override_str);
+    const auto src = toml::parse<toml::preserve_comments>(override_iss, "override.toml");
+    {
+        toml::merge_policy policy;
+        policy.arrays = toml::array_merge::append;
+
+        std::istringstream dst_iss(base_str);
+        auto dst = toml::parse<toml::preserve_comments>(dst_iss, "base.toml");
+        toml::merge(dst, src, policy);
+        BOOST_TEST(toml::find<std::vector<int>>(dst, "ports") ==
+                   (std::vector<int>{8080, 8081, 9090}));
+        BOOST_TEST(toml::find(dst, "plugins").size() == 5u);
+    }
+    {
+        toml::merge_policy policy;
+        policy.arrays    = toml::array_merge::merge_by_key;
+        policy.array_key = "name";
+
+        std::istringstream dst_iss(base_str);
+        auto dst = toml::parse<toml::preserve_comments>(dst_iss, "base.toml");
+        toml::merge(dst, src, policy);
+
+        // arrays of non-tables are appended
+        BOOST_TEST(toml::find<std::vector<int>>(dst, "ports") ==
+                   (std::vector<int>{8080, 8081, 9090}));
+
+        const auto& plugins = toml::find(dst, "plugins");
+        BOOST_TEST_REQUIRE(plugins.size() == 4u);
+        BOOST_TEST(toml::find<std::string>(plugins, 0, "name") == "auth");
+        BOOST_TEST(toml::find<bool>       (plugins, 0, "enabled") == false);
+        BOOST_TEST(toml::find<std::string>(plugins, 1, "name") == "cache");
+        BOOST_TEST(toml::find<int>        (plugins, 1, "size") == 200);
+        BOOST_TEST(toml::find<std::string>(plugins, 2, "name") == "metrics");
+        // a table without the key is appended
+        BOOST_TEST(!plugins.at(3).contains("name"));
+        BOOST_TEST(toml::find<bool>(plugins, 3, "enabled") == true);
+    }
+    {
+        // tables with the same key in src are merged into one
+        toml::merge_policy policy;
+        policy.arrays    = toml::array_merge::merge_by_key;
+        policy.array_key = "id";
+
+        std::istringstream dst_iss("a = [{id = 1, x = 1}]\n");
+        std::istringstream src_iss(
+            "a = [{id = 2, x = 2}, {id = 1, y = 1}, {id = 2, y = 2}]\n");
+        std::istringstream expected_iss(
+            "a = [{id = 1, x = 1, y = 1}, {id = 2, x = 2, y = 2}]\n");
+        auto dst = toml::parse<toml::preserve_comments>(dst_iss, "dst.toml");
+        toml::merge(dst, toml::parse<toml::preserve_comments>(src_iss, "src.toml"), policy);
+        BOOST_TEST(dst == toml::parse<toml::preserve_comments>(expected_iss, "expected.toml"));
+    }
+    {
+        // the comments on the keys are not compared
+        toml::merge_policy policy;
+        policy.arrays    = toml::array_merge::merge_by_key;
+        policy.array_key = "id";
+
+        std::istringstream dst_iss("[[a]]\nid = 1 # the first one\nx = 1\n");
+        std::istringstream src_iss("[[a]]\nid = 1\ny = 1\n");
+        auto dst = toml::parse<toml::preserve_comments>(dst_iss, "dst.toml");
+        toml::merge(dst, toml::parse<toml::preserve_comments>(src_iss, "src.toml"), policy);
+
+        const auto& a = toml::find(dst, "a");
+        BOOST_TEST_REQUIRE(a.size() == 1u);
+        BOOST_TEST(toml::find<int>(a, 0, "x") == 1);
+        BOOST_TEST(toml::find<int>(a, 0, "y") == 1);
+    }
+    {
+        // NaN keys match each other, as they do in diff
+        toml::merge_policy policy;
+        policy.arrays    = toml::array_merge::merge_by_key;
+        policy.array_key = "id";
+
+        std::istringstream dst_iss("a = [{id = nan, x = 1}, {id = [nan, 1.0], x = 2}]\n");
+        std::istringstream src_iss("a = [{id = -nan, y = 1}, {id = [nan, 1.0], y = 2}]\n");
+        auto dst = toml::parse<toml::preserve_comments>(dst_iss, "dst.toml");
+        toml::merge(dst, toml::parse<toml::preserve_comments>(src_iss, "src.toml"), policy);
+
+        const auto& a = toml::find(dst, "a");
+        BOOST_TEST_REQUIRE(a.size() == 2u);
+        BOOST_TEST(toml::find<int>(a, 0, "y") == 1);
+        BOOST_TEST(toml::find<int>(a, 1, "y") == 2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_merge_moves_subtrees)
+{
+    std::istringstream dst_iss(base_str);
+    std::istringstream src_iss(override_str);
+    auto dst = toml::parse<toml::preserve_comments>(dst_iss, "base.toml");
+    auto src = toml::parse<toml::preserve_comments>(src_iss, "override.toml");
+
+    const auto& csrc = src;
+    const auto* tls = std::addressof(toml::find(csrc, "server", "tls").as_table());
+
+    toml::merge(dst, std::move(src));
+
+    // the table is moved into dst, not copied
+    const auto& cdst = dst;
+    BOOST_TEST(std::addressof(toml::find(cdst, "server", "tls").as_table()) == tls);
+}
+
+BOOST_AUTO_TEST_CASE(test_merge_copy)
+{
+    std::istringstream dst_iss(base_str);
+    std::istringstream src_iss(override_str);
+    auto dst = toml::parse<toml::preserve_comments>(dst_iss, "base.toml");
+    const auto src = toml::parse<toml::preserve_comments>(src_iss, "override.toml");
+    const auto src_copy = src;
+
+    auto moved = dst;
+    toml::merge(dst, src);
+    toml::merge(moved, value_type(src));
+
+    BOOST_TEST(src == src_copy);
+    BOOST_TEST(dst == moved);
+}
+
+BOOST_AUTO_TEST_CASE(test_merge_ordered)
+{
+    std::istringstream dst_iss("b = 1\na = 2\n");
+    std::istringstream src_iss("c = 3\na = 4\n");
+    auto dst = toml::parse<toml::discard_comments, toml::ordered_table>(dst_iss, "dst.toml");
+    auto src = toml::parse<toml::discard_comments, toml::ordered_table>(src_iss, "src.toml");
+
+    toml::merge(dst, std::move(src));
+
+    // new keys are added after the existing keys
+    std::vector<std::string> keys;
+    for(const auto& kv : dst.as_table()) {keys.push_back(kv.first);}
+    BOOST_TEST(keys == (std::vector<std::string>{"b", "a", "c"}));
+    BOOST_TEST(toml::find<int>(dst, "a") == 4);
+}
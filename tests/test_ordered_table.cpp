@@ -0,0 +1,134 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <sstream>
+#include <string>
+
+BOOST_AUTO_TEST_CASE(test_ordered_table_container)
+{
+    toml::ordered_table<std::string, int> tab;
+    const std::vector<std::string> keys{"zeta", "alpha", "mu", "beta", "omega"};
+    for(std::size_t i=0; i<keys.size(); ++i)
+    {
+        tab[keys.at(i)] = static_cast<int>(i);
+    }
+    BOOST_TEST(tab.size() == keys.size());
+    BOOST_TEST(tab.at("mu") == 2);
+    BOOST_TEST(tab.count("nu") == 0u);
+
+    std::size_t i = 0;
+    for(const auto& kv : tab)
+    {
+        BOOST_TEST(kv.first == keys.at(i));
+        ++i;
+    }
+
+    // erase keeps the order of the rest
+    BOOST_TEST(tab.erase("alpha") == 1u);
+    const std::vector<std::string> expected{"zeta", "mu", "beta", "omega"};
+    i = 0;
+    for(const auto& kv : tab)
+    {
+        BOOST_TEST(kv.first == expected.at(i));
+        ++i;
+    }
+    BOOST_TEST(tab.at("omega") == 4);
+    BOOST_TEST(tab.count("alpha") == 0u);
+
+    // many elements
+    toml::ordered_table<std::string, int> large;
+    for(int j=0; j<1000; ++j)
+    {
+        large.emplace(std::to_string(999 - j), j);
+    }
+    for(int j=0; j<1000; ++j)
+    {
+        BOOST_TEST(large.at(std::to_string(999 - j)) == j);
+    }
+    BOOST_TEST(large.begin()->first == "999");
+}
+
+BOOST_AUTO_TEST_CASE(test_ordered_value_keeps_order)
+{
+    const std::string file(
+        "# comment for the file\n"
+        "\n"
+        "zeta = 1\n"
+        "alpha = 2\n"
+        "mu = \"three\"\n"
+        "\n"
+        "[server]\n"
+        "port = 8080\n"
+        "host = \"example.com\"\n"
+        "\n"
+        "[client]\n"
+        "timeout = 30\n"
+        "address = \"localhost\"\n"
+        );
+    std::istringstream iss(file);
+    const auto data = toml::parse<toml::preserve_comments, toml::ordered_table>(iss);
+
+    std::vector<std::string> keys;
+    for(const auto& kv : data.as_table())
+    {
+        keys.push_back(kv.first);
+    }
+    const std::vector<std::string> expected{"zeta", "alpha", "mu", "server", "client"};
+    BOOST_CHECK(keys == expected);
+
+    std::ostringstream oss;
+    oss << data;
+    const std::string serialized = oss.str();
+    BOOST_TEST(serialized.find("zeta")    < serialized.find("alpha"));
+    BOOST_TEST(serialized.find("alpha")   < serialized.find("mu"));
+    BOOST_TEST(serialized.find("[server]") < serialized.find("[client]"));
+    BOOST_TEST(serialized.find("port")    < serialized.find("host"));
+    BOOST_TEST(serialized.find("timeout") < serialized.find("address"));
+
+    // the result of serialization is stable
+    std::istringstream iss2(serialized);
+    const auto reparsed = toml::parse<toml::preserve_comments, toml::ordered_table>(iss2);
+    std::ostringstream oss2;
+    oss2 << reparsed;
+    BOOST_TEST(oss2.str() == serialized);
+}
+
+BOOST_AUTO_TEST_CASE(test_ordered_value)
+{
+    toml::ordered_value v(toml::ordered_value::table_type{});
+    v["b"] = 1;
+    v["a"] = 2;
+    BOOST_TEST(toml::format(v) == "b = 1\na = 2\n");
+}
+
+BOOST_AUTO_TEST_CASE(test_ordered_table_erase_many)
+{
+    toml::ordered_table<std::string, int> tab;
+    for(int i=0; i<1000; ++i)
+    {
+        tab.emplace(std::to_string(i), i);
+    }
+    for(int i=0; i<1000; i+=3)
+    {
+        BOOST_TEST(tab.erase(std::to_string(i)) == 1u);
+    }
+    BOOST_TEST(tab.size() == 666u);
+
+    // the order is kept and the shifted elements are still found
+    int prev = -1;
+    for(const auto& kv : tab)
+    {
+        BOOST_TEST(prev < kv.second);
+        BOOST_TEST(kv.second % 3 != 0);
+        prev = kv.second;
+    }
+    for(int i=0; i<1000; ++i)
+    {
+        BOOST_TEST(tab.count(std::to_string(i)) == (i % 3 == 0 ? 0u : 1u));
+        if(i % 3 != 0)
+        {
+            BOOST_TEST(tab.at(std::to_string(i)) == i);
+        }
+    }
+}
@@ -0,0 +1,235 @@
+#define TOML11_PACK_HOMOGENEOUS_ARRAYS
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <map>
+#include <sstream>
+
+namespace
+{
+template<typename Comment = toml::discard_comments>
+toml::basic_value<Comment> parse_string(const std::string& str)
+{
+    std::istringstream iss(str);
+    return toml::parse<Comment>(iss, "test_packed_array.toml");
+}
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_packed_homogeneous_arrays)
+{
+    const auto data = parse_string(
+        "ints   = [1, 2, 3, 4]\n"
+        "floats = [1.0, 2.5, -3.0]\n"
+        "bools  = [true, false, true]\n"
+        );
+
+    const auto& ints = toml::find(data, "ints");
+    BOOST_TEST(ints.is_array());
+    BOOST_TEST(ints.is_packed_array());
+    BOOST_TEST(ints.size() == 4u);
+    const auto ispan = ints.as_integer_span();
+    BOOST_TEST(ispan.size() == 4u);
+    BOOST_TEST(ispan[0] == 1);
+    BOOST_TEST(ispan[3] == 4);
+
+    const auto& floats = toml::find(data, "floats");
+    BOOST_TEST(floats.is_packed_array());
+    const auto fspan = floats.as_floating_span();
+    BOOST_TEST(fspan.size() == 3u);
+    BOOST_TEST(fspan[1] == 2.5);
+    BOOST_CHECK_THROW(floats.as_integer_span(), toml::type_error);
+
+    const auto& bools = toml::find(data, "bools");
+    BOOST_TEST(bools.is_packed_array());
+    const auto bspan = bools.as_boolean_span();
+    BOOST_TEST(bspan.size() == 3u);
+    BOOST_TEST(bspan[0] == true);
+    BOOST_TEST(bspan[1] == false);
+
+    BOOST_CHECK_THROW(toml::find(data, "ints").at(0).as_integer_span(), toml::type_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_array_transparent_access)
+{
+    const auto data = parse_string("xs = [1, 2, 3]\ngrid = [[1.0, 2.0], [3.0, 4.0]]\n");
+
+    const auto& xs = toml::find(data, "xs");
+    BOOST_TEST(xs.is_packed_array());
+    BOOST_TEST(toml::find<int>(data, "xs", 2) == 3);
+    BOOST_CHECK_THROW(toml::find<int>(data, "xs", 3), std::out_of_range);
+    BOOST_CHECK_THROW(toml::find<toml::floating>(data, "xs", 0), toml::type_error);
+
+    const std::vector<int> expected{1, 2, 3};
+    BOOST_CHECK(toml::find<std::vector<int>>(data, "xs") == expected);
+    BOOST_CHECK_THROW(toml::find<std::vector<double>>(data, "xs"), toml::type_error);
+    BOOST_TEST(xs.is_packed_array()); // reading elements does not unpack
+
+    // a reference to an element needs the unpacked array. It is unpacked in
+    // place, so the packed elements are released.
+    BOOST_TEST(xs.at(1).as_integer() == 2);
+    BOOST_TEST(!xs.is_packed_array());
+    BOOST_TEST(xs.size() == 3u);
+    BOOST_TEST(xs.as_array().size() == 3u);
+    BOOST_TEST(toml::find<int>(data, "xs", 2) == 3);
+    BOOST_CHECK(toml::find<std::vector<int>>(data, "xs") == expected);
+
+    const auto grid = toml::find<std::vector<std::vector<double>>>(data, "grid");
+    BOOST_TEST(grid.size() == 2u);
+    BOOST_TEST(grid.at(1).at(0) == 3.0);
+    BOOST_TEST(toml::find(data, "grid").at(0).is_packed_array());
+
+    // compares equal to a normal array
+    BOOST_CHECK(xs == toml::value(toml::array{1, 2, 3}));
+    BOOST_CHECK(xs != toml::value(toml::array{1, 2, 4}));
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_array_stays_packed)
+{
+    const auto data = parse_string(
+        "ints   = [1, 2, 3]\n"
+        "floats = [1.5, 2.5]\n"
+        "bools  = [true, false]\n"
+        );
+    const auto& ints   = toml::find(data, "ints");
+    const auto& floats = toml::find(data, "floats");
+    const auto& bools  = toml::find(data, "bools");
+    const auto before  = toml::memory_usage(data);
+
+    BOOST_TEST(toml::find<double>(data, "floats", 1) == 2.5);
+    BOOST_TEST(toml::find<bool>(data, "bools", 1) == false);
+    BOOST_TEST(toml::format(ints) == "[1,2,3]");
+    BOOST_TEST(toml::format(floats) == "[1.5,2.5]");
+    BOOST_TEST(toml::format(bools, 8) == "[\ntrue,\nfalse,\n]\n");
+    BOOST_TEST(toml::to_json(ints)   == "[1,2,3]");
+    BOOST_TEST(toml::to_json(floats) == "[1.5,2.5]");
+    BOOST_TEST(toml::to_json(bools)  == "[true,false]");
+
+    // copies and conversions keep the arrays packed
+    const auto frozen = toml::freeze(data);
+    BOOST_TEST(toml::find(frozen, "ints").is_packed_array());
+    BOOST_TEST(toml::find<int>(frozen, "ints", 0) == 1);
+    const toml::basic_value<toml::discard_comments, std::map> ordered(data);
+    BOOST_TEST(toml::find(ordered, "floats").is_packed_array());
+
+    BOOST_TEST(ints.is_packed_array());
+    BOOST_TEST(floats.is_packed_array());
+    BOOST_TEST(bools.is_packed_array());
+    BOOST_TEST(toml::memory_usage(data).total() == before.total());
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_array_comparison)
+{
+    const auto data = parse_string("ints = [1, 2, 3]\n");
+    const auto& ints = toml::find(data, "ints");
+    const auto span = ints.as_integer_span();
+
+    const toml::value unpacked(toml::array{1, 2, 3});
+    const toml::value other   (toml::array{1, 2, 4});
+    BOOST_TEST_REQUIRE(!unpacked.is_packed_array());
+
+    // comparing with an unpacked array does not unpack it
+    BOOST_CHECK(ints == unpacked);
+    BOOST_CHECK(unpacked == ints);
+    BOOST_CHECK(ints != other);
+    BOOST_CHECK(toml::detail::structurally_equal(ints, unpacked));
+    BOOST_CHECK(!toml::detail::structurally_equal(other, ints));
+    BOOST_TEST(ints.is_packed_array());
+    BOOST_TEST(span.data() == ints.as_integer_span().data());
+    BOOST_TEST(span[2] == 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_array_mutation)
+{
+    auto data = parse_string("xs = [1, 2, 3]\n");
+    const auto copied = data;
+
+    auto& xs = toml::find(data, "xs");
+    xs.push_back(4);
+    BOOST_TEST(!xs.is_packed_array());
+    BOOST_TEST(xs.size() == 4u);
+    BOOST_TEST(xs.at(3).as_integer() == 4);
+
+    // copies are independent
+    BOOST_TEST(toml::find(copied, "xs").is_packed_array());
+    BOOST_TEST(toml::find(copied, "xs").size() == 3u);
+}
+
+BOOST_AUTO_TEST_CASE(test_not_packed_arrays)
+{
+    const auto data = parse_string(
+        "mixed   = [1, 2, 3.0]\n"
+        "strings = [\"a\", \"b\"]\n"
+        "empty   = []\n"
+        );
+    BOOST_TEST(!toml::find(data, "mixed").is_packed_array());
+    BOOST_TEST(!toml::find(data, "strings").is_packed_array());
+    BOOST_TEST(!toml::find(data, "empty").is_packed_array());
+
+    // arrays that are not packed keep the regions of the elements
+    BOOST_TEST(toml::find(data, "mixed").at(0).location().line() == 1u);
+    BOOST_TEST(toml::find(data, "mixed").at(0).location().region() == 1u);
+
+    const auto commented = parse_string<toml::preserve_comments>(
+        "xs = [\n"
+        "  1, # one\n"
+        "  2,\n"
+        "]\n"
+        );
+    BOOST_TEST(!toml::find(commented, "xs").is_packed_array());
+    BOOST_TEST(toml::find(commented, "xs").at(0).comments().size() == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_array_serialization)
+{
+    const auto data = parse_string("xs = [1, 2, 3]\nys = [true, false]\n");
+    std::ostringstream oss;
+    oss << data;
+    const auto reparsed = parse_string(oss.str());
+    BOOST_CHECK(data == reparsed);
+    BOOST_CHECK(toml::find(reparsed, "xs") == toml::value(toml::array{1, 2, 3}));
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_array_binary)
+{
+    const auto data = parse_string("xs = [1, 2, 3]\nys = [1.5, 2.5]\nzs = [true, false]\n");
+    std::ostringstream oss;
+    toml::save_binary(data, oss);
+    std::istringstream iss(oss.str());
+    const auto loaded = toml::load_binary(iss);
+    BOOST_CHECK(data == loaded);
+    BOOST_TEST(toml::find(loaded, "xs").is_packed_array());
+    BOOST_TEST(toml::find(loaded, "ys").is_packed_array());
+    BOOST_TEST(toml::find(loaded, "zs").is_packed_array());
+    BOOST_TEST(toml::find(loaded, "xs").as_integer_span()[2] == 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_array_diff)
+{
+    const auto lhs = parse_string("a = [1, 2, 3, 4]\nb = [1.0, nan]\nc = [true]\n");
+    const auto rhs = parse_string("a = [1, 5]\nb = [1.0, nan, 2.0]\nc = [1]\n");
+    BOOST_TEST_REQUIRE(lhs.at("a").is_packed_array());
+    BOOST_TEST_REQUIRE(rhs.at("a").is_packed_array());
+
+    // packed arrays are compared element by element, as the other arrays
+    const auto d = toml::diff(lhs, rhs);
+    std::map<std::string, const toml::diff_entry<toml::value>*> entries;
+    for(const auto& e : d) {entries[e.path.str()] = std::addressof(e);}
+    BOOST_TEST(d.size() == 5u);
+    BOOST_TEST_REQUIRE(entries.size() == 5u);
+    BOOST_TEST_REQUIRE(entries.count("a[1]") == 1u);
+    BOOST_TEST(entries.at("a[1]")->kind == toml::diff_kind::replace);
+    BOOST_TEST(entries.at("a[1]")->value.as_integer() == 5);
+    BOOST_TEST(entries.count("a[2]") == 1u);
+    BOOST_TEST(entries.count("a[3]") == 1u);
+    BOOST_TEST_REQUIRE(entries.count("b[2]") == 1u);
+    BOOST_TEST(entries.at("b[2]")->kind == toml::diff_kind::add);
+    BOOST_TEST(entries.at("b[2]")->value.as_floating() == 2.0);
+    BOOST_TEST_REQUIRE(entries.count("c[0]") == 1u);
+    BOOST_TEST(entries.at("c[0]")->kind == toml::diff_kind::replace);
+
+    auto patched = lhs;
+    toml::apply_patch(patched, d);
+    BOOST_TEST(toml::find<std::vector<int>>(patched, "a") == (std::vector<int>{1, 5}));
+    BOOST_TEST(toml::find<std::vector<int>>(patched, "c") == (std::vector<int>{1}));
+}
@@ -0,0 +1,186 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(test_parse_cache_hit)
+{
+    const std::string fname("tmp_parse_cache_hit.toml");
+    {
+        std::ofstream ofs(fname, std::ios_base::binary);
+        ofs << "a = 42\n";
+    }
+
+    toml::parse_cache cache(4);
+    const auto first  = cache.parse(fname);
+    const auto second = cache.parse(fname);
+
+    BOOST_TEST(first.get() == second.get());
+    BOOST_TEST(toml::find<int>(*first, "a") == 42);
+    BOOST_TEST(cache.hits()   == 1u);
+    BOOST_TEST(cache.misses() == 1u);
+    BOOST_TEST(cache.size()   == 1u);
+    std::remove(fname.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_cache_modified)
+{
+    const std::string fname("tmp_parse_cache_modified.toml");
+    {
+        std::ofstream ofs(fname, std::ios_base::binary);
+        ofs << "a = 42\n";
+    }
+
+    toml::parse_cache cache(4);
+    const auto first = cache.parse(fname);
+
+    {
+        std::ofstream ofs(fname, std::ios_base::binary);
+        ofs << "a = 54321\n";
+    }
+    const auto second = cache.parse(fname);
+
+    BOOST_TEST(first.get() != second.get());
+    BOOST_TEST(toml::find<int>(*first,  "a") == 42); // still valid
+    BOOST_TEST(toml::find<int>(*second, "a") == 54321);
+    BOOST_TEST(cache.misses() == 2u);
+    BOOST_TEST(cache.size()   == 1u);
+    std::remove(fname.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_cache_check_content)
+{
+    const std::string fname("tmp_parse_cache_content.toml");
+    const std::string other("tmp_parse_cache_content_new.toml");
+    {
+        std::ofstream ofs(fname, std::ios_base::binary);
+        ofs << "a = 42\n";
+    }
+
+    toml::parse_cache cache(4, /*check_content = */ true);
+    const auto first = cache.parse(fname);
+
+    // replace it by another file (another inode) that has the same content
+    {
+        std::ofstream ofs(other, std::ios_base::binary);
+        ofs << "a = 42\n";
+    }
+    BOOST_TEST(std::rename(other.c_str(), fname.c_str()) == 0);
+
+    const auto second = cache.parse(fname);
+    BOOST_TEST(first.get() == second.get());
+    BOOST_TEST(cache.misses() == 2u);
+
+    {
+        std::ofstream ofs(fname, std::ios_base::binary);
+        ofs << "a = 54321\n";
+    }
+    const auto third = cache.parse(fname);
+    BOOST_TEST(first.get() != third.get());
+    BOOST_TEST(toml::find<int>(*third, "a") == 54321);
+    std::remove(fname.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_cache_eviction)
+{
+    const std::string f1("tmp_parse_cache_lru1.toml");
+    const std::string f2("tmp_parse_cache_lru2.toml");
+    const std::string f3("tmp_parse_cache_lru3.toml");
+    {
+        std::ofstream ofs(f1, std::ios_base::binary);
+        ofs << "a = 1\n";
+    }
+    {
+        std::ofstream ofs(f2, std::ios_base::binary);
+        ofs << "a = 2\n";
+    }
+    {
+        std::ofstream ofs(f3, std::ios_base::binary);
+        ofs << "a = 3\n";
+    }
+
+    toml::parse_cache cache(2);
+    BOOST_TEST(cache.capacity() == 2u);
+
+    cache.parse(f1);
+    cache.parse(f2);
+    cache.parse(f1); // f2 is the least recently used one
+    cache.parse(f3);
+    BOOST_TEST(cache.size()   == 2u);
+    BOOST_TEST(cache.hits()   == 1u);
+    BOOST_TEST(cache.misses() == 3u);
+
+    cache.parse(f1);
+    BOOST_TEST(cache.hits()   == 2u);
+    cache.parse(f2);
+    BOOST_TEST(cache.misses() == 4u);
+
+    cache.erase(f2);
+    BOOST_TEST(cache.size() == 1u);
+    cache.clear();
+    BOOST_TEST(cache.size() == 0u);
+
+    std::remove(f1.c_str());
+    std::remove(f2.c_str());
+    std::remove(f3.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_cache_error)
+{
+    const std::string fname("tmp_parse_cache_error.toml");
+    {
+        std::ofstream ofs(fname, std::ios_base::binary);
+        ofs << "a = \n";
+    }
+
+    toml::parse_cache cache(4);
+    BOOST_CHECK_THROW(cache.parse(fname), toml::syntax_error);
+    BOOST_TEST(cache.size() == 0u);
+    BOOST_CHECK_THROW(cache.parse(fname), toml::syntax_error);
+    BOOST_TEST(cache.misses() == 2u);
+
+    BOOST_CHECK_THROW(cache.parse("tmp_parse_cache_nonexistent.toml"),
+                      std::ios_base::failure);
+    BOOST_TEST(cache.size() == 0u);
+    std::remove(fname.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_cache_concurrent)
+{
+    const std::string fname("tmp_parse_cache_concurrent.toml");
+    {
+        std::string content;
+        for(std::size_t i=0; i<1000; ++i)
+        {
+            content += "key" + std::to_string(i) + " = " + std::to_string(i) + "\n";
+        }
+        {
+            std::ofstream ofs(fname, std::ios_base::binary);
+            ofs << content;
+        }
+    }
+
+    toml::parse_cache cache(4);
+    std::vector<toml::parse_cache::document_type> docs(8);
+    std::vector<std::thread> threads;
+    for(std::size_t i=0; i<docs.size(); ++i)
+    {
+        threads.emplace_back([&cache, &docs, &fname, i]() {
+            docs.at(i) = cache.parse(fname);
+        });
+    }
+    for(auto& t : threads) {t.join();}
+
+    BOOST_TEST(cache.misses() == 1u);
+    BOOST_TEST(cache.hits()   == docs.size() - 1);
+    for(const auto& doc : docs)
+    {
+        BOOST_TEST(doc.get() == docs.front().get());
+    }
+    BOOST_TEST(toml::find<int>(*docs.front(), "key999") == 999);
+    std::remove(fname.c_str());
+}
@@ -0,0 +1,205 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace into_test
+{
+struct endpoint
+{
+    std::string host;
+    int         port;
+};
+struct record
+{
+    std::int64_t id;
+    std::string  name;
+};
+struct config
+{
+    std::string           title;
+    endpoint              server;
+    std::vector<record>   records;
+    std::vector<int>      ports;
+};
+struct service
+{
+    endpoint                   primary;
+    std::map<std::string, int> limits;
+    std::vector<endpoint>      replicas;
+};
+} // into_test
+
+TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(into_test::endpoint, host, port)
+TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(into_test::record,   id, name)
+TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(into_test::config,   title, server, records, ports)
+TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(into_test::service,  primary, limits, replicas)
+
+namespace
+{
+struct name_collector
+{
+    template<typename Struct, typename Member>
+    void operator()(const char* name, Member Struct::*) const
+    {
+        names.push_back(name);
+    }
+    std::vector<std::string>& names;
+};
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_fields_for_each)
+{
+    std::vector<std::string> names;
+    toml::fields<into_test::config>::for_each(name_collector{names});
+    BOOST_TEST(names.size() == 4u);
+    BOOST_TEST(names.at(0) == "title");
+    BOOST_TEST(names.at(1) == "server");
+    BOOST_TEST(names.at(2) == "records");
+    BOOST_TEST(names.at(3) == "ports");
+}
+
+BOOST_AUTO_TEST_CASE(test_fields_projection)
+{
+    const auto proj = toml::fields_projection<into_test::config>();
+    BOOST_TEST(!proj.keeps_all());
+    BOOST_TEST( proj.includes({"title"}));
+    BOOST_TEST( proj.includes({"server", "host"}));
+    BOOST_TEST(!proj.includes({"server", "timeout"}));
+    BOOST_TEST( proj.includes({"records", "id"}));
+    BOOST_TEST(!proj.includes({"records", "payload"}));
+    BOOST_TEST( proj.includes({"ports"}));
+    BOOST_TEST(!proj.includes({"unused"}));
+
+    BOOST_TEST(toml::fields_projection<int>().keeps_all());
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_into)
+{
+    std::istringstream iss(
+        "title = \"example\"\n"
+        "ports = [80, 443]\n"
+        "unused = {a = [1, 2, 3], b = \"skipped\"}\n"
+        "[server]\n"
+        "host = \"localhost\"\n"
+        "port = 8080\n"
+        "timeout = 1.5\n"
+        "[[records]]\n"
+        "id = 1\n"
+        "name = \"foo\"\n"
+        "payload = [\"a\", \"b\"]\n"
+        "[[records]]\n"
+        "id = 2\n"
+        "name = \"bar\"\n"
+        "payload = [\"c\"]\n"
+        "[other]\n"
+        "x = 42\n"
+        );
+    const auto conf = toml::parse_into<into_test::config>(iss, "parse_into.toml");
+
+    BOOST_TEST(conf.title       == "example");
+    BOOST_TEST(conf.server.host == "localhost");
+    BOOST_TEST(conf.server.port == 8080);
+    BOOST_TEST(conf.records.size() == 2u);
+    BOOST_TEST(conf.records.at(0).id   == 1);
+    BOOST_TEST(conf.records.at(0).name == "foo");
+    BOOST_TEST(conf.records.at(1).id   == 2);
+    BOOST_TEST(conf.records.at(1).name == "bar");
+    BOOST_TEST((conf.ports == std::vector<int>{80, 443}));
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_into_layouts)
+{
+    // dotted keys, inline tables, and tables for members that are not structs
+    std::istringstream iss(
+        "primary.host = \"a\"\n"
+        "primary.port = 1\n"
+        "limits.cpu = 2\n"
+        "replicas = [{host = \"b\", port = 2}]\n"
+        "limits.memory = 4\n"
+        "limits.unused = {}\n"
+        );
+    // the last table cannot be converted into int
+    BOOST_CHECK_THROW(toml::parse_into<into_test::service>(iss, "service.toml"),
+                      toml::type_error);
+
+    std::istringstream iss2(
+        "primary.host = \"a\"\n"
+        "primary.port = 1\n"
+        "limits.cpu = 2\n"
+        "replicas = [{host = \"b\", port = 2}]\n"
+        "limits.memory = 4\n"
+        );
+    const auto s = toml::parse_into<into_test::service>(iss2, "service.toml");
+    BOOST_TEST(s.primary.host == "a");
+    BOOST_TEST(s.primary.port == 1);
+    BOOST_TEST(s.limits.size() == 2u);
+    BOOST_TEST(s.limits.at("cpu")    == 2);
+    BOOST_TEST(s.limits.at("memory") == 4);
+    BOOST_TEST(s.replicas.size() == 1u);
+    BOOST_TEST(s.replicas.at(0).host == "b");
+
+    // the same as converting the whole file
+    std::istringstream iss3(
+        "[primary]\nhost = \"a\"\nport = 1\n"
+        "[limits]\ncpu = 2\n"
+        "[[replicas]]\nhost = \"b\"\nport = 2\n"
+        "[[replicas]]\nhost = \"c\"\nport = 3\n");
+    const auto whole = toml::get<into_test::service>(toml::parse(iss3, "service.toml"));
+    iss3.clear();
+    iss3.seekg(0);
+    const auto s3 = toml::parse_into<into_test::service>(iss3, "service.toml");
+    BOOST_TEST(s3.primary.host == whole.primary.host);
+    BOOST_TEST((s3.limits == whole.limits));
+    BOOST_TEST(s3.replicas.size() == 2u);
+    BOOST_TEST(s3.replicas.at(1).host == whole.replicas.at(1).host);
+    BOOST_TEST(s3.replicas.at(1).port == whole.replicas.at(1).port);
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_into_errors)
+{
+    {
+        // a member is missing
+        std::istringstream iss("title = \"example\"\nports = []\n[server]\nhost = \"a\"\n");
+        BOOST_CHECK_THROW(toml::parse_into<into_test::config>(iss, "missing.toml"),
+                          std::out_of_range);
+    }
+    {
+        // a member of an element of an array is missing
+        std::istringstream iss("title = \"\"\nports = []\n[server]\nhost = \"a\"\nport = 1\n"
+                               "[[records]]\nid = 1\n");
+        BOOST_CHECK_THROW(toml::parse_into<into_test::config>(iss, "missing.toml"),
+                          std::out_of_range);
+    }
+    {
+        // a value of a wrong type
+        std::istringstream iss("[primary]\nhost = \"a\"\nport = \"80\"\n");
+        BOOST_CHECK_THROW(toml::parse_into<into_test::service>(iss, "type.toml"),
+                          toml::type_error);
+    }
+    {
+        // duplicate keys and tables
+        std::istringstream iss1("[primary]\nhost = \"a\"\nhost = \"b\"\n");
+        BOOST_CHECK_THROW(toml::parse_into<into_test::service>(iss1, "dup.toml"),
+                          toml::syntax_error);
+        std::istringstream iss2("[primary]\nhost = \"a\"\n[primary]\nport = 1\n");
+        BOOST_CHECK_THROW(toml::parse_into<into_test::service>(iss2, "dup.toml"),
+                          toml::syntax_error);
+        std::istringstream iss3("replicas = []\n[[replicas]]\nhost = \"a\"\n");
+        BOOST_CHECK_THROW(toml::parse_into<into_test::service>(iss3, "dup.toml"),
+                          toml::syntax_error);
+        // a table defined by dotted keys cannot be defined by [table]
+        std::istringstream iss4("primary.host = \"a\"\n[primary]\nport = 1\n");
+        BOOST_CHECK_THROW(toml::parse_into<into_test::service>(iss4, "dup.toml"),
+                          toml::syntax_error);
+    }
+    {
+        // the skipped part is still checked by the lexers
+        std::istringstream iss("unused = [1, 2\n");
+        BOOST_CHECK_THROW(toml::parse_into<into_test::config>(iss, "invalid.toml"),
+                          toml::syntax_error);
+    }
+}
@@ -0,0 +1,133 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+const std::string projection_source = R"(
+title = "monolithic config"
+limits.cpu = 4
+
+[server.http]
+host = "example.com"
+port = 8080
+routes = [ "/", "/api", { path = "/static", cache = true } ]
+
+[server.grpc]
+host = "grpc.example.com"
+deadline = 1979-05-27T07:32:00Z
+
+[limits.heap]
+memory = 1_000_000
+ratio  = 0.5
+
+[database]
+ports = [ 8001, 8001, 8002 ]
+nested = { a = [ [1, 2], ["a", 'b'] ], b = { c = 1987-07-05 } }
+
+[[plugins]]
+name = "a"
+
+[[plugins]]
+name = "b"
+)";
+} // anonymous
+
+BOOST_AUTO_TEST_CASE(test_projection_keeps_requested_subtrees)
+{
+    std::istringstream iss(projection_source);
+    const auto data = toml::parse(iss, "projection.toml",
+                                  toml::projection{"server.http", "limits"});
+
+    BOOST_TEST(data.contains("server"));
+    BOOST_TEST(data.contains("limits"));
+    BOOST_TEST(!data.contains("title"));
+    BOOST_TEST(!data.contains("database"));
+    BOOST_TEST(!data.contains("plugins"));
+
+    const auto& server = toml::find(data, "server");
+    BOOST_TEST(server.size() == 1u);
+    BOOST_TEST(toml::find<int>(server, "http", "port") == 8080);
+    BOOST_TEST(toml::find<std::string>(server, "http", "host") == "example.com");
+    BOOST_TEST(toml::find(server, "http", "routes").size() == 3u);
+
+    BOOST_TEST(toml::find<int>(data, "limits", "cpu") == 4);
+    BOOST_TEST(toml::find<int>(data, "limits", "heap", "memory") == 1000000);
+    BOOST_TEST(toml::find<double>(data, "limits", "heap", "ratio") == 0.5);
+}
+
+BOOST_AUTO_TEST_CASE(test_projection_array_of_tables)
+{
+    std::istringstream iss(projection_source);
+    const auto data = toml::parse(iss, "projection.toml",
+                                  toml::projection{"plugins.name"});
+
+    BOOST_TEST(data.size() == 1u);
+    const auto& plugins = toml::find(data, "plugins");
+    BOOST_TEST(plugins.size() == 2u);
+    BOOST_TEST(toml::find<std::string>(plugins.at(0), "name") == "a");
+    BOOST_TEST(toml::find<std::string>(plugins.at(1), "name") == "b");
+}
+
+BOOST_AUTO_TEST_CASE(test_projection_default_keeps_everything)
+{
+    std::istringstream iss1(projection_source);
+    std::istringstream iss2(projection_source);
+    const auto full = toml::parse(iss1, "projection.toml");
+    const auto proj = toml::parse(iss2, "projection.toml", toml::projection{});
+    BOOST_TEST(full == proj);
+}
+
+BOOST_AUTO_TEST_CASE(test_projection_still_checks_syntax)
+{
+    {
+        std::istringstream iss(std::string(
+            "[a]\n"
+            "x = 1\n"
+            "[b]\n"
+            "y = [1, 2\n"
+            ));
+        BOOST_CHECK_THROW(toml::parse(iss, "invalid.toml", toml::projection{"a"}),
+                          toml::syntax_error);
+    }
+    {
+        std::istringstream iss(std::string(
+            "[a]\n"
+            "x = 1\n"
+            "[b]\n"
+            "y = 1 2\n"
+            ));
+        BOOST_CHECK_THROW(toml::parse(iss, "invalid.toml", toml::projection{"a"}),
+                          toml::syntax_error);
+    }
+    {
+        std::istringstream iss(std::string(
+            "b = { c = 1, }\n"
+            "a = 1\n"
+            ));
+        BOOST_CHECK_THROW(toml::parse(iss, "invalid.toml", toml::projection{"a"}),
+                          toml::syntax_error);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_projection_invalid_path)
+{
+    BOOST_CHECK_THROW(toml::projection{"a..b"}, toml::syntax_error);
+    BOOST_CHECK_THROW(toml::projection{""},     toml::syntax_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_projection_parse_file)
+{
+    {
+        std::ofstream ofs("tmp_projection.toml");
+        ofs << projection_source;
+    }
+    const auto data = toml::parse("tmp_projection.toml",
+                                  toml::projection{"database.ports"});
+    BOOST_TEST(data.size() == 1u);
+    BOOST_TEST(toml::find(data, "database").size() == 1u);
+    BOOST_TEST(toml::find(data, "database", "ports").size() == 3u);
+}
@@ -0,0 +1,155 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <sstream>
+
+BOOST_AUTO_TEST_CASE(test_parse_with_recovery_ok)
+{
+    std::istringstream iss("a = 42\n[table]\nb = \"foo\"\n");
+    const auto res = toml::parse_with_recovery(iss, "ok.toml");
+    BOOST_TEST(res.is_ok());
+    BOOST_TEST(res.errors.empty());
+    BOOST_TEST(toml::find<int>(res.value, "a") == 42);
+    BOOST_TEST(toml::find<std::string>(res.value, "table", "b") == "foo");
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_with_recovery_reports_all_errors)
+{
+    std::istringstream iss(
+        "a = 1\n"          // 1
+        "b = \n"           // 2: missing value
+        "c = 3\n"          // 3
+        "d = 0x\n"         // 4: invalid integer
+        "[table]\n"        // 5
+        "e = 5\n"          // 6
+        "f = \"foo\n"      // 7: unterminated string
+        "g = 7\n"          // 8
+        "e = 8\n"          // 9: redefinition
+        );
+    const auto res = toml::parse_with_recovery(iss, "invalid.toml");
+    BOOST_TEST(!res.is_ok());
+    BOOST_TEST_REQUIRE(res.errors.size() == 4u);
+
+    BOOST_TEST(res.errors.at(0).line() == 2u);
+    BOOST_TEST(res.errors.at(1).line() == 4u);
+    BOOST_TEST(res.errors.at(2).line() == 7u);
+    BOOST_TEST(res.errors.at(3).line() == 9u);
+    for(const auto& e : res.errors)
+    {
+        BOOST_TEST(e.kind() == toml::error_kind::syntax_error);
+        BOOST_TEST(e.file_name() == "invalid.toml");
+    }
+
+    // the valid key-value pairs are kept
+    const auto& v = res.value;
+    BOOST_TEST(toml::find<int>(v, "a") == 1);
+    BOOST_TEST(toml::find<int>(v, "c") == 3);
+    BOOST_TEST(toml::find<int>(v, "table", "e") == 5);
+    BOOST_TEST(toml::find<int>(v, "table", "g") == 7);
+    BOOST_TEST(!v.contains("b"));
+    BOOST_TEST(!v.contains("d"));
+    BOOST_TEST(!toml::find(v, "table").contains("f"));
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_with_recovery_multiline_values)
+{
+    {
+        std::istringstream iss("a = [\n 1,\n 2x,\n 3,\n 4,\n]\nb = 1\n");
+        const auto res = toml::parse_with_recovery(iss, "invalid.toml");
+        BOOST_TEST_REQUIRE(res.errors.size() == 1u);
+        BOOST_TEST(res.errors.front().line() == 3u);
+        BOOST_TEST(toml::find<int>(res.value, "b") == 1);
+    }
+
+    // an error in a multi-line value is reported once
+    std::istringstream iss(
+        "a = [\n"           // 1
+        "  1,\n"            // 2
+        "  2x,\n"           // 3: invalid element
+        "  [3, \"]\"],\n"    // 4
+        "  4, # ]\n"        // 5
+        "]\n"               // 6
+        "b = 1\n"           // 7
+        "s = \"\"\"\n"       // 8
+        "x = 1\n"           // 9
+        "\"\"\" + 1\n"       // 10: trailing characters
+        "c = 2\n"           // 11
+        "d = [1, 2\n"       // 12: not closed
+        "e = 3\n"           // 13
+        "[table]\n"         // 14
+        "f = 4\n"           // 15
+        );
+    const auto res = toml::parse_with_recovery(iss, "invalid.toml");
+    BOOST_TEST_REQUIRE(res.errors.size() == 3u);
+    BOOST_TEST(res.errors.at(0).line() == 3u);
+    BOOST_TEST(res.errors.at(1).line() == 10u);
+    BOOST_TEST(res.errors.at(2).line() == 13u);
+
+    // a key-value pair cannot be an element, so it ends the array not closed
+    const auto& v = res.value;
+    BOOST_TEST(toml::find<int>(v, "b") == 1);
+    BOOST_TEST(toml::find<int>(v, "c") == 2);
+    BOOST_TEST(toml::find<int>(v, "e") == 3);
+    BOOST_TEST(toml::find<int>(v, "table", "f") == 4);
+    BOOST_TEST(!v.contains("a"));
+    BOOST_TEST(!v.contains("x"));
+    BOOST_TEST(!v.contains("d"));
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_with_recovery_same_message)
+{
+    // the first error is the same as the one thrown by toml::parse
+    const std::string content("a = 1\nb = \nc = 3\n");
+    std::string expected;
+    try
+    {
+        std::istringstream iss(content);
+        toml::parse(iss, "invalid.toml");
+        BOOST_ERROR("syntax_error is not thrown");
+    }
+    catch(const toml::syntax_error& e)
+    {
+        expected = e.what();
+    }
+
+    std::istringstream iss(content);
+    const auto res = toml::parse_with_recovery(iss, "invalid.toml");
+    BOOST_TEST_REQUIRE(res.errors.size() == 1u);
+    BOOST_TEST(res.errors.front().what() == expected);
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_with_recovery_table_redefinition)
+{
+    std::istringstream iss("[a]\nx = 1\n[a]\ny = 2\n[b]\nz = 3\n");
+    const auto res = toml::parse_with_recovery(iss, "redefinition.toml");
+    BOOST_TEST_REQUIRE(res.errors.size() == 1u);
+    BOOST_TEST(res.errors.front().line() == 3u);
+    BOOST_TEST(toml::find<int>(res.value, "a", "x") == 1);
+    BOOST_TEST(toml::find<int>(res.value, "b", "z") == 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_with_recovery_max_errors)
+{
+    std::ostringstream oss;
+    for(int i=0; i<10; ++i)
+    {
+        oss << "a" << i << " = \n";
+    }
+    oss << "last = 42\n";
+
+    std::istringstream iss(oss.str());
+    const auto res = toml::parse_with_recovery(iss, "many_errors.toml", 3);
+    BOOST_TEST_REQUIRE(res.errors.size() == 3u);
+    BOOST_TEST(res.errors.at(2).line() == 3u);
+    BOOST_TEST(!res.value.contains("last"));
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_with_recovery_file_io_error)
+{
+    const auto res = toml::parse_with_recovery("there_is_no_such_file.toml");
+    BOOST_TEST_REQUIRE(res.errors.size() == 1u);
+    BOOST_TEST(res.errors.front().kind() == toml::error_kind::file_io_error);
+    BOOST_TEST(res.value.is_table());
+    BOOST_TEST(res.value.as_table().empty());
+}
@@ -0,0 +1,74 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <sstream>
+
+BOOST_AUTO_TEST_CASE(test_try_parse_ok)
+{
+    std::istringstream iss("a = 42\n[table]\nb = \"foo\"\n");
+    const auto res = toml::try_parse(iss, "ok.toml");
+    BOOST_TEST_REQUIRE(res.is_ok());
+    BOOST_TEST(toml::find<int>(res.unwrap(), "a") == 42);
+    BOOST_TEST(toml::find<std::string>(res.unwrap(), "table", "b") == "foo");
+}
+
+BOOST_AUTO_TEST_CASE(test_try_parse_syntax_error)
+{
+    const std::string content("a = 42\nb = [1, 2\nc = 3\n");
+    std::string expected;
+    std::uint_least32_t expected_line = 0;
+    try
+    {
+        std::istringstream iss(content);
+        toml::parse(iss, "invalid.toml");
+        BOOST_ERROR("syntax_error is not thrown");
+    }
+    catch(const toml::syntax_error& e)
+    {
+        expected      = e.what();
+        expected_line = e.location().line();
+    }
+
+    std::istringstream iss(content);
+    const auto res = toml::try_parse(iss, "invalid.toml");
+    BOOST_TEST_REQUIRE(res.is_err());
+    const auto& e = res.unwrap_err();
+    BOOST_TEST(e.kind() == toml::error_kind::syntax_error);
+    BOOST_TEST(e.file_name() == "invalid.toml");
+    BOOST_TEST(e.line() == expected_line);
+    BOOST_TEST(e.what() == expected);
+    BOOST_TEST(7u <= e.offset());
+    BOOST_TEST(e.offset() < content.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_try_parse_redefinition)
+{
+    // detected while building a table
+    std::istringstream iss("a = 1\na = 2\n");
+    const auto res = toml::try_parse(iss, "redefinition.toml");
+    BOOST_TEST_REQUIRE(res.is_err());
+    BOOST_TEST(res.unwrap_err().kind() == toml::error_kind::syntax_error);
+    BOOST_TEST(res.unwrap_err().line() == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(test_try_parse_error_position)
+{
+    // the parser rolls back to the beginning of the line, but the error is
+    // after the `=`.
+    std::istringstream iss("a = 1\nb = \n");
+    const auto res = toml::try_parse(iss, "position.toml");
+    BOOST_TEST_REQUIRE(res.is_err());
+    const auto& e = res.unwrap_err();
+    BOOST_TEST(e.line()   == 2u);
+    BOOST_TEST(e.column() == 5u);
+    BOOST_TEST(e.offset() == 6u);
+}
+
+BOOST_AUTO_TEST_CASE(test_try_parse_file_io_error)
+{
+    const auto res = toml::try_parse("there_is_no_such_file.toml");
+    BOOST_TEST_REQUIRE(res.is_err());
+    BOOST_TEST(res.unwrap_err().kind() == toml::error_kind::file_io_error);
+    BOOST_TEST(res.unwrap_err().what().find("there_is_no_such_file.toml") != std::string::npos);
+}
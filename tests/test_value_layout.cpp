@@ -0,0 +1,60 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <sstream>
+
+// track the size of toml::value. Scalars are stored inline, strings, arrays,
+// and tables are boxed, and the region and comments are in a side node.
+#if !defined(TOML11_COPY_ON_WRITE)
+static_assert(sizeof(void*) != 8 || sizeof(toml::value) <= 32,
+              "sizeof(toml::value) is larger than expected");
+static_assert(sizeof(void*) != 8 ||
+              sizeof(toml::basic_value<toml::preserve_comments>) <= 32,
+              "sizeof(toml::basic_value<preserve_comments>) is larger than expected");
+#endif
+
+BOOST_AUTO_TEST_CASE(test_value_without_metadata)
+{
+    const toml::value v(42);
+    BOOST_TEST(v.comments().empty());
+    BOOST_TEST(v.location().file_name() == "unknown file");
+
+    const toml::basic_value<toml::preserve_comments> s("foo", {"comment"});
+    BOOST_TEST(s.comments().size() == 1u);
+    BOOST_TEST(s.comments().front() == "comment");
+    BOOST_TEST(s.location().file_name() == "unknown file");
+}
+
+BOOST_AUTO_TEST_CASE(test_copied_metadata_is_independent)
+{
+    std::istringstream iss("# a comment\na = \"foo\"\n");
+    const auto data = toml::parse<toml::preserve_comments>(iss, "layout.toml");
+
+    toml::basic_value<toml::preserve_comments> v = toml::find(data, "a");
+    const auto w = v;
+    BOOST_TEST(w.location().file_name() == "layout.toml");
+    BOOST_TEST(w.location().line() == 2u);
+
+    v.comments().push_back(" another");
+    BOOST_TEST(v.comments().size() == 2u);
+    BOOST_TEST(w.comments().size() == 1u);
+    BOOST_TEST(toml::find(data, "a").comments().size() == 1u);
+
+    // a reference obtained before copying does not modify the copy
+    auto& com = v.comments();
+    const auto x = v;
+    com.push_back(" yet another");
+    BOOST_TEST(v.comments().size() == 3u);
+    BOOST_TEST(x.comments().size() == 2u);
+
+    // assigning a scalar drops the region but keeps comments
+    v = 42;
+    BOOST_TEST(v.comments().size() == 3u);
+    BOOST_TEST(v.location().file_name() == "unknown file");
+
+    auto s = toml::find(data, "a");
+    s.as_string().str += "bar";
+    BOOST_TEST(s.as_string().str == "foobar");
+    BOOST_TEST(toml::find<std::string>(data, "a") == "foo");
+}
@@ -0,0 +1,114 @@
+#include <toml.hpp>
+
+#include "unit_test.hpp"
+
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace write_test
+{
+struct point
+{
+    double x;
+    double y;
+    bool operator==(const point& rhs) const {return x == rhs.x && y == rhs.y;}
+};
+struct endpoint
+{
+    std::string host;
+    int         port;
+    bool operator==(const endpoint& rhs) const {return host == rhs.host && port == rhs.port;}
+};
+struct record
+{
+    std::int64_t       id;
+    std::string        name;
+    std::vector<point> path;
+    endpoint           origin;
+    bool operator==(const record& rhs) const
+    {
+        return id == rhs.id && name == rhs.name && path == rhs.path && origin == rhs.origin;
+    }
+};
+struct snapshot
+{
+    std::string                     title;
+    bool                            enabled;
+    toml::local_date                date;
+    std::vector<std::vector<int>>   matrix;
+    std::map<std::string, int>      counts;
+    toml::value                     extra;
+    endpoint                        server;
+    std::map<std::string, endpoint> mirrors;
+    std::vector<record>             records;
+    std::vector<record>             archived;
+};
+} // write_test
+
+TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(write_test::point,    x, y)
+TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(write_test::endpoint, host, port)
+TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(write_test::record,   id, name, path, origin)
+TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(write_test::snapshot, title, enabled, date,
+        matrix, counts, extra, server, mirrors, records, archived)
+
+BOOST_AUTO_TEST_CASE(test_write_format)
+{
+    write_test::record rec;
+    rec.id     = 1;
+    rec.name   = "foo";
+    rec.path   = {{1.0, 2.5}};
+    rec.origin = {"localhost", 8080};
+
+    std::ostringstream oss;
+    toml::write(oss, rec);
+    BOOST_TEST(oss.str() ==
+        "id = 1\n"
+        "name = \"foo\"\n"
+        "\n"
+        "[[path]]\n"
+        "x = 1.0\n"
+        "y = 2.5\n"
+        "\n"
+        "[origin]\n"
+        "host = \"localhost\"\n"
+        "port = 8080\n");
+}
+
+BOOST_AUTO_TEST_CASE(test_write_round_trip)
+{
+    write_test::snapshot snap;
+    snap.title   = "snapshot \"1\"\nsecond line";
+    snap.enabled = true;
+    snap.date    = toml::local_date(2024, toml::month_t::Mar, 1);
+    snap.matrix  = {{1, 2}, {3}, {}};
+    snap.counts  = {{"a", 1}, {"b.c", 2}};
+    snap.extra   = toml::table{{"k", toml::array{1, "two"}}};
+    snap.server  = {"example.com", 443};
+    snap.mirrors = {{"eu", {"eu.example.com", 80}}, {"us", {"us.example.com", 81}}};
+    for(std::int64_t i=0; i<3; ++i)
+    {
+        write_test::record rec;
+        rec.id     = i;
+        rec.name   = "record-" + std::to_string(i);
+        rec.path   = {{0.5 * static_cast<double>(i), -1.0}, {1e-10, 1e+10}};
+        rec.origin = {"host-" + std::to_string(i), static_cast<int>(i)};
+        snap.records.push_back(rec);
+    }
+
+    std::stringstream ss;
+    toml::write(ss, snap);
+    const auto data = toml::parse(ss, "written.toml");
+
+    BOOST_TEST(toml::find<std::string>(data, "title") == snap.title);
+    BOOST_TEST(toml::find<bool>(data, "enabled") == true);
+    BOOST_TEST(toml::find<toml::local_date>(data, "date") == snap.date);
+    BOOST_TEST((toml::find<std::vector<std::vector<int>>>(data, "matrix") == snap.matrix));
+    BOOST_TEST((toml::find<std::map<std::string, int>>(data, "counts") == snap.counts));
+    BOOST_TEST(toml::find(data, "extra") == snap.extra);
+    BOOST_TEST((toml::find<write_test::endpoint>(data, "server") == snap.server));
+    BOOST_TEST((toml::find<write_test::endpoint>(data, "mirrors", "eu") == snap.mirrors.at("eu")));
+    BOOST_TEST((toml::find<write_test::endpoint>(data, "mirrors", "us") == snap.mirrors.at("us")));
+    BOOST_TEST((toml::find<std::vector<write_test::record>>(data, "records") == snap.records));
+    BOOST_TEST(toml::find(data, "archived").as_array().empty());
+}
@@ -34,5 +34,23 @@
 #include "toml/serializer.hpp"
 #include "toml/get.hpp"
 #include "toml/macros.hpp"
+#include "toml/flat_table.hpp"
+#include "toml/ordered_table.hpp"
+#include "toml/frozen_table.hpp"
+#include "toml/memory_usage.hpp"
+#include "toml/detach_source.hpp"
+#include "toml/key_path.hpp"
+#include "toml/parse_into.hpp"
+#include "toml/write.hpp"
+#include "toml/binary.hpp"
+#include "toml/mapped_document.hpp"
+#include "toml/parse_cache.hpp"
+#include "toml/config_handle.hpp"
+#include "toml/incremental.hpp"
+#include "toml/diff.hpp"
+#include "toml/hash.hpp"
+#include "toml/layered_view.hpp"
+#include "toml/merge.hpp"
+#include "toml/json.hpp"
 
 #endif// TOML_FOR_MODERN_CPP
@@ -0,0 +1,721 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_BINARY_HPP
+#define TOML11_BINARY_HPP
+#include <cstdint>
+#include <cstring>
+
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "detach_source.hpp"
+#include "exception.hpp"
+#include "parser.hpp"
+#include "value.hpp"
+
+namespace toml
+{
+
+// The options of toml::save_binary.
+struct binary_options
+{
+    bool comments  = true; // write comments
+    bool locations = true; // write the file name, line, and column of values
+};
+
+namespace detail
+{
+
+// The binary format is the following. All the numbers are little endian.
+//
+// | offset | size | content                                      |
+// |--------|------|----------------------------------------------|
+// |      0 |    8 | "TOML11BV"                                   |
+// |      8 |    4 | format version                               |
+// |     12 |    4 | flags (1: comments, 2: locations)            |
+// |     16 |    8 | size of the payload                          |
+// |     24 |    8 | FNV-1a hash of the payload                   |
+// |     32 |    - | payload (the root value)                     |
+//
+// Each value is written as the following.
+//
+// - type tag (1 byte). value_t, or packed_array_tag for packed arrays.
+// - comments, if the flag is set: the number of comments and the comments.
+// - location, if the flag is set: the file name index + 1 (0 if the value does
+//   not have a location), followed by the file name if it first appears,
+//   the line, the column, and the size.
+// - the content. integers and floatings are 8 bytes, sizes and counts are
+//   LEB128, and strings are the size followed by the bytes.
+struct binary_format
+{
+    static constexpr std::size_t   header_size      = 32;
+    static constexpr std::uint32_t version          = 1;
+    static constexpr std::uint32_t with_comments    = 1;
+    static constexpr std::uint32_t with_locations   = 2;
+    static constexpr std::uint8_t  packed_array_tag = 0x80;
+
+    static const char* magic() noexcept {return "TOML11BV";}
+
+    static std::uint64_t checksum(const char* first, const char* last) noexcept
+    {
+        return fnv1a(first, last);
+    }
+};
+
+template<typename Value>
+class binary_writer
+{
+  public:
+    using value_type = Value;
+
+    explicit binary_writer(const binary_options& opts): opts_(opts) {}
+
+    std::uint32_t flags() const noexcept
+    {
+        return (opts_.comments  ? binary_format::with_comments  : 0u) |
+               (opts_.locations ? binary_format::with_locations : 0u);
+    }
+
+    void write(const value_type& v)
+    {
+        const auto packed = get_packed_array(v);
+        if(packed && !packed->empty())
+        {
+            this->put_u8(static_cast<std::uint8_t>(
+                binary_format::packed_array_tag | static_cast<std::uint8_t>(packed->kind())));
+        }
+        else
+        {
+            this->put_u8(static_cast<std::uint8_t>(v.type()));
+        }
+        if(opts_.comments)
+        {
+            this->put_size(v.comments().size());
+            for(const auto& c : v.comments())
+            {
+                this->put_string(c);
+            }
+        }
+        if(opts_.locations)
+        {
+            this->write_location(v);
+        }
+
+        switch(v.type())
+        {
+            case value_t::boolean : {this->put_u8(v.as_boolean(std::nothrow) ? 1 : 0); break;}
+            case value_t::integer : {this->put_u64(static_cast<std::uint64_t>(v.as_integer(std::nothrow))); break;}
+            case value_t::floating: {this->put_floating(v.as_floating(std::nothrow)); break;}
+            case value_t::string  :
+            {
+                const auto& s = v.as_string(std::nothrow);
+                this->put_u8(static_cast<std::uint8_t>(s.kind));
+                this->put_string(s.str);
+                break;
+            }
+            case value_t::offset_datetime:
+            {
+                const auto& odt = v.as_offset_datetime(std::nothrow);
+                this->put_date(odt.date);
+                this->put_time(odt.time);
+                this->put_u8(static_cast<std::uint8_t>(odt.offset.hour));
+                this->put_u8(static_cast<std::uint8_t>(odt.offset.minute));
+                break;
+            }
+            case value_t::local_datetime:
+            {
+                const auto& ldt = v.as_local_datetime(std::nothrow);
+                this->put_date(ldt.date);
+                this->put_time(ldt.time);
+                break;
+            }
+            case value_t::local_date: {this->put_date(v.as_local_date(std::nothrow)); break;}
+            case value_t::local_time: {this->put_time(v.as_local_time(std::nothrow)); break;}
+            case value_t::array:
+            {
+                if(packed)
+                {
+                    this->write_packed(*packed);
+                    break;
+                }
+                const auto& ary = v.as_array(std::nothrow);
+                this->put_size(ary.size());
+                for(const auto& elem : ary)
+                {
+                    this->write(elem);
+                }
+                break;
+            }
+            case value_t::table:
+            {
+                const auto& tab = v.as_table(std::nothrow);
+                this->put_size(tab.size());
+                for(const auto& kv : tab)
+                {
+                    this->put_string(kv.first);
+                    this->write(kv.second);
+                }
+                break;
+            }
+            default: break;
+        }
+        return;
+    }
+
+    std::string const& buffer() const noexcept {return buf_;}
+
+  private:
+
+    void write_location(const value_type& v)
+    {
+        auto reg = get_metadata(v).shared_region();
+        if(const auto r = dynamic_cast<const region*>(reg.get()))
+        {
+            reg = detacher_.detached(*r);
+        }
+        const auto d = dynamic_cast<const detached_region*>(reg.get());
+        if(!d)
+        {
+            this->put_size(0);
+            return;
+        }
+        const auto found = names_.find(d->shared_name().get());
+        if(found != names_.end())
+        {
+            this->put_size(found->second + 1);
+        }
+        else
+        {
+            const auto idx = names_.size();
+            names_.emplace(d->shared_name().get(), idx);
+            this->put_size(idx + 1);
+            this->put_string(*d->shared_name());
+        }
+        this->put_size(d->line_number());
+        this->put_size(d->column_number());
+        this->put_size(d->size());
+        return;
+    }
+
+    void write_packed(const packed_array& packed)
+    {
+        this->put_size(packed.size());
+        switch(packed.kind())
+        {
+            case value_t::integer:
+            {
+                for(const auto x : packed.integers()) {this->put_u64(static_cast<std::uint64_t>(x));}
+                break;
+            }
+            case value_t::floating:
+            {
+                for(const auto x : packed.floatings()) {this->put_floating(x);}
+                break;
+            }
+            case value_t::boolean:
+            {
+                for(const auto x : packed.booleans()) {this->put_u8(x ? 1 : 0);}
+                break;
+            }
+            default: break;
+        }
+        return;
+    }
+
+    void put_date(const local_date& d)
+    {
+        this->put_u8(static_cast<std::uint8_t>(static_cast<std::uint16_t>(d.year) & 0xFFu));
+        this->put_u8(static_cast<std::uint8_t>(static_cast<std::uint16_t>(d.year) >> 8));
+        this->put_u8(d.month);
+        this->put_u8(d.day);
+    }
+    void put_time(const local_time& t)
+    {
+        this->put_u8(t.hour);
+        this->put_u8(t.minute);
+        this->put_u8(t.second);
+        this->put_size(t.millisecond);
+        this->put_size(t.microsecond);
+        this->put_size(t.nanosecond);
+    }
+
+    void put_u8(const std::uint8_t x)
+    {
+        buf_.push_back(static_cast<char>(x));
+    }
+    void put_u64(const std::uint64_t x)
+    {
+        for(std::size_t i=0; i<8; ++i)
+        {
+            this->put_u8(static_cast<std::uint8_t>((x >> (i * 8)) & 0xFFu));
+        }
+    }
+    void put_floating(const floating x)
+    {
+        static_assert(sizeof(floating) == sizeof(std::uint64_t),
+                      "toml::save_binary assumes 64-bit floating");
+        std::uint64_t bits;
+        std::memcpy(std::addressof(bits), std::addressof(x), sizeof(bits));
+        this->put_u64(bits);
+    }
+    void put_size(std::size_t x) // LEB128
+    {
+        while(0x80u <= x)
+        {
+            this->put_u8(static_cast<std::uint8_t>((x & 0x7Fu) | 0x80u));
+            x >>= 7;
+        }
+        this->put_u8(static_cast<std::uint8_t>(x));
+    }
+    void put_string(const std::string& s)
+    {
+        this->put_size(s.size());
+        buf_.append(s);
+    }
+
+  private:
+    binary_options  opts_;
+    std::string     buf_;
+    source_detacher detacher_;
+    std::unordered_map<const std::string*, std::size_t> names_;
+};
+
+template<typename Value>
+class binary_reader
+{
+  public:
+    using value_type   = Value;
+    using array_type   = typename value_type::array_type;
+    using table_type   = typename value_type::table_type;
+
+    binary_reader(const char* first, const char* last, const std::uint32_t flags)
+        : iter_(first), last_(last), flags_(flags)
+    {}
+
+    bool at_end() const noexcept {return iter_ == last_;}
+
+    value_type read(const std::size_t n_rec = 0)
+    {
+        if(n_rec > TOML11_VALUE_RECURSION_LIMIT)
+        {
+            this->broken("recursion limit ("
+                TOML11_STRINGIZE(TOML11_VALUE_RECURSION_LIMIT) ") exceeded");
+        }
+        const auto tag = this->get_u8();
+
+        std::vector<std::string> com;
+        if((flags_ & binary_format::with_comments) != 0)
+        {
+            const auto n = this->get_size();
+            for(std::size_t i=0; i<n; ++i)
+            {
+                com.push_back(this->get_string());
+            }
+        }
+        std::shared_ptr<region_base> reg;
+        if((flags_ & binary_format::with_locations) != 0)
+        {
+            reg = this->read_location();
+        }
+
+        value_type v = this->read_content(tag, std::move(com), n_rec);
+        if(reg)
+        {
+            change_region(v, std::move(reg));
+        }
+        return v;
+    }
+
+  private:
+
+    value_type read_content(const std::uint8_t tag, std::vector<std::string> com,
+                            const std::size_t n_rec)
+    {
+        if((tag & binary_format::packed_array_tag) != 0)
+        {
+            return this->read_packed(static_cast<value_t>(
+                        tag & ~binary_format::packed_array_tag), std::move(com));
+        }
+        switch(static_cast<value_t>(tag))
+        {
+            case value_t::empty   : {return value_type{};}
+            case value_t::boolean : {return value_type(this->get_u8() != 0, std::move(com));}
+            case value_t::integer : {return value_type(static_cast<integer>(this->get_u64()), std::move(com));}
+            case value_t::floating: {return value_type(this->get_floating(), std::move(com));}
+            case value_t::string  :
+            {
+                const auto kind = this->get_u8();
+                if(kind > static_cast<std::uint8_t>(string_t::literal))
+                {
+                    this->broken("invalid string kind");
+                }
+                auto str = this->get_string();
+                return value_type(std::move(str), static_cast<string_t>(kind), std::move(com));
+            }
+            case value_t::offset_datetime:
+            {
+                const auto d = this->get_date();
+                const auto t = this->get_time();
+                const auto h = static_cast<std::int8_t>(this->get_u8());
+                const auto m = static_cast<std::int8_t>(this->get_u8());
+                if(h < -23 || 23 < h || m < -59 || 59 < m)
+                {
+                    this->broken("invalid time offset");
+                }
+                return value_type(offset_datetime(d, t, time_offset(h, m)), std::move(com));
+            }
+            case value_t::local_datetime:
+            {
+                const auto d = this->get_date();
+                const auto t = this->get_time();
+                return value_type(local_datetime(d, t), std::move(com));
+            }
+            case value_t::local_date: {return value_type(this->get_date(), std::move(com));}
+            case value_t::local_time: {return value_type(this->get_time(), std::move(com));}
+            case value_t::array:
+            {
+                value_type v(array_type{}, std::move(com));
+                auto& ary = v.as_array(std::nothrow);
+                const auto n = this->get_count();
+                try_reserve(ary, n);
+                for(std::size_t i=0; i<n; ++i)
+                {
+                    ary.push_back(this->read(n_rec + 1));
+                }
+                return v;
+            }
+            case value_t::table:
+            {
+                value_type v(table_type{}, std::move(com));
+                auto& tab = v.as_table(std::nothrow);
+                const auto n = this->get_count();
+                for(std::size_t i=0; i<n; ++i)
+                {
+                    auto k = this->get_string();
+                    tab.insert(std::make_pair(std::move(k), this->read(n_rec + 1)));
+                }
+                return v;
+            }
+            default: break;
+        }
+        this->broken("invalid type tag");
+        return value_type{}; // unreachable
+    }
+
+    value_type read_packed(const value_t kind, std::vector<std::string> com)
+    {
+        packed_array packed;
+        const auto n = this->get_count();
+        for(std::size_t i=0; i<n; ++i)
+        {
+            bool pushed = false;
+            switch(kind)
+            {
+                case value_t::integer : {pushed = packed.push_back(static_cast<integer>(this->get_u64())); break;}
+                case value_t::floating: {pushed = packed.push_back(this->get_floating()); break;}
+                case value_t::boolean : {pushed = packed.push_back(this->get_u8() != 0);  break;}
+                default: break;
+            }
+            if(!pushed) {this->broken("invalid packed array");}
+        }
+        return value_type(std::move(packed), std::move(com));
+    }
+
+    std::shared_ptr<region_base> read_location()
+    {
+        const auto idx = this->get_size();
+        if(idx == 0)
+        {
+            return nullptr;
+        }
+        if(idx == names_.size() + 1)
+        {
+            names_.push_back(std::make_shared<const std::string>(this->get_string()));
+        }
+        else if(names_.size() < idx)
+        {
+            this->broken("invalid file name index");
+        }
+        const auto line   = this->get_u32();
+        const auto column = this->get_u32();
+        const auto size   = this->get_u32();
+        return std::make_shared<detached_region>(names_.at(idx - 1), line, column, size);
+    }
+
+    local_date get_date()
+    {
+        const auto lo = this->get_u8();
+        const auto hi = this->get_u8();
+        const auto y  = static_cast<std::int16_t>(static_cast<std::uint16_t>(lo | (hi << 8)));
+        const auto m  = this->get_u8();
+        const auto d  = this->get_u8();
+        if(11 < m || d < 1 || 31 < d)
+        {
+            this->broken("invalid date");
+        }
+        return local_date(y, static_cast<month_t>(m), d);
+    }
+    local_time get_time()
+    {
+        const auto h  = this->get_u8();
+        const auto m  = this->get_u8();
+        const auto s  = this->get_u8();
+        const auto ms = this->get_size();
+        const auto us = this->get_size();
+        const auto ns = this->get_size();
+        if(23 < h || 59 < m || 60 < s || 999 < ms || 999 < us || 999 < ns)
+        {
+            this->broken("invalid time");
+        }
+        return local_time(h, m, s, static_cast<int>(ms), static_cast<int>(us), static_cast<int>(ns));
+    }
+
+    std::uint8_t get_u8()
+    {
+        if(iter_ == last_) {this->broken("unexpected end of data");}
+        return static_cast<std::uint8_t>(*iter_++);
+    }
+    std::uint64_t get_u64()
+    {
+        std::uint64_t x = 0;
+        for(std::size_t i=0; i<8; ++i)
+        {
+            x |= static_cast<std::uint64_t>(this->get_u8()) << (i * 8);
+        }
+        return x;
+    }
+    floating get_floating()
+    {
+        const auto bits = this->get_u64();
+        floating x;
+        std::memcpy(std::addressof(x), std::addressof(bits), sizeof(x));
+        return x;
+    }
+    std::size_t get_size()
+    {
+        constexpr std::size_t digits = std::numeric_limits<std::size_t>::digits;
+        std::size_t x = 0;
+        for(std::size_t shift=0; shift < digits; shift += 7)
+        {
+            const auto b = this->get_u8();
+            x |= static_cast<std::size_t>(b & 0x7Fu) << shift;
+            if((b & 0x80u) == 0)
+            {
+                return x;
+            }
+        }
+        this->broken("too large size");
+        return 0; // unreachable
+    }
+    std::uint_least32_t get_u32()
+    {
+        const auto x = this->get_size();
+        if((std::numeric_limits<std::uint_least32_t>::max)() < x)
+        {
+            this->broken("too large position");
+        }
+        return static_cast<std::uint_least32_t>(x);
+    }
+    // the number of elements. each element takes at least 1 byte.
+    std::size_t get_count()
+    {
+        const auto n = this->get_size();
+        if(static_cast<std::size_t>(last_ - iter_) < n)
+        {
+            this->broken("unexpected end of data");
+        }
+        return n;
+    }
+    std::string get_string()
+    {
+        const auto n = this->get_size();
+        if(static_cast<std::size_t>(last_ - iter_) < n)
+        {
+            this->broken("unexpected end of data");
+        }
+        std::string s(iter_, iter_ + n);
+        iter_ += n;
+        return s;
+    }
+
+    [[noreturn]] void broken(const std::string& what) const
+    {
+        throw binary_error("toml::load_binary: broken data: " + what);
+    }
+
+  private:
+    const char*   iter_;
+    const char*   last_;
+    std::uint32_t flags_;
+    std::vector<detached_region::name_ptr> names_;
+};
+
+// writes the lower `n` bytes of `x` in little endian.
+inline void store_le(std::string& buf, const std::size_t pos,
+                     const std::uint64_t x, const std::size_t n)
+{
+    for(std::size_t i=0; i<n; ++i)
+    {
+        buf[pos + i] = static_cast<char>((x >> (i * 8)) & 0xFFu);
+    }
+}
+// reads `n` bytes in little endian. The result is truncated if T is smaller.
+template<typename T = std::uint64_t>
+T load_le(const char* p, const std::size_t n) noexcept
+{
+    T x = 0;
+    for(std::size_t i=0; i<n && i<sizeof(T); ++i)
+    {
+        x |= static_cast<T>(static_cast<std::uint8_t>(p[i])) << (i * 8);
+    }
+    return x;
+}
+
+} // detail
+
+// ---------------------------------------------------------------------------
+// save_binary / load_binary
+//
+// Write a value in a compact binary format, and read it without parsing TOML.
+// It is useful to cache a large file that rarely changes.
+//
+// The binary contains a format version and a checksum. load_binary throws
+// toml::binary_error if the data is broken or is written by another version.
+// Locations are restored as the file name, the line and the column, like
+// toml::detach_source. Packed arrays remain packed.
+//
+// ```cpp
+// const auto data = toml::parse("large.toml");
+// toml::save_binary(data, "large.toml.bin");
+// // later
+// const auto cached = toml::load_binary("large.toml.bin");
+// ```
+
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+void save_binary(const basic_value<C, T, A>& v, std::ostream& os,
+                 const binary_options& opts = binary_options{})
+{
+    using format = detail::binary_format;
+
+    detail::binary_writer<basic_value<C, T, A>> writer(opts);
+    writer.write(v);
+    const auto& payload = writer.buffer();
+
+    std::string header(format::header_size, '\0');
+    std::memcpy(&header[0], format::magic(), 8);
+    detail::store_le(header,  8, format::version, 4);
+    detail::store_le(header, 12, writer.flags(), 4);
+    detail::store_le(header, 16, payload.size(), 8);
+    detail::store_le(header, 24, format::checksum(
+                payload.data(), payload.data() + payload.size()), 8);
+
+    os.write(header.data(),  static_cast<std::streamsize>(header.size()));
+    os.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    return;
+}
+
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+void save_binary(const basic_value<C, T, A>& v, const std::string& fname,
+                 const binary_options& opts = binary_options{})
+{
+    std::ofstream ofs(fname, std::ios_base::binary);
+    if(!ofs.good())
+    {
+        throw std::ios_base::failure(
+                "toml::save_binary: Error opening file \"" + fname + "\"");
+    }
+    ofs.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    save_binary(v, ofs, opts);
+    return;
+}
+
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+basic_value<Comment, Table, Array>
+load_binary(const std::vector<char>& data)
+{
+    using format     = detail::binary_format;
+    using value_type = basic_value<Comment, Table, Array>;
+
+    if(data.size() < format::header_size ||
+       std::memcmp(data.data(), format::magic(), 8) != 0)
+    {
+        throw binary_error("toml::load_binary: not a toml11 binary");
+    }
+    const char* const head = data.data();
+    const auto version = detail::load_le(head +  8, 4);
+    const auto flags   = detail::load_le(head + 12, 4);
+    const auto size    = detail::load_le(head + 16, 8);
+    const auto hash    = detail::load_le(head + 24, 8);
+    if(version != format::version)
+    {
+        throw binary_error("toml::load_binary: unsupported version " +
+                           std::to_string(version));
+    }
+    if(size != data.size() - format::header_size)
+    {
+        throw binary_error("toml::load_binary: size mismatch");
+    }
+    const char* const first = head + format::header_size;
+    const char* const last  = head + data.size();
+    if(hash != format::checksum(first, last))
+    {
+        throw binary_error("toml::load_binary: checksum mismatch");
+    }
+
+    detail::binary_reader<value_type> reader(first, last,
+            static_cast<std::uint32_t>(flags));
+    auto v = reader.read();
+    if(!reader.at_end())
+    {
+        throw binary_error("toml::load_binary: broken data: trailing bytes");
+    }
+    return detail::finish_parse(std::move(v));
+}
+
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+basic_value<Comment, Table, Array> load_binary(std::istream& is)
+{
+    const auto beg = is.tellg();
+    is.seekg(0, std::ios::end);
+    const auto end = is.tellg();
+    is.seekg(beg);
+    if(beg == std::istream::pos_type(-1) || end == std::istream::pos_type(-1))
+    {
+        throw std::ios_base::failure("toml::load_binary: failed to read the stream");
+    }
+
+    std::vector<char> data(static_cast<std::size_t>(end - beg));
+    is.read(data.data(), end - beg);
+    if(!is || is.gcount() != end - beg)
+    {
+        throw std::ios_base::failure("toml::load_binary: failed to read the stream");
+    }
+    return load_binary<Comment, Table, Array>(data);
+}
+
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+basic_value<Comment, Table, Array> load_binary(const std::string& fname)
+{
+    std::ifstream ifs(fname, std::ios_base::binary);
+    if(!ifs.good())
+    {
+        throw std::ios_base::failure(
+                "toml::load_binary: Error opening file \"" + fname + "\"");
+    }
+    ifs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    return load_binary<Comment, Table, Array>(ifs);
+}
+
+} // toml
+#endif// TOML11_BINARY_HPP
@@ -0,0 +1,226 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_CONFIG_HANDLE_HPP
+#define TOML11_CONFIG_HANDLE_HPP
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "diff.hpp"
+#include "key_path.hpp"
+#include "parser.hpp"
+
+namespace toml
+{
+namespace detail
+{
+
+// std::atomic<std::shared_ptr<T>> if available. The free functions
+// std::atomic_load/store for shared_ptr are deprecated since C++20. Both of
+// them take a small internal lock in the major standard libraries.
+template<typename T>
+class atomic_shared_ptr
+{
+  public:
+
+    explicit atomic_shared_ptr(std::shared_ptr<T> p): ptr_(std::move(p)) {}
+    ~atomic_shared_ptr() = default;
+    atomic_shared_ptr(const atomic_shared_ptr&) = delete;
+    atomic_shared_ptr& operator=(const atomic_shared_ptr&) = delete;
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::shared_ptr<T> load() const noexcept
+    {
+        return ptr_.load(std::memory_order_acquire);
+    }
+    void store(std::shared_ptr<T> p) noexcept
+    {
+        ptr_.store(std::move(p), std::memory_order_release);
+    }
+  private:
+    std::atomic<std::shared_ptr<T>> ptr_;
+#else
+    std::shared_ptr<T> load() const noexcept
+    {
+        return std::atomic_load_explicit(&ptr_, std::memory_order_acquire);
+    }
+    void store(std::shared_ptr<T> p) noexcept
+    {
+        std::atomic_store_explicit(&ptr_, std::move(p), std::memory_order_release);
+    }
+  private:
+    std::shared_ptr<T> ptr_;
+#endif
+};
+
+// a unique id of a config handle. 0 is not used.
+inline std::uint64_t next_config_handle_id() noexcept
+{
+    static std::atomic<std::uint64_t> id(0);
+    return id.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+} // detail
+
+// A handle to a config file that can be reloaded while other threads read it.
+//
+// Readers take a snapshot, a shared pointer to an immutable document. Each
+// thread keeps the last snapshot it took and checks it against an atomic
+// generation counter, so a reader does not lock anything unless a new document
+// has been published. `reload()` parses the file outside of the readers' path
+// and publishes the new document atomically. A reader sees either the old or
+// the new document, and the old one is released when the last reader drops it
+// and every thread that read it takes a new snapshot or exits.
+//
+// ```cpp
+// toml::config_handle conf("service.toml");
+// conf.on_reload([](const toml::config_handle::snapshot_type& now,
+//                   const std::vector<toml::key_path>& changed) {...});
+//
+// // in a signal handling thread
+// conf.reload();
+//
+// // in worker threads
+// const auto snap = conf.snapshot();
+// const auto port = toml::find<int>(*snap, "server", "port");
+// ```
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+class basic_config_handle
+{
+  public:
+    using value_type    = basic_value<Comment, Table, Array>;
+    using snapshot_type = std::shared_ptr<const value_type>;
+    using callback_type = std::function<
+        void(const snapshot_type&, const std::vector<key_path>&)>;
+
+  public:
+
+    // parses the file. throws the same exceptions as toml::parse.
+    explicit basic_config_handle(std::string fname)
+        : fname_(std::move(fname)), id_(detail::next_config_handle_id()),
+          generation_(0), current_(std::make_shared<const value_type>(
+                ::toml::parse<Comment, Table, Array>(fname_)))
+    {}
+    // starts from the given document. reload() reads the file.
+    basic_config_handle(std::string fname, value_type v)
+        : fname_(std::move(fname)), id_(detail::next_config_handle_id()),
+          generation_(0), current_(std::make_shared<const value_type>(std::move(v)))
+    {}
+    ~basic_config_handle() = default;
+
+    basic_config_handle(const basic_config_handle&) = delete;
+    basic_config_handle& operator=(const basic_config_handle&) = delete;
+
+    // the current document. It does not change even if reloaded after this.
+    snapshot_type snapshot() const noexcept
+    {
+        // loading current_ takes a lock, so it is done only if the generation
+        // is changed. A thread that reads several handles alternately loads
+        // it each time.
+        thread_local snapshot_cache cache;
+        const auto gen = generation_.load(std::memory_order_acquire);
+        if(cache.owner != id_ || cache.generation != gen)
+        {
+            cache.snapshot   = current_.load();
+            cache.owner      = id_;
+            cache.generation = gen;
+        }
+        return cache.snapshot;
+    }
+
+    // incremented each time a new document is published.
+    std::uint64_t generation() const noexcept
+    {
+        return generation_.load(std::memory_order_acquire);
+    }
+
+    std::string const& file_name() const noexcept {return fname_;}
+
+    // parses the file again and publishes it if something is changed.
+    // It returns the paths to the changed values. If the file cannot be read
+    // or parsed, it throws and the current document is kept.
+    std::vector<key_path> reload()
+    {
+        return this->publish(::toml::parse<Comment, Table, Array>(fname_));
+    }
+
+    // publishes a document constructed by the caller, in the same way as reload.
+    std::vector<key_path> publish(value_type v)
+    {
+        auto next = std::make_shared<const value_type>(std::move(v));
+
+        std::vector<key_path> changed;
+        callback_type callback;
+        {
+            std::lock_guard<std::mutex> lock(writer_mtx_);
+            const auto prev = current_.load();
+
+            for(auto& d : ::toml::diff(*prev, *next))
+            {
+                changed.push_back(std::move(d.path));
+            }
+            if(changed.empty())
+            {
+                return changed;
+            }
+            std::sort(changed.begin(), changed.end(),
+                [](const key_path& lhs, const key_path& rhs) {
+                    return lhs.str() < rhs.str();
+                });
+
+            // a reader that sees the new generation also sees the new document.
+            current_.store(next);
+            generation_.fetch_add(1, std::memory_order_acq_rel);
+            callback = callback_;
+        }
+
+        if(callback)
+        {
+            callback(next, changed);
+        }
+        return changed;
+    }
+
+    // called after a new document is published, in the thread that published
+    // it. The lock for publishing is released before it is called, so the
+    // callback may call reload() or publish(). If documents are published from
+    // several threads, the callbacks may run concurrently, and `snapshot()`
+    // may already be newer than the document passed to the callback.
+    void on_reload(callback_type f)
+    {
+        std::lock_guard<std::mutex> lock(writer_mtx_);
+        callback_ = std::move(f);
+        return;
+    }
+
+  private:
+
+    struct snapshot_cache
+    {
+        std::uint64_t owner      = 0;
+        std::uint64_t generation = 0;
+        snapshot_type snapshot;
+    };
+
+  private:
+    std::string                                  fname_;
+    std::uint64_t                                id_;
+    std::atomic<std::uint64_t>                   generation_;
+    detail::atomic_shared_ptr<const value_type>  current_;
+    std::mutex                                   writer_mtx_;
+    callback_type                                callback_;
+};
+
+using config_handle = basic_config_handle<>;
+
+} // toml
+#endif// TOML11_CONFIG_HANDLE_HPP
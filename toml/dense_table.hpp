@@ -0,0 +1,455 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_DENSE_TABLE_HPP
+#define TOML11_DENSE_TABLE_HPP
+#include <cstdint>
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace toml
+{
+namespace detail
+{
+
+// An open-addressing hash index for a table that stores its elements in a
+// contiguous array. Each slot has an index of the element (+1, so 0 means an
+// empty slot) and a part of its hash value to skip most of the key comparisons.
+class open_addressing_index
+{
+  public:
+
+    open_addressing_index() = default;
+
+    bool is_active() const noexcept {return !slots_.empty();}
+
+    void clear() noexcept {slots_.clear();}
+
+    // allocate the slots for `n` elements. All the indices are removed.
+    void reset(const std::size_t n)
+    {
+        std::size_t cap = 16;
+        while(cap < n * 2) {cap *= 2;}
+        slots_.assign(cap, slot{0, 0});
+    }
+
+    // true if the index should be rebuilt before inserting the (n+1)-th elem.
+    bool needs_rehash(const std::size_t n) const noexcept
+    {
+        return slots_.size() < (n + 1) * 2;
+    }
+
+    void insert(const std::size_t hash, const std::size_t idx) noexcept
+    {
+        const std::size_t mask = slots_.size() - 1;
+        std::size_t pos = hash & mask;
+        while(slots_[pos].index != 0)
+        {
+            pos = (pos + 1) & mask;
+        }
+        slots_[pos].index = static_cast<std::uint32_t>(idx + 1);
+        slots_[pos].hash  = fragment(hash);
+    }
+
+    // removes the element `idx`. The following slots in the same cluster are
+    // moved back so that `find` does not stop at the empty slot. `hash_of(i)`
+    // returns the hash of the i-th element.
+    template<typename HashOf>
+    void erase(const std::size_t hash, const std::size_t idx, HashOf&& hash_of)
+    {
+        const std::size_t mask = slots_.size() - 1;
+        std::size_t hole = this->position_of(hash, idx);
+        slots_[hole] = slot{0, 0};
+
+        std::size_t pos = (hole + 1) & mask;
+        while(slots_[pos].index != 0)
+        {
+            // a slot can be moved to the hole unless its home position is
+            // in (hole, pos].
+            const std::size_t home = hash_of(slots_[pos].index - 1) & mask;
+            if(((pos - hole) & mask) <= ((pos - home) & mask))
+            {
+                slots_[hole] = slots_[pos];
+                slots_[pos]  = slot{0, 0};
+                hole = pos;
+            }
+            pos = (pos + 1) & mask;
+        }
+    }
+
+    // the element `from` is moved to `to`.
+    void relocate(const std::size_t hash, const std::size_t from, const std::size_t to) noexcept
+    {
+        slots_[this->position_of(hash, from)].index = static_cast<std::uint32_t>(to + 1);
+    }
+
+    // the elements after `idx` are shifted to the front by one.
+    void shift_after(const std::size_t idx) noexcept
+    {
+        for(auto& s : slots_)
+        {
+            if(idx + 1 < s.index) {s.index -= 1;}
+        }
+    }
+
+    // returns the index of the element for which `is_equal(idx)` is true.
+    // If not found, returns npos().
+    template<typename Predicate>
+    std::size_t find(const std::size_t hash, Predicate&& is_equal) const
+    {
+        const std::size_t   mask = slots_.size() - 1;
+        const std::uint32_t frag = fragment(hash);
+        std::size_t pos = hash & mask;
+        while(slots_[pos].index != 0)
+        {
+            const std::size_t idx = slots_[pos].index - 1;
+            if(slots_[pos].hash == frag && is_equal(idx))
+            {
+                return idx;
+            }
+            pos = (pos + 1) & mask;
+        }
+        return npos();
+    }
+
+    static constexpr std::size_t npos() noexcept
+    {
+        return static_cast<std::size_t>(-1);
+    }
+
+  private:
+
+    std::size_t position_of(const std::size_t hash, const std::size_t idx) const noexcept
+    {
+        const std::size_t mask = slots_.size() - 1;
+        std::size_t pos = hash & mask;
+        while(slots_[pos].index != idx + 1)
+        {
+            pos = (pos + 1) & mask;
+        }
+        return pos;
+    }
+
+    static std::uint32_t fragment(const std::size_t hash) noexcept
+    {
+        return static_cast<std::uint32_t>(
+            static_cast<std::uint64_t>(hash) >> 32 ^ static_cast<std::uint64_t>(hash));
+    }
+
+    struct slot
+    {
+        std::uint32_t index;
+        std::uint32_t hash;
+    };
+    std::vector<slot> slots_;
+};
+
+// A map that stores its elements in a contiguous array with a hash index.
+// `Policy` controls when to build the index and how to erase elements.
+// - Policy::linear_search_limit(): tables with at most this number of elements
+//   are searched linearly without the index.
+// - Policy::preserve_order(): if true, `erase` shifts the following elements.
+//   Otherwise, it moves the last element to the position of the erased one.
+template<typename Key, typename T, typename Hash, typename KeyEqual, typename Policy>
+class dense_table
+{
+  public:
+
+    using key_type        = Key;
+    using mapped_type     = T;
+    using value_type      = std::pair<Key, T>;
+    using hasher          = Hash;
+    using key_equal       = KeyEqual;
+    using container_type  = std::vector<value_type>;
+    using size_type       = typename container_type::size_type;
+    using difference_type = typename container_type::difference_type;
+    using reference       = value_type&;
+    using const_reference = value_type const&;
+    using iterator        = typename container_type::iterator;
+    using const_iterator  = typename container_type::const_iterator;
+
+  public:
+
+    dense_table() = default;
+    ~dense_table() = default;
+    dense_table(const dense_table&) = default;
+    dense_table(dense_table&&)      = default;
+    dense_table& operator=(const dense_table&) = default;
+    dense_table& operator=(dense_table&&)      = default;
+
+    template<typename InputIterator>
+    dense_table(InputIterator first, InputIterator last)
+    {
+        this->insert(first, last);
+    }
+    dense_table(std::initializer_list<value_type> init)
+    {
+        this->insert(init.begin(), init.end());
+    }
+    dense_table& operator=(std::initializer_list<value_type> init)
+    {
+        this->clear();
+        this->insert(init.begin(), init.end());
+        return *this;
+    }
+
+    iterator       begin()        noexcept {return elems_.begin();}
+    iterator       end()          noexcept {return elems_.end();}
+    const_iterator begin()  const noexcept {return elems_.begin();}
+    const_iterator end()    const noexcept {return elems_.end();}
+    const_iterator cbegin() const noexcept {return elems_.cbegin();}
+    const_iterator cend()   const noexcept {return elems_.cend();}
+
+    bool      empty()    const noexcept {return elems_.empty();}
+    size_type size()     const noexcept {return elems_.size();}
+    size_type max_size() const noexcept {return elems_.max_size();}
+
+    void clear() noexcept
+    {
+        elems_.clear();
+        index_.clear();
+    }
+    void reserve(const size_type n)
+    {
+        elems_.reserve(n);
+        if(Policy::linear_search_limit() < n && index_.needs_rehash(n))
+        {
+            this->rehash(n);
+        }
+    }
+
+    // -----------------------------------------------------------------------
+    // lookup
+
+    iterator find(const key_type& k)
+    {
+        return elems_.begin() + static_cast<difference_type>(this->find_index(k));
+    }
+    const_iterator find(const key_type& k) const
+    {
+        return elems_.begin() + static_cast<difference_type>(this->find_index(k));
+    }
+    size_type count(const key_type& k) const
+    {
+        return this->find_index(k) == elems_.size() ? 0 : 1;
+    }
+    bool contains(const key_type& k) const
+    {
+        return this->find_index(k) != elems_.size();
+    }
+
+    mapped_type& at(const key_type& k)
+    {
+        const auto idx = this->find_index(k);
+        if(idx == elems_.size())
+        {
+            throw std::out_of_range("toml::detail::dense_table::at: key not found");
+        }
+        return elems_[idx].second;
+    }
+    mapped_type const& at(const key_type& k) const
+    {
+        const auto idx = this->find_index(k);
+        if(idx == elems_.size())
+        {
+            throw std::out_of_range("toml::detail::dense_table::at: key not found");
+        }
+        return elems_[idx].second;
+    }
+
+    mapped_type& operator[](const key_type& k)
+    {
+        return this->try_emplace_impl(k).first->second;
+    }
+    mapped_type& operator[](key_type&& k)
+    {
+        return this->try_emplace_impl(std::move(k)).first->second;
+    }
+
+    // -----------------------------------------------------------------------
+    // modifiers
+
+    std::pair<iterator, bool> insert(const value_type& kv)
+    {
+        const auto idx = this->find_index(kv.first);
+        if(idx != elems_.size())
+        {
+            return std::make_pair(elems_.begin() + static_cast<difference_type>(idx), false);
+        }
+        return std::make_pair(this->append(kv), true);
+    }
+    std::pair<iterator, bool> insert(value_type&& kv)
+    {
+        const auto idx = this->find_index(kv.first);
+        if(idx != elems_.size())
+        {
+            return std::make_pair(elems_.begin() + static_cast<difference_type>(idx), false);
+        }
+        return std::make_pair(this->append(std::move(kv)), true);
+    }
+    template<typename P, typename std::enable_if<
+        std::is_constructible<value_type, P&&>::value, std::nullptr_t>::type = nullptr>
+    std::pair<iterator, bool> insert(P&& kv)
+    {
+        return this->insert(value_type(std::forward<P>(kv)));
+    }
+    template<typename InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+        for(; first != last; ++first)
+        {
+            this->insert(value_type(*first));
+        }
+    }
+
+    template<typename ... Args>
+    std::pair<iterator, bool> emplace(Args&& ... args)
+    {
+        return this->insert(value_type(std::forward<Args>(args)...));
+    }
+
+    size_type erase(const key_type& k)
+    {
+        const auto idx = this->find_index(k);
+        if(idx == elems_.size()) {return 0;}
+        this->erase_at(idx);
+        return 1;
+    }
+    iterator erase(const_iterator pos)
+    {
+        const auto idx = static_cast<size_type>(pos - elems_.cbegin());
+        this->erase_at(idx);
+        return elems_.begin() + static_cast<difference_type>(idx);
+    }
+
+    void swap(dense_table& other) noexcept
+    {
+        using std::swap;
+        swap(elems_, other.elems_);
+        swap(index_, other.index_);
+    }
+
+    hasher    hash_function() const {return hasher{};}
+    key_equal key_eq()        const {return key_equal{};}
+
+  private:
+
+    size_type find_index(const key_type& k) const
+    {
+        if(!index_.is_active())
+        {
+            for(size_type i=0; i<elems_.size(); ++i)
+            {
+                if(key_equal{}(elems_[i].first, k)) {return i;}
+            }
+            return elems_.size();
+        }
+        const auto idx = index_.find(hasher{}(k),
+            [this, &k](const std::size_t i) {
+                return key_equal{}(this->elems_[i].first, k);
+            });
+        return idx == open_addressing_index::npos() ? elems_.size() : idx;
+    }
+
+    template<typename K>
+    std::pair<iterator, bool> try_emplace_impl(K&& k)
+    {
+        const auto idx = this->find_index(k);
+        if(idx != elems_.size())
+        {
+            return std::make_pair(elems_.begin() + static_cast<difference_type>(idx), false);
+        }
+        return std::make_pair(this->append(value_type(std::forward<K>(k), mapped_type{})), true);
+    }
+
+    template<typename V>
+    iterator append(V&& kv)
+    {
+        const size_type n = elems_.size();
+        if(index_.is_active() || Policy::linear_search_limit() <= n)
+        {
+            if(index_.needs_rehash(n))
+            {
+                this->rehash(n + 1);
+            }
+            index_.insert(hasher{}(kv.first), n);
+        }
+        elems_.push_back(std::forward<V>(kv));
+        return elems_.begin() + static_cast<difference_type>(n);
+    }
+
+    void erase_at(const size_type idx)
+    {
+        const size_type last = elems_.size() - 1;
+        if(index_.is_active())
+        {
+            index_.erase(hasher{}(elems_[idx].first), idx,
+                [this](const std::size_t i) {return hasher{}(this->elems_[i].first);});
+            if(Policy::preserve_order())
+            {
+                index_.shift_after(idx);
+            }
+            else if(idx != last)
+            {
+                index_.relocate(hasher{}(elems_[last].first), last, idx);
+            }
+        }
+
+        if(Policy::preserve_order())
+        {
+            elems_.erase(elems_.begin() + static_cast<difference_type>(idx));
+        }
+        else
+        {
+            if(idx != last)
+            {
+                elems_[idx] = std::move(elems_.back());
+            }
+            elems_.pop_back();
+        }
+    }
+
+    void rehash(const size_type n)
+    {
+        index_.reset(n);
+        for(size_type i=0; i<elems_.size(); ++i)
+        {
+            index_.insert(hasher{}(elems_[i].first), i);
+        }
+    }
+
+  private:
+    container_type                elems_;
+    open_addressing_index index_;
+};
+
+template<typename K, typename T, typename H, typename E, typename P>
+bool operator==(const dense_table<K, T, H, E, P>& lhs, const dense_table<K, T, H, E, P>& rhs)
+{
+    if(lhs.size() != rhs.size()) {return false;}
+    for(const auto& kv : lhs)
+    {
+        const auto found = rhs.find(kv.first);
+        if(found == rhs.end() || !(found->second == kv.second)) {return false;}
+    }
+    return true;
+}
+template<typename K, typename T, typename H, typename E, typename P>
+bool operator!=(const dense_table<K, T, H, E, P>& lhs, const dense_table<K, T, H, E, P>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template<typename K, typename T, typename H, typename E, typename P>
+void swap(dense_table<K, T, H, E, P>& lhs, dense_table<K, T, H, E, P>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // detail
+} // toml
+#endif// TOML11_DENSE_TABLE_HPP
@@ -0,0 +1,130 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_DETACH_SOURCE_HPP
+#define TOML11_DETACH_SOURCE_HPP
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "region.hpp"
+#include "value.hpp"
+
+namespace toml
+{
+namespace detail
+{
+
+class source_detacher
+{
+  public:
+
+    template<typename Value>
+    void detach(Value& v)
+    {
+        const auto reg = get_metadata(v).shared_region();
+        if(reg)
+        {
+            if(const auto r = dynamic_cast<const region*>(reg.get()))
+            {
+                change_region(v, this->detached(*r));
+            }
+        }
+
+        if(v.is_table())
+        {
+            for(auto& kv : v.as_table(std::nothrow))
+            {
+                this->detach(kv.second);
+            }
+        }
+        else if(v.is_array() && !v.is_packed_array())
+        {
+            // elements of a packed array do not have regions.
+            for(auto& elem : v.as_array(std::nothrow))
+            {
+                this->detach(elem);
+            }
+        }
+        return;
+    }
+
+    // returns a detached_region that points the same position as `r`.
+    std::shared_ptr<region_base> detached(const region& r)
+    {
+        // the same region object might be shared by copies of a value.
+        auto& d = regions_[std::addressof(r)];
+        if(d) {return d;}
+
+        const auto& info = this->info_of(r);
+        const auto offset = static_cast<std::size_t>(std::distance(r.begin(), r.first()));
+
+        // the number of newlines before the region
+        const auto nl = std::lower_bound(info.newlines.begin(), info.newlines.end(), offset);
+        const auto line = static_cast<std::size_t>(std::distance(info.newlines.begin(), nl)) + 1;
+        const auto line_begin = (nl == info.newlines.begin()) ? 0 : *std::prev(nl) + 1;
+
+        d = std::make_shared<detached_region>(info.name,
+                static_cast<std::uint_least32_t>(line),
+                static_cast<std::uint_least32_t>(offset - line_begin + 1),
+                static_cast<std::uint_least32_t>(r.size()));
+        return d;
+    }
+
+  private:
+
+    struct source_info
+    {
+        detached_region::name_ptr name;
+        std::vector<std::size_t>  newlines; // offsets of '\n'
+    };
+
+    source_info const& info_of(const region& r)
+    {
+        auto& info = sources_[r.source().get()];
+        if(!info.name)
+        {
+            info.name = std::make_shared<const std::string>(r.name());
+            std::size_t offset = 0;
+            for(auto iter = r.begin(); iter != r.end(); ++iter, ++offset)
+            {
+                if(*iter == '\n') {info.newlines.push_back(offset);}
+            }
+        }
+        return info;
+    }
+
+    std::unordered_map<const void*, source_info>                  sources_;
+    std::unordered_map<const void*, std::shared_ptr<region_base>> regions_;
+};
+
+} // detail
+
+// Replace the location information of a value and its elements with a compact
+// one that does not refer to the file content. After that, the file content is
+// released when no other value refers to it.
+//
+// Error messages still show the file name, the line number and the column, but
+// not the content of the line.
+//
+// With TOML11_COPY_ON_WRITE, the tables and arrays in `v` are shared with
+// copies again after this call, so non-const references to the contents of
+// `v` taken before it should not be used to modify them.
+//
+// ```cpp
+// auto data = toml::parse("large.toml");
+// toml::detach_source(data);
+// ```
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+void detach_source(basic_value<C, T, A>& v)
+{
+    detail::source_detacher detacher;
+    detacher.detach(v);
+#ifdef TOML11_COPY_ON_WRITE
+    // `detach` took non-const references, which stopped sharing.
+    detail::enable_sharing(v);
+#endif
+    return;
+}
+
+} // toml
+#endif// TOML11_DETACH_SOURCE_HPP
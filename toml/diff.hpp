@@ -0,0 +1,343 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_DIFF_HPP
+#define TOML11_DIFF_HPP
+#include <cstdint>
+
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+#include "hash.hpp"
+#include "key_path.hpp"
+#include "value.hpp"
+
+namespace toml
+{
+
+enum class diff_kind : std::uint8_t
+{
+    add     = 0, // the value is added
+    remove  = 1, // the value is removed
+    replace = 2  // the value is changed
+};
+
+inline std::ostream& operator<<(std::ostream& os, const diff_kind k)
+{
+    switch(k)
+    {
+        case diff_kind::add    : {os << "add";     break;}
+        case diff_kind::remove : {os << "remove";  break;}
+        case diff_kind::replace: {os << "replace"; break;}
+        default                : {os << "unknown"; break;}
+    }
+    return os;
+}
+
+// An operation found by `toml::diff`.
+//
+// - diff_kind kind
+// - key_path  path
+//   - the path to the value in the documents.
+// - Value     value
+//   - the new value. It is empty if the value is removed.
+template<typename Value>
+struct diff_entry
+{
+    diff_kind kind;
+    key_path  path;
+    Value     value;
+};
+
+namespace detail
+{
+
+template<typename Value>
+class differ
+{
+  public:
+    using entry_type = diff_entry<Value>;
+
+    void compare(const Value& lhs, const Value& rhs)
+    {
+        if(lhs.type() != rhs.type())
+        {
+            this->push(diff_kind::replace, rhs);
+            return;
+        }
+        switch(lhs.type())
+        {
+            case value_t::table:
+            {
+                this->compare_tables(lhs, rhs);
+                return;
+            }
+            case value_t::array:
+            {
+                this->compare_arrays(lhs, rhs);
+                return;
+            }
+            default:
+            {
+                // NaN is not regarded as a change (see detail::leaf_equal).
+                if(detail::leaf_equal(lhs, rhs)) {return;}
+                break;
+            }
+        }
+        this->push(diff_kind::replace, rhs);
+        return;
+    }
+
+    std::vector<entry_type>&& entries() && noexcept {return std::move(entries_);}
+
+  private:
+
+    void compare_tables(const Value& lhs, const Value& rhs)
+    {
+        const auto& ltab = lhs.as_table(std::nothrow);
+        const auto& rtab = rhs.as_table(std::nothrow);
+        if(std::addressof(ltab) == std::addressof(rtab))
+        {
+            return; // copies that share the content (TOML11_COPY_ON_WRITE)
+        }
+        for(const auto& kv : ltab)
+        {
+            path_.push_back(kv.first);
+            if(const auto found = detail::find_mapped(rtab, kv.first))
+            {
+                this->compare(kv.second, *found);
+            }
+            else
+            {
+                this->push(diff_kind::remove, Value{});
+            }
+            path_.pop_back();
+        }
+        for(const auto& kv : rtab)
+        {
+            if(!detail::find_mapped(ltab, kv.first))
+            {
+                path_.push_back(kv.first);
+                this->push(diff_kind::add, kv.second);
+                path_.pop_back();
+            }
+        }
+        return;
+    }
+
+    void compare_arrays(const Value& lhs, const Value& rhs)
+    {
+        const auto lp = detail::get_packed_array(lhs);
+        const auto rp = detail::get_packed_array(rhs);
+        if(lp && rp)
+        {
+            this->compare_packed_arrays(*lp, *rp);
+            return;
+        }
+
+        const auto& lary = lhs.as_array(std::nothrow);
+        const auto& rary = rhs.as_array(std::nothrow);
+        if(std::addressof(lary) == std::addressof(rary))
+        {
+            return;
+        }
+        const std::size_t common = (std::min)(lary.size(), rary.size());
+        for(std::size_t i=0; i<common; ++i)
+        {
+            path_.push_back(i);
+            this->compare(lary[i], rary[i]);
+            path_.pop_back();
+        }
+        // remove from the back so that the indices are valid in apply_patch.
+        for(std::size_t i=lary.size(); common < i; --i)
+        {
+            path_.push_back(i - 1);
+            this->push(diff_kind::remove, Value{});
+            path_.pop_back();
+        }
+        for(std::size_t i=common; i<rary.size(); ++i)
+        {
+            path_.push_back(i);
+            this->push(diff_kind::add, rary[i]);
+            path_.pop_back();
+        }
+        return;
+    }
+
+    // the same as compare_arrays, without unpacking the arrays.
+    void compare_packed_arrays(const packed_array& lhs, const packed_array& rhs)
+    {
+        const std::size_t common = (std::min)(lhs.size(), rhs.size());
+        for(std::size_t i=0; i<common; ++i)
+        {
+            if(!detail::packed_element_equal(lhs, rhs, i))
+            {
+                path_.push_back(i);
+                this->push(diff_kind::replace, packed_element(rhs, i));
+                path_.pop_back();
+            }
+        }
+        for(std::size_t i=lhs.size(); common < i; --i)
+        {
+            path_.push_back(i - 1);
+            this->push(diff_kind::remove, Value{});
+            path_.pop_back();
+        }
+        for(std::size_t i=common; i<rhs.size(); ++i)
+        {
+            path_.push_back(i);
+            this->push(diff_kind::add, packed_element(rhs, i));
+            path_.pop_back();
+        }
+        return;
+    }
+
+    static Value packed_element(const packed_array& p, const std::size_t i)
+    {
+        switch(p.kind())
+        {
+            case value_t::integer : {return Value(p.integers ()[i]);}
+            case value_t::floating: {return Value(p.floatings()[i]);}
+            case value_t::boolean : {return Value(p.booleans ()[i]);}
+            default:                {return Value{};}
+        }
+    }
+
+    void push(const diff_kind kind, const Value& v)
+    {
+        entries_.push_back(entry_type{kind, key_path(path_), v});
+        return;
+    }
+
+    std::vector<key_path::segment> path_;
+    std::vector<entry_type>        entries_;
+};
+
+template<typename Value, typename V>
+void apply_diff_entry(Value& root, const diff_kind kind, const key_path& path, V&& v)
+{
+    const auto& segs = path.segments();
+    if(segs.empty())
+    {
+        if(kind == diff_kind::remove) {root = Value{};}
+        else                          {root = std::forward<V>(v);}
+        return;
+    }
+
+    Value* parent = std::addressof(root);
+    for(std::size_t i=0; i+1<segs.size(); ++i)
+    {
+        parent = segs[i].is_index() ?
+            std::addressof(::toml::find(*parent, segs[i].as_index())) :
+            std::addressof(::toml::find(*parent, segs[i].as_key()));
+    }
+
+    const auto& last = segs.back();
+    if(last.is_key())
+    {
+        auto& tab = parent->as_table();
+        switch(kind)
+        {
+            case diff_kind::add:
+            {
+                tab[last.as_key()] = std::forward<V>(v);
+                break;
+            }
+            case diff_kind::replace:
+            {
+                ::toml::find(*parent, last.as_key()) = std::forward<V>(v);
+                break;
+            }
+            case diff_kind::remove:
+            {
+                ::toml::find(*parent, last.as_key()); // throws if not found
+                tab.erase(last.as_key());
+                break;
+            }
+            default: {break;}
+        }
+        return;
+    }
+
+    auto& ary = parent->as_array();
+    const auto idx = last.as_index();
+    switch(kind)
+    {
+        case diff_kind::add:
+        {
+            if(ary.size() < idx)
+            {
+                throw std::out_of_range(format_underline(concat_to_string(
+                    "toml::apply_patch: index ", idx, " is out of range"),
+                    {{parent->location(), concat_to_string("the size is ", ary.size())}}));
+            }
+            ary.insert(std::next(ary.begin(), static_cast<std::ptrdiff_t>(idx)),
+                       std::forward<V>(v));
+            break;
+        }
+        case diff_kind::replace:
+        {
+            ::toml::find(*parent, idx) = std::forward<V>(v);
+            break;
+        }
+        case diff_kind::remove:
+        {
+            ::toml::find(*parent, idx); // throws if not found
+            ary.erase(std::next(ary.begin(), static_cast<std::ptrdiff_t>(idx)));
+            break;
+        }
+        default: {break;}
+    }
+    return;
+}
+
+} // detail
+
+// Compares two documents and returns the operations that change `lhs` into
+// `rhs`. Tables are compared key by key, and arrays element by element.
+// Comments and locations are not compared.
+//
+// It takes linear time in the size of the documents. With
+// TOML11_COPY_ON_WRITE, subtrees that share the content are skipped.
+//
+// ```cpp
+// for(const auto& d : toml::diff(previous, current))
+// {
+//     std::cout << d.kind << ' ' << d.path << std::endl;
+// }
+// ```
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+std::vector<diff_entry<basic_value<C, T, A>>>
+diff(const basic_value<C, T, A>& lhs, const basic_value<C, T, A>& rhs)
+{
+    detail::differ<basic_value<C, T, A>> d;
+    d.compare(lhs, rhs);
+    return std::move(d).entries();
+}
+
+// Applies the operations returned by `toml::diff(lhs, rhs)` to `lhs` to make
+// it the same as `rhs`. The operations are applied in order. If a path does
+// not exist, it throws std::out_of_range in the same way as `toml::find`.
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+void apply_patch(basic_value<C, T, A>& v,
+                 const std::vector<diff_entry<basic_value<C, T, A>>>& patch)
+{
+    for(const auto& entry : patch)
+    {
+        detail::apply_diff_entry(v, entry.kind, entry.path, entry.value);
+    }
+    return;
+}
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+void apply_patch(basic_value<C, T, A>& v,
+                 std::vector<diff_entry<basic_value<C, T, A>>>&& patch)
+{
+    for(auto& entry : patch)
+    {
+        detail::apply_diff_entry(v, entry.kind, entry.path, std::move(entry.value));
+    }
+    return;
+}
+
+} // toml
+#endif// TOML11_DIFF_HPP
@@ -0,0 +1,170 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_ERROR_INFO_HPP
+#define TOML11_ERROR_INFO_HPP
+#include <cstdint>
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "source_location.hpp"
+
+namespace toml
+{
+
+enum class error_kind : std::uint8_t
+{
+    syntax_error   = 0, // the content is not a valid TOML
+    file_io_error  = 1, // failed to open or read the file
+    internal_error = 2  // toml11 found an inconsistency in itself
+};
+
+inline std::ostream& operator<<(std::ostream& os, const error_kind k)
+{
+    switch(k)
+    {
+        case error_kind::syntax_error  : {os << "syntax_error";   break;}
+        case error_kind::file_io_error : {os << "file_io_error";  break;}
+        case error_kind::internal_error: {os << "internal_error"; break;}
+        default                        : {os << "unknown";        break;}
+    }
+    return os;
+}
+
+namespace detail
+{
+
+// An error found by the parser. It keeps the pieces of the message and
+// formats them by format_underline only when the message is shown, because
+// the parser discards most of the errors it makes while it tries alternatives.
+//
+// `where()` is the position of the error. By default, it is the first
+// location underlined in the message.
+class error_message
+{
+  public:
+    using location_list = std::vector<std::pair<source_location, std::string>>;
+
+    error_message() = default;
+
+    // a message that is already formatted.
+    error_message(std::string msg): title_(std::move(msg)), located_(false) {}
+    error_message(const char* msg): title_(msg), located_(false) {}
+
+    error_message(std::string title, location_list locs,
+                  std::vector<std::string> hints = {})
+        : title_(std::move(title)), locations_(std::move(locs)),
+          hints_(std::move(hints)), located_(!locations_.empty())
+    {
+        if(located_)
+        {
+            where_ = locations_.front().first;
+        }
+    }
+    error_message(std::string title, location_list locs,
+                  std::vector<std::string> hints, source_location where)
+        : title_(std::move(title)), locations_(std::move(locs)),
+          hints_(std::move(hints)), where_(std::move(where)), located_(true)
+    {}
+
+    ~error_message() = default;
+    error_message(error_message const&) = default;
+    error_message(error_message &&)     = default;
+    error_message& operator=(error_message const&) = default;
+    error_message& operator=(error_message &&)     = default;
+
+    source_location const& where() const noexcept {return where_;}
+    std::string     const& title() const noexcept {return title_;}
+
+    // sets the position if the message does not have one.
+    void locate(source_location where)
+    {
+        if(!located_)
+        {
+            where_   = std::move(where);
+            located_ = true;
+        }
+    }
+
+    std::string str() const
+    {
+        if(locations_.empty())
+        {
+            return title_;
+        }
+        return format_underline(title_, locations_, hints_);
+    }
+
+  private:
+    std::string              title_;
+    location_list            locations_;
+    std::vector<std::string> hints_;
+    source_location          where_;
+    bool                     located_ = false;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const error_message& e)
+{
+    os << e.str();
+    return os;
+}
+
+} // detail
+
+// An error reported by `toml::try_parse`.
+//
+// - error_kind kind() const noexcept
+//   - the category of the error.
+// - std::size_t offset() const noexcept
+//   - the number of bytes from the beginning of the file to the position
+//     where the parser stopped.
+// - std::uint_least32_t line() / column() const noexcept
+//   - the position of the error (1-origin). It can be before `offset()`
+//     when the parser needed to look ahead to find the error.
+// - std::string const& file_name() const noexcept
+// - std::string what() const
+//   - the error message in the same format as `toml::syntax_error::what()`.
+//     It is formatted when this function is called.
+struct error_info
+{
+  public:
+
+    error_info(error_kind k, detail::error_message msg, std::size_t off = 0)
+        : kind_(k), offset_(off), msg_(std::move(msg))
+    {}
+    error_info(error_kind k, std::string msg, source_location loc,
+               std::size_t off = 0)
+        : kind_(k), offset_(off),
+          msg_(std::move(msg), {}, {}, std::move(loc))
+    {}
+    ~error_info() = default;
+    error_info(error_info const&) = default;
+    error_info(error_info &&)     = default;
+    error_info& operator=(error_info const&) = default;
+    error_info& operator=(error_info &&)     = default;
+
+    error_kind          kind()      const noexcept {return kind_;}
+    std::size_t         offset()    const noexcept {return offset_;}
+    std::uint_least32_t line()      const noexcept {return location().line();}
+    std::uint_least32_t column()    const noexcept {return location().column();}
+    std::string const&  file_name() const noexcept {return location().file_name();}
+
+    source_location const& location() const noexcept {return msg_.where();}
+    std::string             what()     const {return msg_.str();}
+
+  private:
+    error_kind            kind_;
+    std::size_t           offset_;
+    detail::error_message msg_;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const error_info& e)
+{
+    os << e.what();
+    return os;
+}
+
+} // toml
+#endif// TOML11_ERROR_INFO_HPP
@@ -79,5 +79,20 @@ struct internal_error : public toml::exception
     std::string what_;
 };
 
+// thrown by toml::load_binary when the data is broken or is written in an
+// incompatible format.
+struct binary_error : public toml::exception
+{
+  public:
+    explicit binary_error(const std::string& what_arg)
+        : exception(source_location{}), what_(what_arg)
+    {}
+    virtual ~binary_error() noexcept override = default;
+    virtual const char* what() const noexcept override {return what_.c_str();}
+
+  protected:
+    std::string what_;
+};
+
 } // toml
 #endif // TOML_EXCEPTION
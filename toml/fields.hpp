@@ -0,0 +1,20 @@
+//     Copyright Toru Niina 2019.
+// Distributed under the MIT License.
+#ifndef TOML11_FIELDS_HPP
+#define TOML11_FIELDS_HPP
+
+namespace toml
+{
+
+// The list of the member variables of a struct that are read from a table.
+// TOML11_DEFINE_CONVERSION_NON_INTRUSIVE defines it.
+template<typename T>
+struct fields;
+// {
+//     // calls `f(name, &T::member)` for each member
+//     template<typename F>
+//     static void for_each(F&& f);
+// };
+
+} // toml
+#endif // TOML11_FIELDS_HPP
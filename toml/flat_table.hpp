@@ -0,0 +1,57 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_FLAT_TABLE_HPP
+#define TOML11_FLAT_TABLE_HPP
+#include "dense_table.hpp"
+
+// Tables with at most this number of elements are searched linearly. Larger
+// tables build a hash index.
+#ifndef TOML11_FLAT_TABLE_LINEAR_SEARCH_LIMIT
+#define TOML11_FLAT_TABLE_LINEAR_SEARCH_LIMIT 16
+#endif
+
+namespace toml
+{
+namespace detail
+{
+struct flat_table_policy
+{
+    static constexpr std::size_t linear_search_limit() noexcept
+    {
+        return TOML11_FLAT_TABLE_LINEAR_SEARCH_LIMIT;
+    }
+    static constexpr bool preserve_order() noexcept {return false;}
+};
+} // detail
+
+// A map that stores its elements in a contiguous array.
+//
+// It searches small tables linearly and builds a hash index for larger tables.
+// Since most of the tables in a config file are small, it is faster and uses
+// less memory than std::unordered_map. It can be passed to toml::basic_value
+// as a Table.
+//
+// ```cpp
+// using value = toml::basic_value<toml::discard_comments, toml::flat_table>;
+// const auto data = toml::parse<toml::discard_comments, toml::flat_table>("a.toml");
+// ```
+//
+// Differences from std::unordered_map:
+// - value_type is std::pair<Key, T>. Do not modify keys via iterators.
+// - Insertion and erasure invalidate all the iterators and references.
+// - `erase` moves the last element to the position of the erased element.
+//   Otherwise, elements are kept in the order of insertion.
+template<typename Key, typename T,
+         typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class flat_table
+    : public detail::dense_table<Key, T, Hash, KeyEqual, detail::flat_table_policy>
+{
+    using base_type = detail::dense_table<Key, T, Hash, KeyEqual, detail::flat_table_policy>;
+  public:
+    using base_type::base_type;
+    using base_type::operator=;
+    flat_table() = default;
+};
+
+} // toml
+#endif// TOML11_FLAT_TABLE_HPP
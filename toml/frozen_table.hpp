@@ -0,0 +1,324 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_FROZEN_TABLE_HPP
+#define TOML11_FROZEN_TABLE_HPP
+#include <cstdint>
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "value.hpp"
+
+namespace toml
+{
+
+// An immutable map that looks up keys through a minimal perfect hash function.
+//
+// All the keys are given on construction. A lookup computes the hash of the
+// key once and compares exactly one key, so `find` and `at` never probe.
+// Elements are stored in a contiguous array in the order of construction.
+//
+// Since it has no member function to insert or erase elements, a value that
+// uses this table can only be built by converting another value. Use
+// `toml::freeze` for that.
+//
+// Differences from std::unordered_map:
+// - value_type is std::pair<Key, T>. Do not modify keys via iterators.
+// - If the range passed to the constructor has duplicated keys, the first one
+//   is kept.
+template<typename Key, typename T,
+         typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class frozen_table
+{
+  public:
+
+    using key_type        = Key;
+    using mapped_type     = T;
+    using value_type      = std::pair<Key, T>;
+    using hasher          = Hash;
+    using key_equal       = KeyEqual;
+    using container_type  = std::vector<value_type>;
+    using size_type       = typename container_type::size_type;
+    using difference_type = typename container_type::difference_type;
+    using reference       = value_type&;
+    using const_reference = value_type const&;
+    using iterator        = typename container_type::iterator;
+    using const_iterator  = typename container_type::const_iterator;
+
+  public:
+
+    frozen_table() = default;
+    ~frozen_table() = default;
+    frozen_table(const frozen_table&) = default;
+    frozen_table(frozen_table&&)      = default;
+    frozen_table& operator=(const frozen_table&) = default;
+    frozen_table& operator=(frozen_table&&)      = default;
+
+    template<typename InputIterator>
+    frozen_table(InputIterator first, InputIterator last)
+        : elems_(first, last)
+    {
+        this->build();
+    }
+    frozen_table(std::initializer_list<value_type> init)
+        : elems_(init.begin(), init.end())
+    {
+        this->build();
+    }
+
+    iterator       begin()        noexcept {return elems_.begin();}
+    iterator       end()          noexcept {return elems_.end();}
+    const_iterator begin()  const noexcept {return elems_.begin();}
+    const_iterator end()    const noexcept {return elems_.end();}
+    const_iterator cbegin() const noexcept {return elems_.cbegin();}
+    const_iterator cend()   const noexcept {return elems_.cend();}
+
+    bool      empty()    const noexcept {return elems_.empty();}
+    size_type size()     const noexcept {return elems_.size();}
+    size_type max_size() const noexcept {return elems_.max_size();}
+
+    iterator find(const key_type& k)
+    {
+        return elems_.begin() + static_cast<difference_type>(this->find_index(k));
+    }
+    const_iterator find(const key_type& k) const
+    {
+        return elems_.begin() + static_cast<difference_type>(this->find_index(k));
+    }
+    size_type count(const key_type& k) const
+    {
+        return this->find_index(k) == elems_.size() ? 0 : 1;
+    }
+    bool contains(const key_type& k) const
+    {
+        return this->find_index(k) != elems_.size();
+    }
+
+    mapped_type& at(const key_type& k)
+    {
+        const auto idx = this->find_index(k);
+        if(idx == elems_.size())
+        {
+            throw std::out_of_range("toml::frozen_table::at: key not found");
+        }
+        return elems_[idx].second;
+    }
+    mapped_type const& at(const key_type& k) const
+    {
+        const auto idx = this->find_index(k);
+        if(idx == elems_.size())
+        {
+            throw std::out_of_range("toml::frozen_table::at: key not found");
+        }
+        return elems_[idx].second;
+    }
+
+    void swap(frozen_table& other) noexcept
+    {
+        using std::swap;
+        swap(elems_, other.elems_);
+        swap(seeds_, other.seeds_);
+        swap(slots_, other.slots_);
+    }
+
+    hasher    hash_function() const {return hasher{};}
+    key_equal key_eq()        const {return key_equal{};}
+
+  private:
+
+    // The hash function is built by "hash and displace". Keys are first
+    // grouped into buckets by their hash values. Then, for each bucket, we
+    // search a seed that maps all the keys in the bucket to free slots.
+    // A lookup reads the seed of the bucket and goes to the slot directly.
+
+    // map the upper 32 bits of `x` into [0, n) by multiplication instead of
+    // modulo.
+    static std::size_t reduce(const std::uint64_t x, const std::size_t n) noexcept
+    {
+        return ((x >> 32) * n) >> 32;
+    }
+    static std::size_t bucket_of(const std::uint64_t hash, const std::size_t r) noexcept
+    {
+        return reduce(hash * 0x9E3779B97F4A7C15ull, r);
+    }
+    static std::size_t slot_of(const std::uint64_t hash, const std::uint32_t seed,
+                               const std::size_t n) noexcept
+    {
+        return reduce((hash ^ seed) * 0xFF51AFD7ED558CCDull, n);
+    }
+    static std::size_t bucket_count(const std::size_t n) noexcept
+    {
+        return (n + 1) / 2;
+    }
+    static constexpr std::uint32_t empty_slot() noexcept
+    {
+        return static_cast<std::uint32_t>(-1);
+    }
+
+    void build()
+    {
+        seeds_.clear();
+        slots_.clear();
+        const std::size_t n = elems_.size();
+        if(n == 0) {return;}
+
+        std::vector<std::uint64_t> hashes(n);
+        for(std::size_t i=0; i<n; ++i)
+        {
+            hashes[i] = hasher{}(elems_[i].first);
+        }
+
+        const std::size_t r = bucket_count(n);
+        std::vector<std::vector<std::uint32_t>> buckets(r);
+        std::vector<bool> duplicated(n, false);
+        bool has_duplicate = false;
+        for(std::size_t i=0; i<n; ++i)
+        {
+            auto& bucket = buckets[bucket_of(hashes[i], r)];
+            for(const auto j : bucket)
+            {
+                if(key_equal{}(elems_[j].first, elems_[i].first))
+                {
+                    duplicated[i] = true;
+                    has_duplicate = true;
+                    break;
+                }
+            }
+            if(!duplicated[i]) {bucket.push_back(static_cast<std::uint32_t>(i));}
+        }
+        if(has_duplicate)
+        {
+            container_type uniq;
+            uniq.reserve(n);
+            for(std::size_t i=0; i<n; ++i)
+            {
+                if(!duplicated[i]) {uniq.push_back(std::move(elems_[i]));}
+            }
+            elems_ = std::move(uniq);
+            this->build();
+            return;
+        }
+
+        // place larger buckets first, while there are many free slots.
+        std::vector<std::size_t> order(r);
+        for(std::size_t b=0; b<r; ++b) {order[b] = b;}
+        std::stable_sort(order.begin(), order.end(),
+            [&buckets](const std::size_t lhs, const std::size_t rhs) {
+                return buckets[lhs].size() > buckets[rhs].size();
+            });
+
+        seeds_.assign(r, 0);
+        slots_.assign(n, empty_slot());
+        const std::size_t max_trial = (std::max<std::size_t>)(1024, n * 16);
+        std::vector<std::size_t> placed;
+        for(const auto b : order)
+        {
+            const auto& bucket = buckets[b];
+            if(bucket.empty()) {break;}
+
+            bool found = false;
+            for(std::size_t trial=0; trial<max_trial && !found; ++trial)
+            {
+                const auto seed = static_cast<std::uint32_t>(trial);
+                placed.clear();
+                found = true;
+                for(const auto i : bucket)
+                {
+                    const std::size_t s = slot_of(hashes[i], seed, n);
+                    if(slots_[s] != empty_slot() ||
+                       std::find(placed.begin(), placed.end(), s) != placed.end())
+                    {
+                        found = false;
+                        break;
+                    }
+                    placed.push_back(s);
+                }
+                if(found)
+                {
+                    seeds_[b] = seed;
+                    for(std::size_t k=0; k<bucket.size(); ++k)
+                    {
+                        slots_[placed[k]] = bucket[k];
+                    }
+                }
+            }
+            if(!found)
+            {
+                // different keys have the same hash value. fall back to
+                // linear search.
+                seeds_.clear();
+                slots_.clear();
+                return;
+            }
+        }
+    }
+
+    size_type find_index(const key_type& k) const
+    {
+        const size_type n = elems_.size();
+        if(seeds_.empty())
+        {
+            for(size_type i=0; i<n; ++i)
+            {
+                if(key_equal{}(elems_[i].first, k)) {return i;}
+            }
+            return n;
+        }
+        const std::uint64_t hash = hasher{}(k);
+        const std::uint32_t seed = seeds_[bucket_of(hash, seeds_.size())];
+        const std::uint32_t idx  = slots_[slot_of(hash, seed, n)];
+        return key_equal{}(elems_[idx].first, k) ? idx : n;
+    }
+
+  private:
+    container_type             elems_;
+    std::vector<std::uint32_t> seeds_; // for each bucket
+    std::vector<std::uint32_t> slots_; // slot -> index of the element
+};
+
+template<typename K, typename T, typename H, typename E>
+bool operator==(const frozen_table<K, T, H, E>& lhs, const frozen_table<K, T, H, E>& rhs)
+{
+    if(lhs.size() != rhs.size()) {return false;}
+    for(const auto& kv : lhs)
+    {
+        const auto found = rhs.find(kv.first);
+        if(found == rhs.end() || !(found->second == kv.second)) {return false;}
+    }
+    return true;
+}
+template<typename K, typename T, typename H, typename E>
+bool operator!=(const frozen_table<K, T, H, E>& lhs, const frozen_table<K, T, H, E>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template<typename K, typename T, typename H, typename E>
+void swap(frozen_table<K, T, H, E>& lhs, frozen_table<K, T, H, E>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+// toml::value whose tables are frozen.
+using frozen_value = basic_value<TOML11_DEFAULT_COMMENT_STRATEGY, frozen_table, std::vector>;
+
+// Convert a value into a read-only representation. All the tables in it are
+// replaced by toml::frozen_table and all the arrays are shrunk to fit. Comments
+// and locations are kept.
+//
+// ```cpp
+// const auto config = toml::freeze(toml::parse("config.toml"));
+// const auto port = toml::find<int>(config, "server", "port");
+// ```
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+basic_value<C, frozen_table, A> freeze(const basic_value<C, T, A>& v)
+{
+    return basic_value<C, frozen_table, A>(v);
+}
+
+} // toml
+#endif// TOML11_FROZEN_TABLE_HPP
@@ -290,6 +290,60 @@ get(basic_value<C, M, V>&);
 // ============================================================================
 // array-like types; most likely STL container, like std::vector, etc.
 
+namespace detail
+{
+// convert elements of a packed array without constructing toml::values.
+// If the element type does not match, it returns false and does nothing.
+template<typename T, typename U, bool IsConvertible>
+struct packed_array_converter
+{
+    template<typename Container>
+    static bool invoke(Container&, const span<const U>&) {return false;}
+};
+template<typename T, typename U>
+struct packed_array_converter<T, U, true>
+{
+    template<typename Container>
+    static bool invoke(Container& container, const span<const U>& xs)
+    {
+        try_reserve(container, xs.size());
+        for(const auto& x : xs)
+        {
+            container.push_back(static_cast<T>(x));
+        }
+        return true;
+    }
+};
+
+template<typename Container>
+bool convert_packed_array(Container& container, const packed_array& packed)
+{
+    using T = typename Container::value_type;
+    switch(packed.kind())
+    {
+        case value_t::integer:
+        {
+            return packed_array_converter<T, integer, conjunction<
+                std::is_integral<T>, negation<std::is_same<T, bool>>
+                >::value>::invoke(container, packed.integers());
+        }
+        case value_t::floating:
+        {
+            return packed_array_converter<T, floating,
+                std::is_floating_point<T>::value
+                >::invoke(container, packed.floatings());
+        }
+        case value_t::boolean:
+        {
+            return packed_array_converter<T, boolean,
+                std::is_same<T, bool>::value
+                >::invoke(container, packed.booleans());
+        }
+        default: return false;
+    }
+}
+} // detail
+
 template<typename T, typename C,
          template<typename ...> class M, template<typename ...> class V>
 detail::enable_if_t<detail::conjunction<
@@ -301,6 +355,21 @@ detail::enable_if_t<detail::conjunction<
 get(const basic_value<C, M, V>& v)
 {
     using value_type = typename T::value_type;
+    if(const auto packed = detail::get_packed_array(v))
+    {
+        T container;
+        if(!detail::convert_packed_array(container, *packed))
+        {
+            // convert the elements one by one without unpacking the array.
+            try_reserve(container, packed->size());
+            for(std::size_t i=0; i<packed->size(); ++i)
+            {
+                container.push_back(get<value_type>(
+                    packed->template element<basic_value<C, M, V>>(i)));
+            }
+        }
+        return container;
+    }
     const auto& ary = v.as_array();
 
     T container;
@@ -510,33 +579,36 @@ template<typename C,
 basic_value<C, M, V> const& find(const basic_value<C, M, V>& v, const key& ky)
 {
     const auto& tab = v.as_table();
-    if(tab.count(ky) == 0)
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found)
     {
         detail::throw_key_not_found_error(v, ky);
     }
-    return tab.at(ky);
+    return *found;
 }
 template<typename C,
          template<typename ...> class M, template<typename ...> class V>
 basic_value<C, M, V>& find(basic_value<C, M, V>& v, const key& ky)
 {
     auto& tab = v.as_table();
-    if(tab.count(ky) == 0)
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found)
     {
         detail::throw_key_not_found_error(v, ky);
     }
-    return tab.at(ky);
+    return *found;
 }
 template<typename C,
          template<typename ...> class M, template<typename ...> class V>
 basic_value<C, M, V> find(basic_value<C, M, V>&& v, const key& ky)
 {
     typename basic_value<C, M, V>::table_type tab = std::move(v).as_table();
-    if(tab.count(ky) == 0)
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found)
     {
         detail::throw_key_not_found_error(v, ky);
     }
-    return basic_value<C, M, V>(std::move(tab.at(ky)));
+    return basic_value<C, M, V>(std::move(*found));
 }
 
 // ----------------------------------------------------------------------------
@@ -588,11 +660,12 @@ decltype(::toml::get<T>(std::declval<basic_value<C, M, V> const&>()))
 find(const basic_value<C, M, V>& v, const key& ky)
 {
     const auto& tab = v.as_table();
-    if(tab.count(ky) == 0)
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found)
     {
         detail::throw_key_not_found_error(v, ky);
     }
-    return ::toml::get<T>(tab.at(ky));
+    return ::toml::get<T>(*found);
 }
 
 template<typename T, typename C,
@@ -601,11 +674,12 @@ decltype(::toml::get<T>(std::declval<basic_value<C, M, V>&>()))
 find(basic_value<C, M, V>& v, const key& ky)
 {
     auto& tab = v.as_table();
-    if(tab.count(ky) == 0)
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found)
     {
         detail::throw_key_not_found_error(v, ky);
     }
-    return ::toml::get<T>(tab.at(ky));
+    return ::toml::get<T>(*found);
 }
 
 template<typename T, typename C,
@@ -614,20 +688,101 @@ decltype(::toml::get<T>(std::declval<basic_value<C, M, V>&&>()))
 find(basic_value<C, M, V>&& v, const key& ky)
 {
     typename basic_value<C, M, V>::table_type tab = std::move(v).as_table();
-    if(tab.count(ky) == 0)
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found)
     {
         detail::throw_key_not_found_error(v, ky);
     }
-    return ::toml::get<T>(std::move(tab.at(ky)));
+    return ::toml::get<T>(std::move(*found));
 }
 
 // ----------------------------------------------------------------------------
 // find<T>(value, idx)
+
+namespace detail
+{
+// Reads an element of a packed array without unpacking it if possible.
+//
+// - If get<T> returns a value, it is taken from a temporary element.
+// - If get<T> returns a const reference to toml::integer, toml::floating or
+//   toml::boolean, it refers to the packed element itself.
+// - Otherwise the array is unpacked to get a reference to the element.
+template<typename Result>
+struct packed_element_access : std::integral_constant<int,
+    !std::is_reference<Result>::value ? 0 :
+    (std::is_same<Result, integer  const&>::value ||
+     std::is_same<Result, floating const&>::value ||
+     std::is_same<Result, boolean  const&>::value) ? 1 : 2>
+{};
+
+template<typename T> struct packed_span_of;
+template<> struct packed_span_of<integer>
+{
+    static span<const integer> invoke(const packed_array& p) noexcept {return p.integers();}
+};
+template<> struct packed_span_of<floating>
+{
+    static span<const floating> invoke(const packed_array& p) noexcept {return p.floatings();}
+};
+template<> struct packed_span_of<boolean>
+{
+    static span<const boolean> invoke(const packed_array& p) noexcept {return p.booleans();}
+};
+
+template<typename T, typename Result, int = packed_element_access<Result>::value>
+struct packed_element_getter
+{
+    template<typename Value>
+    static Result invoke(Value& v, const packed_array&, const std::size_t idx)
+    {
+        return ::toml::get<T>(v.as_array().at(idx));
+    }
+};
+template<typename T, typename Result>
+struct packed_element_getter<T, Result, 0>
+{
+    template<typename Value>
+    static Result invoke(Value&, const packed_array& packed, const std::size_t idx)
+    {
+        using value_type = remove_cvref_t<Value>;
+        const auto elem = packed.template element<value_type>(idx);
+        return ::toml::get<T>(elem);
+    }
+};
+template<typename T, typename Result>
+struct packed_element_getter<T, Result, 1>
+{
+    template<typename Value>
+    static Result invoke(Value&, const packed_array& packed, const std::size_t idx)
+    {
+        using value_type   = remove_cvref_t<Value>;
+        using element_type = remove_cvref_t<Result>;
+        constexpr value_t expected = type_to_enum<element_type, value_type>::value;
+        if(packed.kind() != expected)
+        {
+            throw_bad_cast<expected>("toml::value::cast: ", packed.kind(),
+                    packed.template element<value_type>(idx));
+        }
+        return packed_span_of<element_type>::invoke(packed)[idx];
+    }
+};
+} // detail
+
 template<typename T, typename C,
          template<typename ...> class M, template<typename ...> class V>
 decltype(::toml::get<T>(std::declval<basic_value<C, M, V> const&>()))
 find(const basic_value<C, M, V>& v, const std::size_t idx)
 {
+    using result_type = decltype(::toml::get<T>(std::declval<basic_value<C, M, V> const&>()));
+    if(const auto packed = detail::get_packed_array(v))
+    {
+        if(packed->size() <= idx)
+        {
+            throw std::out_of_range(detail::format_underline(concat_to_string(
+                "index ", idx, " is out of range"), {{v.location(), "in this array"}}));
+        }
+        return detail::packed_element_getter<T, result_type>::invoke(v, *packed, idx);
+    }
     const auto& ary = v.as_array();
     if(ary.size() <= idx)
     {
@@ -641,6 +796,16 @@ template<typename T, typename C,
 decltype(::toml::get<T>(std::declval<basic_value<C, M, V>&>()))
 find(basic_value<C, M, V>& v, const std::size_t idx)
 {
+    using result_type = decltype(::toml::get<T>(std::declval<basic_value<C, M, V>&>()));
+    if(const auto packed = detail::get_packed_array(v))
+    {
+        if(packed->size() <= idx)
+        {
+            throw std::out_of_range(detail::format_underline(concat_to_string(
+                "index ", idx, " is out of range"), {{v.location(), "in this array"}}));
+        }
+        return detail::packed_element_getter<T, result_type>::invoke(v, *packed, idx);
+    }
     auto& ary = v.as_array();
     if(ary.size() <= idx)
     {
@@ -939,8 +1104,9 @@ find_or(const basic_value<C, M, V>& v, const key& ky,
 {
     if(!v.is_table()) {return opt;}
     const auto& tab = v.as_table();
-    if(tab.count(ky) == 0) {return opt;}
-    return tab.at(ky);
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found) {return opt;}
+    return *found;
 }
 
 template<typename C,
@@ -950,8 +1116,9 @@ find_or(basic_value<C, M, V>& v, const toml::key& ky, basic_value<C, M, V>& opt)
 {
     if(!v.is_table()) {return opt;}
     auto& tab = v.as_table();
-    if(tab.count(ky) == 0) {return opt;}
-    return tab.at(ky);
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found) {return opt;}
+    return *found;
 }
 
 template<typename C,
@@ -961,8 +1128,9 @@ find_or(basic_value<C, M, V>&& v, const toml::key& ky, basic_value<C, M, V>&& op
 {
     if(!v.is_table()) {return opt;}
     auto tab = std::move(v).as_table();
-    if(tab.count(ky) == 0) {return opt;}
-    return basic_value<C, M, V>(std::move(tab.at(ky)));
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found) {return opt;}
+    return basic_value<C, M, V>(std::move(*found));
 }
 
 // ---------------------------------------------------------------------------
@@ -975,8 +1143,9 @@ find_or(const basic_value<C, M, V>& v, const key& ky, const T& opt)
 {
     if(!v.is_table()) {return opt;}
     const auto& tab = v.as_table();
-    if(tab.count(ky) == 0) {return opt;}
-    return get_or(tab.at(ky), opt);
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found) {return opt;}
+    return get_or(*found, opt);
 }
 
 template<typename T, typename C,
@@ -987,8 +1156,9 @@ find_or(basic_value<C, M, V>& v, const toml::key& ky, T& opt)
 {
     if(!v.is_table()) {return opt;}
     auto& tab = v.as_table();
-    if(tab.count(ky) == 0) {return opt;}
-    return get_or(tab.at(ky), opt);
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found) {return opt;}
+    return get_or(*found, opt);
 }
 
 template<typename T, typename C,
@@ -1000,8 +1170,9 @@ find_or(basic_value<C, M, V>&& v, const toml::key& ky, T&& opt)
 {
     if(!v.is_table()) {return std::forward<T>(opt);}
     auto tab = std::move(v).as_table();
-    if(tab.count(ky) == 0) {return std::forward<T>(opt);}
-    return get_or(std::move(tab.at(ky)), std::forward<T>(opt));
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found) {return std::forward<T>(opt);}
+    return get_or(std::move(*found), std::forward<T>(opt));
 }
 
 // ---------------------------------------------------------------------------
@@ -1014,8 +1185,9 @@ find_or(const basic_value<C, M, V>& v, const key& ky, const T& opt)
 {
     if(!v.is_table()) {return opt;}
     const auto& tab = v.as_table();
-    if(tab.count(ky) == 0) {return opt;}
-    return get_or(tab.at(ky), opt);
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found) {return opt;}
+    return get_or(*found, opt);
 }
 template<typename T, typename C,
          template<typename ...> class M, template<typename ...> class V>
@@ -1024,8 +1196,9 @@ find_or(basic_value<C, M, V>& v, const toml::key& ky, T& opt)
 {
     if(!v.is_table()) {return opt;}
     auto& tab = v.as_table();
-    if(tab.count(ky) == 0) {return opt;}
-    return get_or(tab.at(ky), opt);
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found) {return opt;}
+    return get_or(*found, opt);
 }
 template<typename T, typename C,
          template<typename ...> class M, template<typename ...> class V>
@@ -1034,8 +1207,9 @@ find_or(basic_value<C, M, V>&& v, const toml::key& ky, T&& opt)
 {
     if(!v.is_table()) {return std::forward<T>(opt);}
     auto tab = std::move(v).as_table();
-    if(tab.count(ky) == 0) {return std::forward<T>(opt);}
-    return get_or(std::move(tab.at(ky)), std::forward<T>(opt));
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found) {return std::forward<T>(opt);}
+    return get_or(std::move(*found), std::forward<T>(opt));
 }
 
 // ---------------------------------------------------------------------------
@@ -1049,8 +1223,9 @@ find_or(const basic_value<C, M, V>& v, const toml::key& ky, T&& opt)
 {
     if(!v.is_table()) {return std::string(opt);}
     const auto& tab = v.as_table();
-    if(tab.count(ky) == 0) {return std::string(opt);}
-    return get_or(tab.at(ky), std::forward<T>(opt));
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found) {return std::string(opt);}
+    return get_or(*found, std::forward<T>(opt));
 }
 
 // ---------------------------------------------------------------------------
@@ -1071,8 +1246,9 @@ find_or(const basic_value<C, M, V>& v, const toml::key& ky, T&& opt)
 {
     if(!v.is_table()) {return std::forward<T>(opt);}
     const auto& tab = v.as_table();
-    if(tab.count(ky) == 0) {return std::forward<T>(opt);}
-    return get_or(tab.at(ky), std::forward<T>(opt));
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found) {return std::forward<T>(opt);}
+    return get_or(*found, std::forward<T>(opt));
 }
 
 // ---------------------------------------------------------------------------
@@ -1090,11 +1266,12 @@ auto find_or(Value&& v, const toml::key& ky, Ks&& ... keys)
         return detail::last_one(std::forward<Ks>(keys)...);
     }
     auto&& tab = std::forward<Value>(v).as_table();
-    if(tab.count(ky) == 0)
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found)
     {
         return detail::last_one(std::forward<Ks>(keys)...);
     }
-    return find_or(std::forward<decltype(tab)>(tab).at(ky), std::forward<Ks>(keys)...);
+    return find_or(*found, std::forward<Ks>(keys)...);
 }
 
 // ---------------------------------------------------------------------------
@@ -1112,11 +1289,12 @@ auto find_or(Value&& v, const toml::key& ky, Ks&& ... keys)
         return detail::last_one(std::forward<Ks>(keys)...);
     }
     auto&& tab = std::forward<Value>(v).as_table();
-    if(tab.count(ky) == 0)
+    const auto found = detail::find_mapped(tab, ky);
+    if(!found)
     {
         return detail::last_one(std::forward<Ks>(keys)...);
     }
-    return find_or(std::forward<decltype(tab)>(tab).at(ky), std::forward<Ks>(keys)...);
+    return find_or(*found, std::forward<Ks>(keys)...);
 }
 
 // ============================================================================
@@ -0,0 +1,434 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_HASH_HPP
+#define TOML11_HASH_HPP
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "datetime.hpp"
+#include "value.hpp"
+
+namespace toml
+{
+namespace detail
+{
+
+// A 64-bit hash in the style of xxHash64. It reads 8 bytes at once and the
+// result does not depend on the platform or the process.
+constexpr std::uint64_t hash_prime1 = 0x9E3779B185EBCA87ull;
+constexpr std::uint64_t hash_prime2 = 0xC2B2AE3D27D4EB4Full;
+constexpr std::uint64_t hash_prime3 = 0x165667B19E3779F9ull;
+constexpr std::uint64_t hash_prime4 = 0x85EBCA77C2B2AE63ull;
+constexpr std::uint64_t hash_prime5 = 0x27D4EB2F165667C5ull;
+
+inline std::uint64_t hash_rotl(const std::uint64_t x, const unsigned int r) noexcept
+{
+    return (x << r) | (x >> (64u - r));
+}
+
+// the finalizer of xxHash64. It mixes all the bits.
+inline std::uint64_t hash_mix(std::uint64_t h) noexcept
+{
+    h ^= h >> 33;
+    h *= hash_prime2;
+    h ^= h >> 29;
+    h *= hash_prime3;
+    h ^= h >> 32;
+    return h;
+}
+
+// the result depends on the order of the arguments.
+inline std::uint64_t hash_combine(const std::uint64_t seed, const std::uint64_t v) noexcept
+{
+    return hash_rotl(seed ^ hash_mix(v + hash_prime5), 27) * hash_prime1 + hash_prime4;
+}
+
+inline std::uint64_t hash_bytes(const char* data, std::size_t len) noexcept
+{
+    const auto read = [](const char* p, const std::size_t n) noexcept -> std::uint64_t {
+        // little endian regardless of the platform
+        std::uint64_t x = 0;
+        for(std::size_t i=0; i<n; ++i)
+        {
+            x |= std::uint64_t(static_cast<unsigned char>(p[i])) << (8 * i);
+        }
+        return x;
+    };
+
+    std::uint64_t h = hash_prime5 + len;
+    for(; 8 <= len; data += 8, len -= 8)
+    {
+        const auto k = hash_rotl(read(data, 8) * hash_prime2, 31) * hash_prime1;
+        h = hash_rotl(h ^ k, 27) * hash_prime1 + hash_prime4;
+    }
+    if(len != 0)
+    {
+        h ^= read(data, len) * hash_prime1;
+        h  = hash_rotl(h, 23) * hash_prime2 + hash_prime3;
+    }
+    return hash_mix(h);
+}
+
+inline std::uint64_t hash_of(const local_date& d) noexcept
+{
+    return hash_mix((static_cast<std::uint64_t>(static_cast<std::uint16_t>(d.year)) << 16) |
+                    (static_cast<std::uint64_t>(d.month) << 8) |
+                     static_cast<std::uint64_t>(d.day));
+}
+inline std::uint64_t hash_of(const local_time& t) noexcept
+{
+    return hash_mix((static_cast<std::uint64_t>(t.hour)        << 56) |
+                    (static_cast<std::uint64_t>(t.minute)      << 48) |
+                    (static_cast<std::uint64_t>(t.second)      << 40) |
+                    (static_cast<std::uint64_t>(t.millisecond) << 20) |
+                    (static_cast<std::uint64_t>(t.microsecond) << 10) |
+                     static_cast<std::uint64_t>(t.nanosecond));
+}
+inline std::uint64_t hash_of(const local_datetime& dt) noexcept
+{
+    return hash_combine(hash_of(dt.date), hash_of(dt.time));
+}
+inline std::uint64_t hash_of(const offset_datetime& dt) noexcept
+{
+    const auto offset = static_cast<std::uint64_t>(
+            static_cast<std::uint16_t>(dt.offset.hour * 60 + dt.offset.minute));
+    return hash_combine(hash_combine(hash_of(dt.date), hash_of(dt.time)), offset);
+}
+
+// The hash of a value is the hash of its type and content. Elements of a
+// packed array are hashed in the same way as the corresponding values so
+// that a packed array and an equivalent array have the same hash.
+inline std::uint64_t hash_scalar(const value_t t, const std::uint64_t content) noexcept
+{
+    return hash_combine(hash_mix(static_cast<std::uint64_t>(t)), content);
+}
+inline std::uint64_t hash_scalar(const boolean b) noexcept
+{
+    return hash_scalar(value_t::boolean, b ? 1u : 0u);
+}
+inline std::uint64_t hash_scalar(const integer i) noexcept
+{
+    return hash_scalar(value_t::integer, static_cast<std::uint64_t>(i));
+}
+inline std::uint64_t hash_scalar(floating x) noexcept
+{
+    // 0.0 == -0.0, and every NaN is regarded as the same value (see
+    // floating_equal), so the bits are normalized before hashing.
+    if(x == 0.0)       {x = 0.0;}
+    if(std::isnan(x))  {x = std::numeric_limits<floating>::quiet_NaN();}
+    std::uint64_t bits = 0;
+    static_assert(sizeof(bits) == sizeof(x), "toml::floating should be 64-bit");
+    std::memcpy(std::addressof(bits), std::addressof(x), sizeof(x));
+    return hash_scalar(value_t::floating, bits);
+}
+
+template<typename Value>
+std::uint64_t structural_hash_of(const Value& v)
+{
+    switch(v.type())
+    {
+        case value_t::boolean : {return hash_scalar(v.as_boolean (std::nothrow));}
+        case value_t::integer : {return hash_scalar(v.as_integer (std::nothrow));}
+        case value_t::floating: {return hash_scalar(v.as_floating(std::nothrow));}
+        case value_t::string  :
+        {
+            const auto& s = v.as_string(std::nothrow);
+            return hash_scalar(value_t::string, hash_combine(
+                hash_bytes(s.str.data(), s.str.size()),
+                static_cast<std::uint64_t>(s.kind)));
+        }
+        case value_t::offset_datetime: {return hash_scalar(v.type(), hash_of(v.as_offset_datetime(std::nothrow)));}
+        case value_t::local_datetime : {return hash_scalar(v.type(), hash_of(v.as_local_datetime (std::nothrow)));}
+        case value_t::local_date     : {return hash_scalar(v.type(), hash_of(v.as_local_date     (std::nothrow)));}
+        case value_t::local_time     : {return hash_scalar(v.type(), hash_of(v.as_local_time     (std::nothrow)));}
+        case value_t::array:
+        {
+            std::uint64_t h = hash_mix(static_cast<std::uint64_t>(value_t::array));
+            if(const auto packed = get_packed_array(v))
+            {
+                h = hash_combine(h, packed->size());
+                switch(packed->kind())
+                {
+                    case value_t::integer : {for(const auto x : packed->integers ()) {h = hash_combine(h, hash_scalar(x));} break;}
+                    case value_t::floating: {for(const auto x : packed->floatings()) {h = hash_combine(h, hash_scalar(x));} break;}
+                    case value_t::boolean : {for(const auto x : packed->booleans ()) {h = hash_combine(h, hash_scalar(x));} break;}
+                    default: {break;}
+                }
+                return h;
+            }
+            const auto& ary = v.as_array(std::nothrow);
+            h = hash_combine(h, ary.size());
+            for(const auto& elem : ary)
+            {
+                h = hash_combine(h, structural_hash_of(elem));
+            }
+            return h;
+        }
+        case value_t::table:
+        {
+            // the sum does not depend on the order of the elements.
+            const auto& tab = v.as_table(std::nothrow);
+            std::uint64_t sum = 0;
+            for(const auto& kv : tab)
+            {
+                sum += hash_combine(hash_bytes(kv.first.data(), kv.first.size()),
+                                    structural_hash_of(kv.second));
+            }
+            return hash_combine(hash_combine(
+                hash_mix(static_cast<std::uint64_t>(value_t::table)),
+                tab.size()), sum);
+        }
+        case value_t::empty: {return hash_mix(static_cast<std::uint64_t>(value_t::empty));}
+        default:             {return 0;}
+    }
+}
+
+// NaN is regarded as equal to NaN. Otherwise a value that contains NaN would
+// never equal itself, and diff and merge_by_key would disagree on it.
+inline bool floating_equal(const floating lhs, const floating rhs) noexcept
+{
+    return lhs == rhs || (std::isnan(lhs) && std::isnan(rhs));
+}
+
+inline bool packed_element_equal(const packed_array& lhs, const packed_array& rhs,
+                                  const std::size_t i) noexcept
+{
+    if(lhs.kind() != rhs.kind()) {return false;}
+    switch(lhs.kind())
+    {
+        case value_t::integer : {return lhs.integers()[i] == rhs.integers()[i];}
+        case value_t::boolean : {return lhs.booleans()[i] == rhs.booleans()[i];}
+        case value_t::floating: {return floating_equal(lhs.floatings()[i], rhs.floatings()[i]);}
+        default:                {return false;}
+    }
+}
+
+// compares two values that are neither arrays nor tables. This is the only
+// leaf comparison; structurally_equal and diff both use it.
+template<typename Value>
+bool leaf_equal(const Value& lhs, const Value& rhs)
+{
+    if(lhs.type() != rhs.type()) {return false;}
+    switch(lhs.type())
+    {
+        case value_t::boolean        : {return lhs.as_boolean        (std::nothrow) == rhs.as_boolean        (std::nothrow);}
+        case value_t::integer        : {return lhs.as_integer        (std::nothrow) == rhs.as_integer        (std::nothrow);}
+        case value_t::floating       : {return floating_equal(lhs.as_floating(std::nothrow), rhs.as_floating(std::nothrow));}
+        case value_t::string         : {return lhs.as_string         (std::nothrow) == rhs.as_string         (std::nothrow);}
+        case value_t::offset_datetime: {return lhs.as_offset_datetime(std::nothrow) == rhs.as_offset_datetime(std::nothrow);}
+        case value_t::local_datetime : {return lhs.as_local_datetime (std::nothrow) == rhs.as_local_datetime (std::nothrow);}
+        case value_t::local_date     : {return lhs.as_local_date     (std::nothrow) == rhs.as_local_date     (std::nothrow);}
+        case value_t::local_time     : {return lhs.as_local_time     (std::nothrow) == rhs.as_local_time     (std::nothrow);}
+        case value_t::empty          : {return true;}
+        default                      : {return false;}
+    }
+}
+
+// compares values as structural_hash_of does. Comments and locations are
+// ignored, and a packed array equals an array that has the same elements.
+template<typename Value>
+bool structurally_equal(const Value& lhs, const Value& rhs)
+{
+    if(lhs.type() != rhs.type()) {return false;}
+    switch(lhs.type())
+    {
+        case value_t::array:
+        {
+            const auto lp = get_packed_array(lhs);
+            const auto rp = get_packed_array(rhs);
+            if(lp && rp)
+            {
+                if(lp->kind() != rp->kind() || lp->size() != rp->size()) {return false;}
+                for(std::size_t i=0; i<lp->size(); ++i)
+                {
+                    if(!packed_element_equal(*lp, *rp, i)) {return false;}
+                }
+                return true;
+            }
+            if(lp || rp)
+            {
+                // compare elements one by one not to unpack the packed one.
+                const auto& packed = lp ? *lp : *rp;
+                const auto& ary    = lp ? rhs.as_array(std::nothrow) : lhs.as_array(std::nothrow);
+                if(packed.size() != ary.size()) {return false;}
+                for(std::size_t i=0; i<ary.size(); ++i)
+                {
+                    if(!structurally_equal(packed.template element<Value>(i), ary[i])) {return false;}
+                }
+                return true;
+            }
+
+            // copies share the content with TOML11_COPY_ON_WRITE. NaN equals
+            // NaN here, so this does not change the result.
+            const auto& la = lhs.as_array(std::nothrow);
+            const auto& ra = rhs.as_array(std::nothrow);
+            if(std::addressof(la) == std::addressof(ra)) {return true;}
+            if(la.size() != ra.size()) {return false;}
+            for(std::size_t i=0; i<la.size(); ++i)
+            {
+                if(!structurally_equal(la[i], ra[i])) {return false;}
+            }
+            return true;
+        }
+        case value_t::table:
+        {
+            const auto& lt = lhs.as_table(std::nothrow);
+            const auto& rt = rhs.as_table(std::nothrow);
+            if(std::addressof(lt) == std::addressof(rt)) {return true;}
+            if(lt.size() != rt.size()) {return false;}
+            for(const auto& kv : lt)
+            {
+                const auto found = find_mapped(rt, kv.first);
+                if(!found || !structurally_equal(kv.second, *found)) {return false;}
+            }
+            return true;
+        }
+        default: {return leaf_equal(lhs, rhs);}
+    }
+}
+
+// size_t might be narrower than uint64_t.
+template<typename T>
+T narrow_hash(const std::uint64_t h) noexcept
+{
+    return static_cast<T>(h);
+}
+
+} // detail
+
+// Returns a hash of a value and its elements in one pass.
+//
+// Equivalent values have the same hash regardless of the order of the keys
+// in tables, the table type, and whether an array is packed or not. Comments
+// and locations are not hashed. The hash does not depend on the platform or
+// the process, so it can be stored and compared later.
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+std::uint64_t structural_hash(const basic_value<C, T, A>& v)
+{
+    return detail::structural_hash_of(v);
+}
+
+// An immutable value with the hash computed once.
+//
+// Comparing two of them first compares the hashes, so values that differ are
+// found in constant time. Copies share the same value, and comparing them
+// also takes constant time. It can be used as a key of a hash map.
+//
+// Unlike basic_value::operator==, comments are not compared and NaN equals
+// NaN, the same as structural_hash.
+//
+// ```cpp
+// std::unordered_map<toml::hashed_value<toml::value>, result> cache;
+// const toml::hashed_value<toml::value> key(toml::parse("request.toml"));
+// cache.emplace(key, compute(key.value()));
+// ```
+template<typename Value>
+class hashed_value
+{
+  public:
+    using value_type = Value;
+
+    explicit hashed_value(value_type v)
+        : value_(std::make_shared<const value_type>(std::move(v))),
+          hash_(::toml::structural_hash(*value_))
+    {}
+    // e.g. a document from toml::parse_cache. `v` should not be null.
+    explicit hashed_value(std::shared_ptr<const value_type> v)
+        : value_(std::move(v)), hash_(::toml::structural_hash(*value_))
+    {}
+    ~hashed_value() = default;
+    hashed_value(const hashed_value&) = default;
+    hashed_value(hashed_value&&)      = default;
+    hashed_value& operator=(const hashed_value&) = default;
+    hashed_value& operator=(hashed_value&&)      = default;
+
+    value_type const& value() const noexcept {return *value_;}
+    value_type const& operator*()  const noexcept {return *value_;}
+    value_type const* operator->() const noexcept {return value_.get();}
+
+    std::uint64_t hash() const noexcept {return hash_;}
+
+    std::shared_ptr<const value_type> const& shared() const noexcept {return value_;}
+
+  private:
+    std::shared_ptr<const value_type> value_;
+    std::uint64_t                     hash_;
+};
+
+template<typename Value>
+bool operator==(const hashed_value<Value>& lhs, const hashed_value<Value>& rhs)
+{
+    if(lhs.shared() == rhs.shared()) {return true;}
+    // compares as the hash does, so a key with NaN or comments can be found.
+    return lhs.hash() == rhs.hash() &&
+           detail::structurally_equal(lhs.value(), rhs.value());
+}
+template<typename Value>
+bool operator!=(const hashed_value<Value>& lhs, const hashed_value<Value>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+} // toml
+
+namespace std
+{
+
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+struct hash<::toml::basic_value<C, T, A>>
+{
+    std::size_t operator()(const ::toml::basic_value<C, T, A>& v) const
+    {
+        return ::toml::detail::narrow_hash<std::size_t>(::toml::structural_hash(v));
+    }
+};
+template<typename Value>
+struct hash<::toml::hashed_value<Value>>
+{
+    std::size_t operator()(const ::toml::hashed_value<Value>& v) const noexcept
+    {
+        return ::toml::detail::narrow_hash<std::size_t>(v.hash());
+    }
+};
+
+template<>
+struct hash<::toml::local_date>
+{
+    std::size_t operator()(const ::toml::local_date& d) const noexcept
+    {
+        return ::toml::detail::narrow_hash<std::size_t>(::toml::detail::hash_of(d));
+    }
+};
+template<>
+struct hash<::toml::local_time>
+{
+    std::size_t operator()(const ::toml::local_time& t) const noexcept
+    {
+        return ::toml::detail::narrow_hash<std::size_t>(::toml::detail::hash_of(t));
+    }
+};
+template<>
+struct hash<::toml::local_datetime>
+{
+    std::size_t operator()(const ::toml::local_datetime& dt) const noexcept
+    {
+        return ::toml::detail::narrow_hash<std::size_t>(::toml::detail::hash_of(dt));
+    }
+};
+template<>
+struct hash<::toml::offset_datetime>
+{
+    std::size_t operator()(const ::toml::offset_datetime& dt) const noexcept
+    {
+        return ::toml::detail::narrow_hash<std::size_t>(::toml::detail::hash_of(dt));
+    }
+};
+
+} // std
+#endif// TOML11_HASH_HPP
@@ -0,0 +1,466 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_INCREMENTAL_HPP
+#define TOML11_INCREMENTAL_HPP
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "parser.hpp"
+#include "region.hpp"
+#include "value.hpp"
+
+namespace toml
+{
+namespace detail
+{
+
+// moves the regions of a value and its elements from the previous content to
+// the edited one. Positions after the edit are shifted by the difference of
+// the lengths.
+class source_rebinder
+{
+  public:
+
+    source_rebinder(const location& loc, const region::source_ptr& previous,
+                    const std::size_t edit_last, const std::size_t removed,
+                    const std::size_t inserted)
+        : loc_(loc), previous_(previous), edit_last_(edit_last),
+          removed_(removed), inserted_(inserted)
+    {}
+
+    template<typename Value>
+    void rebind(Value& v)
+    {
+        const auto reg = get_metadata(v).shared_region();
+        if(reg)
+        {
+            if(const auto r = dynamic_cast<const region*>(reg.get()))
+            {
+                if(r->source() == previous_)
+                {
+                    change_region(v, this->rebound(*r));
+                }
+            }
+        }
+
+        if(v.is_table())
+        {
+            for(auto& kv : v.as_table(std::nothrow))
+            {
+                this->rebind(kv.second);
+            }
+        }
+        else if(v.is_array() && !v.is_packed_array())
+        {
+            // elements of a packed array do not have regions.
+            for(auto& elem : v.as_array(std::nothrow))
+            {
+                this->rebind(elem);
+            }
+        }
+        return;
+    }
+
+  private:
+
+    std::shared_ptr<region_base> rebound(const region& r)
+    {
+        // the same region object might be shared by copies of a value.
+        auto& n = regions_[std::addressof(r)];
+        if(n) {return n;}
+
+        const auto first = this->shift(std::distance(r.begin(), r.first()));
+        const auto last  = this->shift(std::distance(r.begin(), r.last()));
+        n = std::make_shared<region>(loc_,
+                std::next(loc_.begin(), static_cast<std::ptrdiff_t>(first)),
+                std::next(loc_.begin(), static_cast<std::ptrdiff_t>(last)));
+        return n;
+    }
+
+    std::size_t shift(const std::ptrdiff_t pos) const noexcept
+    {
+        const auto p = static_cast<std::size_t>(pos);
+        return (edit_last_ <= p) ? p - removed_ + inserted_ : p;
+    }
+
+    const location&    loc_;
+    region::source_ptr previous_;
+    std::size_t        edit_last_;
+    std::size_t        removed_;
+    std::size_t        inserted_;
+    std::unordered_map<const void*, std::shared_ptr<region_base>> regions_;
+};
+
+} // detail
+
+// A document that is parsed again partially after each edit.
+//
+// The content is split into sections at table headers (`[table]` and
+// `[[array.of.tables]]`). The key-value pairs before the first header form
+// the root section. After an edit, only the sections that overlap with it are
+// parsed again. If the edit changes how the following sections are parsed
+// (e.g. it opens a multi-line string), the parser goes on until it finds the
+// beginning of an unchanged section.
+//
+// Then the top-level tables that the parsed sections belong to are rebuilt.
+// The other sections that define values in the same top-level tables are also
+// parsed again to check conflicts (e.g. a table defined twice) in the same way
+// as `toml::parse`. Values in the other top-level tables are kept.
+//
+// ```cpp
+// toml::incremental_document doc(content, "config.toml");
+// doc.edit(offset, length, "replacement");
+// const toml::value& v = doc.value();
+// ```
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+class basic_incremental_document
+{
+  public:
+    using value_type = basic_value<Comment, Table, Array>;
+    using table_type = typename value_type::table_type;
+
+  public:
+
+    // throws syntax_error if the content is not a valid TOML.
+    explicit basic_incremental_document(const std::string& content,
+                                        std::string fname = "unknown file")
+        : fname_(std::move(fname)), size_(content.size()), reparsed_(0)
+    {
+        this->update(std::vector<char>(content.begin(), content.end()), 0, 0, 0);
+    }
+    ~basic_incremental_document() = default;
+    basic_incremental_document(const basic_incremental_document&) = default;
+    basic_incremental_document(basic_incremental_document&&)      = default;
+    basic_incremental_document& operator=(const basic_incremental_document&) = default;
+    basic_incremental_document& operator=(basic_incremental_document&&)      = default;
+
+    // Replaces `length` bytes from `offset` by `replacement`, and updates the
+    // value. If the edited content is not a valid TOML, it throws syntax_error
+    // and the document (both the content and the value) is not changed.
+    value_type const& edit(const std::size_t offset, const std::size_t length,
+                           const std::string& replacement)
+    {
+        if(size_ < offset || size_ - offset < length)
+        {
+            throw std::out_of_range(concat_to_string(
+                "toml::incremental_document::edit: range [", offset, ", ",
+                offset + length, ") exceeds the size ", size_));
+        }
+        const auto first = source_->cbegin();
+        const auto o = static_cast<std::ptrdiff_t>(offset);
+        const auto l = static_cast<std::ptrdiff_t>(offset + length);
+        const auto e = static_cast<std::ptrdiff_t>(size_);
+
+        std::vector<char> letters;
+        letters.reserve(size_ - length + replacement.size() + 1);
+        letters.insert(letters.end(), first, std::next(first, o));
+        letters.insert(letters.end(), replacement.begin(), replacement.end());
+        letters.insert(letters.end(), std::next(first, l), std::next(first, e));
+
+        const auto sz = letters.size();
+        this->update(std::move(letters), offset, length, replacement.size());
+        size_ = sz;
+        return root_;
+    }
+
+    value_type const& value()    const noexcept {return root_;}
+    std::string const& file_name() const noexcept {return fname_;}
+
+    std::string content() const
+    {
+        return std::string(source_->cbegin(),
+                std::next(source_->cbegin(), static_cast<std::ptrdiff_t>(size_)));
+    }
+    std::size_t size() const noexcept {return size_;}
+
+    // the number of sections, and the number of them parsed in the last update.
+    std::size_t sections()          const noexcept {return sections_.size();}
+    std::size_t reparsed_sections() const noexcept {return reparsed_;}
+
+  private:
+
+    struct section
+    {
+        std::size_t      first;     // offset of the header or the root section
+        std::vector<key> top_level; // the top-level keys defined in it
+    };
+    struct parsed_section
+    {
+        section                               info;
+        std::vector<key>                      keys;    // keys in the header
+        bool                                  is_array_of_tables;
+        std::shared_ptr<const detail::region> header;  // nullptr if root
+        value_type                            body;
+        std::vector<std::string>              comments; // for the file
+    };
+
+    static std::size_t offset_of(const detail::location& loc)
+    {
+        return static_cast<std::size_t>(std::distance(loc.begin(), loc.iter()));
+    }
+
+    static parsed_section parse_section(detail::location& loc, const bool is_root)
+    {
+        parsed_section ps;
+        ps.info.first        = offset_of(loc);
+        ps.is_array_of_tables = false;
+        if(is_root)
+        {
+            ps.comments = detail::parse_file_comments(loc);
+            auto tab = detail::parse_ml_table<value_type>(loc);
+            if(!tab)
+            {
+                detail::throw_syntax_error(tab.unwrap_err(), source_location(loc));
+            }
+            ps.body = value_type(std::move(tab.unwrap()));
+            for(const auto& kv : ps.body.as_table(std::nothrow))
+            {
+                ps.info.top_level.push_back(kv.first);
+            }
+            return ps;
+        }
+
+        auto tabkey = detail::parse_array_table_key(loc);
+        if(tabkey)
+        {
+            ps.is_array_of_tables = true;
+        }
+        else
+        {
+            tabkey = detail::parse_table_key(loc);
+        }
+        if(!tabkey)
+        {
+            throw syntax_error(detail::format_underline("toml::parse_toml_file: "
+                "unknown line appeared", {{source_location(loc), "unknown format"}}),
+                source_location(loc));
+        }
+        ps.keys   = tabkey.unwrap().first;
+        ps.header = std::make_shared<const detail::region>(tabkey.unwrap().second);
+
+        const auto tab = detail::parse_ml_table<value_type>(loc, projection{}, ps.keys);
+        if(!tab)
+        {
+            detail::throw_syntax_error(tab.unwrap_err(), source_location(loc));
+        }
+        ps.body = value_type(tab.unwrap(), *ps.header, ps.header->comments());
+        ps.info.top_level.push_back(ps.keys.front());
+        return ps;
+    }
+
+    // the same as the loop in detail::parse_toml_file.
+    static void insert_section(table_type& root, parsed_section& ps)
+    {
+        if(!ps.header)
+        {
+            root = std::move(ps.body.as_table(std::nothrow));
+            return;
+        }
+        const auto inserted = detail::insert_nested_key(root, ps.body,
+                ps.keys.begin(), ps.keys.end(), *ps.header, ps.is_array_of_tables);
+        if(!inserted)
+        {
+            detail::throw_syntax_error(inserted.unwrap_err(),
+                                       source_location(*ps.header));
+        }
+        return;
+    }
+
+    // `removed` bytes from `offset` in the previous content are replaced by
+    // `inserted` bytes. The previous content is empty when it is constructed.
+    void update(std::vector<char> letters, const std::size_t offset,
+                const std::size_t removed, const std::size_t inserted)
+    {
+        auto loc = detail::make_location(std::move(letters), fname_);
+        const auto start = loc.iter(); // after BOM
+
+        const std::size_t edit_last = offset + removed;  // in the previous one
+        const std::size_t new_last  = offset + inserted; // in the edited one
+        const auto shift = [=](const std::size_t pos) noexcept -> std::size_t {
+            return (edit_last <= pos) ? pos - removed + inserted : pos;
+        };
+
+        // the sections overlapping with [offset, edit_last], and the next one
+        // because the comments just before a header belong to the table.
+        const std::size_t n = sections_.size();
+        std::size_t first_affected = 0;
+        while(first_affected + 1 < n && sections_[first_affected + 1].first < offset)
+        {
+            ++first_affected;
+        }
+        std::size_t last_affected = first_affected;
+        while(last_affected + 1 < n && sections_[last_affected + 1].first <= edit_last)
+        {
+            ++last_affected;
+        }
+        const std::size_t affected_end = (std::min)(n, last_affected + 2);
+
+        // parse until it reaches an unchanged section.
+        if(first_affected != 0)
+        {
+            loc.reset(std::next(loc.begin(),
+                      static_cast<std::ptrdiff_t>(sections_[first_affected].first)));
+        }
+        std::vector<parsed_section> fresh;
+        std::size_t resume = n;
+        while(true)
+        {
+            fresh.push_back(parse_section(loc, first_affected == 0 && fresh.empty()));
+            if(loc.iter() == loc.end())
+            {
+                break;
+            }
+            const auto pos = offset_of(loc);
+            if(new_last <= pos)
+            {
+                const auto prev_pos = pos - inserted + removed;
+                const auto found = std::lower_bound(
+                    sections_.begin() + static_cast<std::ptrdiff_t>(affected_end),
+                    sections_.end(), prev_pos,
+                    [](const section& s, const std::size_t p) {return s.first < p;});
+                if(found != sections_.end() && found->first == prev_pos)
+                {
+                    resume = static_cast<std::size_t>(std::distance(sections_.begin(), found));
+                    break;
+                }
+            }
+        }
+
+        // the top-level keys that should be rebuilt.
+        std::unordered_set<key> touched;
+        for(std::size_t i=first_affected; i<resume; ++i)
+        {
+            touched.insert(sections_[i].top_level.begin(), sections_[i].top_level.end());
+        }
+        for(const auto& ps : fresh)
+        {
+            touched.insert(ps.info.top_level.begin(), ps.info.top_level.end());
+        }
+
+        // the edited list of sections. `parsed` is null for unchanged ones.
+        struct entry
+        {
+            section         info;
+            parsed_section* parsed;
+        };
+        std::vector<entry> entries;
+        entries.reserve(first_affected + fresh.size() + (n - resume));
+        for(std::size_t i=0; i<first_affected; ++i)
+        {
+            entries.push_back(entry{sections_[i], nullptr});
+        }
+        for(auto& ps : fresh)
+        {
+            entries.push_back(entry{ps.info, std::addressof(ps)});
+        }
+        for(std::size_t i=resume; i<n; ++i)
+        {
+            entries.push_back(entry{sections_[i], nullptr});
+            entries.back().info.first = shift(sections_[i].first);
+        }
+
+        // unchanged sections that share top-level keys with the touched ones.
+        // Only the root section has several top-level keys. It comes first.
+        std::vector<parsed_section> shared;
+        shared.reserve(entries.size());
+        bool updated = true;
+        while(updated)
+        {
+            updated = false;
+            for(auto& e : entries)
+            {
+                if(e.parsed) {continue;}
+                const bool is_touched = std::any_of(
+                    e.info.top_level.begin(), e.info.top_level.end(),
+                    [&touched](const key& k) {return touched.count(k) != 0;});
+                if(is_touched)
+                {
+                    touched.insert(e.info.top_level.begin(), e.info.top_level.end());
+                    loc.reset(std::next(loc.begin(), static_cast<std::ptrdiff_t>(e.info.first)));
+                    shared.push_back(parse_section(loc, std::addressof(e) == std::addressof(entries.front())));
+                    e.parsed = std::addressof(shared.back());
+                    updated  = true;
+                }
+            }
+        }
+
+        table_type rebuilt;
+        std::size_t reparsed = 0;
+        for(auto& e : entries)
+        {
+            if(e.parsed)
+            {
+                insert_section(rebuilt, *e.parsed);
+                ++reparsed;
+            }
+        }
+
+        // --------------------------------------------------------------------
+        // nothing throws syntax_error after here.
+
+        if(first_affected == 0)
+        {
+            file_comments_ = fresh.front().comments;
+        }
+
+        // keep the order of top-level keys in the same way as toml::parse.
+        table_type data;
+        if(root_.is_table())
+        {
+            auto& prev = root_.as_table(std::nothrow);
+            detail::source_rebinder rebinder(loc, source_, edit_last, removed, inserted);
+            for(auto& e : entries)
+            {
+                for(const auto& k : e.info.top_level)
+                {
+                    if(data.count(k) != 0) {continue;}
+                    auto& from = (touched.count(k) != 0) ? rebuilt : prev;
+                    const auto found = from.find(k);
+                    if(found == from.end()) {continue;}
+                    if(!e.parsed) {rebinder.rebind(found->second);}
+                    data.insert(std::make_pair(k, std::move(found->second)));
+                }
+            }
+        }
+        else
+        {
+            data = std::move(rebuilt);
+        }
+
+        std::vector<section> infos;
+        infos.reserve(entries.size());
+        for(auto& e : entries)
+        {
+            infos.push_back(std::move(e.info));
+        }
+
+        const auto root_last = (start == loc.end()) ? start : std::next(start);
+        root_ = detail::finish_parse(value_type(std::move(data),
+                    detail::region(loc, start, root_last), file_comments_));
+        source_   = loc.source();
+        sections_ = std::move(infos);
+        reparsed_ = reparsed;
+        return;
+    }
+
+  private:
+    std::string                 fname_;
+    std::size_t                 size_;     // excluding the appended newline
+    detail::region::source_ptr  source_;
+    std::vector<section>        sections_;
+    std::vector<std::string>    file_comments_;
+    value_type                  root_;
+    std::size_t                 reparsed_;
+};
+
+using incremental_document = basic_incremental_document<>;
+
+} // toml
+#endif// TOML11_INCREMENTAL_HPP
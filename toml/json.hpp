@@ -0,0 +1,1098 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_JSON_HPP
+#define TOML11_JSON_HPP
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#include <locale.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+#include <xlocale.h>
+#elif defined(__linux__)
+#include <locale.h>
+#endif
+
+#include "parser.hpp"
+#include "value.hpp"
+
+namespace toml
+{
+
+enum class json_format : std::uint8_t
+{
+    // tables and arrays become objects and arrays, and the other values become
+    // JSON values. Datetimes become strings. NaN and infinity become null.
+    plain = 0,
+    // the encoding of toml-test. The other values become objects like
+    // `{"type":"integer","value":"42"}` and keep their TOML types.
+    typed = 1
+};
+
+struct json_options
+{
+    json_format format = json_format::plain;
+};
+
+namespace detail
+{
+
+// sets the numeric locale of the current thread to "C" while it is alive, so
+// that floats are written and read with `.`. See also toml::serializer.
+class c_numeric_locale
+{
+  public:
+    c_numeric_locale()
+    {
+#if defined(_WIN32)
+        _configthreadlocale(_ENABLE_PER_THREAD_LOCALE);
+        original_ = setlocale(LC_NUMERIC, nullptr);
+        setlocale(LC_NUMERIC, "C");
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__linux__)
+        c_locale_ = newlocale(LC_NUMERIC_MASK, "C", locale_t(0));
+        if(c_locale_ != locale_t(0))
+        {
+            original_ = uselocale(c_locale_);
+        }
+#endif
+    }
+    ~c_numeric_locale()
+    {
+#if defined(_WIN32)
+        setlocale(LC_NUMERIC, original_.c_str());
+        _configthreadlocale(_DISABLE_PER_THREAD_LOCALE);
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__linux__)
+        if(c_locale_ != locale_t(0))
+        {
+            uselocale(original_);
+            freelocale(c_locale_);
+        }
+#endif
+    }
+    c_numeric_locale(const c_numeric_locale&) = delete;
+    c_numeric_locale& operator=(const c_numeric_locale&) = delete;
+
+  private:
+#if defined(_WIN32)
+    std::string original_;
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__linux__)
+    locale_t c_locale_ = locale_t(0);
+    locale_t original_ = locale_t(0);
+#endif
+};
+
+// a sink is a function that takes (const char*, std::size_t).
+template<typename Sink>
+struct is_json_sink
+{
+    template<typename S>
+    static std::true_type check(decltype(std::declval<S&>()(
+        std::declval<const char*>(), std::declval<std::size_t>()))*);
+    template<typename S>
+    static std::false_type check(...);
+
+    static constexpr bool value = decltype(check<Sink>(nullptr))::value;
+};
+
+struct json_ostream_sink
+{
+    void operator()(const char* p, const std::size_t n)
+    {
+        os.write(p, static_cast<std::streamsize>(n));
+    }
+    std::ostream& os;
+};
+struct json_string_sink
+{
+    void operator()(const char* p, const std::size_t n)
+    {
+        str.append(p, n);
+    }
+    std::string& str;
+};
+
+// writes a value as JSON into a fixed-size buffer and passes the buffer to
+// the sink when it is full.
+template<typename Value, typename Sink>
+class json_writer
+{
+  public:
+    json_writer(Sink& sink, const json_options& opts)
+        : sink_(sink), typed_(opts.format == json_format::typed), size_(0)
+    {}
+    ~json_writer() = default;
+    json_writer(const json_writer&) = delete;
+    json_writer& operator=(const json_writer&) = delete;
+
+    void write(const Value& v)
+    {
+        switch(v.type())
+        {
+            case value_t::boolean:
+            {
+                this->write_boolean(v.as_boolean(std::nothrow));
+                break;
+            }
+            case value_t::integer:
+            {
+                this->write_integer(v.as_integer(std::nothrow));
+                break;
+            }
+            case value_t::floating:
+            {
+                this->put_floating(v.as_floating(std::nothrow));
+                break;
+            }
+            case value_t::string:
+            {
+                if(typed_) {this->put("{\"type\":\"string\",\"value\":");}
+                this->put_string(v.as_string(std::nothrow).str);
+                if(typed_) {this->put('}');}
+                break;
+            }
+            case value_t::offset_datetime:
+            {
+                const auto& dt = v.as_offset_datetime(std::nothrow);
+                this->open_datetime("datetime");
+                this->put_date(dt.date);
+                this->put('T');
+                this->put_time(dt.time);
+                this->put_offset(dt.offset);
+                this->close_datetime();
+                break;
+            }
+            case value_t::local_datetime:
+            {
+                const auto& dt = v.as_local_datetime(std::nothrow);
+                this->open_datetime("datetime-local");
+                this->put_date(dt.date);
+                this->put('T');
+                this->put_time(dt.time);
+                this->close_datetime();
+                break;
+            }
+            case value_t::local_date:
+            {
+                this->open_datetime("date-local");
+                this->put_date(v.as_local_date(std::nothrow));
+                this->close_datetime();
+                break;
+            }
+            case value_t::local_time:
+            {
+                this->open_datetime("time-local");
+                this->put_time(v.as_local_time(std::nothrow));
+                this->close_datetime();
+                break;
+            }
+            case value_t::array:
+            {
+                if(const auto packed = get_packed_array(v))
+                {
+                    this->write_packed(*packed);
+                    break;
+                }
+                this->put('[');
+                bool is_first = true;
+                for(const auto& elem : v.as_array(std::nothrow))
+                {
+                    if(!is_first) {this->put(',');}
+                    is_first = false;
+                    this->write(elem);
+                }
+                this->put(']');
+                break;
+            }
+            case value_t::table:
+            {
+                this->put('{');
+                bool is_first = true;
+                for(const auto& kv : v.as_table(std::nothrow))
+                {
+                    if(!is_first) {this->put(',');}
+                    is_first = false;
+                    this->put_string(kv.first);
+                    this->put(':');
+                    this->write(kv.second);
+                }
+                this->put('}');
+                break;
+            }
+            default:
+            {
+                // an empty value has no JSON representation.
+                this->put("null");
+                break;
+            }
+        }
+        return;
+    }
+
+    void flush()
+    {
+        if(size_ != 0)
+        {
+            sink_(buffer_, size_);
+            size_ = 0;
+        }
+        return;
+    }
+
+  private:
+
+    void write_boolean(const bool b)
+    {
+        if(typed_) {this->put_typed("bool", b ? "true" : "false");}
+        else       {this->put(b ? "true" : "false");}
+        return;
+    }
+    void write_integer(const std::int64_t i)
+    {
+        if(typed_) {this->put("{\"type\":\"integer\",\"value\":\"");}
+        this->put_integer(i);
+        if(typed_) {this->put("\"}");}
+        return;
+    }
+
+    // writes the elements of a packed array without unpacking it.
+    void write_packed(const packed_array& packed)
+    {
+        this->put('[');
+        for(std::size_t i=0; i<packed.size(); ++i)
+        {
+            if(i != 0) {this->put(',');}
+            switch(packed.kind())
+            {
+                case value_t::integer : {this->write_integer(packed.integers()[i]);  break;}
+                case value_t::floating: {this->put_floating (packed.floatings()[i]); break;}
+                default               : {this->write_boolean(packed.booleans()[i]);  break;}
+            }
+        }
+        this->put(']');
+        return;
+    }
+
+    void put(const char c)
+    {
+        if(size_ == sizeof(buffer_)) {this->flush();}
+        buffer_[size_++] = c;
+        return;
+    }
+    void put(const char* p, std::size_t n)
+    {
+        if(sizeof(buffer_) - size_ < n)
+        {
+            this->flush();
+            if(sizeof(buffer_) < n)
+            {
+                sink_(p, n);
+                return;
+            }
+        }
+        std::memcpy(buffer_ + size_, p, n);
+        size_ += n;
+        return;
+    }
+    void put(const char* s)
+    {
+        this->put(s, std::strlen(s));
+    }
+
+    void put_typed(const char* type, const char* value)
+    {
+        this->put("{\"type\":\"");
+        this->put(type);
+        this->put("\",\"value\":\"");
+        this->put(value);
+        this->put("\"}");
+        return;
+    }
+
+    void put_integer(const std::int64_t i)
+    {
+        char buf[24];
+        std::size_t pos = sizeof(buf);
+        // -INT64_MIN overflows, so negate it as an unsigned value.
+        std::uint64_t u = (i < 0) ? (~static_cast<std::uint64_t>(i) + 1u) :
+                                    static_cast<std::uint64_t>(i);
+        do
+        {
+            buf[--pos] = static_cast<char>('0' + u % 10u);
+            u /= 10u;
+        }
+        while(u != 0);
+        if(i < 0) {buf[--pos] = '-';}
+        this->put(buf + pos, sizeof(buf) - pos);
+        return;
+    }
+
+    void put_floating(double f)
+    {
+        if(std::isnan(f) || std::isinf(f))
+        {
+            if(!typed_)
+            {
+                this->put("null");
+                return;
+            }
+            // toml-test does not distinguish -nan from nan.
+            const char* str = std::isnan(f) ? "nan" : (std::signbit(f) ? "-inf" : "inf");
+            this->put_typed("float", str);
+            return;
+        }
+
+        // use the shortest one that is read as the same value.
+        char buf[32];
+        int n = std::snprintf(buf, sizeof(buf), "%.15g", f);
+        if(std::strtod(buf, nullptr) != f)
+        {
+            n = std::snprintf(buf, sizeof(buf), "%.17g", f);
+        }
+        auto len = static_cast<std::size_t>(n);
+        if(std::strpbrk(buf, ".eE") == nullptr)
+        {
+            // keep it a float when it is read again. 1 => 1.0
+            buf[len++] = '.';
+            buf[len++] = '0';
+        }
+        if(typed_) {this->put("{\"type\":\"float\",\"value\":\"");}
+        this->put(buf, len);
+        if(typed_) {this->put("\"}");}
+        return;
+    }
+
+    void put_string(const std::string& s)
+    {
+        static constexpr char hex[] = "0123456789abcdef";
+
+        this->put('"');
+        const char* p    = s.data();
+        const char* last = s.data() + s.size();
+        const char* run  = p; // the beginning of the characters that need no escape
+        for(; p != last; ++p)
+        {
+            const auto c = static_cast<unsigned char>(*p);
+            if(c >= 0x20 && c != '"' && c != '\\')
+            {
+                continue;
+            }
+            this->put(run, static_cast<std::size_t>(p - run));
+            run = p + 1;
+            switch(c)
+            {
+                case '"' : {this->put("\\\"", 2); break;}
+                case '\\': {this->put("\\\\", 2); break;}
+                case '\b': {this->put("\\b",  2); break;}
+                case '\f': {this->put("\\f",  2); break;}
+                case '\n': {this->put("\\n",  2); break;}
+                case '\r': {this->put("\\r",  2); break;}
+                case '\t': {this->put("\\t",  2); break;}
+                default:
+                {
+                    const char esc[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                    this->put(esc, sizeof(esc));
+                    break;
+                }
+            }
+        }
+        this->put(run, static_cast<std::size_t>(p - run));
+        this->put('"');
+        return;
+    }
+
+    void put_digits(unsigned int v, const std::size_t width)
+    {
+        char buf[8];
+        for(std::size_t i=width; 0 < i; --i)
+        {
+            buf[i-1] = static_cast<char>('0' + v % 10u);
+            v /= 10u;
+        }
+        this->put(buf, width);
+        return;
+    }
+    void put_date(const local_date& d)
+    {
+        this->put_digits(static_cast<unsigned int>(d.year), 4);
+        this->put('-');
+        this->put_digits(d.month + 1u, 2);
+        this->put('-');
+        this->put_digits(d.day, 2);
+        return;
+    }
+    void put_time(const local_time& t)
+    {
+        this->put_digits(t.hour, 2);
+        this->put(':');
+        this->put_digits(t.minute, 2);
+        this->put(':');
+        this->put_digits(t.second, 2);
+        if(t.millisecond != 0 || t.microsecond != 0 || t.nanosecond != 0)
+        {
+            this->put('.');
+            this->put_digits(t.millisecond, 3);
+            if(t.microsecond != 0 || t.nanosecond != 0)
+            {
+                this->put_digits(t.microsecond, 3);
+                if(t.nanosecond != 0)
+                {
+                    this->put_digits(t.nanosecond, 3);
+                }
+            }
+        }
+        return;
+    }
+    void put_offset(const time_offset& o)
+    {
+        int minute = o.hour * 60 + o.minute;
+        if(minute == 0)
+        {
+            this->put('Z');
+            return;
+        }
+        if(minute < 0) {this->put('-'); minute = -minute;}
+        else           {this->put('+');}
+        this->put_digits(static_cast<unsigned int>(minute / 60), 2);
+        this->put(':');
+        this->put_digits(static_cast<unsigned int>(minute % 60), 2);
+        return;
+    }
+    void open_datetime(const char* type)
+    {
+        if(typed_)
+        {
+            this->put("{\"type\":\"");
+            this->put(type);
+            this->put("\",\"value\":\"");
+        }
+        else
+        {
+            this->put('"');
+        }
+        return;
+    }
+    void close_datetime()
+    {
+        this->put(typed_ ? "\"}" : "\"");
+        return;
+    }
+
+  private:
+    Sink&       sink_;
+    bool        typed_;
+    std::size_t size_;
+    char        buffer_[4096];
+};
+
+// reads JSON and builds a value.
+template<typename Value>
+class json_reader
+{
+  public:
+    using value_type = Value;
+    using array_type = typename value_type::array_type;
+    using table_type = typename value_type::table_type;
+
+    json_reader(const std::string& content, const json_options& opts)
+        : first_(content.data()), cur_(content.data()),
+          last_(content.data() + content.size()),
+          typed_(opts.format == json_format::typed)
+    {}
+
+    value_type read()
+    {
+        this->skip_ws();
+        value_type v = this->read_value(0);
+        this->skip_ws();
+        if(cur_ != last_)
+        {
+            this->error("unexpected character after the value", "expected the end of input");
+        }
+        return v;
+    }
+
+  private:
+
+    value_type read_value(const std::size_t n_rec)
+    {
+        if(n_rec > TOML11_VALUE_RECURSION_LIMIT)
+        {
+            this->error("recursion limit (" TOML11_STRINGIZE(TOML11_VALUE_RECURSION_LIMIT)
+                        ") exceeded", "here");
+        }
+        if(cur_ == last_)
+        {
+            this->error("unexpected end of input", "expected a value");
+        }
+        switch(*cur_)
+        {
+            case '{': {return this->read_object(n_rec);}
+            case '[': {return this->read_array(n_rec);}
+            case '"': {return value_type(this->read_string());}
+            case 't': {this->read_literal("true");  return value_type(true);}
+            case 'f': {this->read_literal("false"); return value_type(false);}
+            case 'n':
+            {
+                this->error("null cannot be converted to TOML", "null found");
+            }
+            default : {return this->read_number();}
+        }
+    }
+
+    value_type read_object(const std::size_t n_rec)
+    {
+        if(typed_)
+        {
+            value_type scalar;
+            if(this->read_typed(scalar))
+            {
+                return scalar;
+            }
+        }
+
+        ++cur_; // {
+        value_type v(table_type{});
+        auto& tab = v.as_table();
+
+        this->skip_ws();
+        if(cur_ != last_ && *cur_ == '}')
+        {
+            ++cur_;
+            return v;
+        }
+        while(true)
+        {
+            this->skip_ws();
+            if(cur_ == last_ || *cur_ != '"')
+            {
+                this->error("invalid object", "expected a string key");
+            }
+            const char* key_pos = cur_;
+            auto k = this->read_string();
+            this->skip_ws();
+            this->expect(':');
+            this->skip_ws();
+            auto elem = this->read_value(n_rec + 1);
+            if(!tab.emplace(std::move(k), std::move(elem)).second)
+            {
+                cur_ = key_pos;
+                this->error("duplicate key in an object", "the key is already defined");
+            }
+            this->skip_ws();
+            if(cur_ != last_ && *cur_ == ',')
+            {
+                ++cur_;
+                continue;
+            }
+            this->expect('}');
+            break;
+        }
+        return v;
+    }
+
+    value_type read_array(const std::size_t n_rec)
+    {
+        ++cur_; // [
+        value_type v(array_type{});
+
+        this->skip_ws();
+        if(cur_ != last_ && *cur_ == ']')
+        {
+            ++cur_;
+            return v;
+        }
+
+        // The elements are pushed to a stack shared by all the arrays, and
+        // then moved to the array at once. It avoids reallocating each array.
+        const std::size_t first = elements_.size();
+        while(true)
+        {
+            this->skip_ws();
+            elements_.push_back(this->read_value(n_rec + 1));
+            this->skip_ws();
+            if(cur_ != last_ && *cur_ == ',')
+            {
+                ++cur_;
+                continue;
+            }
+            this->expect(']');
+            break;
+        }
+
+        auto& ary = v.as_array();
+        ary.reserve(elements_.size() - first);
+        for(std::size_t i=first; i<elements_.size(); ++i)
+        {
+            ary.push_back(std::move(elements_[i]));
+        }
+        elements_.erase(std::next(elements_.begin(), static_cast<std::ptrdiff_t>(first)),
+                        elements_.end());
+        return v;
+    }
+
+    std::string read_string()
+    {
+        ++cur_; // "
+        std::string str;
+        while(true)
+        {
+            const char* run = cur_;
+            while(cur_ != last_ && *cur_ != '"' && *cur_ != '\\' &&
+                  0x20 <= static_cast<unsigned char>(*cur_))
+            {
+                ++cur_;
+            }
+            str.append(run, cur_);
+
+            if(cur_ == last_)
+            {
+                this->error("unterminated string", "expected `\"`");
+            }
+            if(*cur_ == '"')
+            {
+                ++cur_;
+                return str;
+            }
+            if(*cur_ != '\\')
+            {
+                this->error("control character in a string", "it should be escaped");
+            }
+            ++cur_; // backslash
+            if(cur_ == last_)
+            {
+                this->error("unterminated string", "expected an escape sequence");
+            }
+            switch(*cur_)
+            {
+                case '"' : {str += '"';  ++cur_; break;}
+                case '\\': {str += '\\'; ++cur_; break;}
+                case '/' : {str += '/';  ++cur_; break;}
+                case 'b' : {str += '\b'; ++cur_; break;}
+                case 'f' : {str += '\f'; ++cur_; break;}
+                case 'n' : {str += '\n'; ++cur_; break;}
+                case 'r' : {str += '\r'; ++cur_; break;}
+                case 't' : {str += '\t'; ++cur_; break;}
+                case 'u' :
+                {
+                    ++cur_;
+                    std::uint_least32_t cp = this->read_hex4();
+                    if(0xD800 <= cp && cp <= 0xDBFF)
+                    {
+                        // a surrogate pair
+                        if(last_ - cur_ < 2 || cur_[0] != '\\' || cur_[1] != 'u')
+                        {
+                            this->error("invalid surrogate pair", "expected a low surrogate");
+                        }
+                        cur_ += 2;
+                        const auto low = this->read_hex4();
+                        if(low < 0xDC00 || 0xDFFF < low)
+                        {
+                            this->error("invalid surrogate pair", "expected a low surrogate");
+                        }
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    else if(0xDC00 <= cp && cp <= 0xDFFF)
+                    {
+                        this->error("invalid surrogate pair", "unexpected low surrogate");
+                    }
+                    this->append_utf8(str, cp);
+                    break;
+                }
+                default:
+                {
+                    this->error("invalid escape sequence", "here");
+                }
+            }
+        }
+    }
+
+    std::uint_least32_t read_hex4()
+    {
+        std::uint_least32_t cp = 0;
+        for(int i=0; i<4; ++i)
+        {
+            if(cur_ == last_)
+            {
+                this->error("invalid escape sequence", "expected 4 hex digits");
+            }
+            const char c = *cur_;
+            std::uint_least32_t d = 0;
+            if     ('0' <= c && c <= '9') {d = static_cast<std::uint_least32_t>(c - '0');}
+            else if('a' <= c && c <= 'f') {d = static_cast<std::uint_least32_t>(c - 'a' + 10);}
+            else if('A' <= c && c <= 'F') {d = static_cast<std::uint_least32_t>(c - 'A' + 10);}
+            else
+            {
+                this->error("invalid escape sequence", "expected 4 hex digits");
+            }
+            cp = cp * 16 + d;
+            ++cur_;
+        }
+        return cp;
+    }
+
+    static void append_utf8(std::string& str, const std::uint_least32_t cp)
+    {
+        const auto to_char = [](const std::uint_least32_t i) noexcept -> char {
+            const auto uc = static_cast<unsigned char>(i);
+            return *reinterpret_cast<const char*>(std::addressof(uc));
+        };
+        if(cp < 0x80)
+        {
+            str += to_char(cp);
+        }
+        else if(cp < 0x800)
+        {
+            str += to_char(0xC0 | (cp >> 6));
+            str += to_char(0x80 | (cp & 0x3F));
+        }
+        else if(cp < 0x10000)
+        {
+            str += to_char(0xE0 | (cp >> 12));
+            str += to_char(0x80 | ((cp >> 6) & 0x3F));
+            str += to_char(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+            str += to_char(0xF0 | (cp >> 18));
+            str += to_char(0x80 | ((cp >> 12) & 0x3F));
+            str += to_char(0x80 | ((cp >> 6) & 0x3F));
+            str += to_char(0x80 | (cp & 0x3F));
+        }
+        return;
+    }
+
+    void read_literal(const char* lit)
+    {
+        const auto len = std::strlen(lit);
+        if(static_cast<std::size_t>(last_ - cur_) < len ||
+           std::memcmp(cur_, lit, len) != 0)
+        {
+            this->error("invalid literal", concat_to_string("expected `", lit, "`"));
+        }
+        cur_ += len;
+        return;
+    }
+
+    value_type read_number()
+    {
+        const char* first = cur_;
+        bool is_float = false;
+
+        if(cur_ != last_ && *cur_ == '-') {++cur_;}
+        if(cur_ == last_ || !is_digit(*cur_))
+        {
+            this->error("invalid value", "expected a value");
+        }
+        if(*cur_ == '0') {++cur_;}
+        else             {this->skip_digits();}
+
+        if(cur_ != last_ && *cur_ == '.')
+        {
+            is_float = true;
+            ++cur_;
+            if(cur_ == last_ || !is_digit(*cur_))
+            {
+                this->error("invalid number", "expected a digit after `.`");
+            }
+            this->skip_digits();
+        }
+        if(cur_ != last_ && (*cur_ == 'e' || *cur_ == 'E'))
+        {
+            is_float = true;
+            ++cur_;
+            if(cur_ != last_ && (*cur_ == '+' || *cur_ == '-')) {++cur_;}
+            if(cur_ == last_ || !is_digit(*cur_))
+            {
+                this->error("invalid number", "expected a digit in the exponent");
+            }
+            this->skip_digits();
+        }
+
+        if(!is_float)
+        {
+            std::int64_t i = 0;
+            if(read_integer(first, cur_, i))
+            {
+                return value_type(i);
+            }
+            // it does not fit in toml::integer.
+        }
+        return value_type(read_floating(std::string(first, cur_)));
+    }
+
+    static bool is_digit(const char c) noexcept {return '0' <= c && c <= '9';}
+
+    void skip_digits() noexcept
+    {
+        while(cur_ != last_ && is_digit(*cur_)) {++cur_;}
+        return;
+    }
+
+    // decimal digits with an optional sign. returns false if it overflows.
+    static bool read_integer(const char* first, const char* last, std::int64_t& i) noexcept
+    {
+        bool neg = false;
+        if(first != last && (*first == '-' || *first == '+'))
+        {
+            neg = (*first == '-');
+            ++first;
+        }
+        if(first == last) {return false;}
+
+        const std::uint64_t limit = neg ?
+            static_cast<std::uint64_t>((std::numeric_limits<std::int64_t>::max)()) + 1u :
+            static_cast<std::uint64_t>((std::numeric_limits<std::int64_t>::max)());
+        std::uint64_t u = 0;
+        for(; first != last; ++first)
+        {
+            if(!is_digit(*first)) {return false;}
+            const auto d = static_cast<std::uint64_t>(*first - '0');
+            if(u > (limit - d) / 10u) {return false;}
+            u = u * 10u + d;
+        }
+        i = neg ? static_cast<std::int64_t>(~u + 1u) : static_cast<std::int64_t>(u);
+        return true;
+    }
+
+    static double read_floating(const std::string& token)
+    {
+        return std::strtod(token.c_str(), nullptr);
+    }
+
+    // reads an object like {"type": "integer", "value": "42"} in the toml-test
+    // encoding without building a table. If the object is not like that, it
+    // returns false and does not consume the input.
+    bool read_typed(value_type& v)
+    {
+        const char* open = cur_;
+        ++cur_; // {
+
+        std::string type, str;
+        bool has_type = false, has_value = false;
+        for(int i=0; i<2; ++i)
+        {
+            this->skip_ws();
+            if(cur_ == last_ || *cur_ != '"') {cur_ = open; return false;}
+            const auto k = this->read_string();
+            this->skip_ws();
+            if(cur_ == last_ || *cur_ != ':') {cur_ = open; return false;}
+            ++cur_;
+            this->skip_ws();
+            if(cur_ == last_ || *cur_ != '"') {cur_ = open; return false;}
+
+            if     (!has_type  && k == "type" ) {type = this->read_string(); has_type  = true;}
+            else if(!has_value && k == "value") {str  = this->read_string(); has_value = true;}
+            else {cur_ = open; return false;}
+
+            this->skip_ws();
+            const char delim = (i == 0) ? ',' : '}';
+            if(cur_ == last_ || *cur_ != delim) {cur_ = open; return false;}
+            ++cur_;
+        }
+
+        if(type == "string")
+        {
+            v = value_type(std::move(str));
+            return true;
+        }
+        if(type == "bool")
+        {
+            if(str == "true")  {v = value_type(true);  return true;}
+            if(str == "false") {v = value_type(false); return true;}
+        }
+        else if(type == "integer")
+        {
+            std::int64_t i = 0;
+            if(read_integer(str.data(), str.data() + str.size(), i))
+            {
+                v = value_type(i);
+                return true;
+            }
+        }
+        else if(type == "float")
+        {
+            if(str == "nan" || str == "+nan" || str == "-nan")
+            {
+                v = value_type(std::numeric_limits<floating>::quiet_NaN());
+                return true;
+            }
+            if(str == "inf" || str == "+inf")
+            {
+                v = value_type(std::numeric_limits<floating>::infinity());
+                return true;
+            }
+            if(str == "-inf")
+            {
+                v = value_type(-std::numeric_limits<floating>::infinity());
+                return true;
+            }
+            char* end = nullptr;
+            const double f = std::strtod(str.c_str(), std::addressof(end));
+            if(!str.empty() && end == str.c_str() + str.size())
+            {
+                v = value_type(f);
+                return true;
+            }
+        }
+        else if(type == "datetime")
+        {
+            location loc("toml::from_json", str);
+            const auto dt = parse_offset_datetime(loc);
+            if(dt && loc.iter() == loc.end()) {v = value_type(dt.unwrap().first); return true;}
+        }
+        else if(type == "datetime-local")
+        {
+            location loc("toml::from_json", str);
+            const auto dt = parse_local_datetime(loc);
+            if(dt && loc.iter() == loc.end()) {v = value_type(dt.unwrap().first); return true;}
+        }
+        else if(type == "date-local")
+        {
+            location loc("toml::from_json", str);
+            const auto dt = parse_local_date(loc);
+            if(dt && loc.iter() == loc.end()) {v = value_type(dt.unwrap().first); return true;}
+        }
+        else if(type == "time-local")
+        {
+            location loc("toml::from_json", str);
+            const auto dt = parse_local_time(loc);
+            if(dt && loc.iter() == loc.end()) {v = value_type(dt.unwrap().first); return true;}
+        }
+        else
+        {
+            // a table that happens to have "type" and "value".
+            cur_ = open;
+            return false;
+        }
+        cur_ = open;
+        this->error(concat_to_string("invalid value for type \"", type, "\": \"", str, "\""),
+                    "in this object");
+    }
+
+    void skip_ws() noexcept
+    {
+        while(cur_ != last_ &&
+              (*cur_ == ' ' || *cur_ == '\t' || *cur_ == '\n' || *cur_ == '\r'))
+        {
+            ++cur_;
+        }
+        return;
+    }
+
+    void expect(const char c)
+    {
+        if(cur_ == last_ || *cur_ != c)
+        {
+            this->error("unexpected character", concat_to_string("expected `", c, "`"));
+        }
+        ++cur_;
+        return;
+    }
+
+    [[noreturn]] void error(const std::string& msg, const std::string& hint) const
+    {
+        location loc("toml::from_json", std::string(first_, last_));
+        loc.advance(cur_ - first_);
+        throw syntax_error(format_underline(concat_to_string("toml::from_json: ", msg),
+            {{source_location(loc), hint}}), source_location(loc));
+    }
+
+  private:
+    const char* first_;
+    const char* cur_;
+    const char* last_;
+    bool        typed_;
+    std::vector<value_type> elements_;
+};
+
+} // detail
+
+// Writes a value as JSON. It does not build the whole JSON string, but
+// passes the output to `sink` in chunks. `sink` is called as
+// `sink(const char* ptr, std::size_t len)`.
+//
+// Keys are written in the order of iteration of the table type. Comments
+// and locations are not written.
+//
+// ```cpp
+// const auto data = toml::parse("large.toml");
+// toml::to_json(data, std::cout);
+//
+// toml::json_options opts;
+// opts.format = toml::json_format::typed; // for toml-test
+// toml::to_json(data, [&](const char* p, std::size_t n) {fwrite(p, 1, n, fp);}, opts);
+// ```
+template<typename C, template<typename ...> class T, template<typename ...> class A,
+         typename Sink, typename std::enable_if<
+            detail::is_json_sink<Sink>::value, std::nullptr_t>::type = nullptr>
+void to_json(const basic_value<C, T, A>& v, Sink&& sink,
+             const json_options& opts = json_options{})
+{
+    using sink_type = typename std::remove_reference<Sink>::type;
+    const detail::c_numeric_locale locale_guard;
+    detail::json_writer<basic_value<C, T, A>, sink_type> writer(sink, opts);
+    writer.write(v);
+    writer.flush();
+    return;
+}
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+void to_json(const basic_value<C, T, A>& v, std::ostream& os,
+             const json_options& opts = json_options{})
+{
+    detail::json_ostream_sink sink{os};
+    ::toml::to_json(v, sink, opts);
+    return;
+}
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+std::string to_json(const basic_value<C, T, A>& v,
+                    const json_options& opts = json_options{})
+{
+    std::string str;
+    detail::json_string_sink sink{str};
+    ::toml::to_json(v, sink, opts);
+    return str;
+}
+
+// Reads JSON and builds a value. It throws toml::syntax_error if the input is
+// not valid JSON or has a value that cannot be represented in TOML, e.g. null.
+//
+// In json_format::plain, a number becomes an integer if it does not have a
+// fraction or an exponent and fits in toml::integer, otherwise a floating.
+// In json_format::typed, objects like `{"type":"integer","value":"42"}`
+// become values of that type.
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+basic_value<Comment, Table, Array>
+from_json(const std::string& content, const json_options& opts = json_options{})
+{
+    const detail::c_numeric_locale locale_guard;
+    detail::json_reader<basic_value<Comment, Table, Array>> reader(content, opts);
+    return detail::finish_parse(reader.read());
+}
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+basic_value<Comment, Table, Array>
+from_json(std::istream& is, const json_options& opts = json_options{})
+{
+    const std::string content{std::istreambuf_iterator<char>(is),
+                              std::istreambuf_iterator<char>()};
+    return ::toml::from_json<Comment, Table, Array>(content, opts);
+}
+
+} // toml
+#endif// TOML11_JSON_HPP
@@ -0,0 +1,308 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_KEY_PATH_HPP
+#define TOML11_KEY_PATH_HPP
+#include <cstdint>
+
+#include <initializer_list>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "get.hpp"
+#include "parser.hpp"
+#include "serializer.hpp"
+
+namespace toml
+{
+
+// A sequence of keys and indices that points a value in a document.
+//
+// It is parsed once, and then used to look up the same value in many documents
+// without parsing and copying the keys every time.
+//
+// ```cpp
+// const auto port = toml::key_path::parse("server.listeners[2].port");
+// // or, equivalently, from the components
+// const toml::key_path port{"server", "listeners", 2, "port"};
+//
+// const auto p = toml::find<int>(data, port);
+// ```
+//
+// The components are not parsed, so `toml::key_path{"a.b"}` is a single key
+// "a.b". Use `key_path::parse` to split a dotted path.
+class key_path
+{
+  public:
+
+    // a key in a table, or an index in an array.
+    class segment
+    {
+      public:
+
+        segment(key k): key_(std::move(k)), index_(0), is_index_(false) {}
+        segment(const char* k): key_(k), index_(0), is_index_(false) {}
+
+        template<typename Integer, typename std::enable_if<
+            std::is_integral<Integer>::value, std::nullptr_t>::type = nullptr>
+        segment(const Integer idx)
+            : key_(), index_(static_cast<std::size_t>(idx)), is_index_(true)
+        {}
+
+        bool is_index() const noexcept {return is_index_;}
+        bool is_key()   const noexcept {return !is_index_;}
+
+        key const&  as_key()   const noexcept {return key_;}
+        std::size_t as_index() const noexcept {return index_;}
+
+      private:
+        key         key_;
+        std::size_t index_;
+        bool        is_index_;
+    };
+
+  public:
+
+    key_path() = default;
+    ~key_path() = default;
+    key_path(const key_path&) = default;
+    key_path(key_path&&)      = default;
+    key_path& operator=(const key_path&) = default;
+    key_path& operator=(key_path&&)      = default;
+
+    key_path(std::initializer_list<segment> segs)
+        : segments_(segs)
+    {}
+    explicit key_path(std::vector<segment> segs)
+        : segments_(std::move(segs))
+    {}
+
+    // parses a dotted path with array indices, e.g. `a."b.c"[2]`.
+    // throws syntax_error if the path is invalid.
+    static key_path parse(const std::string& path)
+    {
+        return key_path(parse_path(path));
+    }
+
+    std::vector<segment> const& segments() const noexcept {return segments_;}
+    bool        empty() const noexcept {return segments_.empty();}
+    std::size_t size()  const noexcept {return segments_.size();}
+
+    std::string str() const
+    {
+        std::string retval;
+        for(const auto& seg : segments_)
+        {
+            if(seg.is_index())
+            {
+                retval += '[';
+                retval += std::to_string(seg.as_index());
+                retval += ']';
+            }
+            else
+            {
+                if(!retval.empty()) {retval += '.';}
+                retval += format_key(seg.as_key());
+            }
+        }
+        return retval;
+    }
+
+    // returns nullptr if the path does not exist in the value.
+    template<typename Value>
+    Value const* lookup(const Value& root) const
+    {
+        const Value* current = std::addressof(root);
+        for(const auto& seg : segments_)
+        {
+            if(seg.is_index())
+            {
+                if(!current->is_array()) {return nullptr;}
+                const auto& ary = current->as_array(std::nothrow);
+                if(ary.size() <= seg.as_index()) {return nullptr;}
+                current = std::addressof(ary[seg.as_index()]);
+            }
+            else
+            {
+                if(!current->is_table()) {return nullptr;}
+                current = detail::find_mapped(current->as_table(std::nothrow), seg.as_key());
+                if(!current) {return nullptr;}
+            }
+        }
+        return current;
+    }
+
+    // Same as `lookup(root)`, but remembers the result. The next call with the
+    // same root and generation returns it without looking up the keys.
+    //
+    // The caller increments the generation whenever the document is modified,
+    // because a modification may invalidate the remembered pointer. This
+    // function modifies the path object, so do not share it between threads.
+    template<typename Value>
+    Value const* lookup(const Value& root, const std::uint64_t generation)
+    {
+        if(cache_.root == std::addressof(root) && cache_.generation == generation)
+        {
+            return static_cast<Value const*>(cache_.node);
+        }
+        const Value* node  = this->lookup(root);
+        cache_.root       = std::addressof(root);
+        cache_.generation = generation;
+        cache_.node       = node;
+        return node;
+    }
+
+    // forget the cached result.
+    void clear_cache() noexcept
+    {
+        cache_ = cache_entry{};
+    }
+
+  private:
+
+    static std::vector<segment> parse_path(const std::string& path)
+    {
+        using namespace detail;
+        std::vector<segment> segs;
+        location loc("toml::key_path", path);
+
+        bool expects_key = true;
+        while(loc.iter() != loc.end())
+        {
+            lex_ws::invoke(loc);
+            if(loc.iter() == loc.end()) {break;}
+
+            if(*loc.iter() == '[')
+            {
+                loc.advance();
+                lex_ws::invoke(loc);
+                std::size_t idx = 0;
+                bool has_digit = false;
+                while(loc.iter() != loc.end() && '0' <= *loc.iter() && *loc.iter() <= '9')
+                {
+                    const auto d = static_cast<std::size_t>(*loc.iter() - '0');
+                    if(((std::numeric_limits<std::size_t>::max)() - d) / 10 < idx)
+                    {
+                        throw syntax_error(format_underline(
+                            "toml::key_path: array index is too large",
+                            {{source_location(loc), "overflows std::size_t"}}),
+                            source_location(loc));
+                    }
+                    idx = idx * 10 + d;
+                    has_digit = true;
+                    loc.advance();
+                }
+                lex_ws::invoke(loc);
+                if(!has_digit || loc.iter() == loc.end() || *loc.iter() != ']')
+                {
+                    throw syntax_error(format_underline(
+                        "toml::key_path: invalid array index",
+                        {{source_location(loc), "expected `[` digits `]`"}}),
+                        source_location(loc));
+                }
+                loc.advance();
+                segs.push_back(segment(idx));
+                expects_key = false;
+            }
+            else if(expects_key)
+            {
+                const auto k = parse_simple_key(loc);
+                if(!k)
+                {
+                    throw syntax_error(format_underline(
+                        "toml::key_path: invalid key",
+                        {{source_location(loc), "expected a bare or quoted key"}}),
+                        source_location(loc));
+                }
+                segs.push_back(segment(k.unwrap().first));
+                expects_key = false;
+            }
+            else if(*loc.iter() == '.')
+            {
+                loc.advance();
+                expects_key = true;
+            }
+            else
+            {
+                throw syntax_error(format_underline(
+                    "toml::key_path: invalid character",
+                    {{source_location(loc), "expected `.` or `[`"}}),
+                    source_location(loc));
+            }
+        }
+        if(expects_key && !segs.empty())
+        {
+            throw syntax_error(format_underline(
+                "toml::key_path: the path ends with `.`",
+                {{source_location(loc), "expected a key"}}),
+                source_location(loc));
+        }
+        return segs;
+    }
+
+    struct cache_entry
+    {
+        const void*   root       = nullptr;
+        std::uint64_t generation = 0;
+        const void*   node       = nullptr;
+    };
+
+    std::vector<segment> segments_;
+    cache_entry          cache_;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const key_path& path)
+{
+    os << path.str();
+    return os;
+}
+
+// ----------------------------------------------------------------------------
+// find(value, key_path)
+//
+// It throws the same exceptions as `toml::find(value, key1, key2, ...)`.
+
+template<typename C,
+         template<typename ...> class M, template<typename ...> class V>
+basic_value<C, M, V> const& find(const basic_value<C, M, V>& v, const key_path& path)
+{
+    const basic_value<C, M, V>* current = std::addressof(v);
+    for(const auto& seg : path.segments())
+    {
+        current = seg.is_index() ? std::addressof(::toml::find(*current, seg.as_index())) :
+                                   std::addressof(::toml::find(*current, seg.as_key()));
+    }
+    return *current;
+}
+template<typename C,
+         template<typename ...> class M, template<typename ...> class V>
+basic_value<C, M, V>& find(basic_value<C, M, V>& v, const key_path& path)
+{
+    basic_value<C, M, V>* current = std::addressof(v);
+    for(const auto& seg : path.segments())
+    {
+        current = seg.is_index() ? std::addressof(::toml::find(*current, seg.as_index())) :
+                                   std::addressof(::toml::find(*current, seg.as_key()));
+    }
+    return *current;
+}
+
+template<typename T, typename C,
+         template<typename ...> class M, template<typename ...> class V>
+decltype(::toml::get<T>(std::declval<basic_value<C, M, V> const&>()))
+find(const basic_value<C, M, V>& v, const key_path& path)
+{
+    return ::toml::get<T>(::toml::find(v, path));
+}
+template<typename T, typename C,
+         template<typename ...> class M, template<typename ...> class V>
+decltype(::toml::get<T>(std::declval<basic_value<C, M, V>&>()))
+find(basic_value<C, M, V>& v, const key_path& path)
+{
+    return ::toml::get<T>(::toml::find(v, path));
+}
+
+} // toml
+#endif// TOML11_KEY_PATH_HPP
@@ -0,0 +1,361 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_LAYERED_VIEW_HPP
+#define TOML11_LAYERED_VIEW_HPP
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "key_path.hpp"
+#include "parser.hpp"
+
+namespace toml
+{
+
+// A read-only view of documents stacked on top of each other.
+//
+// Layers are added from the lowest precedence to the highest, e.g. defaults,
+// region, host, and overrides. A value in a higher layer overrides the same
+// value in the lower layers. Tables in the layers are merged recursively, and
+// other values, including arrays, are replaced as a whole.
+//
+// Lookups check the layers from the highest precedence and do not copy the
+// documents. `flatten()` makes the merged document when it is needed.
+//
+// ```cpp
+// const auto defaults  = toml::parse("defaults.toml");
+// const auto overrides = toml::parse("overrides.toml");
+//
+// toml::layered_view conf;
+// conf.add_layer(defaults,  "defaults.toml");
+// conf.add_layer(overrides, "overrides.toml");
+//
+// const auto port = conf.find<int>("server", "port");
+// std::cout << "port is set in " << conf.source("server", "port")->name << std::endl;
+// ```
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+class basic_layered_view
+{
+  public:
+    using value_type = basic_value<Comment, Table, Array>;
+    using table_type = typename value_type::table_type;
+
+    struct layer_type
+    {
+        // the document, or a table in it if this is a subview.
+        std::shared_ptr<const value_type> document;
+        std::string                       name;
+        // the position in the view it was added to. 0 is the lowest.
+        std::size_t                       index;
+    };
+
+  public:
+
+    basic_layered_view() = default;
+    ~basic_layered_view() = default;
+    basic_layered_view(const basic_layered_view&) = default;
+    basic_layered_view(basic_layered_view&&)      = default;
+    basic_layered_view& operator=(const basic_layered_view&) = default;
+    basic_layered_view& operator=(basic_layered_view&&)      = default;
+
+    // The view does not own the document. It should outlive the view.
+    void add_layer(const value_type& doc, std::string name = "")
+    {
+        // a shared_ptr that points `doc` without owning it
+        this->add_layer(std::shared_ptr<const value_type>(
+                std::shared_ptr<const value_type>(), std::addressof(doc)),
+            std::move(name));
+        return;
+    }
+    // The view takes over a temporary document, e.g. `toml::parse(...)`.
+    void add_layer(value_type&& doc, std::string name = "")
+    {
+        this->add_layer(std::make_shared<const value_type>(std::move(doc)),
+                        std::move(name));
+        return;
+    }
+    // The view keeps the document alive, e.g. a snapshot of toml::config_handle.
+    void add_layer(std::shared_ptr<const value_type> doc, std::string name = "")
+    {
+        const auto idx = layers_.size();
+        layers_.push_back(layer_type{std::move(doc), std::move(name), idx});
+        return;
+    }
+
+    std::vector<layer_type> const& layers() const noexcept {return layers_;}
+    std::size_t size()  const noexcept {return layers_.size();}
+    bool        empty() const noexcept {return layers_.empty();}
+
+    // ------------------------------------------------------------------------
+    // lookup
+
+    // returns nullptr if the path does not exist in the merged document. If it
+    // points to a table, the table in the highest layer is returned. Use
+    // `subview` or `flatten` to see the merged table.
+    value_type const* lookup(const key_path& path) const
+    {
+        const layer_type* src = this->resolve(path, nullptr);
+        return src ? path.lookup(*src->document) : nullptr;
+    }
+
+    bool contains(const key_path& path) const
+    {
+        return this->resolve(path, nullptr) != nullptr;
+    }
+    template<typename ... Keys>
+    bool contains(const key& k, Keys&& ... ks) const
+    {
+        return this->contains(key_path{key_path::segment(k),
+                key_path::segment(std::forward<Keys>(ks))...});
+    }
+
+    // returns the layer that the value comes from, or nullptr if the path does
+    // not exist. If the value is a table merged from several layers, it
+    // returns the highest one.
+    layer_type const* source(const key_path& path) const
+    {
+        return this->resolve(path, nullptr);
+    }
+    template<typename ... Keys>
+    layer_type const* source(const key& k, Keys&& ... ks) const
+    {
+        return this->source(key_path{key_path::segment(k),
+                key_path::segment(std::forward<Keys>(ks))...});
+    }
+
+    // throws std::out_of_range if the path does not exist. If it points to a
+    // table, the table in the highest layer is returned, as `lookup` does.
+    value_type const& find(const key_path& path) const
+    {
+        if(const auto* found = this->lookup(path))
+        {
+            return *found;
+        }
+        this->throw_not_found(path);
+    }
+    // `N` makes `find<T>(k, ks...)` not match this overload.
+    template<std::nullptr_t N = nullptr, typename ... Keys>
+    value_type const& find(const key& k, Keys&& ... ks) const
+    {
+        return this->find(key_path{key_path::segment(k),
+                key_path::segment(std::forward<Keys>(ks))...});
+    }
+
+    // converts the value in the same way as `toml::get<T>`. If the path points
+    // to a table in several layers, the merged table is converted.
+    template<typename T>
+    T find(const key_path& path) const
+    {
+        std::vector<const layer_type*> tables;
+        const layer_type* src = this->resolve(path, std::addressof(tables));
+        if(!src)
+        {
+            this->throw_not_found(path);
+        }
+        if(tables.size() < 2)
+        {
+            return ::toml::get<T>(*path.lookup(*src->document));
+        }
+        const value_type merged = this->flatten(path);
+        return ::toml::get<T>(merged);
+    }
+    template<typename T, typename ... Keys>
+    T find(const key& k, Keys&& ... ks) const
+    {
+        return this->find<T>(key_path{key_path::segment(k),
+                key_path::segment(std::forward<Keys>(ks))...});
+    }
+
+    // ------------------------------------------------------------------------
+    // subview and flatten
+
+    // a view of the tables at the path in the layers. It keeps the names and
+    // indices of the layers. Throws std::out_of_range if the path does not
+    // exist and toml::type_error if it does not point to a table.
+    basic_layered_view subview(const key_path& path) const
+    {
+        std::vector<const layer_type*> tables;
+        const layer_type* src = this->resolve(path, std::addressof(tables));
+        if(!src)
+        {
+            this->throw_not_found(path);
+        }
+        const auto& top = *path.lookup(*src->document);
+        if(!top.is_table())
+        {
+            detail::throw_bad_cast<value_t::table>(
+                "toml::layered_view::subview: ", top.type(), top);
+        }
+
+        basic_layered_view sub;
+        for(auto iter = tables.rbegin(); iter != tables.rend(); ++iter)
+        {
+            const layer_type& l = **iter;
+            // shares the ownership of the document, if any.
+            sub.layers_.push_back(layer_type{std::shared_ptr<const value_type>(
+                    l.document, path.lookup(*l.document)), l.name, l.index});
+        }
+        return sub;
+    }
+
+    // makes the merged document. The values are copied once.
+    value_type flatten() const
+    {
+        return this->flatten(key_path{});
+    }
+    // makes the merged value at the path. Throws std::out_of_range if the path
+    // does not exist.
+    value_type flatten(const key_path& path) const
+    {
+        std::vector<const layer_type*> tables;
+        const layer_type* src = this->resolve(path, std::addressof(tables));
+        if(!src)
+        {
+            if(path.empty() && layers_.empty()) {return value_type(table_type{});}
+            this->throw_not_found(path);
+        }
+        if(tables.empty())
+        {
+            return *path.lookup(*src->document);
+        }
+        std::vector<const value_type*> values;
+        for(const auto* l : tables)
+        {
+            values.push_back(path.lookup(*l->document));
+        }
+        return detail::finish_parse(merge_tables(values));
+    }
+
+  private:
+
+    enum class walk_result
+    {
+        found,    // the path exists in the layer
+        missing,  // the layer does not have it. check the lower layers.
+        shadowed  // a value in the layer hides the lower layers
+    };
+
+    static walk_result walk(const value_type& root, const key_path& path,
+                            const value_type*& found)
+    {
+        const value_type* current = std::addressof(root);
+        bool in_array = false;
+        for(const auto& seg : path.segments())
+        {
+            if(seg.is_index())
+            {
+                // an array replaces the arrays in the lower layers.
+                if(!current->is_array()) {return walk_result::shadowed;}
+                const auto& ary = current->as_array(std::nothrow);
+                if(ary.size() <= seg.as_index()) {return walk_result::shadowed;}
+                current  = std::addressof(ary[seg.as_index()]);
+                in_array = true;
+            }
+            else
+            {
+                if(!current->is_table()) {return walk_result::shadowed;}
+                current = detail::find_mapped(current->as_table(std::nothrow), seg.as_key());
+                if(!current)
+                {
+                    return in_array ? walk_result::shadowed : walk_result::missing;
+                }
+            }
+        }
+        found = current;
+        return walk_result::found;
+    }
+
+    // returns the highest layer that has the path. If `tables` is given and
+    // the path points to tables, it is filled with the layers that contribute
+    // to the merged table, from the highest to the lowest.
+    layer_type const* resolve(const key_path& path,
+                              std::vector<const layer_type*>* tables) const
+    {
+        const layer_type* top = nullptr;
+        for(auto iter = layers_.rbegin(); iter != layers_.rend(); ++iter)
+        {
+            const value_type* found = nullptr;
+            const auto r = walk(*iter->document, path, found);
+            if(r == walk_result::missing)  {continue;}
+            if(r == walk_result::shadowed) {break;}
+
+            if(!found->is_table())
+            {
+                // a table in a higher layer replaces it.
+                if(!top) {top = std::addressof(*iter);}
+                break;
+            }
+            if(!top) {top = std::addressof(*iter);}
+            if(!tables) {break;}
+            tables->push_back(std::addressof(*iter));
+        }
+        return top;
+    }
+
+    // `tables` are ordered from the highest to the lowest. The keys are
+    // inserted in the order they first appear from the lowest layer.
+    static value_type merge_tables(const std::vector<const value_type*>& tables)
+    {
+        value_type merged(table_type{});
+        merged.comments() = tables.front()->comments();
+        detail::change_region(merged, detail::get_metadata(*tables.front()).shared_region());
+
+        auto& tab = merged.as_table();
+        for(auto iter = tables.rbegin(); iter != tables.rend(); ++iter)
+        {
+            for(const auto& kv : (*iter)->as_table(std::nothrow))
+            {
+                if(detail::find_mapped(tab, kv.first)) {continue;}
+
+                // collect the values for the key from the highest layer
+                std::vector<const value_type*> values;
+                for(const auto* t : tables)
+                {
+                    const auto* v = detail::find_mapped(t->as_table(std::nothrow), kv.first);
+                    if(!v) {continue;}
+                    if(!v->is_table())
+                    {
+                        if(values.empty()) {values.push_back(v);}
+                        break;
+                    }
+                    values.push_back(v);
+                }
+                if(values.front()->is_table())
+                {
+                    tab.emplace(kv.first, merge_tables(values));
+                }
+                else
+                {
+                    tab.emplace(kv.first, *values.front());
+                }
+            }
+        }
+        return merged;
+    }
+
+    [[noreturn]] void throw_not_found(const key_path& path) const
+    {
+        std::string names;
+        for(auto iter = layers_.rbegin(); iter != layers_.rend(); ++iter)
+        {
+            if(!names.empty()) {names += ", ";}
+            names += iter->name.empty() ? concat_to_string("#", iter->index) : iter->name;
+        }
+        throw std::out_of_range(concat_to_string("toml::layered_view: \"",
+            path.str(), "\" not found in the layers [", names, "]"));
+    }
+
+  private:
+    std::vector<layer_type> layers_;
+};
+
+using layered_view = basic_layered_view<>;
+
+} // toml
+#endif// TOML11_LAYERED_VIEW_HPP
@@ -76,7 +76,7 @@ literal_internal_impl(::toml::detail::location loc)
     }
     else // none of them.
     {
-        throw ::toml::syntax_error(data.unwrap_err(), source_location(loc));
+        ::toml::detail::throw_syntax_error(data.unwrap_err(), source_location(loc));
     }
 
 }
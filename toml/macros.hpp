@@ -83,6 +83,7 @@
 // TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(foo::Foo, s, d, i)
 // ```
 // And then you can use `toml::find<foo::Foo>(file, "foo");`
+// It also defines `toml::fields<foo::Foo>` for `toml::parse_into`.
 //
 #define TOML11_FIND_MEMBER_VARIABLE_FROM_VALUE(VAR_NAME)\
     obj.VAR_NAME = toml::find<decltype(obj.VAR_NAME)>(v, TOML11_STRINGIZE(VAR_NAME));
@@ -90,6 +91,9 @@
 #define TOML11_ASSIGN_MEMBER_VARIABLE_TO_VALUE(VAR_NAME)\
     v[TOML11_STRINGIZE(VAR_NAME)] = obj.VAR_NAME;
 
+#define TOML11_VISIT_MEMBER_VARIABLE(VAR_NAME)\
+    f(TOML11_STRINGIZE(VAR_NAME), &type::VAR_NAME);
+
 #define TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(NAME, ...)\
     namespace toml {                                                                     \
     template<>                                                                           \
@@ -114,6 +118,16 @@
             return v;                                                                    \
         }                                                                                \
     };                                                                                   \
+    template<>                                                                           \
+    struct fields<NAME>                                                                  \
+    {                                                                                    \
+        using type = NAME;                                                               \
+        template<typename F>                                                             \
+        static void for_each(F&& f)                                                      \
+        {                                                                                \
+            TOML11_FOR_EACH_VA_ARGS(TOML11_VISIT_MEMBER_VARIABLE, __VA_ARGS__)           \
+        }                                                                                \
+    };                                                                                   \
     } /* toml */
 
 #endif// TOML11_WITHOUT_DEFINE_NON_INTRUSIVE
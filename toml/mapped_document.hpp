@@ -0,0 +1,880 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_MAPPED_DOCUMENT_HPP
+#define TOML11_MAPPED_DOCUMENT_HPP
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "binary.hpp"
+#include "get.hpp"
+#include "parser.hpp"
+#include "value.hpp"
+
+namespace toml
+{
+namespace detail
+{
+
+// The layout of a mapped document. All the numbers are little endian.
+//
+// | offset | size | content                       |
+// |--------|------|-------------------------------|
+// |      0 |    8 | "TOML11MD"                    |
+// |      8 |    4 | format version                |
+// |     12 |    4 | reserved                      |
+// |     16 |    8 | size of the whole document    |
+// |     24 |    8 | reserved                      |
+// |     32 |   16 | the root slot                 |
+//
+// A slot (16 bytes) represents a value.
+//
+// | offset | size | content                                                  |
+// |--------|------|----------------------------------------------------------|
+// |      0 |    1 | value_t                                                  |
+// |      1 |    1 | string_t of a string                                     |
+// |      2 |    2 | hour and minute of time_offset                           |
+// |      4 |    4 | the number of elements, the length of a string, or date  |
+// |      8 |    8 | a scalar, time, or the offset of the elements or string  |
+//
+// The elements of an array are consecutive slots. The elements of a table are
+// consecutive entries (32 bytes) sorted by key: the length of the key (4 bytes),
+// padding (4 bytes), the offset of the key (8 bytes), and the slot of the value.
+// Strings and keys are followed by '\0'. Slots and entries are aligned to 8.
+struct mapped_format
+{
+    static constexpr std::size_t   header_size = 32;
+    static constexpr std::size_t   slot_size   = 16;
+    static constexpr std::size_t   entry_size  = 32;
+    static constexpr std::uint32_t version     = 1;
+
+    static const char* magic() noexcept {return "TOML11MD";}
+
+    // local_time is packed into 8 bytes. sub-second parts are in [0, 999].
+    static std::uint64_t pack_time(const local_time& t) noexcept
+    {
+        return  static_cast<std::uint64_t>(t.hour)               |
+               (static_cast<std::uint64_t>(t.minute)      <<  8) |
+               (static_cast<std::uint64_t>(t.second)      << 16) |
+               (static_cast<std::uint64_t>(t.millisecond) << 24) |
+               (static_cast<std::uint64_t>(t.microsecond) << 34) |
+               (static_cast<std::uint64_t>(t.nanosecond)  << 44);
+    }
+    static local_time unpack_time(const std::uint64_t x) noexcept
+    {
+        return local_time(static_cast<int>( x        & 0xFFu),
+                          static_cast<int>((x >>  8) & 0xFFu),
+                          static_cast<int>((x >> 16) & 0xFFu),
+                          static_cast<int>((x >> 24) & 0x3FFu),
+                          static_cast<int>((x >> 34) & 0x3FFu),
+                          static_cast<int>((x >> 44) & 0x3FFu));
+    }
+    static std::uint32_t pack_date(const local_date& d) noexcept
+    {
+        return  static_cast<std::uint32_t>(static_cast<std::uint16_t>(d.year)) |
+               (static_cast<std::uint32_t>(d.month) << 16) |
+               (static_cast<std::uint32_t>(d.day)   << 24);
+    }
+    static local_date unpack_date(const std::uint32_t x) noexcept
+    {
+        return local_date(static_cast<std::int16_t>(static_cast<std::uint16_t>(x & 0xFFFFu)),
+                          static_cast<month_t>((x >> 16) & 0xFFu),
+                          static_cast<int>((x >> 24) & 0xFFu));
+    }
+};
+
+template<typename Value>
+class mapped_writer
+{
+  public:
+    using value_type = Value;
+    using key_value  = typename value_type::table_type::value_type;
+
+    mapped_writer(): buf_(mapped_format::header_size + mapped_format::slot_size, '\0') {}
+
+    std::string const& write(const value_type& root)
+    {
+        std::memcpy(&buf_[0], mapped_format::magic(), 8);
+        store_le(buf_, 8, mapped_format::version, 4);
+        this->write_slot(mapped_format::header_size, root);
+        store_le(buf_, 16, buf_.size(), 8);
+        return buf_;
+    }
+
+  private:
+
+    // reserve `n` bytes aligned to 8, and returns the offset.
+    std::size_t allocate(const std::size_t n)
+    {
+        const std::size_t pos = (buf_.size() + 7u) & ~std::size_t(7u);
+        buf_.resize(pos + n, '\0');
+        return pos;
+    }
+    std::size_t write_bytes(const std::string& s)
+    {
+        const auto pos = this->allocate(s.size() + 1);
+        std::copy(s.begin(), s.end(), buf_.begin() + static_cast<std::ptrdiff_t>(pos));
+        return pos;
+    }
+    static std::uint32_t count(const std::size_t n)
+    {
+        if((std::numeric_limits<std::uint32_t>::max)() < n)
+        {
+            throw std::length_error("toml::save_mapped: too many elements");
+        }
+        return static_cast<std::uint32_t>(n);
+    }
+
+    void write_slot(const std::size_t pos, const value_type& v)
+    {
+        buf_[pos] = static_cast<char>(v.type());
+        switch(v.type())
+        {
+            case value_t::boolean : {store_le(buf_, pos + 8, v.as_boolean(std::nothrow) ? 1u : 0u, 8); break;}
+            case value_t::integer : {this->write_integer(pos, v.as_integer(std::nothrow)); break;}
+            case value_t::floating: {this->write_floating(pos, v.as_floating(std::nothrow)); break;}
+            case value_t::string  :
+            {
+                const auto& s = v.as_string(std::nothrow);
+                buf_[pos + 1] = static_cast<char>(s.kind);
+                store_le(buf_, pos + 4, count(s.str.size()), 4);
+                store_le(buf_, pos + 8, this->write_bytes(s.str), 8);
+                break;
+            }
+            case value_t::offset_datetime:
+            {
+                const auto& odt = v.as_offset_datetime(std::nothrow);
+                buf_[pos + 2] = static_cast<char>(odt.offset.hour);
+                buf_[pos + 3] = static_cast<char>(odt.offset.minute);
+                store_le(buf_, pos + 4, mapped_format::pack_date(odt.date), 4);
+                store_le(buf_, pos + 8, mapped_format::pack_time(odt.time), 8);
+                break;
+            }
+            case value_t::local_datetime:
+            {
+                const auto& ldt = v.as_local_datetime(std::nothrow);
+                store_le(buf_, pos + 4, mapped_format::pack_date(ldt.date), 4);
+                store_le(buf_, pos + 8, mapped_format::pack_time(ldt.time), 8);
+                break;
+            }
+            case value_t::local_date:
+            {
+                store_le(buf_, pos + 4, mapped_format::pack_date(v.as_local_date(std::nothrow)), 4);
+                break;
+            }
+            case value_t::local_time:
+            {
+                store_le(buf_, pos + 8, mapped_format::pack_time(v.as_local_time(std::nothrow)), 8);
+                break;
+            }
+            case value_t::array:
+            {
+                if(const auto packed = get_packed_array(v))
+                {
+                    this->write_packed(pos, *packed);
+                    break;
+                }
+                const auto& ary = v.as_array(std::nothrow);
+                const auto first = this->allocate(ary.size() * mapped_format::slot_size);
+                store_le(buf_, pos + 4, count(ary.size()), 4);
+                store_le(buf_, pos + 8, first, 8);
+                std::size_t slot = first;
+                for(const auto& elem : ary)
+                {
+                    this->write_slot(slot, elem);
+                    slot += mapped_format::slot_size;
+                }
+                break;
+            }
+            case value_t::table:
+            {
+                const auto& tab = v.as_table(std::nothrow);
+                std::vector<const key_value*> sorted;
+                sorted.reserve(tab.size());
+                for(const auto& kv : tab)
+                {
+                    sorted.push_back(std::addressof(kv));
+                }
+                std::sort(sorted.begin(), sorted.end(),
+                    [](const key_value* lhs, const key_value* rhs) {
+                        return lhs->first < rhs->first;
+                    });
+
+                const auto first = this->allocate(sorted.size() * mapped_format::entry_size);
+                store_le(buf_, pos + 4, count(sorted.size()), 4);
+                store_le(buf_, pos + 8, first, 8);
+                std::size_t entry = first;
+                for(const auto kv : sorted)
+                {
+                    store_le(buf_, entry, count(kv->first.size()), 4);
+                    store_le(buf_, entry + 8, this->write_bytes(kv->first), 8);
+                    this->write_slot(entry + 16, kv->second);
+                    entry += mapped_format::entry_size;
+                }
+                break;
+            }
+            default: break;
+        }
+        return;
+    }
+
+    void write_packed(const std::size_t pos, const packed_array& packed)
+    {
+        const auto first = this->allocate(packed.size() * mapped_format::slot_size);
+        store_le(buf_, pos + 4, count(packed.size()), 4);
+        store_le(buf_, pos + 8, first, 8);
+        std::size_t slot = first;
+        switch(packed.kind())
+        {
+            case value_t::integer:
+            {
+                for(const auto x : packed.integers())
+                {
+                    buf_[slot] = static_cast<char>(value_t::integer);
+                    this->write_integer(slot, x);
+                    slot += mapped_format::slot_size;
+                }
+                break;
+            }
+            case value_t::floating:
+            {
+                for(const auto x : packed.floatings())
+                {
+                    buf_[slot] = static_cast<char>(value_t::floating);
+                    this->write_floating(slot, x);
+                    slot += mapped_format::slot_size;
+                }
+                break;
+            }
+            case value_t::boolean:
+            {
+                for(const auto x : packed.booleans())
+                {
+                    buf_[slot] = static_cast<char>(value_t::boolean);
+                    store_le(buf_, slot + 8, x ? 1u : 0u, 8);
+                    slot += mapped_format::slot_size;
+                }
+                break;
+            }
+            default: break;
+        }
+        return;
+    }
+
+    void write_integer(const std::size_t pos, const integer x)
+    {
+        store_le(buf_, pos + 8, static_cast<std::uint64_t>(x), 8);
+    }
+    void write_floating(const std::size_t pos, const floating x)
+    {
+        std::uint64_t bits;
+        std::memcpy(std::addressof(bits), std::addressof(x), sizeof(bits));
+        store_le(buf_, pos + 8, bits, 8);
+    }
+
+  private:
+    std::string buf_;
+};
+
+} // detail
+
+// A read-only view of a value in a mapped document. It is a pair of pointers
+// and does not own anything; it is valid while the document is alive.
+//
+// All the offsets are checked when they are followed, so a broken document
+// throws toml::binary_error instead of reading outside of it.
+class mapped_value
+{
+  public:
+
+    mapped_value() noexcept: first_(nullptr), size_(0), slot_(0) {}
+    mapped_value(const char* first, const std::size_t size, const std::size_t slot)
+        : first_(first), size_(size), slot_(slot)
+    {
+        this->check_range(slot, detail::mapped_format::slot_size);
+    }
+
+    value_t type() const noexcept
+    {
+        return first_ ? static_cast<value_t>(first_[slot_]) : value_t::empty;
+    }
+
+    bool is_uninitialized()   const noexcept {return this->is(value_t::empty          );}
+    bool is_boolean()         const noexcept {return this->is(value_t::boolean        );}
+    bool is_integer()         const noexcept {return this->is(value_t::integer        );}
+    bool is_floating()        const noexcept {return this->is(value_t::floating       );}
+    bool is_string()          const noexcept {return this->is(value_t::string         );}
+    bool is_offset_datetime() const noexcept {return this->is(value_t::offset_datetime);}
+    bool is_local_datetime()  const noexcept {return this->is(value_t::local_datetime );}
+    bool is_local_date()      const noexcept {return this->is(value_t::local_date     );}
+    bool is_local_time()      const noexcept {return this->is(value_t::local_time     );}
+    bool is_array()           const noexcept {return this->is(value_t::array          );}
+    bool is_table()           const noexcept {return this->is(value_t::table          );}
+
+    boolean as_boolean() const
+    {
+        this->expect<value_t::boolean>("toml::mapped_value::as_boolean(): ");
+        return this->payload() != 0;
+    }
+    integer as_integer() const
+    {
+        this->expect<value_t::integer>("toml::mapped_value::as_integer(): ");
+        return static_cast<integer>(this->payload());
+    }
+    floating as_floating() const
+    {
+        this->expect<value_t::floating>("toml::mapped_value::as_floating(): ");
+        const auto bits = this->payload();
+        floating x;
+        std::memcpy(std::addressof(x), std::addressof(bits), sizeof(x));
+        return x;
+    }
+    local_date as_local_date() const
+    {
+        this->expect<value_t::local_date>("toml::mapped_value::as_local_date(): ");
+        return detail::mapped_format::unpack_date(this->aux());
+    }
+    local_time as_local_time() const
+    {
+        this->expect<value_t::local_time>("toml::mapped_value::as_local_time(): ");
+        return detail::mapped_format::unpack_time(this->payload());
+    }
+    local_datetime as_local_datetime() const
+    {
+        this->expect<value_t::local_datetime>("toml::mapped_value::as_local_datetime(): ");
+        return local_datetime(detail::mapped_format::unpack_date(this->aux()),
+                              detail::mapped_format::unpack_time(this->payload()));
+    }
+    offset_datetime as_offset_datetime() const
+    {
+        this->expect<value_t::offset_datetime>("toml::mapped_value::as_offset_datetime(): ");
+        return offset_datetime(detail::mapped_format::unpack_date(this->aux()),
+                               detail::mapped_format::unpack_time(this->payload()),
+                               time_offset(static_cast<std::int8_t>(first_[slot_ + 2]),
+                                           static_cast<std::int8_t>(first_[slot_ + 3])));
+    }
+
+    // a pointer to the null-terminated string in the document.
+    const char* string_data() const
+    {
+        this->expect<value_t::string>("toml::mapped_value::string_data(): ");
+        const auto pos = this->checked_offset(static_cast<std::size_t>(this->aux()) + 1u, 1);
+        if(first_[pos + this->aux()] != '\0')
+        {
+            this->broken();
+        }
+        return first_ + pos;
+    }
+    string_t string_kind() const
+    {
+        this->expect<value_t::string>("toml::mapped_value::string_kind(): ");
+        return static_cast<string_t>(first_[slot_ + 1]);
+    }
+    std::string as_string() const
+    {
+        const char* const str = this->string_data();
+        return std::string(str, this->aux());
+    }
+
+    // the number of elements in an array or a table, or the length of a string.
+    std::size_t size() const
+    {
+        switch(this->type())
+        {
+            case value_t::string: return this->aux();
+            case value_t::array : return this->aux();
+            case value_t::table : return this->aux();
+            default: break;
+        }
+        detail::throw_bad_cast<value_t::array>("toml::mapped_value::size(): ",
+                                               this->type(), toml::value{});
+    }
+
+    // array ------------------------------------------------------------------
+
+    mapped_value at(const std::size_t idx) const
+    {
+        this->expect<value_t::array>("toml::mapped_value::at(idx): ");
+        if(this->aux() <= idx)
+        {
+            throw std::out_of_range(concat_to_string(
+                "toml::mapped_value::at(idx): index ", idx,
+                " exceeds the size of the array ", this->aux()));
+        }
+        const auto first = this->checked_offset(this->aux(), detail::mapped_format::slot_size);
+        return mapped_value(first_, size_, first + idx * detail::mapped_format::slot_size);
+    }
+    mapped_value operator[](const std::size_t idx) const {return this->at(idx);}
+
+    // table ------------------------------------------------------------------
+
+    // keys are sorted in byte-wise order.
+    std::string key_at(const std::size_t idx) const
+    {
+        const auto entry = this->entry_at(idx, "toml::mapped_value::key_at(idx): ");
+        const auto len   = detail::load_le<std::size_t>(first_ + entry, 4);
+        const auto pos   = this->checked_key(entry, len);
+        return std::string(first_ + pos, len);
+    }
+    mapped_value value_at(const std::size_t idx) const
+    {
+        const auto entry = this->entry_at(idx, "toml::mapped_value::value_at(idx): ");
+        return mapped_value(first_, size_, entry + 16);
+    }
+
+    bool contains(const key& k) const
+    {
+        this->expect<value_t::table>("toml::mapped_value::contains(key): ");
+        return this->find_entry(k) != 0;
+    }
+    std::size_t count(const key& k) const
+    {
+        return this->contains(k) ? 1 : 0;
+    }
+    mapped_value at(const key& k) const
+    {
+        this->expect<value_t::table>("toml::mapped_value::at(key): ");
+        const auto entry = this->find_entry(k);
+        if(entry == 0)
+        {
+            throw std::out_of_range(concat_to_string(
+                "toml::mapped_value::at(key): key \"", k, "\" not found"));
+        }
+        return mapped_value(first_, size_, entry + 16);
+    }
+    mapped_value operator[](const key& k) const {return this->at(k);}
+
+    // ------------------------------------------------------------------------
+
+    // constructs a toml::value that has the same contents.
+    template<typename Value = ::toml::value>
+    Value to_value() const
+    {
+        return this->to_value_impl<Value>(0);
+    }
+
+  private:
+
+    template<typename Value>
+    Value to_value_impl(const std::size_t n_rec) const
+    {
+        if(n_rec > TOML11_VALUE_RECURSION_LIMIT)
+        {
+            throw binary_error("toml::mapped_value: recursion limit ("
+                TOML11_STRINGIZE(TOML11_VALUE_RECURSION_LIMIT) ") exceeded");
+        }
+        using array_type = typename Value::array_type;
+        using table_type = typename Value::table_type;
+        switch(this->type())
+        {
+            case value_t::boolean        : return Value(this->as_boolean());
+            case value_t::integer        : return Value(this->as_integer());
+            case value_t::floating       : return Value(this->as_floating());
+            case value_t::string         : return Value(this->as_string(), this->string_kind());
+            case value_t::offset_datetime: return Value(this->as_offset_datetime());
+            case value_t::local_datetime : return Value(this->as_local_datetime());
+            case value_t::local_date     : return Value(this->as_local_date());
+            case value_t::local_time     : return Value(this->as_local_time());
+            case value_t::array:
+            {
+                Value v(array_type{});
+                auto& ary = v.as_array(std::nothrow);
+                const auto n = this->size();
+                try_reserve(ary, n);
+                for(std::size_t i=0; i<n; ++i)
+                {
+                    ary.push_back(this->at(i).template to_value_impl<Value>(n_rec + 1));
+                }
+                return v;
+            }
+            case value_t::table:
+            {
+                Value v(table_type{});
+                auto& tab = v.as_table(std::nothrow);
+                const auto n = this->size();
+                for(std::size_t i=0; i<n; ++i)
+                {
+                    tab.insert(std::make_pair(this->key_at(i),
+                               this->value_at(i).template to_value_impl<Value>(n_rec + 1)));
+                }
+                return v;
+            }
+            default: return Value{};
+        }
+    }
+
+    bool is(const value_t t) const noexcept {return this->type() == t;}
+
+    template<value_t Expected>
+    void expect(const char* funcname) const
+    {
+        if(this->type() != Expected)
+        {
+            detail::throw_bad_cast<Expected>(funcname, this->type(), toml::value{});
+        }
+    }
+
+    std::uint32_t aux()     const noexcept {return detail::load_le<std::uint32_t>(first_ + slot_ + 4, 4);}
+    std::uint64_t payload() const noexcept {return detail::load_le(first_ + slot_ + 8, 8);}
+
+    // the offset of `n` elements of `elem_size` bytes that this slot points.
+    // The writer always allocates them after the slot, so an offset that
+    // points back to this slot or its parents is a broken (cyclic) document.
+    std::size_t checked_offset(const std::size_t n, const std::size_t elem_size) const
+    {
+        const auto off = detail::load_le<std::size_t>(first_ + slot_ + 8, 8);
+        if(off < slot_ + detail::mapped_format::slot_size ||
+           size_ < off || (size_ - off) / elem_size < n)
+        {
+            this->broken();
+        }
+        return off;
+    }
+    std::size_t checked_key(const std::size_t entry, const std::size_t len) const
+    {
+        const auto off = detail::load_le<std::size_t>(first_ + entry + 8, 8);
+        if(size_ < off || size_ - off <= len)
+        {
+            this->broken();
+        }
+        return off;
+    }
+    void check_range(const std::size_t pos, const std::size_t len) const
+    {
+        if(size_ < pos || size_ - pos < len)
+        {
+            this->broken();
+        }
+    }
+    [[noreturn]] void broken() const
+    {
+        throw binary_error("toml::mapped_value: broken document");
+    }
+
+    std::size_t entry_at(const std::size_t idx, const char* funcname) const
+    {
+        this->expect<value_t::table>(funcname);
+        if(this->aux() <= idx)
+        {
+            throw std::out_of_range(concat_to_string(
+                funcname, "index ", idx, " exceeds the size of the table ", this->aux()));
+        }
+        const auto first = this->checked_offset(this->aux(), detail::mapped_format::entry_size);
+        return first + idx * detail::mapped_format::entry_size;
+    }
+
+    // binary search. returns 0 if not found.
+    std::size_t find_entry(const key& k) const
+    {
+        const auto first = this->checked_offset(this->aux(), detail::mapped_format::entry_size);
+        std::size_t lo = 0;
+        std::size_t hi = this->aux();
+        while(lo < hi)
+        {
+            const auto mid   = lo + (hi - lo) / 2;
+            const auto entry = first + mid * detail::mapped_format::entry_size;
+            const auto len   = detail::load_le<std::size_t>(first_ + entry, 4);
+            const auto pos   = this->checked_key(entry, len);
+
+            int cmp = std::memcmp(first_ + pos, k.data(), (std::min)(len, k.size()));
+            if(cmp == 0)
+            {
+                cmp = (len < k.size()) ? -1 : (k.size() < len) ? 1 : 0;
+            }
+            if(cmp == 0) {return entry;}
+            if(cmp < 0) {lo = mid + 1;} else {hi = mid;}
+        }
+        return 0;
+    }
+
+  private:
+    const char* first_;
+    std::size_t size_;
+    std::size_t slot_;
+};
+
+// A document written by toml::save_mapped. It maps the file into memory if the
+// platform supports mmap, and reads it into a buffer otherwise. Nothing is
+// parsed or allocated for the values; mapped_value reads the file directly.
+//
+// Processes that open the same file share the same pages in the page cache.
+//
+// ```cpp
+// toml::save_mapped(toml::parse("dataset.toml"), "dataset.tomlmd");
+//
+// const toml::mapped_document doc("dataset.tomlmd");
+// const auto name = toml::find<std::string>(doc.root(), "records", 42, "name");
+// ```
+class mapped_document
+{
+  public:
+
+    explicit mapped_document(const std::string& fname)
+        : first_(nullptr), size_(0), mapped_(false)
+    {
+#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__linux__)
+        const int fd = ::open(fname.c_str(), O_RDONLY);
+        if(fd < 0)
+        {
+            throw std::ios_base::failure(
+                "toml::mapped_document: Error opening file \"" + fname + "\"");
+        }
+        struct stat st;
+        if(::fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+            ::close(fd);
+            throw std::ios_base::failure(
+                "toml::mapped_document: Error reading file \"" + fname + "\"");
+        }
+        const auto len = static_cast<std::size_t>(st.st_size);
+        void* const addr = ::mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if(addr == MAP_FAILED)
+        {
+            throw std::ios_base::failure(
+                "toml::mapped_document: Error mapping file \"" + fname + "\"");
+        }
+        first_  = static_cast<const char*>(addr);
+        size_   = len;
+        mapped_ = true;
+#else
+        std::ifstream ifs(fname, std::ios_base::binary);
+        if(!ifs.good())
+        {
+            throw std::ios_base::failure(
+                "toml::mapped_document: Error opening file \"" + fname + "\"");
+        }
+        ifs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        ifs.seekg(0, std::ios::end);
+        const auto len = static_cast<std::size_t>(ifs.tellg());
+        ifs.seekg(0);
+        buffer_.reset(new char[len]);
+        ifs.read(buffer_.get(), static_cast<std::streamsize>(len));
+        first_ = buffer_.get();
+        size_  = len;
+#endif
+        try
+        {
+            this->validate();
+        }
+        catch(...)
+        {
+            this->release();
+            throw;
+        }
+    }
+
+    // a view of a document in memory owned by the caller.
+    mapped_document(const char* first, const std::size_t size)
+        : first_(first), size_(size), mapped_(false)
+    {
+        this->validate();
+    }
+
+    ~mapped_document() noexcept {this->release();}
+
+    mapped_document(const mapped_document&) = delete;
+    mapped_document& operator=(const mapped_document&) = delete;
+
+    mapped_document(mapped_document&& other) noexcept
+        : first_(other.first_), size_(other.size_), mapped_(other.mapped_),
+          buffer_(std::move(other.buffer_))
+    {
+        other.first_  = nullptr;
+        other.size_   = 0;
+        other.mapped_ = false;
+    }
+    mapped_document& operator=(mapped_document&& other) noexcept
+    {
+        if(this != std::addressof(other))
+        {
+            this->release();
+            first_  = other.first_;
+            size_   = other.size_;
+            mapped_ = other.mapped_;
+            buffer_ = std::move(other.buffer_);
+            other.first_  = nullptr;
+            other.size_   = 0;
+            other.mapped_ = false;
+        }
+        return *this;
+    }
+
+    mapped_value root() const
+    {
+        return mapped_value(first_, size_, detail::mapped_format::header_size);
+    }
+
+    const char* data() const noexcept {return first_;}
+    std::size_t size() const noexcept {return size_;}
+
+  private:
+
+    void validate() const
+    {
+        using format = detail::mapped_format;
+        if(size_ < format::header_size + format::slot_size ||
+           std::memcmp(first_, format::magic(), 8) != 0)
+        {
+            throw binary_error("toml::mapped_document: not a toml11 mapped document");
+        }
+        const auto version = detail::load_le(first_ + 8, 4);
+        if(version != format::version)
+        {
+            throw binary_error("toml::mapped_document: unsupported version " +
+                               std::to_string(version));
+        }
+        if(detail::load_le(first_ + 16, 8) != size_)
+        {
+            throw binary_error("toml::mapped_document: size mismatch");
+        }
+    }
+
+    void release() noexcept
+    {
+#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__linux__)
+        if(mapped_ && first_)
+        {
+            ::munmap(const_cast<char*>(first_), size_);
+        }
+#endif
+        first_  = nullptr;
+        size_   = 0;
+        mapped_ = false;
+        buffer_.reset();
+    }
+
+  private:
+    const char*             first_;
+    std::size_t             size_;
+    bool                    mapped_;
+    std::unique_ptr<char[]> buffer_; // used if mmap is not available
+};
+
+// ----------------------------------------------------------------------------
+// save_mapped
+
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+void save_mapped(const basic_value<C, T, A>& v, std::ostream& os)
+{
+    detail::mapped_writer<basic_value<C, T, A>> writer;
+    const auto& buf = writer.write(v);
+    os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+    return;
+}
+
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+void save_mapped(const basic_value<C, T, A>& v, const std::string& fname)
+{
+    std::ofstream ofs(fname, std::ios_base::binary);
+    if(!ofs.good())
+    {
+        throw std::ios_base::failure(
+                "toml::save_mapped: Error opening file \"" + fname + "\"");
+    }
+    ofs.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    save_mapped(v, ofs);
+    return;
+}
+
+// ----------------------------------------------------------------------------
+// get / find for mapped_value
+
+template<typename T>
+detail::enable_if_t<std::is_same<T, boolean>::value, T>
+get(const mapped_value& v)
+{
+    return v.as_boolean();
+}
+template<typename T>
+detail::enable_if_t<detail::conjunction<std::is_integral<T>,
+    detail::negation<std::is_same<T, boolean>>>::value, T>
+get(const mapped_value& v)
+{
+    return static_cast<T>(v.as_integer());
+}
+template<typename T>
+detail::enable_if_t<std::is_floating_point<T>::value, T>
+get(const mapped_value& v)
+{
+    return static_cast<T>(v.as_floating());
+}
+template<typename T>
+detail::enable_if_t<std::is_same<T, std::string>::value, T>
+get(const mapped_value& v)
+{
+    return v.as_string();
+}
+template<typename T>
+detail::enable_if_t<std::is_same<T, local_date>::value, T>
+get(const mapped_value& v)
+{
+    return v.as_local_date();
+}
+template<typename T>
+detail::enable_if_t<std::is_same<T, local_time>::value, T>
+get(const mapped_value& v)
+{
+    return v.as_local_time();
+}
+template<typename T>
+detail::enable_if_t<std::is_same<T, local_datetime>::value, T>
+get(const mapped_value& v)
+{
+    return v.as_local_datetime();
+}
+template<typename T>
+detail::enable_if_t<std::is_same<T, offset_datetime>::value, T>
+get(const mapped_value& v)
+{
+    return v.as_offset_datetime();
+}
+template<typename T>
+detail::enable_if_t<detail::is_basic_value<T>::value, T>
+get(const mapped_value& v)
+{
+    return v.to_value<T>();
+}
+
+inline mapped_value find(const mapped_value& v, const key& ky)
+{
+    return v.at(ky);
+}
+inline mapped_value find(const mapped_value& v, const std::size_t idx)
+{
+    return v.at(idx);
+}
+// `Value` is always mapped_value. It is a template parameter to exclude this
+// from the candidates when T is specified explicitly, e.g. find<int>(v, "a", 0).
+template<typename Value, typename K1, typename K2, typename ... Ks>
+detail::enable_if_t<std::is_same<Value, mapped_value>::value, mapped_value>
+find(const Value& v, const K1& k1, const K2& k2, const Ks& ... ks)
+{
+    return ::toml::find(::toml::find(v, detail::key_cast(k1)),
+                        detail::key_cast(k2), ks...);
+}
+
+template<typename T, typename K, typename ... Ks>
+decltype(::toml::get<T>(std::declval<const mapped_value&>()))
+find(const mapped_value& v, const K& k, const Ks& ... ks)
+{
+    return ::toml::get<T>(::toml::find(v, detail::key_cast(k), ks...));
+}
+
+} // toml
+#endif// TOML11_MAPPED_DOCUMENT_HPP
@@ -0,0 +1,228 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_MEMORY_USAGE_HPP
+#define TOML11_MEMORY_USAGE_HPP
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "value.hpp"
+
+namespace toml
+{
+
+// The approximate number of bytes used by a value, including its elements.
+// Objects shared by several values (e.g. source buffers) are counted once.
+struct memory_usage_info
+{
+    // value objects that hold booleans, integers, floatings, and datetimes.
+    std::size_t scalars    = 0;
+    // value objects that hold strings, and the string contents.
+    std::size_t strings    = 0;
+    // value objects that hold arrays and tables, the container buffers and
+    // nodes, and keys. The elements are counted in the other fields.
+    std::size_t containers = 0;
+    // location information of values.
+    std::size_t regions    = 0;
+    // the contents of the files referred by the regions.
+    std::size_t sources    = 0;
+    // comments, and the nodes that hold comments and regions.
+    std::size_t comments   = 0;
+
+    std::size_t total() const noexcept
+    {
+        return scalars + strings + containers + regions + sources + comments;
+    }
+};
+
+namespace detail
+{
+
+// the number of bytes allocated by a string.
+inline std::size_t heap_size(const std::string& s) noexcept
+{
+    const char* const first = reinterpret_cast<const char*>(std::addressof(s));
+    const char* const last  = first + sizeof(std::string);
+    if(first <= s.data() && s.data() < last) {return 0;} // short string
+    return s.capacity() + 1;
+}
+
+// the number of bytes used by a container, except the elements themselves.
+template<typename Container>
+std::size_t container_overhead(const Container& c)
+{
+    return sizeof(Container) + c.size() * sizeof(typename Container::key_type);
+}
+template<typename T, typename Alloc>
+std::size_t container_overhead(const std::vector<T, Alloc>& v)
+{
+    return sizeof(v) + (v.capacity() - v.size()) * sizeof(T);
+}
+template<typename K, typename T, typename Hash, typename Eq, typename Alloc>
+std::size_t container_overhead(const std::unordered_map<K, T, Hash, Eq, Alloc>& m)
+{
+    // each node has a pointer to the next node and the cached hash value.
+    return sizeof(m) + m.bucket_count() * sizeof(void*) +
+           m.size() * (sizeof(K) + sizeof(void*) + sizeof(std::size_t));
+}
+template<typename K, typename T, typename Comp, typename Alloc>
+std::size_t container_overhead(const std::map<K, T, Comp, Alloc>& m)
+{
+    // each node has three pointers and a color.
+    return sizeof(m) + m.size() * (sizeof(K) + 4 * sizeof(void*));
+}
+
+struct memory_usage_counter
+{
+    template<typename Value>
+    void count(const Value& v)
+    {
+        this->count_metadata(v);
+        switch(v.type())
+        {
+            case value_t::string:
+            {
+                usage.strings += sizeof(Value);
+                const auto& str = v.as_string(std::nothrow);
+                if(this->first_visit(std::addressof(str)))
+                {
+                    usage.strings += sizeof(str) + heap_size(str.str);
+                }
+                return;
+            }
+            case value_t::array:
+            {
+                usage.containers += sizeof(Value);
+                this->count_array(v);
+                return;
+            }
+            case value_t::table:
+            {
+                usage.containers += sizeof(Value);
+                const auto& tab = v.as_table(std::nothrow);
+                if(this->first_visit(std::addressof(tab)))
+                {
+                    usage.containers += container_overhead(tab);
+                    for(const auto& kv : tab)
+                    {
+                        usage.containers += heap_size(kv.first);
+                        this->count(kv.second);
+                    }
+                }
+                return;
+            }
+            default:
+            {
+                usage.scalars += sizeof(Value);
+                return;
+            }
+        }
+    }
+
+    template<typename Value>
+    void count_array(const Value& v)
+    {
+        if(const auto packed = get_packed_array(v))
+        {
+            if(this->first_visit(packed))
+            {
+                std::size_t elem = 0;
+                switch(packed->kind())
+                {
+                    case value_t::integer : {elem = sizeof(integer);  break;}
+                    case value_t::floating: {elem = sizeof(floating); break;}
+                    case value_t::boolean : {elem = sizeof(boolean);  break;}
+                    default: break;
+                }
+                usage.containers += sizeof(*packed) + packed->size() * elem;
+            }
+            return;
+        }
+        const auto& ary = v.as_array(std::nothrow);
+        if(this->first_visit(std::addressof(ary)))
+        {
+            usage.containers += container_overhead(ary);
+            for(const auto& elem : ary)
+            {
+                this->count(elem);
+            }
+        }
+        return;
+    }
+
+    template<typename Value>
+    void count_metadata(const Value& v)
+    {
+        const auto& meta = get_metadata(v);
+        if(meta.node_address() == nullptr || !this->first_visit(meta.node_address()))
+        {
+            return;
+        }
+        usage.comments += meta.node_size();
+        for(const auto& c : v.comments())
+        {
+            usage.comments += sizeof(c) + heap_size(c);
+        }
+
+        const auto reg = meta.shared_region();
+        if(!reg || !this->first_visit(reg.get()))
+        {
+            return;
+        }
+        // the control block of std::make_shared has two counters.
+        const std::size_t control_block = 2 * sizeof(long);
+        if(const auto r = dynamic_cast<const region*>(reg.get()))
+        {
+            usage.regions += sizeof(region) + control_block + heap_size(r->name());
+            const auto& src = r->source();
+            if(src && this->first_visit(src.get()))
+            {
+                usage.sources += sizeof(*src) + control_block + src->capacity();
+            }
+        }
+        else if(const auto d = dynamic_cast<const detached_region*>(reg.get()))
+        {
+            usage.regions += sizeof(detached_region) + control_block;
+            const auto& name = d->shared_name();
+            if(name && this->first_visit(name.get()))
+            {
+                usage.regions += sizeof(*name) + control_block + heap_size(*name);
+            }
+        }
+        else
+        {
+            usage.regions += sizeof(region_base) + control_block;
+        }
+        return;
+    }
+
+    bool first_visit(const void* p)
+    {
+        return visited.insert(p).second;
+    }
+
+    memory_usage_info               usage;
+    std::unordered_set<const void*> visited;
+};
+
+} // detail
+
+// Estimate the memory used by a value and its elements.
+//
+// ```cpp
+// const auto data  = toml::parse("config.toml");
+// const auto usage = toml::memory_usage(data);
+// std::cout << usage.total() << " bytes (" << usage.sources << " bytes of source)\n";
+// ```
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+memory_usage_info memory_usage(const basic_value<C, T, A>& v)
+{
+    detail::memory_usage_counter counter;
+    counter.count(v);
+    return counter.usage;
+}
+
+} // toml
+#endif// TOML11_MEMORY_USAGE_HPP
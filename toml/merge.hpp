@@ -0,0 +1,221 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_MERGE_HPP
+#define TOML11_MERGE_HPP
+#include <cstdint>
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include "hash.hpp"
+#include "value.hpp"
+
+namespace toml
+{
+
+enum class array_merge : std::uint8_t
+{
+    replace      = 0, // the array in src replaces the array in dst
+    append       = 1, // the elements in src are appended to the array in dst
+    merge_by_key = 2  // tables that have the same `merge_policy::array_key` are merged
+};
+
+struct merge_policy
+{
+    array_merge arrays    = array_merge::replace;
+    key         array_key = "name"; // used by array_merge::merge_by_key
+};
+
+namespace detail
+{
+
+// Merges a value into another. If `Src` is not const, the values are moved
+// from it. Otherwise, the values are copied, but only the ones that are used.
+template<typename Value>
+class merger
+{
+  public:
+    using table_type = typename Value::table_type;
+    using array_type = typename Value::array_type;
+
+    explicit merger(const merge_policy& p): policy_(p) {}
+
+    template<typename Src>
+    void merge(Value& dst, Src& src) const
+    {
+        if(dst.is_table() && src.is_table())
+        {
+            this->merge_tables(dst, src);
+        }
+        else if(dst.is_array() && src.is_array() &&
+                policy_.arrays != array_merge::replace)
+        {
+            if(policy_.arrays == array_merge::append)
+            {
+                this->append_arrays(dst, src);
+            }
+            else
+            {
+                this->merge_arrays_by_key(dst, src);
+            }
+        }
+        else
+        {
+            dst = take(src); // with the comments and the location of src
+        }
+        return;
+    }
+
+  private:
+
+    static Value&&      take(Value& v)       noexcept {return std::move(v);}
+    static Value const& take(const Value& v) noexcept {return v;}
+
+    static table_type&       table_of(Value& v)       {return v.as_table();}
+    static table_type const& table_of(const Value& v) {return v.as_table(std::nothrow);}
+    static array_type&       array_of(Value& v)       {return v.as_array();}
+    static array_type const& array_of(const Value& v) {return v.as_array(std::nothrow);}
+
+    template<typename Src>
+    void merge_tables(Value& dst, Src& src) const
+    {
+        auto& dtab = dst.as_table();
+        for(auto& kv : table_of(src))
+        {
+            if(const auto found = detail::find_mapped(dtab, kv.first))
+            {
+                this->merge(*found, kv.second);
+            }
+            else
+            {
+                dtab.emplace(kv.first, take(kv.second));
+            }
+        }
+        return;
+    }
+
+    template<typename Src>
+    void append_arrays(Value& dst, Src& src) const
+    {
+        auto& dary = dst.as_array();
+        auto& sary = array_of(src);
+        dary.reserve(dary.size() + sary.size());
+        for(auto& elem : sary)
+        {
+            dary.push_back(take(elem));
+        }
+        return;
+    }
+
+    Value const* key_of(const Value& v) const
+    {
+        return v.is_table() ?
+            detail::find_mapped(v.as_table(std::nothrow), policy_.array_key) : nullptr;
+    }
+
+    // tables in src are merged into the tables in dst that have the same key.
+    // The other elements are appended.
+    template<typename Src>
+    void merge_arrays_by_key(Value& dst, Src& src) const
+    {
+        auto& dary = dst.as_array();
+
+        std::unordered_multimap<std::uint64_t, std::size_t> index;
+        for(std::size_t i=0; i<dary.size(); ++i)
+        {
+            if(const auto k = this->key_of(dary[i]))
+            {
+                index.emplace(::toml::structural_hash(*k), i);
+            }
+        }
+
+        for(auto& elem : array_of(src))
+        {
+            const auto k = this->key_of(elem);
+            if(!k)
+            {
+                dary.push_back(take(elem));
+                continue;
+            }
+            const auto h = ::toml::structural_hash(*k);
+
+            bool merged = false;
+            const auto range = index.equal_range(h);
+            for(auto iter = range.first; iter != range.second; ++iter)
+            {
+                auto& target = dary[iter->second];
+                if(detail::structurally_equal(*this->key_of(target), *k))
+                {
+                    this->merge_tables(target, elem);
+                    merged = true;
+                    break;
+                }
+            }
+            if(!merged)
+            {
+                dary.push_back(take(elem));
+                index.emplace(h, dary.size() - 1);
+            }
+        }
+        return;
+    }
+
+  private:
+    merge_policy policy_;
+};
+
+} // detail
+
+// Merges `src` into `dst` recursively.
+//
+// Tables are merged key by key. A value in `src` replaces the value in `dst`
+// together with its comments and location. Arrays are handled as specified by
+// `policy.arrays`. Tables and arrays that exist in both keep the comments and
+// the location of `dst`.
+//
+// The values in `src` are moved into `dst`, not copied.
+//
+// With TOML11_COPY_ON_WRITE, the tables and arrays in `dst` are shared with
+// copies again after merging, so non-const references to the contents of `dst`
+// taken before it should not be used to modify them.
+//
+// ```cpp
+// toml::value conf = toml::parse("defaults.toml");
+// toml::merge(conf, toml::parse("overrides.toml"));
+//
+// toml::merge_policy policy;
+// policy.arrays    = toml::array_merge::merge_by_key;
+// policy.array_key = "id";
+// toml::merge(conf, toml::parse("plugins.toml"), policy);
+// ```
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+void merge(basic_value<C, T, A>& dst, basic_value<C, T, A>&& src,
+           const merge_policy& policy = merge_policy{})
+{
+    if(std::addressof(dst) == std::addressof(src)) {return;}
+    detail::merger<basic_value<C, T, A>>(policy).merge(dst, src);
+#ifdef TOML11_COPY_ON_WRITE
+    // the merger took non-const references, which stopped sharing.
+    detail::enable_sharing(dst);
+#endif
+    return;
+}
+
+// Same as above, but the values in `src` are copied. Only the values that are
+// put in `dst` are copied.
+template<typename C, template<typename ...> class T, template<typename ...> class A>
+void merge(basic_value<C, T, A>& dst, const basic_value<C, T, A>& src,
+           const merge_policy& policy = merge_policy{})
+{
+    if(std::addressof(dst) == std::addressof(src)) {return;}
+    detail::merger<basic_value<C, T, A>>(policy).merge(dst, src);
+#ifdef TOML11_COPY_ON_WRITE
+    // the merger took non-const references, which stopped sharing.
+    detail::enable_sharing(dst);
+#endif
+    return;
+}
+
+} // toml
+#endif// TOML11_MERGE_HPP
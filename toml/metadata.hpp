@@ -0,0 +1,177 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_METADATA_HPP
+#define TOML11_METADATA_HPP
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "region.hpp"
+
+namespace toml
+{
+namespace detail
+{
+
+// The region and the comments of a value.
+//
+// Values constructed in a program have neither of them, so basic_value keeps
+// them out of line in a node that is allocated only when needed. The node is
+// reference-counted and shared between copies, and is cloned before it is
+// modified. Once a non-const reference to the comments is given, the node is
+// not shared anymore because the reference might be used to modify it later.
+template<typename Comment>
+class metadata
+{
+  public:
+    using comment_type = Comment;
+
+    metadata() noexcept : node_(nullptr) {}
+    explicit metadata(comment_type com): node_(nullptr)
+    {
+        if(!com.empty())
+        {
+            node_ = new node(nullptr, std::move(com));
+        }
+    }
+    metadata(std::shared_ptr<region_base> reg, comment_type com): node_(nullptr)
+    {
+        if(reg || !com.empty())
+        {
+            node_ = new node(std::move(reg), std::move(com));
+        }
+    }
+    ~metadata() noexcept {this->release();}
+
+    metadata(const metadata& other): node_(other.node_)
+    {
+        if(node_ == nullptr) {return;}
+        if(node_->exclusive)
+        {
+            node_ = new node(node_->region, node_->comments);
+        }
+        else
+        {
+            node_->count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    metadata(metadata&& other) noexcept : node_(other.node_)
+    {
+        other.node_ = nullptr;
+    }
+    metadata& operator=(const metadata& other)
+    {
+        metadata tmp(other);
+        this->swap(tmp);
+        return *this;
+    }
+    metadata& operator=(metadata&& other) noexcept
+    {
+        metadata tmp(std::move(other));
+        this->swap(tmp);
+        return *this;
+    }
+
+    void swap(metadata& other) noexcept {std::swap(node_, other.node_);}
+
+    // returns a default region if the value does not have it.
+    region_base const* region() const noexcept
+    {
+        return (node_ && node_->region) ? node_->region.get() : default_region();
+    }
+    std::shared_ptr<region_base> shared_region() const
+    {
+        return node_ ? node_->region : nullptr;
+    }
+    void set_region(std::shared_ptr<region_base> reg)
+    {
+        if(node_ == nullptr && !reg) {return;}
+        this->make_exclusive();
+        node_->region = std::move(reg);
+        return;
+    }
+    void reset_region()
+    {
+        if(node_ == nullptr) {return;}
+        if(node_->comments.empty())
+        {
+            this->release();
+            return;
+        }
+        this->set_region(nullptr);
+        return;
+    }
+
+    comment_type const& comments() const noexcept
+    {
+        return node_ ? node_->comments : empty_comments();
+    }
+    comment_type& comments()
+    {
+        this->make_exclusive();
+        node_->exclusive = true;
+        return node_->comments;
+    }
+
+    // for toml::memory_usage. nullptr if the node is not allocated.
+    void const* node_address() const noexcept {return node_;}
+    static constexpr std::size_t node_size() noexcept {return sizeof(node);}
+
+  private:
+
+    struct node
+    {
+        node(std::shared_ptr<region_base> reg, comment_type com)
+            : count(1), exclusive(false), region(std::move(reg)), comments(std::move(com))
+        {}
+
+        std::atomic<std::size_t>     count;
+        bool                         exclusive; // see copy constructor
+        std::shared_ptr<region_base> region;
+        comment_type                 comments;
+    };
+
+    void make_exclusive()
+    {
+        if(node_ == nullptr)
+        {
+            node_ = new node(nullptr, comment_type{});
+        }
+        else if(node_->count.load(std::memory_order_acquire) != 1)
+        {
+            node* copied = new node(node_->region, node_->comments);
+            this->release();
+            node_ = copied;
+        }
+        return;
+    }
+
+    void release() noexcept
+    {
+        if(node_ != nullptr &&
+           node_->count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete node_;
+        }
+        node_ = nullptr;
+        return;
+    }
+
+    static region_base const* default_region() noexcept
+    {
+        static const region_base reg = region_base();
+        return std::addressof(reg);
+    }
+    static comment_type const& empty_comments() noexcept
+    {
+        static const comment_type com = comment_type();
+        return com;
+    }
+
+  private:
+    node* node_;
+};
+
+} // detail
+} // toml
+#endif// TOML11_METADATA_HPP
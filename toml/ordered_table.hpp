@@ -0,0 +1,63 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_ORDERED_TABLE_HPP
+#define TOML11_ORDERED_TABLE_HPP
+#include "dense_table.hpp"
+#include "value.hpp"
+
+// Tables with at most this number of elements are searched linearly. Larger
+// tables build a hash index.
+#ifndef TOML11_ORDERED_TABLE_LINEAR_SEARCH_LIMIT
+#define TOML11_ORDERED_TABLE_LINEAR_SEARCH_LIMIT 8
+#endif
+
+namespace toml
+{
+namespace detail
+{
+struct ordered_table_policy
+{
+    static constexpr std::size_t linear_search_limit() noexcept
+    {
+        return TOML11_ORDERED_TABLE_LINEAR_SEARCH_LIMIT;
+    }
+    static constexpr bool preserve_order() noexcept {return true;}
+};
+} // detail
+
+// A map that keeps the order of insertion.
+//
+// It stores its elements in a contiguous array. Small tables are searched
+// linearly, and larger tables look up keys through an open-addressing hash
+// index, so `find` and `at` take O(1) time. Since it iterates over the
+// elements in the order of insertion, the serializer writes keys in the same
+// order as the input file. Small tables, most of the tables in a config file,
+// use less memory than std::map. Larger tables may use more because of the
+// index and the spare capacity of the array.
+//
+// ```cpp
+// const auto data = toml::parse<toml::preserve_comments, toml::ordered_table>("a.toml");
+// std::cout << data << std::endl; // keys are written in the original order
+// ```
+//
+// Differences from std::unordered_map:
+// - value_type is std::pair<Key, T>. Do not modify keys via iterators.
+// - Insertion and erasure invalidate all the iterators and references.
+// - `erase` takes O(n) time to keep the order of the rest of elements.
+template<typename Key, typename T,
+         typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class ordered_table
+    : public detail::dense_table<Key, T, Hash, KeyEqual, detail::ordered_table_policy>
+{
+    using base_type = detail::dense_table<Key, T, Hash, KeyEqual, detail::ordered_table_policy>;
+  public:
+    using base_type::base_type;
+    using base_type::operator=;
+    ordered_table() = default;
+};
+
+// toml::value that keeps the order of keys.
+using ordered_value = basic_value<TOML11_DEFAULT_COMMENT_STRATEGY, ordered_table, std::vector>;
+
+} // toml
+#endif// TOML11_ORDERED_TABLE_HPP
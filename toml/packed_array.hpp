@@ -0,0 +1,431 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_PACKED_ARRAY_HPP
+#define TOML11_PACKED_ARRAY_HPP
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "storage.hpp"
+#include "types.hpp"
+#include "utility.hpp"
+
+namespace toml
+{
+
+// a view of contiguous elements of a packed array.
+template<typename T>
+class span
+{
+  public:
+    using element_type    = T;
+    using value_type      = typename std::remove_cv<T>::type;
+    using size_type       = std::size_t;
+    using pointer         = T*;
+    using reference       = T&;
+    using iterator        = T*;
+    using const_iterator  = T const*;
+
+    span() noexcept : data_(nullptr), size_(0) {}
+    span(pointer p, size_type n) noexcept : data_(p), size_(n) {}
+
+    pointer   data()  const noexcept {return data_;}
+    size_type size()  const noexcept {return size_;}
+    bool      empty() const noexcept {return size_ == 0;}
+
+    iterator begin() const noexcept {return data_;}
+    iterator end()   const noexcept {return data_ + size_;}
+
+    reference operator[](size_type i) const noexcept {return data_[i];}
+    reference front() const noexcept {return data_[0];}
+    reference back()  const noexcept {return data_[size_-1];}
+
+  private:
+    pointer   data_;
+    size_type size_;
+};
+
+namespace detail
+{
+
+// a growable buffer of trivially copyable values. std::vector<bool> is not
+// contiguous, so we cannot use std::vector here.
+template<typename T>
+class packed_buffer
+{
+  public:
+    packed_buffer() noexcept : size_(0), capacity_(0) {}
+    ~packed_buffer() = default;
+    packed_buffer(packed_buffer&& other) noexcept
+        : data_(std::move(other.data_)), size_(other.size_), capacity_(other.capacity_)
+    {
+        other.size_     = 0;
+        other.capacity_ = 0;
+    }
+    packed_buffer& operator=(packed_buffer&& other) noexcept
+    {
+        data_     = std::move(other.data_);
+        size_     = other.size_;
+        capacity_ = other.capacity_;
+        other.size_     = 0;
+        other.capacity_ = 0;
+        return *this;
+    }
+    packed_buffer(const packed_buffer& other)
+        : data_(other.size_ == 0 ? nullptr : new T[other.size_]),
+          size_(other.size_), capacity_(other.size_)
+    {
+        if(size_ != 0) {std::memcpy(data_.get(), other.data_.get(), sizeof(T) * size_);}
+    }
+    packed_buffer& operator=(const packed_buffer& other)
+    {
+        packed_buffer tmp(other);
+        *this = std::move(tmp);
+        return *this;
+    }
+
+    void push_back(const T& x)
+    {
+        if(size_ == capacity_)
+        {
+            this->reallocate((std::max<std::size_t>)(4, capacity_ * 2));
+        }
+        data_[size_++] = x;
+    }
+    void shrink_to_fit()
+    {
+        if(size_ != capacity_) {this->reallocate(size_);}
+    }
+
+    T const*    data() const noexcept {return data_.get();}
+    std::size_t size() const noexcept {return size_;}
+
+  private:
+
+    void reallocate(const std::size_t cap)
+    {
+        std::unique_ptr<T[]> buf(cap == 0 ? nullptr : new T[cap]);
+        if(size_ != 0) {std::memcpy(buf.get(), data_.get(), sizeof(T) * size_);}
+        data_     = std::move(buf);
+        capacity_ = cap;
+    }
+
+  private:
+    std::unique_ptr<T[]> data_;
+    std::size_t size_;
+    std::size_t capacity_;
+};
+
+// An array whose elements are all integers, floatings, or booleans. Those are
+// stored contiguously without regions and comments.
+class packed_array
+{
+  public:
+    packed_array() noexcept : kind_(value_t::empty) {}
+
+    value_t kind() const noexcept {return kind_;}
+
+    std::size_t size() const noexcept
+    {
+        switch(kind_)
+        {
+            case value_t::integer : return integers_ .size();
+            case value_t::floating: return floatings_.size();
+            case value_t::boolean : return booleans_ .size();
+            default               : return 0;
+        }
+    }
+    bool empty() const noexcept {return this->size() == 0;}
+
+    // returns false if the type does not match with the elements.
+    bool push_back(const integer x)
+    {
+        if(!this->accepts(value_t::integer)) {return false;}
+        integers_.push_back(x);
+        return true;
+    }
+    bool push_back(const floating x)
+    {
+        if(!this->accepts(value_t::floating)) {return false;}
+        floatings_.push_back(x);
+        return true;
+    }
+    bool push_back(const boolean x)
+    {
+        if(!this->accepts(value_t::boolean)) {return false;}
+        booleans_.push_back(x);
+        return true;
+    }
+
+    void shrink_to_fit()
+    {
+        integers_ .shrink_to_fit();
+        floatings_.shrink_to_fit();
+        booleans_ .shrink_to_fit();
+    }
+
+    span<const integer> integers() const noexcept
+    {return span<const integer>(integers_.data(), integers_.size());}
+    span<const floating> floatings() const noexcept
+    {return span<const floating>(floatings_.data(), floatings_.size());}
+    span<const boolean> booleans() const noexcept
+    {return span<const boolean>(booleans_.data(), booleans_.size());}
+
+    // returns the i-th element as a value (without regions and comments).
+    template<typename Value>
+    Value element(const std::size_t i) const
+    {
+        switch(kind_)
+        {
+            case value_t::integer : return Value(this->integers() [i]);
+            case value_t::floating: return Value(this->floatings()[i]);
+            default               : return Value(this->booleans() [i]);
+        }
+    }
+
+    // convert into an array of values (without regions and comments).
+    template<typename Array>
+    void unpack_to(Array& ary) const
+    {
+        using value_type = typename Array::value_type;
+        try_reserve(ary, ary.size() + this->size());
+        switch(kind_)
+        {
+            case value_t::integer:
+            {
+                for(const auto& x : this->integers()) {ary.push_back(value_type(x));}
+                return;
+            }
+            case value_t::floating:
+            {
+                for(const auto& x : this->floatings()) {ary.push_back(value_type(x));}
+                return;
+            }
+            case value_t::boolean:
+            {
+                for(const auto& x : this->booleans()) {ary.push_back(value_type(x));}
+                return;
+            }
+            default: return;
+        }
+    }
+
+  private:
+
+    bool accepts(const value_t t) noexcept
+    {
+        if(kind_ == value_t::empty) {kind_ = t;}
+        return kind_ == t;
+    }
+
+  private:
+    value_t                 kind_;
+    packed_buffer<integer>  integers_;
+    packed_buffer<floating> floatings_;
+    packed_buffer<boolean>  booleans_;
+};
+
+inline bool operator==(const packed_array& lhs, const packed_array& rhs)
+{
+    if(lhs.kind() != rhs.kind() || lhs.size() != rhs.size()) {return false;}
+    switch(lhs.kind())
+    {
+        case value_t::integer : return std::equal(lhs.integers().begin(),
+                lhs.integers().end(), rhs.integers().begin());
+        case value_t::floating: return std::equal(lhs.floatings().begin(),
+                lhs.floatings().end(), rhs.floatings().begin());
+        case value_t::boolean : return std::equal(lhs.booleans().begin(),
+                lhs.booleans().end(), rhs.booleans().begin());
+        default: return true;
+    }
+}
+
+// Storage of an array. It has either a normal array or a packed array.
+//
+// A packed array is unpacked when it is accessed as an array of values. Via
+// const reference, it is unpacked in place at the first access under
+// std::call_once and the packed elements are released, so the storage never
+// keeps both. The spans obtained before that become invalid.
+//
+// If TOML11_COPY_ON_WRITE is defined, the contents are shared between copies
+// in the same way as detail::storage.
+template<typename Array>
+struct array_storage
+{
+    using value_type = Array;
+
+  private:
+    struct packed_state;
+#ifdef TOML11_COPY_ON_WRITE
+    using array_pointer  = std::shared_ptr<Array>;
+    using packed_pointer = std::shared_ptr<packed_state>;
+#else
+    using array_pointer  = std::unique_ptr<Array>;
+    using packed_pointer = std::unique_ptr<packed_state>;
+#endif
+
+  public:
+
+    explicit array_storage(value_type const& v): ptr(make_array(v)) {}
+    explicit array_storage(value_type&&      v): ptr(make_array(std::move(v))) {}
+    explicit array_storage(packed_array      p): packed(make_packed(std::move(p))) {}
+    ~array_storage() = default;
+    array_storage(const array_storage& rhs)
+        : ptr(rhs.copy_array()), packed(rhs.copy_packed())
+    {}
+    array_storage& operator=(const array_storage& rhs)
+    {
+        array_storage tmp(rhs);
+        *this = std::move(tmp);
+        return *this;
+    }
+    array_storage(array_storage&&) = default;
+    array_storage& operator=(array_storage&&) = default;
+
+    bool is_ok() const noexcept {return static_cast<bool>(ptr) || static_cast<bool>(packed);}
+    bool is_packed() const noexcept
+    {
+        return packed && !packed->unpacked.load(std::memory_order_acquire);
+    }
+
+    packed_array const& packed_value() const noexcept {return packed->data;}
+
+    std::size_t size() const noexcept
+    {
+        if(ptr) {return ptr->size();}
+        return this->is_packed() ? packed->data.size() : packed->cache->size();
+    }
+
+    value_type const& value() const&
+    {
+        if(ptr) {return *ptr;}
+        packed_state& st = *packed;
+        std::call_once(st.once, [&st]() {
+            auto ary = toml::make_unique<Array>();
+            st.data.unpack_to(*ary);
+            st.cache = std::move(ary);
+            st.data  = packed_array(); // release the packed elements
+            st.unpacked.store(true, std::memory_order_release);
+        });
+        return *st.cache;
+    }
+    value_type& value() &
+    {
+        this->make_exclusive();
+#ifdef TOML11_COPY_ON_WRITE
+        shareable = false;
+#endif
+        return *ptr;
+    }
+    value_type&& value() &&
+    {
+        this->make_exclusive();
+        return std::move(*ptr);
+    }
+
+#ifdef TOML11_COPY_ON_WRITE
+    // see detail::storage.
+    value_type* exclusive_value() noexcept
+    {
+        return shareable ? nullptr : ptr.get();
+    }
+    void share() noexcept {shareable = true;}
+#endif
+
+  private:
+
+    struct packed_state
+    {
+        explicit packed_state(packed_array p): data(std::move(p)), unpacked(false) {}
+
+        packed_array           data;
+        std::once_flag         once;
+        std::unique_ptr<Array> cache;    // the elements after unpacking
+        std::atomic<bool>      unpacked; // true if `data` is moved to `cache`
+    };
+
+#ifdef TOML11_COPY_ON_WRITE
+    template<typename V>
+    static array_pointer make_array(V&& v)
+    {
+        return std::make_shared<Array>(std::forward<V>(v));
+    }
+    static packed_pointer make_packed(packed_array p)
+    {
+        return std::make_shared<packed_state>(std::move(p));
+    }
+    array_pointer copy_array() const
+    {
+        if(!ptr) {return nullptr;}
+        return shareable ? ptr : std::make_shared<Array>(*ptr);
+    }
+    packed_pointer copy_packed() const
+    {
+        return packed; // a packed array is never modified.
+    }
+#else
+    template<typename V>
+    static array_pointer make_array(V&& v)
+    {
+        return toml::make_unique<Array>(std::forward<V>(v));
+    }
+    static packed_pointer make_packed(packed_array p)
+    {
+        return toml::make_unique<packed_state>(std::move(p));
+    }
+    array_pointer copy_array() const
+    {
+        if(ptr) {return toml::make_unique<Array>(*ptr);}
+        // the packed array has been unpacked via const reference.
+        if(packed && !this->is_packed()) {return toml::make_unique<Array>(*packed->cache);}
+        return nullptr;
+    }
+    packed_pointer copy_packed() const
+    {
+        if(!this->is_packed()) {return nullptr;}
+        return toml::make_unique<packed_state>(packed->data);
+    }
+#endif
+
+    void make_exclusive()
+    {
+        if(!ptr)
+        {
+#ifdef TOML11_COPY_ON_WRITE
+            if(packed.use_count() != 1)
+            {
+                // the other copies keep sharing the packed array.
+                ptr = std::make_shared<Array>();
+                if(this->is_packed()) {packed->data.unpack_to(*ptr);}
+                else                  {*ptr = *packed->cache;}
+                packed.reset();
+                return;
+            }
+#endif
+            // unpack it in the same way as `value() const&`, so that the
+            // references returned from it remain valid.
+            static_cast<const array_storage&>(*this).value();
+            ptr = std::move(packed->cache);
+            packed.reset();
+            return;
+        }
+#ifdef TOML11_COPY_ON_WRITE
+        detail::make_exclusive(ptr);
+#endif
+        return;
+    }
+
+  private:
+    array_pointer  ptr;
+    packed_pointer packed;
+#ifdef TOML11_COPY_ON_WRITE
+    bool shareable = true;
+#endif
+};
+
+} // detail
+} // toml
+#endif// TOML11_PACKED_ARRAY_HPP
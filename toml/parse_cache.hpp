@@ -0,0 +1,300 @@
+//     Copyright Toru Niina 2017.
+// Distributed under the MIT License.
+#ifndef TOML11_PARSE_CACHE_HPP
+#define TOML11_PARSE_CACHE_HPP
+#include <cstdint>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "parser.hpp"
+#include "utility.hpp"
+
+namespace toml
+{
+namespace detail
+{
+
+// identifies a version of a file without reading it.
+struct file_identity
+{
+    using stat_type = struct stat;
+
+    decltype(stat_type::st_dev)   device{};
+    decltype(stat_type::st_ino)   inode{};
+    decltype(stat_type::st_size)  size{};
+    decltype(stat_type::st_mtime) mtime_sec{};
+    long                          mtime_nsec{};
+};
+inline bool operator==(const file_identity& lhs, const file_identity& rhs) noexcept
+{
+    return lhs.device    == rhs.device    && lhs.inode      == rhs.inode &&
+           lhs.size      == rhs.size      &&
+           lhs.mtime_sec == rhs.mtime_sec && lhs.mtime_nsec == rhs.mtime_nsec;
+}
+inline bool operator!=(const file_identity& lhs, const file_identity& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+// returns false if the file does not exist.
+inline bool get_file_identity(const std::string& fname, file_identity& id) noexcept
+{
+    struct stat st;
+    if(::stat(fname.c_str(), &st) != 0)
+    {
+        return false;
+    }
+    id.device = st.st_dev;
+    id.inode  = st.st_ino;
+    id.size   = st.st_size;
+#if defined(__APPLE__)
+    id.mtime_sec  = st.st_mtimespec.tv_sec;
+    id.mtime_nsec = st.st_mtimespec.tv_nsec;
+#elif defined(__FreeBSD__) || defined(__linux__)
+    id.mtime_sec  = st.st_mtim.tv_sec;
+    id.mtime_nsec = st.st_mtim.tv_nsec;
+#else
+    id.mtime_sec  = st.st_mtime;
+    id.mtime_nsec = 0;
+#endif
+    return true;
+}
+
+} // detail
+
+// A thread-safe cache of parsed files.
+//
+// It returns the same document while the file is not changed. A file is
+// regarded as changed if its inode, size, or modification time is changed.
+// If `check_content` is true, a changed file whose content is the same as the
+// cached one (e.g. touched or rewritten with the same content) is not parsed
+// again; the file is read and hashed instead.
+//
+// If several threads request the same file at the same time, only one of them
+// parses it and the others wait for the result. When the number of files
+// exceeds the capacity, the least recently used one is removed.
+//
+// ```cpp
+// toml::parse_cache cache(64);
+// std::shared_ptr<const toml::value> data = cache.parse("shared.toml");
+// ```
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+class basic_parse_cache
+{
+  public:
+    using value_type    = basic_value<Comment, Table, Array>;
+    using document_type = std::shared_ptr<const value_type>;
+
+  public:
+
+    explicit basic_parse_cache(const std::size_t capacity = 16,
+                               const bool check_content = false)
+        : capacity_((std::max<std::size_t>)(capacity, 1)),
+          check_content_(check_content), serial_(0), hits_(0), misses_(0)
+    {}
+    ~basic_parse_cache() = default;
+
+    basic_parse_cache(const basic_parse_cache&) = delete;
+    basic_parse_cache& operator=(const basic_parse_cache&) = delete;
+
+    // throws the same exceptions as toml::parse. Failures are not cached.
+    document_type parse(const std::string& fname)
+    {
+        detail::file_identity id;
+        const bool exists = detail::get_file_identity(fname, id);
+
+        std::promise<document_type>        promise;
+        std::shared_future<document_type>  previous;
+        bool                               reuse_previous = false;
+        std::uint64_t                      previous_hash  = 0;
+        std::uint64_t                      serial         = 0;
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            const auto found = index_.find(fname);
+            if(found != index_.end() && exists && found->second->id == id)
+            {
+                lru_.splice(lru_.begin(), lru_, found->second);
+                ++hits_;
+                const auto cached = found->second->document;
+                lock.unlock();
+                return cached.get(); // waits if another thread is parsing it
+            }
+            ++misses_;
+            if(found != index_.end())
+            {
+                previous       = found->second->document;
+                reuse_previous = found->second->has_hash;
+                previous_hash  = found->second->hash;
+                lru_.erase(found->second);
+                index_.erase(found);
+            }
+            if(exists)
+            {
+                serial = ++serial_;
+                lru_.push_front(entry{fname, id, serial, false, 0,
+                                      promise.get_future().share()});
+                index_[fname] = lru_.begin();
+                while(capacity_ < lru_.size())
+                {
+                    index_.erase(lru_.back().name);
+                    lru_.pop_back();
+                }
+            }
+        }
+
+        try
+        {
+            document_type doc;
+            if(check_content_)
+            {
+                auto letters = read_file(fname);
+                const auto hash = detail::fnv1a(letters.data(), letters.data() + letters.size());
+                if(reuse_previous && hash == previous_hash &&
+                   previous.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+                {
+                    doc = previous.get();
+                }
+                else
+                {
+                    doc = std::make_shared<const value_type>(
+                        detail::parse<Comment, Table, Array>(std::move(letters), fname));
+                }
+                this->set_hash(fname, serial, hash);
+            }
+            else
+            {
+                doc = std::make_shared<const value_type>(
+                        ::toml::parse<Comment, Table, Array>(fname));
+            }
+            promise.set_value(doc);
+            return doc;
+        }
+        catch(...)
+        {
+            promise.set_exception(std::current_exception());
+            this->erase_if(fname, serial);
+            throw;
+        }
+    }
+
+    void erase(const std::string& fname)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        const auto found = index_.find(fname);
+        if(found != index_.end())
+        {
+            lru_.erase(found->second);
+            index_.erase(found);
+        }
+        return;
+    }
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        index_.clear();
+        lru_.clear();
+        return;
+    }
+
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return lru_.size();
+    }
+    std::size_t capacity() const noexcept {return capacity_;}
+
+    // the number of calls that returned a cached document, and that did not.
+    std::size_t hits() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return hits_;
+    }
+    std::size_t misses() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return misses_;
+    }
+
+  private:
+
+    struct entry
+    {
+        std::string                       name;
+        detail::file_identity             id;
+        std::uint64_t                     serial;
+        bool                              has_hash;
+        std::uint64_t                     hash;
+        std::shared_future<document_type> document;
+    };
+    using list_type = std::list<entry>;
+
+    static std::vector<char> read_file(const std::string& fname)
+    {
+        std::ifstream ifs(fname, std::ios_base::binary);
+        if(!ifs.good())
+        {
+            throw std::ios_base::failure(
+                    "toml::parse_cache: Error opening file \"" + fname + "\"");
+        }
+        ifs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        ifs.seekg(0, std::ios::end);
+        const auto end = ifs.tellg();
+        ifs.seekg(0, std::ios::beg);
+        std::vector<char> letters(static_cast<std::size_t>(end));
+        ifs.read(letters.data(), end);
+        return letters;
+    }
+
+    // the entry might have been replaced by another thread while parsing.
+    void set_hash(const std::string& fname, const std::uint64_t serial,
+                  const std::uint64_t hash)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        const auto found = index_.find(fname);
+        if(found != index_.end() && found->second->serial == serial)
+        {
+            found->second->has_hash = true;
+            found->second->hash     = hash;
+        }
+        return;
+    }
+    void erase_if(const std::string& fname, const std::uint64_t serial)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        const auto found = index_.find(fname);
+        if(found != index_.end() && found->second->serial == serial)
+        {
+            lru_.erase(found->second);
+            index_.erase(found);
+        }
+        return;
+    }
+
+  private:
+    mutable std::mutex mtx_;
+    std::size_t        capacity_;
+    bool               check_content_;
+    std::uint64_t      serial_;
+    std::size_t        hits_;
+    std::size_t        misses_;
+    list_type          lru_; // the most recently used one first
+    std::unordered_map<std::string, typename list_type::iterator> index_;
+};
+
+using parse_cache = basic_parse_cache<>;
+
+} // toml
+#endif// TOML11_PARSE_CACHE_HPP
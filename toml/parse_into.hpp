@@ -0,0 +1,704 @@
+//     Copyright Toru Niina 2019.
+// Distributed under the MIT License.
+#ifndef TOML11_PARSE_INTO_HPP
+#define TOML11_PARSE_INTO_HPP
+#include <cassert>
+#include <cstdint>
+
+#include <algorithm>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "get.hpp"
+#include "parser.hpp"
+#include "serializer.hpp"
+#include "traits.hpp"
+
+namespace toml
+{
+namespace detail
+{
+
+// collects the paths to the members of T that are not structs with fields.
+// The elements of arrays of structs share the same path, e.g. `records.id`.
+struct field_path_collector
+{
+    template<typename T>
+    static void collect(projection& proj, const std::string& prefix)
+    {
+        ::toml::fields<T>::for_each(field_path_collector{proj, prefix});
+    }
+
+    template<typename Struct, typename Member>
+    void operator()(const char* name, Member Struct::*) const
+    {
+        const std::string path = prefix.empty() ? format_key(std::string(name)) :
+                                 prefix + "." + format_key(std::string(name));
+        this->add<Member>(path);
+    }
+
+    // a struct with fields
+    template<typename T>
+    enable_if_t<has_specialized_fields<T>::value, void> add(const std::string& path) const
+    {
+        collect<T>(proj, path);
+    }
+    // an array of structs with fields
+    template<typename T>
+    enable_if_t<conjunction<negation<has_specialized_fields<T>>,
+        is_array_of_fields<T>>::value, void> add(const std::string& path) const
+    {
+        collect<typename T::value_type>(proj, path);
+    }
+    // the others are read as a whole
+    template<typename T>
+    enable_if_t<conjunction<negation<has_specialized_fields<T>>,
+        negation<is_array_of_fields<T>>>::value, void> add(const std::string& path) const
+    {
+        proj.add(path);
+    }
+
+    projection&        proj;
+    std::string const& prefix;
+};
+
+// ---------------------------------------------------------------------------
+// struct-directed reader
+//
+// The reader walks a file with the lexers and the value parsers, and writes
+// each value into the member of the struct it belongs to. Tables and arrays of
+// tables that correspond to structs with fields are not constructed; the
+// reader keeps a sink for the struct being filled instead. Only the values of
+// the members that are not structs are constructed, and they are converted by
+// toml::get as soon as they are read.
+
+enum class field_kind : std::uint8_t
+{
+    none,             // not a member. the value is skipped.
+    value,            // a member converted from a toml::value.
+    table,            // a struct with fields.
+    array_of_tables   // a container of structs with fields.
+};
+
+// the receiver of key-value pairs in a table.
+template<typename Value>
+class field_sink
+{
+  public:
+    using value_type    = Value;
+    using key_iterator  = std::vector<key>::const_iterator;
+
+    virtual ~field_sink() = default;
+
+    virtual field_kind kind(const key& k) const = 0;
+
+    // the sink of a struct member. If `define` is true, it is defined by a
+    // [table] header and it is an error to define it twice.
+    virtual field_sink* table(const key& k, const bool define, const region& reg) = 0;
+    // appends an element to an array of structs for [[k]].
+    virtual field_sink* array_table(const key& k, const region& reg) = 0;
+    // the last element of an array of structs for [k.sub].
+    virtual field_sink* last_element(const key& k, const region& reg) = 0;
+
+    // `k = v`
+    virtual void assign(const key& k, value_type v, const region& reg) = 0;
+    // a part of a member that is not a struct, e.g. `k.a.b = v` or [k.a].
+    virtual void insert(key_iterator first, key_iterator last, value_type v,
+                        const region& reg, const bool is_array_of_table) = 0;
+
+    // marks it as defined by a [table] header. it cannot be defined twice.
+    virtual void define(const region& reg) = 0;
+    // marks it as defined by dotted keys. it cannot be defined by a [table]
+    // header after that.
+    virtual void extend() = 0;
+    // converts the parts and checks that all the members are found.
+    virtual void finish() = 0;
+};
+
+template<typename T, typename Value>
+class struct_sink;
+
+template<typename T, typename Value>
+struct field_entry
+{
+    using value_type = Value;
+
+    explicit field_entry(const char* n): name(n) {}
+    virtual ~field_entry() = default;
+
+    virtual field_kind kind() const noexcept = 0;
+    virtual void assign(T& obj, const value_type& v) const = 0;
+    virtual std::unique_ptr<field_sink<value_type>> sink(T& obj) const = 0;
+
+    std::string name;
+};
+
+template<typename T, typename Member, typename Value, typename Enable = void>
+struct field_entry_impl final : field_entry<T, Value>
+{
+    using value_type = Value;
+
+    field_entry_impl(const char* n, Member T::* m): field_entry<T, Value>(n), member(m) {}
+
+    field_kind kind() const noexcept override {return field_kind::value;}
+    void assign(T& obj, const value_type& v) const override
+    {
+        obj.*member = ::toml::get<Member>(v);
+    }
+    std::unique_ptr<field_sink<value_type>> sink(T&) const override
+    {
+        return nullptr;
+    }
+
+    Member T::* member;
+};
+template<typename T, typename Member, typename Value>
+struct field_entry_impl<T, Member, Value,
+    enable_if_t<has_specialized_fields<Member>::value, void>> final : field_entry<T, Value>
+{
+    using value_type = Value;
+
+    field_entry_impl(const char* n, Member T::* m): field_entry<T, Value>(n), member(m) {}
+
+    field_kind kind() const noexcept override {return field_kind::table;}
+    void assign(T& obj, const value_type& v) const override
+    {
+        obj.*member = ::toml::get<Member>(v);
+    }
+    std::unique_ptr<field_sink<value_type>> sink(T& obj) const override
+    {
+        return std::unique_ptr<field_sink<value_type>>(
+                new struct_sink<Member, value_type>(obj.*member));
+    }
+
+    Member T::* member;
+};
+template<typename T, typename Member, typename Value>
+struct field_entry_impl<T, Member, Value, enable_if_t<conjunction<
+    negation<has_specialized_fields<Member>>, is_array_of_fields<Member>>::value, void>
+    > final : field_entry<T, Value>
+{
+    using value_type = Value;
+    using elem_type  = typename Member::value_type;
+
+    field_entry_impl(const char* n, Member T::* m): field_entry<T, Value>(n), member(m) {}
+
+    field_kind kind() const noexcept override {return field_kind::array_of_tables;}
+    void assign(T& obj, const value_type& v) const override
+    {
+        obj.*member = ::toml::get<Member>(v);
+    }
+    std::unique_ptr<field_sink<value_type>> sink(T& obj) const override
+    {
+        auto& container = obj.*member;
+        container.emplace_back();
+        return std::unique_ptr<field_sink<value_type>>(
+                new struct_sink<elem_type, value_type>(container.back()));
+    }
+
+    Member T::* member;
+};
+
+// The dispatch table of the members of T. It is built once for each T from
+// toml::fields<T>, and looks up a member by binary search on the names.
+template<typename T, typename Value>
+class field_table
+{
+  public:
+    using entry_type = field_entry<T, Value>;
+
+    static field_table const& get()
+    {
+        static const field_table tab;
+        return tab;
+    }
+
+    std::size_t size() const noexcept {return entries_.size();}
+    entry_type const& at(const std::size_t i) const {return *entries_.at(i);}
+
+    // returns size() if not found.
+    std::size_t find(const key& k) const
+    {
+        const auto found = std::lower_bound(sorted_.begin(), sorted_.end(), k,
+            [this](const std::size_t i, const key& rhs) {
+                return entries_[i]->name < rhs;
+            });
+        if(found != sorted_.end() && entries_[*found]->name == k)
+        {
+            return *found;
+        }
+        return this->size();
+    }
+
+  private:
+
+    struct builder
+    {
+        template<typename Member>
+        void operator()(const char* name, Member T::* member) const
+        {
+            entries.emplace_back(new field_entry_impl<T, Member, Value>(name, member));
+        }
+        std::vector<std::unique_ptr<entry_type>>& entries;
+    };
+
+    field_table()
+    {
+        ::toml::fields<T>::for_each(builder{entries_});
+        sorted_.resize(entries_.size());
+        for(std::size_t i=0; i<sorted_.size(); ++i)
+        {
+            sorted_[i] = i;
+        }
+        std::sort(sorted_.begin(), sorted_.end(),
+            [this](const std::size_t lhs, const std::size_t rhs) {
+                return entries_[lhs]->name < entries_[rhs]->name;
+            });
+    }
+
+    std::vector<std::unique_ptr<entry_type>> entries_;
+    std::vector<std::size_t>                 sorted_;
+};
+
+template<typename T, typename Value>
+class struct_sink final : public field_sink<Value>
+{
+  public:
+    using base_type    = field_sink<Value>;
+    using value_type   = Value;
+    using table_type   = typename value_type::table_type;
+    using key_iterator = typename base_type::key_iterator;
+    using table_info   = field_table<T, Value>;
+
+    explicit struct_sink(T& obj)
+        : obj_(obj), fields_(table_info::get()), found_(fields_.size(), false),
+          defined_(false), dotted_(false)
+    {}
+    ~struct_sink() override = default;
+
+    field_kind kind(const key& k) const override
+    {
+        const auto idx = fields_.find(k);
+        return (idx == fields_.size()) ? field_kind::none : fields_.at(idx).kind();
+    }
+
+    base_type* table(const key& k, const bool define, const region& reg) override
+    {
+        const auto idx = fields_.find(k);
+        auto& child = this->child(idx, reg);
+        if(!child)
+        {
+            child = fields_.at(idx).sink(obj_);
+            found_[idx] = true;
+        }
+        if(define)
+        {
+            child->define(reg);
+        }
+        return child.get();
+    }
+    base_type* array_table(const key& k, const region& reg) override
+    {
+        const auto idx = fields_.find(k);
+        auto& child = this->child(idx, reg);
+        if(child)
+        {
+            child->finish();
+        }
+        child = fields_.at(idx).sink(obj_);
+        found_[idx] = true;
+        return child.get();
+    }
+    base_type* last_element(const key& k, const region& reg) override
+    {
+        const auto idx = fields_.find(k);
+        auto& child = this->child(idx, reg);
+        if(!child)
+        {
+            throw_error("toml::parse_into: array of tables is not defined yet", reg,
+                        "the last element of this array is referred");
+        }
+        return child.get();
+    }
+
+    void assign(const key& k, value_type v, const region& reg) override
+    {
+        const auto idx = fields_.find(k);
+        if(found_[idx] || rest_.count(k) != 0)
+        {
+            throw_error("toml::parse_into: duplicate key", reg, "defined twice");
+        }
+        fields_.at(idx).assign(obj_, v);
+        found_[idx] = true;
+    }
+    void insert(key_iterator first, key_iterator last, value_type v,
+                const region& reg, const bool is_array_of_table) override
+    {
+        if(found_[fields_.find(*first)])
+        {
+            throw_error("toml::parse_into: duplicate key", reg, "defined twice");
+        }
+        const auto inserted = insert_nested_key(rest_, v, first, last, reg, is_array_of_table);
+        if(!inserted)
+        {
+            throw_syntax_error(inserted.unwrap_err(), source_location(reg));
+        }
+    }
+
+    void finish() override
+    {
+        for(auto& c : children_)
+        {
+            c.second->finish();
+        }
+        for(std::size_t i=0; i<fields_.size(); ++i)
+        {
+            if(found_[i])
+            {
+                continue;
+            }
+            const auto& entry = fields_.at(i);
+            const auto found = rest_.find(entry.name);
+            if(found == rest_.end())
+            {
+                throw std::out_of_range(concat_to_string(
+                    "toml::parse_into: key \"", entry.name, "\" not found"));
+            }
+            entry.assign(obj_, found->second);
+        }
+        return;
+    }
+
+    void define(const region& reg) override
+    {
+        if(defined_)
+        {
+            throw_error("toml::parse_into: table defined twice", reg,
+                        "this table is already defined");
+        }
+        if(dotted_)
+        {
+            throw_error("toml::parse_into: table defined twice", reg,
+                        "this table is already defined by dotted keys");
+        }
+        defined_ = true;
+    }
+    void extend() override
+    {
+        dotted_ = true;
+    }
+
+  private:
+
+    std::unique_ptr<base_type>& child(const std::size_t idx, const region& reg)
+    {
+        for(auto& c : children_)
+        {
+            if(c.first == idx) {return c.second;}
+        }
+        if(found_[idx])
+        {
+            throw_error("toml::parse_into: duplicate key", reg, "defined twice");
+        }
+        children_.emplace_back(idx, nullptr);
+        return children_.back().second;
+    }
+
+    [[noreturn]] static void throw_error(const std::string& msg, const region& reg,
+                                         const std::string& comment)
+    {
+        throw syntax_error(format_underline(msg, {{source_location(reg), comment}}),
+                           source_location(reg));
+    }
+
+  private:
+    T&                  obj_;
+    table_info const&   fields_;
+    std::vector<bool>   found_;
+    bool                defined_;
+    bool                dotted_;
+    // the sinks of struct members and the last elements of arrays of structs
+    std::vector<std::pair<std::size_t, std::unique_ptr<base_type>>> children_;
+    // members that are not structs and defined by dotted keys or [table]s
+    table_type          rest_;
+};
+
+template<typename Value>
+class struct_reader
+{
+  public:
+    using value_type = Value;
+    using sink_type  = field_sink<Value>;
+
+    explicit struct_reader(location& loc): loc_(loc) {}
+
+    void read(sink_type& root)
+    {
+        this->read_body(std::addressof(root));
+        while(loc_.iter() != loc_.end())
+        {
+            if(const auto tabkey = parse_array_table_key(loc_))
+            {
+                this->read_table(root, tabkey.unwrap().first, tabkey.unwrap().second, true);
+                continue;
+            }
+            if(const auto tabkey = parse_table_key(loc_))
+            {
+                this->read_table(root, tabkey.unwrap().first, tabkey.unwrap().second, false);
+                continue;
+            }
+            throw syntax_error(format_underline("toml::parse_into: "
+                "unknown line appeared", {{source_location(loc_), "unknown format"}}),
+                source_location(loc_));
+        }
+        root.finish();
+    }
+
+  private:
+
+    // [a.b.c] or [[a.b.c]]
+    void read_table(sink_type& root, const std::vector<key>& keys,
+                    const region& reg, const bool is_array_of_table)
+    {
+        sink_type* sink = std::addressof(root);
+        for(auto iter = keys.begin(); iter != keys.end(); ++iter)
+        {
+            const bool is_last = std::next(iter) == keys.end();
+            switch(sink->kind(*iter))
+            {
+                case field_kind::none:
+                {
+                    this->read_body(nullptr);
+                    return;
+                }
+                case field_kind::table:
+                {
+                    if(is_last && is_array_of_table)
+                    {
+                        throw syntax_error(format_underline("toml::parse_into: "
+                            "a struct is defined as an array of tables",
+                            {{source_location(reg), "this is a table"}}),
+                            source_location(reg));
+                    }
+                    sink = sink->table(*iter, is_last, reg);
+                    break;
+                }
+                case field_kind::array_of_tables:
+                {
+                    if(is_last && !is_array_of_table)
+                    {
+                        throw syntax_error(format_underline("toml::parse_into: "
+                            "an array of structs is defined as a table",
+                            {{source_location(reg), "this is an array of tables"}}),
+                            source_location(reg));
+                    }
+                    sink = is_last ? sink->array_table(*iter, reg) :
+                                     sink->last_element(*iter, reg);
+                    break;
+                }
+                case field_kind::value:
+                {
+                    // a member that is not a struct. construct the table.
+                    auto tab = parse_ml_table<value_type>(loc_, projection{}, keys);
+                    if(!tab)
+                    {
+                        throw_syntax_error(tab.unwrap_err(), source_location(loc_));
+                    }
+                    sink->insert(iter, keys.end(),
+                        value_type(std::move(tab.unwrap()), reg, reg.comments()),
+                        reg, is_array_of_table);
+                    return;
+                }
+            }
+        }
+        this->read_body(sink);
+    }
+
+    // key-value pairs until the next [table]. If sink is null, the values are
+    // checked by the lexers and skipped.
+    void read_body(sink_type* sink)
+    {
+        using skip_line = repeat<
+            sequence<maybe<lex_ws>, maybe<lex_comment>, lex_newline>, at_least<1>>;
+        skip_line::invoke(loc_);
+        lex_ws::invoke(loc_);
+
+        while(loc_.iter() != loc_.end())
+        {
+            lex_ws::invoke(loc_);
+            if(loc_.iter() == loc_.end() || *loc_.iter() == '[') // next table found
+            {
+                return;
+            }
+
+            const auto before = loc_.iter();
+            const auto keys = parse_key(loc_);
+            if(!keys || !lex_keyval_sep::invoke(loc_) ||
+               !this->read_key_value(sink, keys.unwrap().first, keys.unwrap().second))
+            {
+                // parse it again to get an informative error message.
+                loc_.reset(before);
+                const auto kv = parse_key_value_pair<value_type>(loc_, 0);
+                throw_syntax_error(kv ? error_message("toml::parse_into: invalid value")
+                                      : kv.unwrap_err(), source_location(loc_));
+            }
+
+            // the same as parse_ml_table.
+            lex_ws::invoke(loc_);
+            lex_comment::invoke(loc_);
+            const auto newline = skip_line::invoke(loc_);
+            if(!newline && loc_.iter() != loc_.end())
+            {
+                lex_ws::invoke(loc_);
+                throw syntax_error(format_underline("toml::parse_into: "
+                    "invalid line format", {{source_location(loc_), concat_to_string(
+                    "expected newline, but got '", show_char(*loc_.iter()), "'.")}}),
+                    source_location(loc_));
+            }
+            lex_ws::invoke(loc_);
+            lex_comment::invoke(loc_);
+        }
+        return;
+    }
+
+    // `a.b.c = value`. returns false if the value is invalid.
+    bool read_key_value(sink_type* sink, const std::vector<key>& keys, const region& reg)
+    {
+        for(auto iter = keys.begin(); iter != keys.end() && sink; ++iter)
+        {
+            const auto k = sink->kind(*iter);
+            if(k == field_kind::none)
+            {
+                break;
+            }
+            if(std::next(iter) != keys.end() && k == field_kind::table)
+            {
+                sink = sink->table(*iter, false, reg);
+                sink->extend();
+                continue;
+            }
+            if(std::next(iter) != keys.end() && k == field_kind::array_of_tables)
+            {
+                throw syntax_error(format_underline("toml::parse_into: "
+                    "a key is added to an array of tables",
+                    {{source_location(reg), "this is an array of tables"}}),
+                    source_location(reg));
+            }
+
+            auto v = parse_value<value_type>(loc_, 0);
+            if(!v)
+            {
+                return false;
+            }
+            if(std::next(iter) == keys.end())
+            {
+                sink->assign(*iter, std::move(v.unwrap()), reg);
+            }
+            else
+            {
+                sink->insert(iter, keys.end(), std::move(v.unwrap()), reg, false);
+            }
+            return true;
+        }
+        // the lexers may reject a value that the parser accepts. try it.
+        return skip_value(loc_, 0) || static_cast<bool>(parse_value<value_type>(loc_, 0));
+    }
+
+  private:
+    location& loc_;
+};
+
+} // detail
+
+// A projection that contains only the members of T listed in
+// TOML11_DEFINE_CONVERSION_NON_INTRUSIVE, recursively. If T does not have a
+// list of members, the projection keeps everything.
+template<typename T>
+detail::enable_if_t<detail::has_specialized_fields<T>::value, projection>
+fields_projection()
+{
+    projection proj;
+    detail::field_path_collector::collect<T>(proj, std::string{});
+    return proj;
+}
+template<typename T>
+detail::enable_if_t<!detail::has_specialized_fields<T>::value, projection>
+fields_projection()
+{
+    return projection{};
+}
+
+// Parse a file into T. The values are written into the members of T while the
+// file is read, and the tables that correspond to structs are not constructed.
+// Keys that are not members of T are checked by the lexers and skipped.
+//
+// ```cpp
+// struct record {std::int64_t id; std::string name;};
+// struct records {std::vector<record> records;};
+// TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(record,  id, name)
+// TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(records, records)
+//
+// const auto rs = toml::parse_into<records>("records.toml");
+// ```
+template<typename T,
+         typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+detail::enable_if_t<detail::has_specialized_fields<T>::value, T>
+parse_into(std::istream& is, std::string fname = "unknown file")
+{
+    using value_type = basic_value<Comment, Table, Array>;
+
+    const auto beg = is.tellg();
+    is.seekg(0, std::ios::end);
+    const auto end = is.tellg();
+    const auto fsize = end - beg;
+    is.seekg(beg);
+
+    assert(fsize >= 0);
+    std::vector<char> letters(static_cast<std::size_t>(fsize));
+    is.read(letters.data(), fsize);
+
+    auto loc = detail::make_location(std::move(letters), fname);
+
+    T obj;
+    detail::struct_sink<T, value_type> root(obj);
+    detail::struct_reader<value_type>(loc).read(root);
+    return obj;
+}
+
+// T without toml::fields is converted from the whole file.
+template<typename T,
+         typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+detail::enable_if_t<!detail::has_specialized_fields<T>::value, T>
+parse_into(std::istream& is, std::string fname = "unknown file")
+{
+    return ::toml::get<T>(::toml::parse<Comment, Table, Array>(is, std::move(fname)));
+}
+
+template<typename T,
+         typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+T parse_into(std::string fname)
+{
+    std::ifstream ifs(fname, std::ios_base::binary);
+    if(!ifs.good())
+    {
+        throw std::ios_base::failure(
+                "toml::parse_into: Error opening file \"" + fname + "\"");
+    }
+    ifs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    return parse_into<T, Comment, Table, Array>(ifs, std::move(fname));
+}
+
+} // toml
+#endif// TOML11_PARSE_INTO_HPP
@@ -2,11 +2,14 @@
 // Distributed under the MIT License.
 #ifndef TOML11_PARSER_HPP
 #define TOML11_PARSER_HPP
+#include <algorithm>
 #include <cstring>
 #include <fstream>
+#include <initializer_list>
 #include <sstream>
 
 #include "combinator.hpp"
+#include "error_info.hpp"
 #include "lexer.hpp"
 #include "macros.hpp"
 #include "region.hpp"
@@ -33,7 +36,7 @@ namespace toml
 namespace detail
 {
 
-inline result<std::pair<boolean, region>, std::string>
+inline result<std::pair<boolean, region>, error_message>
 parse_boolean(location& loc)
 {
     const auto first = loc.iter();
@@ -51,11 +54,11 @@ parse_boolean(location& loc)
         }
     }
     loc.reset(first); //rollback
-    return err(format_underline("toml::parse_boolean: ",
+    return err(error_message("toml::parse_boolean: ",
                {{source_location(loc), "the next token is not a boolean"}}));
 }
 
-inline result<std::pair<integer, region>, std::string>
+inline result<std::pair<integer, region>, error_message>
 parse_binary_integer(location& loc)
 {
     const auto first = loc.iter();
@@ -78,7 +81,7 @@ parse_binary_integer(location& loc)
         if(static_cast<std::string::size_type>(max_length) < str.size())
         {
             loc.reset(first);
-            return err(format_underline("toml::parse_binary_integer: "
+            return err(error_message("toml::parse_binary_integer: "
                 "only signed 64bit integer is available",
                {{source_location(loc), "too large input (> int64_t)"}}));
         }
@@ -119,11 +122,11 @@ parse_binary_integer(location& loc)
         return ok(std::make_pair(retval, token.unwrap()));
     }
     loc.reset(first);
-    return err(format_underline("toml::parse_binary_integer:",
+    return err(error_message("toml::parse_binary_integer:",
                {{source_location(loc), "the next token is not an integer"}}));
 }
 
-inline result<std::pair<integer, region>, std::string>
+inline result<std::pair<integer, region>, error_message>
 parse_octal_integer(location& loc)
 {
     const auto first = loc.iter();
@@ -148,17 +151,17 @@ parse_octal_integer(location& loc)
             // since we already checked that the string is valid octal integer,
             // so the error reason is out_of_range.
             loc.reset(first);
-            return err(format_underline("toml::parse_octal_integer:",
+            return err(error_message("toml::parse_octal_integer:",
                        {{source_location(loc), "out of range"}}));
         }
         return ok(std::make_pair(retval, token.unwrap()));
     }
     loc.reset(first);
-    return err(format_underline("toml::parse_octal_integer:",
+    return err(error_message("toml::parse_octal_integer:",
                {{source_location(loc), "the next token is not an integer"}}));
 }
 
-inline result<std::pair<integer, region>, std::string>
+inline result<std::pair<integer, region>, error_message>
 parse_hexadecimal_integer(location& loc)
 {
     const auto first = loc.iter();
@@ -175,17 +178,17 @@ parse_hexadecimal_integer(location& loc)
         {
             // see parse_octal_integer for detail of this error message.
             loc.reset(first);
-            return err(format_underline("toml::parse_hexadecimal_integer:",
+            return err(error_message("toml::parse_hexadecimal_integer:",
                        {{source_location(loc), "out of range"}}));
         }
         return ok(std::make_pair(retval, token.unwrap()));
     }
     loc.reset(first);
-    return err(format_underline("toml::parse_hexadecimal_integer",
+    return err(error_message("toml::parse_hexadecimal_integer",
                {{source_location(loc), "the next token is not an integer"}}));
 }
 
-inline result<std::pair<integer, region>, std::string>
+inline result<std::pair<integer, region>, error_message>
 parse_integer(location& loc)
 {
     const auto first = loc.iter();
@@ -204,13 +207,13 @@ parse_integer(location& loc)
 
         if(std::isdigit(*second))
         {
-            return err(format_underline("toml::parse_integer: "
+            return err(error_message("toml::parse_integer: "
                 "leading zero in an Integer is not allowed.",
                 {{source_location(loc), "leading zero"}}));
         }
         else if(std::isalpha(*second))
         {
-             return err(format_underline("toml::parse_integer: "
+             return err(error_message("toml::parse_integer: "
                 "unknown integer prefix appeared.",
                 {{source_location(loc), "none of 0x, 0o, 0b"}}));
         }
@@ -228,17 +231,17 @@ parse_integer(location& loc)
         {
             // see parse_octal_integer for detail of this error message.
             loc.reset(first);
-            return err(format_underline("toml::parse_integer:",
+            return err(error_message("toml::parse_integer:",
                        {{source_location(loc), "out of range"}}));
         }
         return ok(std::make_pair(retval, token.unwrap()));
     }
     loc.reset(first);
-    return err(format_underline("toml::parse_integer: ",
+    return err(error_message("toml::parse_integer: ",
                {{source_location(loc), "the next token is not an integer"}}));
 }
 
-inline result<std::pair<floating, region>, std::string>
+inline result<std::pair<floating, region>, error_message>
 parse_floating(location& loc)
 {
     const auto first = loc.iter();
@@ -323,13 +326,13 @@ parse_floating(location& loc)
         {
             // see parse_octal_integer for detail of this error message.
             loc.reset(first);
-            return err(format_underline("toml::parse_floating:",
+            return err(error_message("toml::parse_floating:",
                        {{source_location(loc), "out of range"}}));
         }
         return ok(std::make_pair(v, token.unwrap()));
     }
     loc.reset(first);
-    return err(format_underline("toml::parse_floating: ",
+    return err(error_message("toml::parse_floating: ",
                {{source_location(loc), "the next token is not a float"}}));
 }
 
@@ -390,12 +393,12 @@ inline std::string read_utf8_codepoint(const region& reg, const location& loc)
     return character;
 }
 
-inline result<std::string, std::string> parse_escape_sequence(location& loc)
+inline result<std::string, error_message> parse_escape_sequence(location& loc)
 {
     const auto first = loc.iter();
     if(first == loc.end() || *first != '\\')
     {
-        return err(format_underline("toml::parse_escape_sequence: ", {{
+        return err(error_message("toml::parse_escape_sequence: ", {{
             source_location(loc), "the next token is not a backslash \"\\\""}}));
     }
     loc.advance();
@@ -419,7 +422,7 @@ inline result<std::string, std::string> parse_escape_sequence(location& loc)
             }
             else
             {
-                return err(format_underline("parse_escape_sequence: "
+                return err(error_message("parse_escape_sequence: "
                            "invalid token found in UTF-8 codepoint uXXXX.",
                            {{source_location(loc), "here"}}));
             }
@@ -432,14 +435,14 @@ inline result<std::string, std::string> parse_escape_sequence(location& loc)
             }
             else
             {
-                return err(format_underline("parse_escape_sequence: "
+                return err(error_message("parse_escape_sequence: "
                            "invalid token found in UTF-8 codepoint Uxxxxxxxx",
                            {{source_location(loc), "here"}}));
             }
         }
     }
 
-    const auto msg = format_underline("parse_escape_sequence: "
+    const auto msg = error_message("parse_escape_sequence: "
            "unknown escape sequence appeared.", {{source_location(loc),
            "escape sequence is one of \\, \", b, t, n, f, r, uxxxx, Uxxxxxxxx"}},
            /* Hints = */{"if you want to write backslash as just one backslash, "
@@ -461,7 +464,7 @@ inline std::ptrdiff_t check_utf8_validity(const std::string& reg)
     return -1;
 }
 
-inline result<std::pair<toml::string, region>, std::string>
+inline result<std::pair<toml::string, region>, error_message>
 parse_ml_basic_string(location& loc)
 {
     const auto first = loc.iter();
@@ -548,13 +551,13 @@ parse_ml_basic_string(location& loc)
     else
     {
         loc.reset(first);
-        return err(format_underline("toml::parse_ml_basic_string: "
+        return err(error_message("toml::parse_ml_basic_string: "
                    "the next token is not a valid multiline string",
                    {{source_location(loc), "here"}}));
     }
 }
 
-inline result<std::pair<toml::string, region>, std::string>
+inline result<std::pair<toml::string, region>, error_message>
 parse_basic_string(location& loc)
 {
     const auto first = loc.iter();
@@ -614,13 +617,13 @@ parse_basic_string(location& loc)
     else
     {
         loc.reset(first); // rollback
-        return err(format_underline("toml::parse_basic_string: "
+        return err(error_message("toml::parse_basic_string: "
                    "the next token is not a valid string",
                    {{source_location(loc), "here"}}));
     }
 }
 
-inline result<std::pair<toml::string, region>, std::string>
+inline result<std::pair<toml::string, region>, error_message>
 parse_ml_literal_string(location& loc)
 {
     const auto first = loc.iter();
@@ -691,13 +694,13 @@ parse_ml_literal_string(location& loc)
     else
     {
         loc.reset(first); // rollback
-        return err(format_underline("toml::parse_ml_literal_string: "
+        return err(error_message("toml::parse_ml_literal_string: "
                    "the next token is not a valid multiline literal string",
                    {{source_location(loc), "here"}}));
     }
 }
 
-inline result<std::pair<toml::string, region>, std::string>
+inline result<std::pair<toml::string, region>, error_message>
 parse_literal_string(location& loc)
 {
     const auto first = loc.iter();
@@ -746,13 +749,13 @@ parse_literal_string(location& loc)
     else
     {
         loc.reset(first); // rollback
-        return err(format_underline("toml::parse_literal_string: "
+        return err(error_message("toml::parse_literal_string: "
                    "the next token is not a valid literal string",
                    {{source_location(loc), "here"}}));
     }
 }
 
-inline result<std::pair<toml::string, region>, std::string>
+inline result<std::pair<toml::string, region>, error_message>
 parse_string(location& loc)
 {
     if(loc.iter() != loc.end() && *(loc.iter()) == '"')
@@ -779,11 +782,11 @@ parse_string(location& loc)
             return parse_literal_string(loc);
         }
     }
-    return err(format_underline("toml::parse_string: ",
+    return err(error_message("toml::parse_string: ",
                 {{source_location(loc), "the next token is not a string"}}));
 }
 
-inline result<std::pair<local_date, region>, std::string>
+inline result<std::pair<local_date, region>, error_message>
 parse_local_date(location& loc)
 {
     const auto first = loc.iter();
@@ -851,12 +854,12 @@ parse_local_date(location& loc)
     else
     {
         loc.reset(first);
-        return err(format_underline("toml::parse_local_date: ",
+        return err(error_message("toml::parse_local_date: ",
             {{source_location(loc), "the next token is not a local_date"}}));
     }
 }
 
-inline result<std::pair<local_time, region>, std::string>
+inline result<std::pair<local_time, region>, error_message>
 parse_local_time(location& loc)
 {
     const auto first = loc.iter();
@@ -951,12 +954,12 @@ parse_local_time(location& loc)
     else
     {
         loc.reset(first);
-        return err(format_underline("toml::parse_local_time: ",
+        return err(error_message("toml::parse_local_time: ",
             {{source_location(loc), "the next token is not a local_time"}}));
     }
 }
 
-inline result<std::pair<local_datetime, region>, std::string>
+inline result<std::pair<local_datetime, region>, error_message>
 parse_local_datetime(location& loc)
 {
     const auto first = loc.iter();
@@ -995,12 +998,12 @@ parse_local_datetime(location& loc)
     else
     {
         loc.reset(first);
-        return err(format_underline("toml::parse_local_datetime: ",
+        return err(error_message("toml::parse_local_datetime: ",
             {{source_location(loc), "the next token is not a local_datetime"}}));
     }
 }
 
-inline result<std::pair<offset_datetime, region>, std::string>
+inline result<std::pair<offset_datetime, region>, error_message>
 parse_offset_datetime(location& loc)
 {
     const auto first = loc.iter();
@@ -1054,12 +1057,12 @@ parse_offset_datetime(location& loc)
     else
     {
         loc.reset(first);
-        return err(format_underline("toml::parse_offset_datetime: ",
+        return err(error_message("toml::parse_offset_datetime: ",
             {{source_location(loc), "the next token is not a offset_datetime"}}));
     }
 }
 
-inline result<std::pair<key, region>, std::string>
+inline result<std::pair<key, region>, error_message>
 parse_simple_key(location& loc)
 {
     if(const auto bstr = parse_basic_string(loc))
@@ -1075,12 +1078,12 @@ parse_simple_key(location& loc)
         const auto reg = bare.unwrap();
         return ok(std::make_pair(reg.str(), reg));
     }
-    return err(format_underline("toml::parse_simple_key: ",
+    return err(error_message("toml::parse_simple_key: ",
             {{source_location(loc), "the next token is not a simple key"}}));
 }
 
 // dotted key become vector of keys
-inline result<std::pair<std::vector<key>, region>, std::string>
+inline result<std::pair<std::vector<key>, region>, error_message>
 parse_key(location& loc)
 {
     const auto first = loc.iter();
@@ -1103,7 +1106,7 @@ parse_key(location& loc)
             {
                 throw internal_error(format_underline(
                     "toml::parse_key: dotted key contains invalid key",
-                    {{source_location(inner_loc), k.unwrap_err()}}),
+                    {{source_location(inner_loc), k.unwrap_err().str()}}),
                     source_location(inner_loc));
             }
 
@@ -1134,7 +1137,7 @@ parse_key(location& loc)
         return ok(std::make_pair(std::vector<key>(1, smpl.unwrap().first),
                                  smpl.unwrap().second));
     }
-    return err(format_underline("toml::parse_key: an invalid key appeared.",
+    return err(error_message("toml::parse_key: an invalid key appeared.",
                 {{source_location(loc), "is not a valid key"}}, {
                 "bare keys  : non-empty strings composed only of [A-Za-z0-9_-].",
                 "quoted keys: same as \"basic strings\" or 'literal strings'.",
@@ -1144,11 +1147,29 @@ parse_key(location& loc)
 
 // forward-decl to implement parse_array and parse_table
 template<typename Value>
-result<Value, std::string> parse_value(location&, const std::size_t n_rec);
+result<Value, error_message> parse_value(location&, const std::size_t n_rec);
 
+// push a value into a packed array if possible.
 template<typename Value>
-result<std::pair<typename Value::array_type, region>, std::string>
-parse_array(location& loc, const std::size_t n_rec)
+bool try_pack(packed_array& packed, const Value& v)
+{
+    if(!v.comments().empty()) {return false;}
+    switch(v.type())
+    {
+        case value_t::integer : return packed.push_back(v.as_integer (std::nothrow));
+        case value_t::floating: return packed.push_back(v.as_floating(std::nothrow));
+        case value_t::boolean : return packed.push_back(v.as_boolean (std::nothrow));
+        default               : return false;
+    }
+}
+
+// If `packed` is not null, it tries to store the elements in `packed`. If it
+// succeeded, the returned array is empty and `packed` has the elements. If
+// the elements cannot be packed, `packed` is left empty.
+template<typename Value>
+result<std::pair<typename Value::array_type, region>, error_message>
+parse_array(location& loc, const std::size_t n_rec,
+            packed_array* packed = nullptr)
 {
     using value_type = Value;
     using array_type = typename value_type::array_type;
@@ -1189,32 +1210,50 @@ parse_array(location& loc, const std::size_t n_rec)
 
         if(auto val = parse_value<value_type>(loc, n_rec+1))
         {
-            // After TOML v1.0.0-rc.1, array becomes to be able to have values
-            // with different types. So here we will omit this by default.
-            //
-            // But some of the test-suite checks if the parser accepts a hetero-
-            // geneous arrays, so we keep this for a while.
-#ifdef TOML11_DISALLOW_HETEROGENEOUS_ARRAYS
-            if(!retval.empty() && retval.front().type() != val.as_ok().type())
+            if(packed != nullptr && try_pack(*packed, val.unwrap()))
             {
-                auto array_start_loc = loc;
-                array_start_loc.reset(first);
-
-                throw syntax_error(format_underline("toml::parse_array: "
-                    "type of elements should be the same each other.", {
-                        {source_location(array_start_loc), "array starts here"},
-                        {
-                            retval.front().location(),
-                            "value has type " + stringize(retval.front().type())
-                        },
-                        {
-                            val.unwrap().location(),
-                            "value has different type, " + stringize(val.unwrap().type())
-                        }
-                    }), source_location(loc));
+                // packed. go to the next element.
             }
+            else if(packed != nullptr && !packed->empty())
+            {
+                // Some elements are already packed, but now it turned out
+                // that the array cannot be packed. To keep the regions of
+                // the elements, parse the array again without packing.
+                *packed = packed_array{};
+                loc.reset(first);
+                return parse_array<value_type>(loc, n_rec, nullptr);
+            }
+            else
+            {
+                packed = nullptr; // the first element cannot be packed.
+
+                // After TOML v1.0.0-rc.1, array becomes to be able to have values
+                // with different types. So here we will omit this by default.
+                //
+                // But some of the test-suite checks if the parser accepts a hetero-
+                // geneous arrays, so we keep this for a while.
+#ifdef TOML11_DISALLOW_HETEROGENEOUS_ARRAYS
+                if(!retval.empty() && retval.front().type() != val.as_ok().type())
+                {
+                    auto array_start_loc = loc;
+                    array_start_loc.reset(first);
+
+                    throw syntax_error(format_underline("toml::parse_array: "
+                        "type of elements should be the same each other.", {
+                            {source_location(array_start_loc), "array starts here"},
+                            {
+                                retval.front().location(),
+                                "value has type " + stringize(retval.front().type())
+                            },
+                            {
+                                val.unwrap().location(),
+                                "value has different type, " + stringize(val.unwrap().type())
+                            }
+                        }), source_location(loc));
+                }
 #endif
-            retval.push_back(std::move(val.unwrap()));
+                retval.push_back(std::move(val.unwrap()));
+            }
         }
         else
         {
@@ -1260,7 +1299,7 @@ parse_array(location& loc, const std::size_t n_rec)
 }
 
 template<typename Value>
-result<std::pair<std::pair<std::vector<key>, region>, Value>, std::string>
+result<std::pair<std::pair<std::vector<key>, region>, Value>, error_message>
 parse_key_value_pair(location& loc, const std::size_t n_rec)
 {
     using value_type = Value;
@@ -1269,13 +1308,13 @@ parse_key_value_pair(location& loc, const std::size_t n_rec)
     auto key_reg = parse_key(loc);
     if(!key_reg)
     {
-        std::string msg = std::move(key_reg.unwrap_err());
+        error_message msg = std::move(key_reg.unwrap_err());
         // if the next token is keyvalue-separator, it means that there are no
         // key. then we need to show error as "empty key is not allowed".
         if(const auto keyval_sep = lex_keyval_sep::invoke(loc))
         {
             loc.reset(first);
-            msg = format_underline("toml::parse_key_value_pair: "
+            msg = error_message("toml::parse_key_value_pair: "
                 "empty key is not allowed.",
                 {{source_location(loc), "key expected before '='"}});
         }
@@ -1285,13 +1324,13 @@ parse_key_value_pair(location& loc, const std::size_t n_rec)
     const auto kvsp = lex_keyval_sep::invoke(loc);
     if(!kvsp)
     {
-        std::string msg;
+        error_message msg;
         // if the line contains '=' after the invalid sequence, possibly the
         // error is in the key (like, invalid character in bare key).
         const auto line_end = std::find(loc.iter(), loc.end(), '\n');
         if(std::find(loc.iter(), line_end, '=') != line_end)
         {
-            msg = format_underline("toml::parse_key_value_pair: "
+            msg = error_message("toml::parse_key_value_pair: "
                 "invalid format for key",
                 {{source_location(loc), "invalid character in key"}},
                 {"Did you forget '.' to separate dotted-key?",
@@ -1299,7 +1338,7 @@ parse_key_value_pair(location& loc, const std::size_t n_rec)
         }
         else // if not, the error is lack of key-value separator.
         {
-            msg = format_underline("toml::parse_key_value_pair: "
+            msg = error_message("toml::parse_key_value_pair: "
                 "missing key-value separator `=`",
                 {{source_location(loc), "should be `=`"}});
         }
@@ -1311,13 +1350,13 @@ parse_key_value_pair(location& loc, const std::size_t n_rec)
     auto val = parse_value<value_type>(loc, n_rec);
     if(!val)
     {
-        std::string msg;
+        error_message msg;
         loc.reset(after_kvsp);
         // check there is something not a comment/whitespace after `=`
         if(sequence<maybe<lex_ws>, maybe<lex_comment>, lex_newline>::invoke(loc))
         {
             loc.reset(after_kvsp);
-            msg = format_underline("toml::parse_key_value_pair: "
+            msg = error_message("toml::parse_key_value_pair: "
                     "missing value after key-value separator '='",
                     {{source_location(loc), "expected value, but got nothing"}});
         }
@@ -1326,7 +1365,7 @@ parse_key_value_pair(location& loc, const std::size_t n_rec)
             msg = std::move(val.unwrap_err());
         }
         loc.reset(first);
-        return err(msg);
+        return err(std::move(msg));
     }
     return ok(std::make_pair(std::move(key_reg.unwrap()),
                              std::move(val.unwrap())));
@@ -1349,12 +1388,12 @@ std::string format_dotted_keys(InputIterator first, const InputIterator last)
 }
 
 // forward decl for is_valid_forward_table_definition
-result<std::pair<std::vector<key>, region>, std::string>
+result<std::pair<std::vector<key>, region>, error_message>
 parse_table_key(location& loc);
-result<std::pair<std::vector<key>, region>, std::string>
+result<std::pair<std::vector<key>, region>, error_message>
 parse_array_table_key(location& loc);
 template<typename Value>
-result<std::pair<typename Value::table_type, region>, std::string>
+result<std::pair<typename Value::table_type, region>, error_message>
 parse_inline_table(location& loc, const std::size_t n_rec);
 
 // The following toml file is allowed.
@@ -1520,7 +1559,7 @@ bool is_valid_forward_table_definition(const Value& fwd, const Value& inserting,
 }
 
 template<typename Value, typename InputIterator>
-result<bool, std::string>
+result<bool, error_message>
 insert_nested_key(typename Value::table_type& root, const Value& v,
                   InputIterator iter, const InputIterator last,
                   region key_reg,
@@ -1552,17 +1591,17 @@ insert_nested_key(typename Value::table_type& root, const Value& v,
                     if(tab->at(k).is_table())
                     {
                         // show special err msg for conflicting table
-                        throw syntax_error(format_underline(concat_to_string(
+                        return err(error_message(concat_to_string(
                             "toml::insert_value: array of table (\"",
                             format_dotted_keys(first, last),
                             "\") cannot be defined"), {
                                 {tab->at(k).location(), "table already defined"},
                                 {v.location(), "this conflicts with the previous table"}
-                            }), v.location());
+                            }, {}, v.location()));
                     }
                     else if(!(tab->at(k).is_array()))
                     {
-                        throw syntax_error(format_underline(concat_to_string(
+                        return err(error_message(concat_to_string(
                             "toml::insert_value: array of table (\"",
                             format_dotted_keys(first, last), "\") collides with"
                             " existing value"), {
@@ -1571,7 +1610,7 @@ insert_nested_key(typename Value::table_type& root, const Value& v,
                                                   " value already exists")},
                                 {v.location(),
                                  "while inserting this array-of-tables"}
-                            }), v.location());
+                            }, {}, v.location()));
                     }
                     // the above if-else-if checks tab->at(k) is an array
                     auto& a = tab->at(k).as_array();
@@ -1580,7 +1619,7 @@ insert_nested_key(typename Value::table_type& root, const Value& v,
                     // defined as `aot = []`, it cannot be appended.
                     if(a.empty() || !(a.front().is_table()))
                     {
-                        throw syntax_error(format_underline(concat_to_string(
+                        return err(error_message(concat_to_string(
                             "toml::insert_value: array of table (\"",
                             format_dotted_keys(first, last), "\") collides with"
                             " existing value"), {
@@ -1589,7 +1628,7 @@ insert_nested_key(typename Value::table_type& root, const Value& v,
                                                   " value already exists")},
                                 {v.location(),
                                  "while inserting this array-of-tables"}
-                            }), v.location());
+                            }, {}, v.location()));
                     }
                     // avoid conflicting array of table like the following.
                     // ```toml
@@ -1610,7 +1649,7 @@ insert_nested_key(typename Value::table_type& root, const Value& v,
                     {
                         if(ptr->str().substr(0,2) != "[[")
                         {
-                            throw syntax_error(format_underline(concat_to_string(
+                            return err(error_message(concat_to_string(
                                 "toml::insert_value: array of table (\"",
                                 format_dotted_keys(first, last), "\") collides "
                                 "with existing array-of-tables"), {
@@ -1619,7 +1658,7 @@ insert_nested_key(typename Value::table_type& root, const Value& v,
                                                       " value has static size")},
                                     {v.location(),
                                      "appending it to the statically sized array"}
-                                }), v.location());
+                                }, {}, v.location()));
                         }
                     }
                     a.push_back(v);
@@ -1674,13 +1713,13 @@ insert_nested_key(typename Value::table_type& root, const Value& v,
                     if(!is_valid_forward_table_definition(
                                 tab->at(k), v, first, iter, last))
                     {
-                        throw syntax_error(format_underline(concat_to_string(
+                        return err(error_message(concat_to_string(
                             "toml::insert_value: table (\"",
                             format_dotted_keys(first, last),
                             "\") already exists."), {
                                 {tab->at(k).location(), "table already exists here"},
                                 {v.location(), "table defined twice"}
-                            }), v.location());
+                            }, {}, v.location()));
                     }
                     // to allow the following toml file.
                     // [a.b.c]
@@ -1692,13 +1731,13 @@ insert_nested_key(typename Value::table_type& root, const Value& v,
                     {
                         if(tab->at(k).contains(kv.first))
                         {
-                            throw syntax_error(format_underline(concat_to_string(
+                            return err(error_message(concat_to_string(
                                 "toml::insert_value: value (\"",
                                 format_dotted_keys(first, last),
                                 "\") already exists."), {
                                     {t.at(kv.first).location(), "already exists here"},
                                     {v.location(), "this defined twice"}
-                                }), v.location());
+                                }, {}, v.location()));
                         }
                         t[kv.first] = kv.second;
                     }
@@ -1710,21 +1749,21 @@ insert_nested_key(typename Value::table_type& root, const Value& v,
                         tab->at(k).as_array().size() > 0 &&
                         tab->at(k).as_array().front().is_table())
                 {
-                    throw syntax_error(format_underline(concat_to_string(
+                    return err(error_message(concat_to_string(
                         "toml::insert_value: array of tables (\"",
                         format_dotted_keys(first, last), "\") already exists."), {
                             {tab->at(k).location(), "array of tables defined here"},
                             {v.location(), "table conflicts with the previous array of table"}
-                        }), v.location());
+                        }, {}, v.location()));
                 }
                 else
                 {
-                    throw syntax_error(format_underline(concat_to_string(
+                    return err(error_message(concat_to_string(
                         "toml::insert_value: value (\"",
                         format_dotted_keys(first, last), "\") already exists."), {
                             {tab->at(k).location(), "value already exists here"},
                             {v.location(), "value defined twice"}
-                        }), v.location());
+                        }, {}, v.location()));
                 }
             }
             tab->insert(std::make_pair(k, v));
@@ -1756,13 +1795,13 @@ insert_nested_key(typename Value::table_type& root, const Value& v,
                     // should be something like `[table-name]`.
                     if(ptr->front() == '{')
                     {
-                        throw syntax_error(format_underline(concat_to_string(
+                        return err(error_message(concat_to_string(
                             "toml::insert_value: inserting to an inline table (",
                             format_dotted_keys(first, std::next(iter)),
                             ") but inline tables are immutable"), {
                                 {tab->at(k).location(), "inline tables are immutable"},
                                 {v.location(), "inserting this"}
-                            }), v.location());
+                            }, {}, v.location()));
                     }
                 }
                 tab = std::addressof((*tab)[k].as_table());
@@ -1772,58 +1811,58 @@ insert_nested_key(typename Value::table_type& root, const Value& v,
                 auto& a = (*tab)[k].as_array();
                 if(!a.back().is_table())
                 {
-                    throw syntax_error(format_underline(concat_to_string(
+                    return err(error_message(concat_to_string(
                         "toml::insert_value: target (",
                         format_dotted_keys(first, std::next(iter)),
                         ") is neither table nor an array of tables"), {
                             {a.back().location(), concat_to_string(
                                     "actual type is ", a.back().type())},
                             {v.location(), "inserting this"}
-                        }), v.location());
+                        }, {}, v.location()));
                 }
                 if(a.empty())
                 {
-                    throw syntax_error(format_underline(concat_to_string(
+                    return err(error_message(concat_to_string(
                         "toml::insert_value: table (\"",
                         format_dotted_keys(first, last), "\") conflicts with"
                         " existing value"), {
                             {tab->at(k).location(), std::string("this array is not insertable")},
                             {v.location(), std::string("appending it to the statically sized array")}
-                        }), v.location());
+                        }, {}, v.location()));
                 }
                 if(const auto ptr = detail::get_region(a.at(0)))
                 {
                     if(ptr->str().substr(0,2) != "[[")
                     {
-                        throw syntax_error(format_underline(concat_to_string(
+                        return err(error_message(concat_to_string(
                             "toml::insert_value: a table (\"",
                             format_dotted_keys(first, last), "\") cannot be "
                             "inserted to an existing inline array-of-tables"), {
                                 {tab->at(k).location(), std::string("this array of table has a static size")},
                                 {v.location(), std::string("appending it to the statically sized array")}
-                            }), v.location());
+                            }, {}, v.location()));
                     }
                 }
                 tab = std::addressof(a.back().as_table());
             }
             else
             {
-                throw syntax_error(format_underline(concat_to_string(
+                return err(error_message(concat_to_string(
                     "toml::insert_value: target (",
                     format_dotted_keys(first, std::next(iter)),
                     ") is neither table nor an array of tables"), {
                         {tab->at(k).location(), concat_to_string(
                                 "actual type is ", tab->at(k).type())},
                         {v.location(), "inserting this"}
-                    }), v.location());
+                    }, {}, v.location()));
             }
         }
     }
-    return err(std::string("toml::detail::insert_nested_key: never reach here"));
+    return err(error_message("toml::detail::insert_nested_key: never reach here"));
 }
 
 template<typename Value>
-result<std::pair<typename Value::table_type, region>, std::string>
+result<std::pair<typename Value::table_type, region>, error_message>
 parse_inline_table(location& loc, const std::size_t n_rec)
 {
     using value_type = Value;
@@ -1840,7 +1879,7 @@ parse_inline_table(location& loc, const std::size_t n_rec)
     table_type retval;
     if(!(loc.iter() != loc.end() && *loc.iter() == '{'))
     {
-        return err(format_underline("toml::parse_inline_table: ",
+        return err(error_message("toml::parse_inline_table: ",
             {{source_location(loc), "the next token is not an inline table"}}));
     }
     loc.advance();
@@ -1871,9 +1910,10 @@ parse_inline_table(location& loc, const std::size_t n_rec)
             insert_nested_key(retval, val, keys.begin(), keys.end(), key_reg);
         if(!inserted)
         {
-            throw internal_error("toml::parse_inline_table: "
-                "failed to insert value into table: " + inserted.unwrap_err(),
-                source_location(loc));
+            // the inline table is broken. do not let an enclosing array
+            // replace the message with its own one.
+            const auto& e = inserted.unwrap_err();
+            throw syntax_error(e.str(), e.where());
         }
 
         using lex_table_separator = sequence<maybe<lex_ws>, character<','>>;
@@ -1931,7 +1971,7 @@ parse_inline_table(location& loc, const std::size_t n_rec)
             source_location(loc));
 }
 
-inline result<value_t, std::string> guess_number_type(const location& l)
+inline result<value_t, error_message> guess_number_type(const location& l)
 {
     // This function tries to find some (common) mistakes by checking characters
     // that follows the last character of a value. But it is often difficult
@@ -1950,7 +1990,7 @@ inline result<value_t, std::string> guess_number_type(const location& l)
         if(loc.iter() != loc.end() && (*loc.iter() == '+' || *loc.iter() == '-'
                     || *loc.iter() == 'Z' || *loc.iter() == 'z'))
         {
-            return err(format_underline("bad offset: should be [+-]HH:MM or Z",
+            return err(error_message("bad offset: should be [+-]HH:MM or Z",
                         {{source_location(loc), "[+-]HH:MM or Z"}},
                         {"pass: +09:00, -05:30", "fail: +9:00, -5:30"}));
         }
@@ -1970,14 +2010,14 @@ inline result<value_t, std::string> guess_number_type(const location& l)
             const auto c = *loc.iter();
             if(c == 'T' || c == 't')
             {
-                return err(format_underline("bad time: should be HH:MM:SS.subsec",
+                return err(error_message("bad time: should be HH:MM:SS.subsec",
                         {{source_location(loc), "HH:MM:SS.subsec"}},
                         {"pass: 1979-05-27T07:32:00, 1979-05-27 07:32:00.999999",
                          "fail: 1979-05-27T7:32:00, 1979-05-27 17:32"}));
             }
             if('0' <= c && c <= '9')
             {
-                return err(format_underline("bad time: missing T",
+                return err(error_message("bad time: missing T",
                         {{source_location(loc), "T or space required here"}},
                         {"pass: 1979-05-27T07:32:00, 1979-05-27 07:32:00.999999",
                          "fail: 1979-05-27T7:32:00, 1979-05-27 7:32"}));
@@ -1986,7 +2026,7 @@ inline result<value_t, std::string> guess_number_type(const location& l)
                 ('0' <= *std::next(loc.iter()) && *std::next(loc.iter())<= '9'))
             {
                 loc.advance();
-                return err(format_underline("bad time: should be HH:MM:SS.subsec",
+                return err(error_message("bad time: should be HH:MM:SS.subsec",
                         {{source_location(loc), "HH:MM:SS.subsec"}},
                         {"pass: 1979-05-27T07:32:00, 1979-05-27 07:32:00.999999",
                          "fail: 1979-05-27T7:32:00, 1979-05-27 7:32"}));
@@ -2003,7 +2043,7 @@ inline result<value_t, std::string> guess_number_type(const location& l)
     {
         if(loc.iter() != loc.end() && *loc.iter() == '_')
         {
-            return err(format_underline("bad float: `_` should be surrounded by digits",
+            return err(error_message("bad float: `_` should be surrounded by digits",
                         {{source_location(loc), "here"}},
                         {"pass: +1.0, -2e-2, 3.141_592_653_589, inf, nan",
                          "fail: .0, 1., _1.0, 1.0_, 1_.0, 1.0__0"}));
@@ -2019,7 +2059,7 @@ inline result<value_t, std::string> guess_number_type(const location& l)
             const auto c = *loc.iter();
             if(c == '_')
             {
-                return err(format_underline("bad integer: `_` should be surrounded by digits",
+                return err(error_message("bad integer: `_` should be surrounded by digits",
                             {{source_location(loc), "here"}},
                             {"pass: -42, 1_000, 1_2_3_4_5, 0xC0FFEE, 0b0010, 0o755",
                              "fail: 1__000, 0123"}));
@@ -2028,21 +2068,21 @@ inline result<value_t, std::string> guess_number_type(const location& l)
             {
                 // leading zero. point '0'
                 loc.retrace();
-                return err(format_underline("bad integer: leading zero",
+                return err(error_message("bad integer: leading zero",
                             {{source_location(loc), "here"}},
                             {"pass: -42, 1_000, 1_2_3_4_5, 0xC0FFEE, 0b0010, 0o755",
                              "fail: 1__000, 0123"}));
             }
             if(c == ':' || c == '-')
             {
-                return err(format_underline("bad datetime: invalid format",
+                return err(error_message("bad datetime: invalid format",
                             {{source_location(loc), "here"}},
                             {"pass: 1979-05-27T07:32:00-07:00, 1979-05-27 07:32:00.999999Z",
                              "fail: 1979-05-27T7:32:00-7:00, 1979-05-27 7:32-00:30"}));
             }
             if(c == '.' || c == 'e' || c == 'E')
             {
-                return err(format_underline("bad float: invalid format",
+                return err(error_message("bad float: invalid format",
                             {{source_location(loc), "here"}},
                             {"pass: +1.0, -2e-2, 3.141_592_653_589, inf, nan",
                              "fail: .0, 1., _1.0, 1.0_, 1_.0, 1.0__0"}));
@@ -2052,23 +2092,23 @@ inline result<value_t, std::string> guess_number_type(const location& l)
     }
     if(loc.iter() != loc.end() && *loc.iter() == '.')
     {
-        return err(format_underline("bad float: invalid format",
+        return err(error_message("bad float: invalid format",
                 {{source_location(loc), "integer part required before this"}},
                 {"pass: +1.0, -2e-2, 3.141_592_653_589, inf, nan",
                  "fail: .0, 1., _1.0, 1.0_, 1_.0, 1.0__0"}));
     }
     if(loc.iter() != loc.end() && *loc.iter() == '_')
     {
-        return err(format_underline("bad number: `_` should be surrounded by digits",
+        return err(error_message("bad number: `_` should be surrounded by digits",
                 {{source_location(loc), "`_` is not surrounded by digits"}},
                 {"pass: -42, 1_000, 1_2_3_4_5, 0xC0FFEE, 0b0010, 0o755",
                  "fail: 1__000, 0123"}));
     }
-    return err(format_underline("bad format: unknown value appeared",
+    return err(error_message("bad format: unknown value appeared",
                 {{source_location(loc), "here"}}));
 }
 
-inline result<value_t, std::string> guess_value_type(const location& loc)
+inline result<value_t, error_message> guess_value_type(const location& loc)
 {
     switch(*loc.iter())
     {
@@ -2085,8 +2125,8 @@ inline result<value_t, std::string> guess_value_type(const location& loc)
 }
 
 template<typename Value, typename T>
-result<Value, std::string>
-parse_value_helper(result<std::pair<T, region>, std::string> rslt)
+result<Value, error_message>
+parse_value_helper(result<std::pair<T, region>, error_message> rslt)
 {
     if(rslt.is_ok())
     {
@@ -2100,12 +2140,12 @@ parse_value_helper(result<std::pair<T, region>, std::string> rslt)
 }
 
 template<typename Value>
-result<Value, std::string> parse_value(location& loc, const std::size_t n_rec)
+result<Value, error_message> parse_value(location& loc, const std::size_t n_rec)
 {
     const auto first = loc.iter();
     if(first == loc.end())
     {
-        return err(format_underline("toml::parse_value: input is empty",
+        return err(error_message("toml::parse_value: input is empty",
                    {{source_location(loc), ""}}));
     }
 
@@ -2125,11 +2165,26 @@ result<Value, std::string> parse_value(location& loc, const std::size_t n_rec)
         case value_t::local_datetime : {return parse_value_helper<Value>(parse_local_datetime(loc)     );}
         case value_t::local_date     : {return parse_value_helper<Value>(parse_local_date(loc)         );}
         case value_t::local_time     : {return parse_value_helper<Value>(parse_local_time(loc)         );}
-        case value_t::array          : {return parse_value_helper<Value>(parse_array<Value>(loc, n_rec));}
+        case value_t::array          :
+        {
+#ifdef TOML11_PACK_HOMOGENEOUS_ARRAYS
+            packed_array packed;
+            auto ary = parse_array<Value>(loc, n_rec, std::addressof(packed));
+            if(ary.is_ok() && !packed.empty())
+            {
+                auto comments = ary.as_ok().second.comments();
+                return ok(Value(std::move(packed), std::move(ary.as_ok().second),
+                                std::move(comments)));
+            }
+            return parse_value_helper<Value>(std::move(ary));
+#else
+            return parse_value_helper<Value>(parse_array<Value>(loc, n_rec));
+#endif
+        }
         case value_t::table          : {return parse_value_helper<Value>(parse_inline_table<Value>(loc, n_rec));}
         default:
         {
-            const auto msg = format_underline("toml::parse_value: "
+            const auto msg = error_message("toml::parse_value: "
                     "unknown token appeared", {{source_location(loc), "unknown"}});
             loc.reset(first);
             return err(msg);
@@ -2137,7 +2192,126 @@ result<Value, std::string> parse_value(location& loc, const std::size_t n_rec)
     }
 }
 
-inline result<std::pair<std::vector<key>, region>, std::string>
+// ---------------------------------------------------------------------------
+// skip a value without constructing it. This is used to jump over the values
+// that are not in a projection. It only checks the syntax by lexers, so some
+// semantic errors (e.g. integer overflow) in skipped values are not reported.
+// On failure, the location is reset and the caller should parse the value
+// normally to get an informative error message.
+
+inline bool skip_value(location& loc, const std::size_t n_rec);
+
+inline bool skip_array(location& loc, const std::size_t n_rec)
+{
+    const auto first = loc.iter();
+    if(loc.iter() == loc.end() || *loc.iter() != '[')
+    {
+        return false;
+    }
+    loc.advance();
+
+    using lex_ws_comment_newline = repeat<
+        either<lex_wschar, lex_newline, lex_comment>, unlimited>;
+    using lex_array_separator = sequence<maybe<lex_ws_comment_newline>, character<','>>;
+
+    while(loc.iter() != loc.end())
+    {
+        lex_ws_comment_newline::invoke(loc);
+        if(loc.iter() != loc.end() && *loc.iter() == ']')
+        {
+            loc.advance();
+            return true;
+        }
+        if(!skip_value(loc, n_rec+1))
+        {
+            break;
+        }
+        if(!lex_array_separator::invoke(loc))
+        {
+            lex_ws_comment_newline::invoke(loc);
+            if(loc.iter() != loc.end() && *loc.iter() == ']')
+            {
+                loc.advance();
+                return true;
+            }
+            break;
+        }
+    }
+    loc.reset(first);
+    return false;
+}
+
+inline bool skip_inline_table(location& loc, const std::size_t n_rec)
+{
+    const auto first = loc.iter();
+    if(loc.iter() == loc.end() || *loc.iter() != '{')
+    {
+        return false;
+    }
+    loc.advance();
+
+    maybe<lex_ws>::invoke(loc);
+    if(loc.iter() != loc.end() && *loc.iter() == '}')
+    {
+        loc.advance();
+        return true;
+    }
+    while(loc.iter() != loc.end())
+    {
+        if(!lex_key::invoke(loc) || !lex_keyval_sep::invoke(loc) ||
+           !skip_value(loc, n_rec+1))
+        {
+            break;
+        }
+        maybe<lex_ws>::invoke(loc);
+        if(loc.iter() == loc.end())
+        {
+            break;
+        }
+        if(*loc.iter() == '}')
+        {
+            loc.advance();
+            return true;
+        }
+        if(*loc.iter() != ',')
+        {
+            break;
+        }
+        loc.advance();
+        maybe<lex_ws>::invoke(loc);
+        if(loc.iter() != loc.end() && *loc.iter() == '}')
+        {
+            break; // trailing comma is not allowed
+        }
+    }
+    loc.reset(first);
+    return false;
+}
+
+inline bool skip_value(location& loc, const std::size_t n_rec)
+{
+    if(n_rec > TOML11_VALUE_RECURSION_LIMIT || loc.iter() == loc.end())
+    {
+        return false;
+    }
+    switch(*loc.iter())
+    {
+        case '[': {return skip_array(loc, n_rec);}
+        case '{': {return skip_inline_table(loc, n_rec);}
+        case '"': // fallthrough
+        case '\'': {return static_cast<bool>(lex_string::invoke(loc));}
+        case 't': // fallthrough
+        case 'f': {return static_cast<bool>(lex_boolean::invoke(loc));}
+        default: break;
+    }
+    // datetimes should be checked before numbers because they start with
+    // digits. floats are checked before integers because `1.0` starts with `1`.
+    using lex_scalar = either<lex_offset_date_time, lex_local_date_time,
+          lex_local_date, lex_local_time, lex_float, lex_integer>;
+    return static_cast<bool>(lex_scalar::invoke(loc));
+}
+
+inline result<std::pair<std::vector<key>, region>, error_message>
 parse_table_key(location& loc)
 {
     if(auto token = lex_std_table::invoke(loc))
@@ -2193,12 +2367,12 @@ parse_table_key(location& loc)
     }
     else
     {
-        return err(format_underline("toml::parse_table_key: "
+        return err(error_message("toml::parse_table_key: "
             "not a valid table key", {{source_location(loc), "here"}}));
     }
 }
 
-inline result<std::pair<std::vector<key>, region>, std::string>
+inline result<std::pair<std::vector<key>, region>, error_message>
 parse_array_table_key(location& loc)
 {
     if(auto token = lex_array_table::invoke(loc))
@@ -2250,15 +2424,299 @@ parse_array_table_key(location& loc)
     }
     else
     {
-        return err(format_underline("toml::parse_array_table_key: "
+        return err(error_message("toml::parse_array_table_key: "
             "not a valid table key", {{source_location(loc), "here"}}));
     }
 }
 
+} // detail
+
+// ---------------------------------------------------------------------------
+// projection
+//
+// A set of dotted key paths to be read from a file. When it is passed to
+// `toml::parse`, only the values under the listed paths (and the tables that
+// contain them) are constructed. The rest of the file is scanned by the lexers
+// and discarded, so the syntax of the whole file is still checked.
+//
+// ```cpp
+// const auto data = toml::parse("config.toml",
+//                               toml::projection{"server.http", "limits"});
+// ```
+//
+// A default-constructed projection keeps everything.
+class projection
+{
+  public:
+
+    projection() = default;
+    ~projection() = default;
+    projection(const projection&) = default;
+    projection(projection&&)      = default;
+    projection& operator=(const projection&) = default;
+    projection& operator=(projection&&)      = default;
+
+    projection(std::initializer_list<std::string> paths)
+    {
+        for(const auto& path : paths) {this->add(path);}
+    }
+    explicit projection(const std::vector<std::string>& paths)
+    {
+        for(const auto& path : paths) {this->add(path);}
+    }
+
+    // throws syntax_error if the path is not a valid (dotted) key.
+    projection& add(const std::string& path)
+    {
+        detail::location loc("toml::projection", path);
+        const auto keys = detail::parse_key(loc);
+        if(!keys || loc.iter() != loc.end())
+        {
+            throw syntax_error(detail::format_underline("toml::projection: "
+                "invalid key path", {{source_location(loc), "here"}}),
+                source_location(loc));
+        }
+        this->paths_.push_back(keys.unwrap().first);
+        return *this;
+    }
+
+    bool keeps_all() const noexcept {return this->paths_.empty();}
+
+    // true if the value at `keys` or some of its descendants are requested.
+    bool includes(const std::vector<key>& keys) const
+    {
+        return this->includes(std::vector<key>{}, keys);
+    }
+    // the same as above, but the key is given as `prefix` + `keys`.
+    bool includes(const std::vector<key>& prefix,
+                  const std::vector<key>& keys) const
+    {
+        if(this->keeps_all()) {return true;}
+        for(const auto& path : this->paths_)
+        {
+            if(matches(path, prefix, keys)) {return true;}
+        }
+        return false;
+    }
+
+  private:
+
+    // check that one of `path` and `prefix + keys` is a prefix of the other.
+    static bool matches(const std::vector<key>& path,
+        const std::vector<key>& prefix, const std::vector<key>& keys) noexcept
+    {
+        const std::size_t n = (std::min)(path.size(), prefix.size() + keys.size());
+        for(std::size_t i=0; i<n; ++i)
+        {
+            const key& k = (i < prefix.size()) ? prefix[i] : keys[i - prefix.size()];
+            if(path[i] != k) {return false;}
+        }
+        return true;
+    }
+
+  private:
+    std::vector<std::vector<key>> paths_;
+};
+
+// The result of `toml::parse_with_recovery`.
+template<typename Value>
+struct recovered
+{
+    Value                   value;  // the values parsed without errors
+    std::vector<error_info> errors; // empty if the file is valid
+
+    bool is_ok() const noexcept {return errors.empty();}
+};
+
+namespace detail
+{
+
+// throws an error found by the parser as syntax_error. If the message does not
+// have its location, the error is reported at `stop`.
+[[noreturn]] inline void
+throw_syntax_error(error_message e, const source_location& stop)
+{
+    e.locate(stop);
+    throw syntax_error(e.str(), e.where());
+}
+
+// errors collected in the recovery mode. When an error is found, the parser
+// records it and resumes from the next key-value pair or table header.
+class diagnostics
+{
+  public:
+
+    explicit diagnostics(const std::size_t limit): limit_(limit) {}
+
+    // records an error found at `loc` and moves `loc` to the beginning of the
+    // next line that starts a key-value pair or a table header. `first` is the
+    // beginning of the broken line; the brackets and strings are tracked from
+    // there, so the lines in a multi-line array or string are skipped.
+    // returns false if no more errors should be collected.
+    bool recover(error_message msg, location& loc,
+                 const location::const_iterator first)
+    {
+        const auto pos = loc.iter();
+        this->record(std::move(msg), loc, pos);
+        const auto line = loc.line_begin();
+        loc.reset(first);
+        skip_to_next_line(loc, line);
+        return !this->full();
+    }
+    bool recover(error_message msg, location& loc)
+    {
+        return this->recover(std::move(msg), loc, loc.iter());
+    }
+
+    // records an error found at `pos`. If the message has no location, the
+    // error is reported at `pos`.
+    void record(error_message msg, const location& loc,
+                const location::const_iterator pos)
+    {
+        const auto offset = static_cast<std::size_t>(std::distance(loc.begin(), pos));
+        if(pos == loc.iter())
+        {
+            msg.locate(source_location(loc));
+        }
+        else
+        {
+            location at(loc);
+            at.reset(pos);
+            msg.locate(source_location(at));
+        }
+        errors_.push_back(error_info(error_kind::syntax_error,
+                                     std::move(msg), offset));
+    }
+
+    bool full() const noexcept {return limit_ <= errors_.size();}
+
+    std::vector<error_info>&       errors()       noexcept {return errors_;}
+    std::vector<error_info> const& errors() const noexcept {return errors_;}
+
+  private:
+
+    // moves `loc` to the beginning of a line that starts a
+    // key-value pair or a table header outside of strings, skipping the lines
+    // before `line` and the current one. A header should be
+    // outside of brackets. A key-value pair should be outside of inline
+    // tables; it cannot be an element of an array, so it also ends an array
+    // that is not closed.
+    static void skip_to_next_line(location& loc, const location::const_iterator line)
+    {
+        std::vector<char> brackets;
+        char quote     = '\0';
+        bool multiline = false;
+        while(loc.iter() != loc.end())
+        {
+            const char c = *loc.iter();
+            if(quote != '\0' && !(c == '\n' && !multiline))
+            {
+                if(c == '\\' && quote == '"')
+                {
+                    loc.advance(); // skip the escaped character
+                    if(loc.iter() == loc.end()) {break;}
+                    if(*loc.iter() == '\n' && !multiline) {continue;}
+                }
+                else if(c == quote && !multiline)
+                {
+                    quote = '\0';
+                }
+                else if(c == quote && starts_with(loc, quote, 3))
+                {
+                    loc.advance(2);
+                    quote = '\0';
+                }
+                loc.advance();
+                continue;
+            }
+            switch(c)
+            {
+                case '"': case '\'':
+                {
+                    multiline = starts_with(loc, c, 3);
+                    quote     = c;
+                    loc.advance(multiline ? 3 : 1);
+                    break;
+                }
+                case '#':
+                {
+                    while(loc.iter() != loc.end() && *loc.iter() != '\n')
+                    {
+                        loc.advance();
+                    }
+                    break;
+                }
+                case '[': case '{':
+                {
+                    brackets.push_back(c);
+                    loc.advance();
+                    break;
+                }
+                case ']': case '}':
+                {
+                    if(!brackets.empty()) {brackets.pop_back();}
+                    loc.advance();
+                    break;
+                }
+                case '\n':
+                {
+                    quote = '\0'; // a single-line string is not closed
+                    loc.advance();
+                    if(0 <= std::distance(line, loc.iter()) &&
+                       starts_statement(loc, brackets))
+                    {
+                        return;
+                    }
+                    break;
+                }
+                default:
+                {
+                    loc.advance();
+                    break;
+                }
+            }
+        }
+        return;
+    }
+
+    static bool starts_with(const location& loc, const char c, const std::size_t n)
+    {
+        if(static_cast<std::size_t>(std::distance(loc.iter(), loc.end())) < n)
+        {
+            return false;
+        }
+        return std::count(loc.iter(), std::next(loc.iter(),
+                    static_cast<location::difference_type>(n)), c) ==
+               static_cast<location::difference_type>(n);
+    }
+
+    static bool starts_statement(const location& loc, const std::vector<char>& brackets)
+    {
+        location line(loc);
+        lex_ws::invoke(line);
+        if(line.iter() == line.end()) {return true;}
+        if(*line.iter() == '[') {return brackets.empty();}
+        if(std::find(brackets.begin(), brackets.end(), '{') != brackets.end())
+        {
+            return false;
+        }
+        return lex_key::invoke(line) && lex_keyval_sep::invoke(line);
+    }
+    std::size_t             limit_;
+    std::vector<error_info> errors_;
+};
+
 // parse table body (key-value pairs until the iter hits the next [tablekey])
+//
+// If a projection is given, key-value pairs whose full keys (`prefix` + key)
+// are not included in it are skipped without constructing values.
+//
+// If `diag` is given, errors are recorded in it and the parser resumes from
+// the next key-value pair. It returns the key-value pairs parsed successfully.
 template<typename Value>
-result<typename Value::table_type, std::string>
-parse_ml_table(location& loc)
+result<typename Value::table_type, error_message>
+parse_ml_table(location& loc, const projection& proj,
+               const std::vector<key>& prefix, diagnostics* diag = nullptr)
 {
     using value_type = Value;
     using table_type = typename value_type::table_type;
@@ -2291,7 +2749,61 @@ parse_ml_table(location& loc)
             return ok(tab);
         }
 
-        if(const auto kv = parse_key_value_pair<value_type>(loc, 0))
+        bool skipped = false;
+        if(!proj.keeps_all())
+        {
+            // If the value is not requested, skip it. If it fails, rewind
+            // and parse it normally to get a proper error message.
+            if(const auto keys = parse_key(loc))
+            {
+                if(!proj.includes(prefix, keys.unwrap().first))
+                {
+                    skipped = lex_keyval_sep::invoke(loc) && skip_value(loc, 0);
+                }
+            }
+            if(!skipped)
+            {
+                loc.reset(before);
+            }
+        }
+
+        if(skipped)
+        {
+            // nothing to do.
+        }
+        else if(diag)
+        {
+            // some errors in values are thrown as exceptions.
+            try
+            {
+                const auto kv = parse_key_value_pair<value_type>(loc, 0);
+                if(!kv)
+                {
+                    if(!diag->recover(kv.unwrap_err(), loc, before)) {return ok(tab);}
+                    continue;
+                }
+                const auto&              kvpair  = kv.unwrap();
+                const std::vector<key>&  keys    = kvpair.first.first;
+                const auto&              key_reg = kvpair.first.second;
+                const auto inserted = insert_nested_key(
+                        tab, kvpair.second, keys.begin(), keys.end(), key_reg);
+                if(!inserted)
+                {
+                    if(!diag->recover(inserted.unwrap_err(), loc, before)) {return ok(tab);}
+                    continue;
+                }
+            }
+            catch(const syntax_error& e)
+            {
+                if(!diag->recover(error_message(e.what(), {}, {}, e.location()),
+                                  loc, before))
+                {
+                    return ok(tab);
+                }
+                continue;
+            }
+        }
+        else if(const auto kv = parse_key_value_pair<value_type>(loc, 0))
         {
             const auto&              kvpair  = kv.unwrap();
             const std::vector<key>&  keys    = kvpair.first.first;
@@ -2325,10 +2837,15 @@ parse_ml_table(location& loc)
         {
             const auto before2 = loc.iter();
             lex_ws::invoke(loc); // skip whitespace
-            const auto msg = format_underline("toml::parse_table: "
+            const auto msg = error_message("toml::parse_table: "
                 "invalid line format", {{source_location(loc), concat_to_string(
                 "expected newline, but got '", show_char(*loc.iter()), "'.")}});
             loc.reset(before2);
+            if(diag)
+            {
+                if(!diag->recover(msg, loc)) {return ok(tab);}
+                continue;
+            }
             return err(msg);
         }
 
@@ -2342,34 +2859,25 @@ parse_ml_table(location& loc)
 }
 
 template<typename Value>
-result<Value, std::string> parse_toml_file(location& loc)
+result<typename Value::table_type, error_message>
+parse_ml_table(location& loc)
 {
-    using value_type = Value;
-    using table_type = typename value_type::table_type;
-
-    const auto first = loc.iter();
-    if(first == loc.end())
-    {
-        // For empty files, return an empty table with an empty region (zero-length).
-        // Without the region, error messages would miss the filename.
-        return ok(value_type(table_type{}, region(loc, first, first), {}));
-    }
-
-    // put the first line as a region of a file
-    // Here first != loc.end(), so taking std::next is okay
-    const region file(loc, first, std::next(loc.iter()));
+    return parse_ml_table<Value>(loc, projection{}, std::vector<key>{});
+}
 
-    // The first successive comments that are separated from the first value
-    // by an empty line are for a file itself.
-    // ```toml
-    // # this is a comment for a file.
-    //
-    // key = "the first value"
-    // ```
-    // ```toml
-    // # this is a comment for "the first value".
-    // key = "the first value"
-    // ```
+// The first successive comments that are separated from the first value
+// by an empty line are for a file itself.
+// ```toml
+// # this is a comment for a file.
+//
+// key = "the first value"
+// ```
+// ```toml
+// # this is a comment for "the first value".
+// key = "the first value"
+// ```
+inline std::vector<std::string> parse_file_comments(location& loc)
+{
     std::vector<std::string> comments;
     using lex_first_comments = sequence<
         repeat<sequence<maybe<lex_ws>, lex_comment, lex_newline>, at_least<1>>,
@@ -2392,10 +2900,34 @@ result<Value, std::string> parse_toml_file(location& loc)
             lex_newline::invoke(inner_loc);
         }
     }
+    return comments;
+}
+
+template<typename Value>
+result<Value, error_message>
+parse_toml_file(location& loc, const projection& proj = projection{},
+                diagnostics* diag = nullptr)
+{
+    using value_type = Value;
+    using table_type = typename value_type::table_type;
+
+    const auto first = loc.iter();
+    if(first == loc.end())
+    {
+        // For empty files, return an empty table with an empty region (zero-length).
+        // Without the region, error messages would miss the filename.
+        return ok(value_type(table_type{}, region(loc, first, first), {}));
+    }
+
+    // put the first line as a region of a file
+    // Here first != loc.end(), so taking std::next is okay
+    const region file(loc, first, std::next(loc.iter()));
+
+    const std::vector<std::string> comments = parse_file_comments(loc);
 
     table_type data;
     // root object is also a table, but without [tablename]
-    if(const auto tab = parse_ml_table<value_type>(loc))
+    if(const auto tab = parse_ml_table<value_type>(loc, proj, std::vector<key>{}, diag))
     {
         data = std::move(tab.unwrap());
     }
@@ -2403,7 +2935,7 @@ result<Value, std::string> parse_toml_file(location& loc)
     {
         return err(tab.unwrap_err());
     }
-    while(loc.iter() != loc.end())
+    while(loc.iter() != loc.end() && !(diag && diag->full()))
     {
         // here, the region of [table] is regarded as the table-key because
         // the table body is normally too big and it is not so informative
@@ -2411,52 +2943,96 @@ result<Value, std::string> parse_toml_file(location& loc)
         // message.
         if(const auto tabkey = parse_array_table_key(loc))
         {
-            const auto tab = parse_ml_table<value_type>(loc);
-            if(!tab){return err(tab.unwrap_err());}
-
             const auto& tk   = tabkey.unwrap();
             const auto& keys = tk.first;
             const auto& reg  = tk.second;
 
-            const auto inserted = insert_nested_key(data,
-                    value_type(tab.unwrap(), reg, reg.comments()),
-                    keys.begin(), keys.end(), reg,
-                    /*is_array_of_table=*/ true);
-            if(!inserted) {return err(inserted.unwrap_err());}
+            const auto tab = parse_ml_table<value_type>(loc, proj, keys, diag);
+            if(!tab){return err(tab.unwrap_err());}
+            if(!proj.includes(keys)) {continue;}
 
+            if(!diag)
+            {
+                const auto inserted = insert_nested_key(data,
+                        value_type(tab.unwrap(), reg, reg.comments()),
+                        keys.begin(), keys.end(), reg,
+                        /*is_array_of_table=*/ true);
+                if(!inserted) {return err(inserted.unwrap_err());}
+                continue;
+            }
+            // the header is already consumed. report the error at the header.
+            try
+            {
+                const auto inserted = insert_nested_key(data,
+                        value_type(tab.unwrap(), reg, reg.comments()),
+                        keys.begin(), keys.end(), reg,
+                        /*is_array_of_table=*/ true);
+                if(!inserted)
+                {
+                    diag->record(inserted.unwrap_err(), loc, reg.first());
+                }
+            }
+            catch(const syntax_error& e)
+            {
+                diag->record(error_message(e.what(), {}, {}, source_location(reg)),
+                             loc, reg.first());
+            }
             continue;
         }
         if(const auto tabkey = parse_table_key(loc))
         {
-            const auto tab = parse_ml_table<value_type>(loc);
-            if(!tab){return err(tab.unwrap_err());}
-
             const auto& tk   = tabkey.unwrap();
             const auto& keys = tk.first;
             const auto& reg  = tk.second;
 
-            const auto inserted = insert_nested_key(data,
-                value_type(tab.unwrap(), reg, reg.comments()),
-                keys.begin(), keys.end(), reg);
-            if(!inserted) {return err(inserted.unwrap_err());}
+            const auto tab = parse_ml_table<value_type>(loc, proj, keys, diag);
+            if(!tab){return err(tab.unwrap_err());}
+            if(!proj.includes(keys)) {continue;}
 
+            if(!diag)
+            {
+                const auto inserted = insert_nested_key(data,
+                    value_type(tab.unwrap(), reg, reg.comments()),
+                    keys.begin(), keys.end(), reg);
+                if(!inserted) {return err(inserted.unwrap_err());}
+                continue;
+            }
+            // the header is already consumed. report the error at the header.
+            try
+            {
+                const auto inserted = insert_nested_key(data,
+                        value_type(tab.unwrap(), reg, reg.comments()),
+                        keys.begin(), keys.end(), reg);
+                if(!inserted)
+                {
+                    diag->record(inserted.unwrap_err(), loc, reg.first());
+                }
+            }
+            catch(const syntax_error& e)
+            {
+                diag->record(error_message(e.what(), {}, {}, source_location(reg)),
+                             loc, reg.first());
+            }
             continue;
         }
-        return err(format_underline("toml::parse_toml_file: "
-            "unknown line appeared", {{source_location(loc), "unknown format"}}));
+        const auto msg = error_message("toml::parse_toml_file: "
+            "unknown line appeared", {{source_location(loc), "unknown format"}});
+        if(!diag) {return err(msg);}
+        if(!diag->recover(msg, loc)) {break;}
+
+        // skip the key-value pairs after the broken header.
+        if(!parse_ml_table<value_type>(loc, projection{}, std::vector<key>{}, diag))
+        {
+            break;
+        }
     }
 
     return ok(Value(std::move(data), file, comments));
 }
 
-template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
-         template<typename ...> class Table   = std::unordered_map,
-         template<typename ...> class Array   = std::vector>
-basic_value<Comment, Table, Array>
-parse(std::vector<char> letters, const std::string& fname)
+// normalize the content and make a location that points to the beginning.
+inline location make_location(std::vector<char> letters, const std::string& fname)
 {
-    using value_type = basic_value<Comment, Table, Array>;
-
     // append LF.
     // Although TOML does not require LF at the EOF, to make parsing logic
     // simpler, we "normalize" the content by adding LF if it does not exist.
@@ -2485,15 +3061,104 @@ parse(std::vector<char> letters, const std::string& fname)
             loc.advance(3); // BOM found. skip.
         }
     }
+    return loc;
+}
+
+template<typename Value>
+Value finish_parse(Value v)
+{
+#ifdef TOML11_COPY_ON_WRITE
+    // the parser does not keep references to the contents.
+    detail::enable_sharing(v);
+#endif
+    return v;
+}
+
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+basic_value<Comment, Table, Array>
+parse(std::vector<char> letters, const std::string& fname,
+      const projection& proj = projection{})
+{
+    using value_type = basic_value<Comment, Table, Array>;
 
-    if (auto data = detail::parse_toml_file<value_type>(loc))
+    auto loc = make_location(std::move(letters), fname);
+    if (auto data = detail::parse_toml_file<value_type>(loc, proj))
     {
-        return std::move(data).unwrap();
+        return finish_parse(std::move(data).unwrap());
     }
     else
     {
-        throw syntax_error(std::move(data).unwrap_err(), source_location(loc));
+        detail::throw_syntax_error(std::move(data).unwrap_err(),
+                                   source_location(loc));
+    }
+}
+
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+result<basic_value<Comment, Table, Array>, error_info>
+try_parse(std::vector<char> letters, const std::string& fname,
+          const projection& proj = projection{})
+{
+    using value_type = basic_value<Comment, Table, Array>;
+
+    auto loc = make_location(std::move(letters), fname);
+    const auto offset = [&loc]() -> std::size_t {
+        return static_cast<std::size_t>(std::distance(loc.begin(), loc.iter()));
+    };
+    try
+    {
+        if(auto data = detail::parse_toml_file<value_type>(loc, proj))
+        {
+            return ok(finish_parse(std::move(data).unwrap()));
+        }
+        else
+        {
+            auto e = std::move(data).unwrap_err();
+            e.locate(source_location(loc));
+            return err(error_info(error_kind::syntax_error, std::move(e), offset()));
+        }
+    }
+    catch(const syntax_error& e)
+    {
+        return err(error_info(error_kind::syntax_error,
+                              e.what(), e.location(), offset()));
+    }
+    catch(const toml::exception& e)
+    {
+        return err(error_info(error_kind::internal_error,
+                              e.what(), e.location(), offset()));
+    }
+}
+
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+recovered<basic_value<Comment, Table, Array>>
+parse_with_recovery(std::vector<char> letters, const std::string& fname,
+                    const std::size_t max_errors)
+{
+    using value_type = basic_value<Comment, Table, Array>;
+    using table_type = typename value_type::table_type;
+
+    auto loc = make_location(std::move(letters), fname);
+    diagnostics diag(max_errors);
+
+    recovered<value_type> retval{value_type(table_type{}), {}};
+    if(auto data = detail::parse_toml_file<value_type>(loc, projection{}, &diag))
+    {
+        retval.value = finish_parse(std::move(data).unwrap());
     }
+    else // not expected to happen in the recovery mode, but just in case.
+    {
+        auto e = std::move(data).unwrap_err();
+        e.locate(source_location(loc));
+        diag.errors().push_back(error_info(error_kind::syntax_error, std::move(e)));
+    }
+    retval.errors = std::move(diag.errors());
+    return retval;
 }
 
 } // detail
@@ -2542,7 +3207,7 @@ template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
          template<typename ...> class Table   = std::unordered_map,
          template<typename ...> class Array   = std::vector>
 basic_value<Comment, Table, Array>
-parse(std::istream& is, std::string fname = "unknown file")
+parse(std::istream& is, std::string fname, const projection& proj)
 {
     const auto beg = is.tellg();
     is.seekg(0, std::ios::end);
@@ -2555,13 +3220,23 @@ parse(std::istream& is, std::string fname = "unknown file")
     std::vector<char> letters(static_cast<std::size_t>(fsize));
     is.read(letters.data(), fsize);
 
-    return detail::parse<Comment, Table, Array>(letters, fname);
+    return detail::parse<Comment, Table, Array>(letters, fname, proj);
 }
 
 template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
          template<typename ...> class Table   = std::unordered_map,
          template<typename ...> class Array   = std::vector>
-basic_value<Comment, Table, Array> parse(std::string fname)
+basic_value<Comment, Table, Array>
+parse(std::istream& is, std::string fname = "unknown file")
+{
+    return parse<Comment, Table, Array>(is, std::move(fname), projection{});
+}
+
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+basic_value<Comment, Table, Array>
+parse(std::string fname, const projection& proj)
 {
     std::ifstream ifs(fname, std::ios_base::binary);
     if(!ifs.good())
@@ -2570,7 +3245,15 @@ basic_value<Comment, Table, Array> parse(std::string fname)
                 "toml::parse: Error opening file \"" + fname + "\"");
     }
     ifs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    return parse<Comment, Table, Array>(ifs, std::move(fname));
+    return parse<Comment, Table, Array>(ifs, std::move(fname), proj);
+}
+
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+basic_value<Comment, Table, Array> parse(std::string fname)
+{
+    return parse<Comment, Table, Array>(std::move(fname), projection{});
 }
 
 #ifdef TOML11_HAS_STD_FILESYSTEM
@@ -2590,11 +3273,20 @@ basic_value<Comment, Table, Array> parse(const char* fname)
 {
     return parse<Comment, Table, Array>(std::string(fname));
 }
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+basic_value<Comment, Table, Array>
+parse(const char* fname, const projection& proj)
+{
+    return parse<Comment, Table, Array>(std::string(fname), proj);
+}
 
 template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
          template<typename ...> class Table   = std::unordered_map,
          template<typename ...> class Array   = std::vector>
-basic_value<Comment, Table, Array> parse(const std::filesystem::path& fpath)
+basic_value<Comment, Table, Array>
+parse(const std::filesystem::path& fpath, const projection& proj)
 {
     std::ifstream ifs(fpath, std::ios_base::binary);
     if(!ifs.good())
@@ -2603,9 +3295,164 @@ basic_value<Comment, Table, Array> parse(const std::filesystem::path& fpath)
                 "toml::parse: Error opening file \"" + fpath.string() + "\"");
     }
     ifs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    return parse<Comment, Table, Array>(ifs, fpath.string());
+    return parse<Comment, Table, Array>(ifs, fpath.string(), proj);
+}
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+basic_value<Comment, Table, Array> parse(const std::filesystem::path& fpath)
+{
+    return parse<Comment, Table, Array>(fpath, projection{});
+}
+#endif // TOML11_HAS_STD_FILESYSTEM
+
+// ---------------------------------------------------------------------------
+// try_parse
+//
+// The same as `toml::parse`, but returns an error instead of throwing.
+//
+// ```cpp
+// const auto res = toml::try_parse("config.toml");
+// if(!res)
+// {
+//     const toml::error_info& e = res.unwrap_err();
+//     std::cerr << e.file_name() << ':' << e.line() << ':' << e.column() << '\n';
+//     std::cerr << e.what() << std::endl;
+// }
+// ```
+
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+result<basic_value<Comment, Table, Array>, error_info>
+try_parse(std::istream& is, std::string fname = "unknown file",
+          const projection& proj = projection{})
+{
+    const auto beg = is.tellg();
+    is.seekg(0, std::ios::end);
+    const auto end = is.tellg();
+    is.seekg(beg);
+    if(beg == std::istream::pos_type(-1) || end == std::istream::pos_type(-1))
+    {
+        return err(error_info(error_kind::file_io_error,
+            "toml::try_parse: failed to read \"" + fname + "\"", source_location{}));
+    }
+
+    // read whole file as a sequence of char
+    std::vector<char> letters(static_cast<std::size_t>(end - beg));
+    is.read(letters.data(), end - beg);
+    if(!is)
+    {
+        return err(error_info(error_kind::file_io_error,
+            "toml::try_parse: failed to read \"" + fname + "\"", source_location{}));
+    }
+    return detail::try_parse<Comment, Table, Array>(std::move(letters), fname, proj);
+}
+
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+result<basic_value<Comment, Table, Array>, error_info>
+try_parse(const std::string& fname, const projection& proj = projection{})
+{
+    std::ifstream ifs(fname, std::ios_base::binary);
+    if(!ifs.good())
+    {
+        return err(error_info(error_kind::file_io_error,
+            "toml::try_parse: Error opening file \"" + fname + "\"", source_location{}));
+    }
+    return try_parse<Comment, Table, Array>(ifs, fname, proj);
+}
+
+#ifdef TOML11_HAS_STD_FILESYSTEM
+// see the comment on `parse(const char*)`.
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+result<basic_value<Comment, Table, Array>, error_info>
+try_parse(const char* fname, const projection& proj = projection{})
+{
+    return try_parse<Comment, Table, Array>(std::string(fname), proj);
+}
+
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+result<basic_value<Comment, Table, Array>, error_info>
+try_parse(const std::filesystem::path& fpath, const projection& proj = projection{})
+{
+    return try_parse<Comment, Table, Array>(fpath.string(), proj);
 }
 #endif // TOML11_HAS_STD_FILESYSTEM
 
+// ---------------------------------------------------------------------------
+// parse_with_recovery
+//
+// Parse a file and collect all the errors in it. When the parser finds an
+// error, it records the error and resumes from the next key-value pair or
+// table header. It stops after
+// `max_errors` errors.
+//
+// ```cpp
+// const auto res = toml::parse_with_recovery("config.toml");
+// for(const auto& e : res.errors)
+// {
+//     std::cerr << e.what() << std::endl;
+// }
+// const auto& data = res.value; // the key-value pairs parsed successfully
+// ```
+
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+recovered<basic_value<Comment, Table, Array>>
+parse_with_recovery(std::istream& is, std::string fname = "unknown file",
+                    const std::size_t max_errors = 100)
+{
+    using value_type = basic_value<Comment, Table, Array>;
+    using table_type = typename value_type::table_type;
+    const recovered<value_type> failed{value_type(table_type{}), {error_info(
+        error_kind::file_io_error, "toml::parse_with_recovery: "
+        "failed to read \"" + fname + "\"", source_location{})}};
+
+    const auto beg = is.tellg();
+    is.seekg(0, std::ios::end);
+    const auto end = is.tellg();
+    is.seekg(beg);
+    if(beg == std::istream::pos_type(-1) || end == std::istream::pos_type(-1))
+    {
+        return failed;
+    }
+
+    // read whole file as a sequence of char
+    std::vector<char> letters(static_cast<std::size_t>(end - beg));
+    is.read(letters.data(), end - beg);
+    if(!is)
+    {
+        return failed;
+    }
+    return detail::parse_with_recovery<Comment, Table, Array>(
+            std::move(letters), fname, max_errors);
+}
+
+template<typename                     Comment = TOML11_DEFAULT_COMMENT_STRATEGY,
+         template<typename ...> class Table   = std::unordered_map,
+         template<typename ...> class Array   = std::vector>
+recovered<basic_value<Comment, Table, Array>>
+parse_with_recovery(const std::string& fname, const std::size_t max_errors = 100)
+{
+    using value_type = basic_value<Comment, Table, Array>;
+    using table_type = typename value_type::table_type;
+
+    std::ifstream ifs(fname, std::ios_base::binary);
+    if(!ifs.good())
+    {
+        return recovered<value_type>{value_type(table_type{}), {error_info(
+            error_kind::file_io_error, "toml::parse_with_recovery: "
+            "Error opening file \"" + fname + "\"", source_location{})}};
+    }
+    return parse_with_recovery<Comment, Table, Array>(ifs, fname, max_errors);
+}
+
 } // toml
 #endif// TOML11_PARSER_HPP
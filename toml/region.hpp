@@ -9,6 +9,8 @@
 #include <iterator>
 #include <iomanip>
 #include <cassert>
+#include <cstdint>
+#include <string>
 #include "color.hpp"
 
 namespace toml
@@ -411,6 +413,41 @@ struct region final : public region_base
     const_iterator first_, last_;
 };
 
+// detached_region has only the position of a region, without the file content.
+// It is used by toml::detach_source to release the content after parsing.
+// Error messages show the file name, the line number, and the column, but not
+// the line itself.
+struct detached_region final : public region_base
+{
+    using name_ptr = std::shared_ptr<const std::string>;
+
+    detached_region(name_ptr name, const std::uint_least32_t line,
+                    const std::uint_least32_t column, const std::uint_least32_t size)
+        : name_(std::move(name)), line_(line), column_(column), size_(size)
+    {}
+
+    bool is_ok() const noexcept override {return true;}
+
+    std::string str()      const override {return std::string("");}
+    std::string name()     const override {return *name_;}
+    std::string line()     const override {return std::string("");}
+    std::string line_num() const override {return std::to_string(line_);}
+
+    std::size_t size()   const noexcept override {return size_;}
+    std::size_t before() const noexcept override {return column_ - 1;}
+
+    name_ptr const&     shared_name()   const noexcept {return name_;}
+    std::uint_least32_t line_number()   const noexcept {return line_;}
+    std::uint_least32_t column_number() const noexcept {return column_;}
+
+  private:
+
+    name_ptr            name_;
+    std::uint_least32_t line_;
+    std::uint_least32_t column_; // 1-origin
+    std::uint_least32_t size_;
+};
+
 } // detail
 } // toml
 #endif// TOML11_REGION_H
@@ -349,6 +349,23 @@ struct serializer
         return oss.str();
     }
 
+    // formats a value. A packed array is formatted from its elements without
+    // being unpacked.
+    std::string format_value(const value_type& v) const
+    {
+        if(const auto packed = detail::get_packed_array(v))
+        {
+            switch(packed->kind())
+            {
+                case value_t::integer : return this->make_packed_array(packed->integers());
+                case value_t::floating: return this->make_packed_array(packed->floatings());
+                case value_t::boolean : return this->make_packed_array(packed->booleans());
+                default               : return std::string("[]");
+            }
+        }
+        return visit(*this, v);
+    }
+
     std::string operator()(const array_type& v) const
     {
         if(v.empty())
@@ -408,7 +425,7 @@ struct serializer
                     token += c;
                     token += '\n';
                 }
-                token += toml::visit(*this, item);
+                token += this->format_value(item);
                 if(!token.empty() && token.back() == '\n') {token.pop_back();}
                 token += ",\n";
                 continue;
@@ -419,11 +436,11 @@ struct serializer
                 serializer ser(*this);
                 ser.can_be_inlined_ = true;
                 ser.width_ = (std::numeric_limits<std::size_t>::max)();
-                next_elem += toml::visit(ser, item);
+                next_elem += ser.format_value(item);
             }
             else
             {
-                next_elem += toml::visit(*this, item);
+                next_elem += this->format_value(item);
             }
 
             // comma before newline.
@@ -596,6 +613,61 @@ struct serializer
         return retval;
     }
 
+    // formats a packed array in the same way as operator()(array_type). The
+    // elements have no comments and are not tables.
+    template<typename T>
+    std::string make_packed_array(const span<const T>& xs) const
+    {
+        if(xs.empty())
+        {
+            return std::string("[]");
+        }
+        std::string inl;
+        inl += '[';
+        for(const auto& x : xs)
+        {
+            if(inl.size() != 1) {inl += ',';}
+            inl += (*this)(x);
+        }
+        inl += ']';
+        if(inl.size() < this->width_)
+        {
+            return inl;
+        }
+
+        std::string token;
+        std::string current_line;
+        token += "[\n";
+        for(const auto& x : xs)
+        {
+            const auto next_elem = (*this)(x);
+            if(current_line.size() + next_elem.size() + 1 < this->width_)
+            {
+                current_line += next_elem;
+                current_line += ',';
+            }
+            else if(current_line.empty())
+            {
+                token += next_elem;
+                token += ",\n";
+            }
+            else
+            {
+                token += current_line;
+                token += '\n';
+                current_line = next_elem;
+                current_line += ',';
+            }
+        }
+        if(!current_line.empty())
+        {
+            token += current_line;
+            token += '\n';
+        }
+        token += "]\n";
+        return token;
+    }
+
     // if an element of a table or an array has a comment, it cannot be inlined.
     bool has_comment_inside(const array_type& a) const noexcept
     {
@@ -629,10 +701,10 @@ struct serializer
         for(const auto& item : v)
         {
             if(is_first) {is_first = false;} else {token += ',';}
-            token += visit(serializer(
+            token += serializer(
                 (std::numeric_limits<std::size_t>::max)(), this->float_prec_,
                 /* inlined */ true, /*no comment*/ false, /*keys*/ {},
-                /*has_comment*/ !item.comments().empty()), item);
+                /*has_comment*/ !item.comments().empty()).format_value(item);
         }
         token += ']';
         return token;
@@ -651,10 +723,10 @@ struct serializer
             if(is_first) {is_first = false;} else {token += ',';}
             token += format_key(kv.first);
             token += '=';
-            token += visit(serializer(
+            token += serializer(
                 (std::numeric_limits<std::size_t>::max)(), this->float_prec_,
                 /* inlined */ true, /*no comment*/ false, /*keys*/ {},
-                /*has_comment*/ !kv.second.comments().empty()), kv.second);
+                /*has_comment*/ !kv.second.comments().empty()).format_value(kv.second);
         }
         token += '}';
         return token;
@@ -687,9 +759,9 @@ struct serializer
             const auto residual_width = (this->width_ > key_and_sep.size()) ?
                                         this->width_ - key_and_sep.size() : 0;
             token += key_and_sep;
-            token += visit(serializer(residual_width, this->float_prec_,
+            token += serializer(residual_width, this->float_prec_,
                 /*can be inlined*/ true, /*no comment*/ false, /*keys*/ {},
-                /*has_comment*/ !kv.second.comments().empty()), kv.second);
+                /*has_comment*/ !kv.second.comments().empty()).format_value(kv.second);
 
             if(token.back() != '\n')
             {
@@ -715,9 +787,9 @@ struct serializer
             std::vector<toml::key> ks(this->keys_);
             ks.push_back(kv.first);
 
-            auto tmp = visit(serializer(this->width_, this->float_prec_,
+            auto tmp = serializer(this->width_, this->float_prec_,
                 !multiline_table_printed, this->no_comment_, ks,
-                /*has_comment*/ !kv.second.comments().empty()), kv.second);
+                /*has_comment*/ !kv.second.comments().empty()).format_value(kv.second);
 
             // If it is the first time to print a multi-line table, it would be
             // helpful to separate normal key-value pair and subtables by a
@@ -864,7 +936,8 @@ struct serializer
 
     bool is_array_of_tables(const value_type& v) const
     {
-        if(!v.is_array() || v.as_array().empty()) {return false;}
+        // a packed array has no tables.
+        if(!v.is_array() || v.is_packed_array() || v.as_array().empty()) {return false;}
         return is_array_of_tables(v.as_array());
     }
     bool is_array_of_tables(const array_type& v) const
@@ -905,11 +978,11 @@ format(const basic_value<C, M, V>& v, std::size_t w = 80u,
             oss << v.comments();
             oss << '\n'; // to split the file comment from the first element
         }
-        const auto serialized = visit(serializer<value_type>(w, fprec, false, no_comment), v);
+        const auto serialized = serializer<value_type>(w, fprec, false, no_comment).format_value(v);
         oss << serialized;
         return oss.str();
     }
-    return visit(serializer<value_type>(w, fprec, force_inline), v);
+    return serializer<value_type>(w, fprec, force_inline).format_value(v);
 }
 
 namespace detail
@@ -962,7 +1035,7 @@ operator<<(std::basic_ostream<charT, traits>& os, const basic_value<C, M, V>& v)
         os << '\n'; // to split the file comment from the first element
     }
     // the root object can't be an inline table. so pass `false`.
-    const auto serialized = visit(serializer<value_type>(w, fprec, no_comment, false), v);
+    const auto serialized = serializer<value_type>(w, fprec, no_comment, false).format_value(v);
     os << serialized;
 
     // if v is a non-table value, and has only one comment, then
@@ -156,6 +156,16 @@ inline std::string format_underline(const std::string& message,
         (std::ostringstream& oss,
          const source_location& loc, const std::string& comment) -> void
         {
+            if(loc.line_str().empty() && loc.region() != 0)
+            {
+                // the source was released by toml::detach_source.
+                // 1 | column 5: missing =
+                oss << ' ' << color::bold << color::blue
+                    << std::setw(static_cast<int>(line_num_width))
+                    << std::right << loc.line() << " | "  << color::reset
+                    << "column " << loc.column() << ": " << comment;
+                return;
+            }
             oss << ' ' << color::bold << color::blue
                 << std::setw(static_cast<int>(line_num_width))
                 << std::right << loc.line() << " | "  << color::reset
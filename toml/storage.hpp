@@ -2,6 +2,9 @@
 // Distributed under the MIT License.
 #ifndef TOML11_STORAGE_HPP
 #define TOML11_STORAGE_HPP
+#include <atomic>
+#include <memory>
+
 #include "utility.hpp"
 
 namespace toml
@@ -9,6 +12,8 @@ namespace toml
 namespace detail
 {
 
+#ifndef TOML11_COPY_ON_WRITE
+
 // this contains pointer and deep-copy the content if copied.
 // to avoid recursive pointer.
 template<typename T>
@@ -38,6 +43,87 @@ struct storage
     std::unique_ptr<value_type> ptr;
 };
 
+#else // TOML11_COPY_ON_WRITE
+
+// make `p` the only owner of the object before modifying it.
+template<typename T>
+void make_exclusive(std::shared_ptr<T>& p)
+{
+    if(p.use_count() == 1)
+    {
+        // synchronize with the other owners that have released it, so that
+        // their reads happen before our writes.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return;
+    }
+    p = std::make_shared<T>(*p);
+    return;
+}
+
+// this contains pointer and shares the content with its copies. The content
+// is cloned before it is modified (copy-on-write). Since the elements of the
+// content are also shared, modifying a value clones only the tables and arrays
+// on the path to it.
+//
+// A non-const reference to the content might be used to modify it after the
+// storage is copied. So, once it is given, the storage stops sharing the
+// content and deep-copies it instead, until `share()` is called.
+template<typename T>
+struct storage
+{
+    using value_type = T;
+
+    explicit storage(value_type const& v)
+        : ptr(std::make_shared<T>(v)), shareable(true)
+    {}
+    explicit storage(value_type&& v)
+        : ptr(std::make_shared<T>(std::move(v))), shareable(true)
+    {}
+    ~storage() = default;
+    storage(const storage& rhs)
+        : ptr(rhs.shareable ? rhs.ptr : std::make_shared<T>(*rhs.ptr)),
+          shareable(true)
+    {}
+    storage& operator=(const storage& rhs)
+    {
+        storage tmp(rhs);
+        *this = std::move(tmp);
+        return *this;
+    }
+    storage(storage&&) = default;
+    storage& operator=(storage&&) = default;
+
+    bool is_ok() const noexcept {return static_cast<bool>(ptr);}
+
+    value_type& value() &
+    {
+        make_exclusive(ptr);
+        shareable = false;
+        return *ptr;
+    }
+    value_type const& value() const& noexcept {return *ptr;}
+    value_type&& value() &&
+    {
+        make_exclusive(ptr);
+        return std::move(*ptr);
+    }
+
+    // returns the content if it is not shared because a non-const reference
+    // was given. Otherwise, nullptr.
+    value_type* exclusive_value() noexcept
+    {
+        return shareable ? nullptr : ptr.get();
+    }
+    // call this only if no non-const reference to the content remains.
+    void share() noexcept {shareable = true;}
+
+  private:
+    std::shared_ptr<value_type> ptr;
+    bool shareable;
+};
+
+#endif // TOML11_COPY_ON_WRITE
+
 } // detail
 } // toml
 #endif// TOML11_STORAGE_HPP
@@ -3,6 +3,7 @@
 #ifndef TOML11_TRAITS_HPP
 #define TOML11_TRAITS_HPP
 
+#include "fields.hpp"
 #include "from.hpp"
 #include "into.hpp"
 #include "version.hpp"
@@ -96,6 +97,13 @@ struct has_specialized_from_impl
     template<typename T, std::size_t S = sizeof(::toml::from<T>)>
     static std::true_type check(::toml::from<T>*);
 };
+struct has_specialized_fields_impl
+{
+    template<typename T>
+    static std::false_type check(...);
+    template<typename T, std::size_t S = sizeof(::toml::fields<T>)>
+    static std::true_type check(::toml::fields<T>*);
+};
 struct has_specialized_into_impl
 {
     template<typename T>
@@ -138,6 +146,8 @@ struct has_into_toml_method
 template<typename T>
 struct has_specialized_from : decltype(has_specialized_from_impl::check<T>(nullptr)){};
 template<typename T>
+struct has_specialized_fields : decltype(has_specialized_fields_impl::check<T>(nullptr)){};
+template<typename T>
 struct has_specialized_into : decltype(has_specialized_into_impl::check<T>(nullptr)){};
 
 #ifdef __INTEL_COMPILER
@@ -222,6 +232,13 @@ template<typename T> struct is_container<T const&>          : is_container<T>{};
 template<typename T> struct is_container<T volatile&>       : is_container<T>{};
 template<typename T> struct is_container<T const volatile&> : is_container<T>{};
 
+// a container of structs that have toml::fields.
+template<typename T, bool = is_container<T>::value>
+struct is_array_of_fields : std::false_type{};
+template<typename T>
+struct is_array_of_fields<T, true>
+    : has_specialized_fields<typename T::value_type>{};
+
 template<typename T>
 struct is_basic_value: std::false_type{};
 template<typename T> struct is_basic_value<T&>                : is_basic_value<T>{};
@@ -2,6 +2,8 @@
 // Distributed under the MIT License.
 #ifndef TOML11_UTILITY_HPP
 #define TOML11_UTILITY_HPP
+#include <cstdint>
+
 #include <memory>
 #include <sstream>
 #include <utility>
@@ -81,6 +83,21 @@ std::string concat_to_string(Ts&& ... args)
     return detail::concat_to_string_impl(oss, std::forward<Ts>(args) ...);
 }
 
+namespace detail
+{
+// 64-bit FNV-1a hash of a byte sequence.
+inline std::uint64_t fnv1a(const char* first, const char* last) noexcept
+{
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for(; first != last; ++first)
+    {
+        hash ^= static_cast<std::uint8_t>(*first);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+} // detail
+
 template<typename T>
 T from_string(const std::string& str, T opt)
 {
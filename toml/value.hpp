@@ -4,9 +4,13 @@
 #define TOML11_VALUE_HPP
 #include <cassert>
 
+#include <atomic>
+
 #include "comments.hpp"
 #include "exception.hpp"
 #include "into.hpp"
+#include "metadata.hpp"
+#include "packed_array.hpp"
 #include "region.hpp"
 #include "source_location.hpp"
 #include "storage.hpp"
@@ -17,6 +21,44 @@
 namespace toml
 {
 
+#ifdef TOML11_COUNT_LIVE_VALUES
+namespace detail
+{
+inline std::atomic<std::size_t>& live_value_counter() noexcept
+{
+    static std::atomic<std::size_t> counter(0);
+    return counter;
+}
+
+// a member of basic_value that counts the number of living values.
+struct live_value_tracker
+{
+    live_value_tracker() noexcept
+    {
+        live_value_counter().fetch_add(1, std::memory_order_relaxed);
+    }
+    live_value_tracker(const live_value_tracker&) noexcept
+    {
+        live_value_counter().fetch_add(1, std::memory_order_relaxed);
+    }
+    live_value_tracker& operator=(const live_value_tracker&) noexcept
+    {
+        return *this;
+    }
+    ~live_value_tracker() noexcept
+    {
+        live_value_counter().fetch_sub(1, std::memory_order_relaxed);
+    }
+};
+} // detail
+
+// returns the number of basic_values that currently exist. for debugging.
+inline std::size_t live_value_count() noexcept
+{
+    return detail::live_value_counter().load(std::memory_order_relaxed);
+}
+#endif // TOML11_COUNT_LIVE_VALUES
+
 namespace detail
 {
 
@@ -24,16 +66,73 @@ namespace detail
 template<typename Value>
 inline region_base const* get_region(const Value& v)
 {
-    return v.region_info_.get();
+    return v.meta_.region();
 }
 
 template<typename Value>
 void change_region(Value& v, region reg)
 {
-    v.region_info_ = std::make_shared<region>(std::move(reg));
+    v.meta_.set_region(std::make_shared<region>(std::move(reg)));
+    return;
+}
+template<typename Value>
+void change_region(Value& v, std::shared_ptr<region_base> reg)
+{
+    v.meta_.set_region(std::move(reg));
     return;
 }
 
+// for toml::memory_usage.
+template<typename Value>
+inline metadata<typename Value::comment_type> const& get_metadata(const Value& v) noexcept
+{
+    return v.meta_;
+}
+
+// returns nullptr if the value is not a packed array.
+template<typename Value>
+inline packed_array const* get_packed_array(const Value& v) noexcept
+{
+    return v.is_packed_array() ? std::addressof(v.array_.packed_value()) : nullptr;
+}
+
+#ifdef TOML11_COPY_ON_WRITE
+// allow the tables and arrays in `v` to be shared with copies again. Call this
+// only if no non-const reference to the contents of `v` remains, e.g. at the
+// end of parsing.
+template<typename Value>
+void enable_sharing(Value& v) noexcept
+{
+    if(v.is_array())
+    {
+        if(auto* ary = v.array_.exclusive_value())
+        {
+            for(auto& elem : *ary) {enable_sharing(elem);}
+            v.array_.share();
+        }
+    }
+    else if(v.is_table())
+    {
+        if(auto* tab = v.table_.exclusive_value())
+        {
+            for(auto& kv : *tab) {enable_sharing(kv.second);}
+            v.table_.share();
+        }
+    }
+    return;
+}
+#endif
+
+// looks up a key with a single hash computation and probe.
+// returns nullptr if the table does not have the key.
+template<typename Table>
+auto find_mapped(Table& tab, const typename Table::key_type& k)
+    -> decltype(std::addressof(tab.find(k)->second))
+{
+    const auto found = tab.find(k);
+    return (found == tab.end()) ? nullptr : std::addressof(found->second);
+}
+
 template<value_t Expected, typename Value>
 [[noreturn]] inline void
 throw_bad_cast(const std::string& funcname, value_t actual, const Value& v)
@@ -203,13 +302,12 @@ class basic_value
   public:
 
     basic_value() noexcept
-        : type_(value_t::empty),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::empty)
     {}
     ~basic_value() noexcept {this->cleanup();}
 
     basic_value(const basic_value& v)
-        : type_(v.type()), region_info_(v.region_info_), comments_(v.comments_)
+        : type_(v.type()), meta_(v.meta_)
     {
         switch(v.type())
         {
@@ -227,8 +325,7 @@ class basic_value
         }
     }
     basic_value(basic_value&& v)
-        : type_(v.type()), region_info_(std::move(v.region_info_)),
-          comments_(std::move(v.comments_))
+        : type_(v.type()), meta_(std::move(v.meta_))
     {
         switch(this->type_) // here this->type_ is already initialized
         {
@@ -249,8 +346,7 @@ class basic_value
     {
         if(this == std::addressof(v)) {return *this;}
         this->cleanup();
-        this->region_info_ = v.region_info_;
-        this->comments_ = v.comments_;
+        this->meta_ = v.meta_;
         this->type_ = v.type();
         switch(this->type_)
         {
@@ -272,8 +368,7 @@ class basic_value
     {
         if(this == std::addressof(v)) {return *this;}
         this->cleanup();
-        this->region_info_ = std::move(v.region_info_);
-        this->comments_ = std::move(v.comments_);
+        this->meta_ = std::move(v.meta_);
         this->type_ = v.type();
         switch(this->type_)
         {
@@ -295,8 +390,7 @@ class basic_value
     // overwrite comments ----------------------------------------------------
 
     basic_value(const basic_value& v, std::vector<std::string> com)
-        : type_(v.type()), region_info_(v.region_info_),
-          comments_(std::move(com))
+        : type_(v.type()), meta_(v.meta_.shared_region(), comment_type(std::move(com)))
     {
         switch(v.type())
         {
@@ -315,8 +409,7 @@ class basic_value
     }
 
     basic_value(basic_value&& v, std::vector<std::string> com)
-        : type_(v.type()), region_info_(std::move(v.region_info_)),
-          comments_(std::move(com))
+        : type_(v.type()), meta_(v.meta_.shared_region(), comment_type(std::move(com)))
     {
         switch(this->type_) // here this->type_ is already initialized
         {
@@ -340,7 +433,7 @@ class basic_value
              template<typename ...> class T,
              template<typename ...> class A>
     basic_value(const basic_value<C, T, A>& v)
-        : type_(v.type()), region_info_(v.region_info_), comments_(v.comments())
+        : type_(v.type()), meta_(v.meta_.shared_region(), comment_type(v.comments()))
     {
         switch(v.type())
         {
@@ -354,6 +447,11 @@ class basic_value
             case value_t::local_time     : assigner(local_time_     , v.local_time_     ); break;
             case value_t::array          :
             {
+                if(const auto packed = detail::get_packed_array(v))
+                {
+                    assigner(array_, *packed); // keep it packed
+                    break;
+                }
                 array_type tmp(v.as_array(std::nothrow).begin(),
                                v.as_array(std::nothrow).end());
                 assigner(array_, std::move(tmp));
@@ -373,8 +471,7 @@ class basic_value
              template<typename ...> class T,
              template<typename ...> class A>
     basic_value(const basic_value<C, T, A>& v, std::vector<std::string> com)
-        : type_(v.type()), region_info_(v.region_info_),
-          comments_(std::move(com))
+        : type_(v.type()), meta_(v.meta_.shared_region(), comment_type(std::move(com)))
     {
         switch(v.type())
         {
@@ -388,6 +485,11 @@ class basic_value
             case value_t::local_time     : assigner(local_time_     , v.local_time_     ); break;
             case value_t::array          :
             {
+                if(const auto packed = detail::get_packed_array(v))
+                {
+                    assigner(array_, *packed); // keep it packed
+                    break;
+                }
                 array_type tmp(v.as_array(std::nothrow).begin(),
                                v.as_array(std::nothrow).end());
                 assigner(array_, std::move(tmp));
@@ -408,8 +510,7 @@ class basic_value
              template<typename ...> class A>
     basic_value& operator=(const basic_value<C, T, A>& v)
     {
-        this->region_info_ = v.region_info_;
-        this->comments_    = comment_type(v.comments());
+        this->meta_ = metadata_type(v.meta_.shared_region(), comment_type(v.comments()));
         this->type_        = v.type();
         switch(v.type())
         {
@@ -423,6 +524,11 @@ class basic_value
             case value_t::local_time     : assigner(local_time_     , v.local_time_     ); break;
             case value_t::array          :
             {
+                if(const auto packed = detail::get_packed_array(v))
+                {
+                    assigner(array_, *packed); // keep it packed
+                    break;
+                }
                 array_type tmp(v.as_array(std::nothrow).begin(),
                                v.as_array(std::nothrow).end());
                 assigner(array_, std::move(tmp));
@@ -443,8 +549,7 @@ class basic_value
     // boolean ==============================================================
 
     basic_value(boolean b)
-        : type_(value_t::boolean),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::boolean)
     {
         assigner(this->boolean_, b);
     }
@@ -452,14 +557,13 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::boolean;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
         assigner(this->boolean_, b);
         return *this;
     }
     basic_value(boolean b, std::vector<std::string> com)
         : type_(value_t::boolean),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->boolean_, b);
     }
@@ -470,8 +574,7 @@ class basic_value
         std::is_integral<T>, detail::negation<std::is_same<T, boolean>>>::value,
         std::nullptr_t>::type = nullptr>
     basic_value(T i)
-        : type_(value_t::integer),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::integer)
     {
         assigner(this->integer_, static_cast<integer>(i));
     }
@@ -483,7 +586,7 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::integer;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
         assigner(this->integer_, static_cast<integer>(i));
         return *this;
     }
@@ -493,8 +596,7 @@ class basic_value
         std::nullptr_t>::type = nullptr>
     basic_value(T i, std::vector<std::string> com)
         : type_(value_t::integer),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->integer_, static_cast<integer>(i));
     }
@@ -504,8 +606,7 @@ class basic_value
     template<typename T, typename std::enable_if<
         std::is_floating_point<T>::value, std::nullptr_t>::type = nullptr>
     basic_value(T f)
-        : type_(value_t::floating),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::floating)
     {
         assigner(this->floating_, static_cast<floating>(f));
     }
@@ -517,7 +618,7 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::floating;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
         assigner(this->floating_, static_cast<floating>(f));
         return *this;
     }
@@ -526,8 +627,7 @@ class basic_value
         std::is_floating_point<T>::value, std::nullptr_t>::type = nullptr>
     basic_value(T f, std::vector<std::string> com)
         : type_(value_t::floating),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->floating_, f);
     }
@@ -535,8 +635,7 @@ class basic_value
     // string ===============================================================
 
     basic_value(toml::string s)
-        : type_(value_t::string),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::string)
     {
         assigner(this->string_, std::move(s));
     }
@@ -544,21 +643,19 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::string ;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
         assigner(this->string_, s);
         return *this;
     }
     basic_value(toml::string s, std::vector<std::string> com)
         : type_(value_t::string),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->string_, std::move(s));
     }
 
     basic_value(std::string s)
-        : type_(value_t::string),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::string)
     {
         assigner(this->string_, toml::string(std::move(s)));
     }
@@ -566,34 +663,30 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::string ;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
         assigner(this->string_, toml::string(std::move(s)));
         return *this;
     }
     basic_value(std::string s, string_t kind)
-        : type_(value_t::string),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::string)
     {
         assigner(this->string_, toml::string(std::move(s), kind));
     }
     basic_value(std::string s, std::vector<std::string> com)
         : type_(value_t::string),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->string_, toml::string(std::move(s)));
     }
     basic_value(std::string s, string_t kind, std::vector<std::string> com)
         : type_(value_t::string),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->string_, toml::string(std::move(s), kind));
     }
 
     basic_value(const char* s)
-        : type_(value_t::string),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::string)
     {
         assigner(this->string_, toml::string(std::string(s)));
     }
@@ -601,35 +694,31 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::string ;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
         assigner(this->string_, toml::string(std::string(s)));
         return *this;
     }
     basic_value(const char* s, string_t kind)
-        : type_(value_t::string),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::string)
     {
         assigner(this->string_, toml::string(std::string(s), kind));
     }
     basic_value(const char* s, std::vector<std::string> com)
         : type_(value_t::string),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->string_, toml::string(std::string(s)));
     }
     basic_value(const char* s, string_t kind, std::vector<std::string> com)
         : type_(value_t::string),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->string_, toml::string(std::string(s), kind));
     }
 
 #if defined(TOML11_USING_STRING_VIEW) && TOML11_USING_STRING_VIEW>0
     basic_value(std::string_view s)
-        : type_(value_t::string),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::string)
     {
         assigner(this->string_, toml::string(s));
     }
@@ -637,27 +726,24 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::string ;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
         assigner(this->string_, toml::string(s));
         return *this;
     }
     basic_value(std::string_view s, std::vector<std::string> com)
         : type_(value_t::string),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->string_, toml::string(s));
     }
     basic_value(std::string_view s, string_t kind)
-        : type_(value_t::string),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::string)
     {
         assigner(this->string_, toml::string(s, kind));
     }
     basic_value(std::string_view s, string_t kind, std::vector<std::string> com)
         : type_(value_t::string),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->string_, toml::string(s, kind));
     }
@@ -666,8 +752,7 @@ class basic_value
     // local date ===========================================================
 
     basic_value(const local_date& ld)
-        : type_(value_t::local_date),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::local_date)
     {
         assigner(this->local_date_, ld);
     }
@@ -675,14 +760,13 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::local_date;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
         assigner(this->local_date_, ld);
         return *this;
     }
     basic_value(const local_date& ld, std::vector<std::string> com)
         : type_(value_t::local_date),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->local_date_, ld);
     }
@@ -690,15 +774,13 @@ class basic_value
     // local time ===========================================================
 
     basic_value(const local_time& lt)
-        : type_(value_t::local_time),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::local_time)
     {
         assigner(this->local_time_, lt);
     }
     basic_value(const local_time& lt, std::vector<std::string> com)
         : type_(value_t::local_time),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->local_time_, lt);
     }
@@ -706,15 +788,14 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::local_time;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
         assigner(this->local_time_, lt);
         return *this;
     }
 
     template<typename Rep, typename Period>
     basic_value(const std::chrono::duration<Rep, Period>& dur)
-        : type_(value_t::local_time),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::local_time)
     {
         assigner(this->local_time_, local_time(dur));
     }
@@ -722,8 +803,7 @@ class basic_value
     basic_value(const std::chrono::duration<Rep, Period>& dur,
                 std::vector<std::string> com)
         : type_(value_t::local_time),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->local_time_, local_time(dur));
     }
@@ -732,7 +812,7 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::local_time;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
         assigner(this->local_time_, local_time(dur));
         return *this;
     }
@@ -740,15 +820,13 @@ class basic_value
     // local datetime =======================================================
 
     basic_value(const local_datetime& ldt)
-        : type_(value_t::local_datetime),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::local_datetime)
     {
         assigner(this->local_datetime_, ldt);
     }
     basic_value(const local_datetime& ldt, std::vector<std::string> com)
         : type_(value_t::local_datetime),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->local_datetime_, ldt);
     }
@@ -756,7 +834,7 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::local_datetime;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
         assigner(this->local_datetime_, ldt);
         return *this;
     }
@@ -764,15 +842,13 @@ class basic_value
     // offset datetime ======================================================
 
     basic_value(const offset_datetime& odt)
-        : type_(value_t::offset_datetime),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::offset_datetime)
     {
         assigner(this->offset_datetime_, odt);
     }
     basic_value(const offset_datetime& odt, std::vector<std::string> com)
         : type_(value_t::offset_datetime),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->offset_datetime_, odt);
     }
@@ -780,21 +856,19 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::offset_datetime;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
         assigner(this->offset_datetime_, odt);
         return *this;
     }
     basic_value(const std::chrono::system_clock::time_point& tp)
-        : type_(value_t::offset_datetime),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::offset_datetime)
     {
         assigner(this->offset_datetime_, offset_datetime(tp));
     }
     basic_value(const std::chrono::system_clock::time_point& tp,
                 std::vector<std::string> com)
         : type_(value_t::offset_datetime),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->offset_datetime_, offset_datetime(tp));
     }
@@ -802,7 +876,7 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::offset_datetime;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
         assigner(this->offset_datetime_, offset_datetime(tp));
         return *this;
     }
@@ -810,15 +884,13 @@ class basic_value
     // array ================================================================
 
     basic_value(const array_type& ary)
-        : type_(value_t::array),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::array)
     {
         assigner(this->array_, ary);
     }
     basic_value(const array_type& ary, std::vector<std::string> com)
         : type_(value_t::array),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->array_, ary);
     }
@@ -826,7 +898,7 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::array ;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
         assigner(this->array_, ary);
         return *this;
     }
@@ -837,8 +909,7 @@ class basic_value
             std::is_convertible<T, value_type>::value,
         std::nullptr_t>::type = nullptr>
     basic_value(std::initializer_list<T> list)
-        : type_(value_t::array),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::array)
     {
         array_type ary(list.begin(), list.end());
         assigner(this->array_, std::move(ary));
@@ -848,8 +919,7 @@ class basic_value
         std::nullptr_t>::type = nullptr>
     basic_value(std::initializer_list<T> list, std::vector<std::string> com)
         : type_(value_t::array),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         array_type ary(list.begin(), list.end());
         assigner(this->array_, std::move(ary));
@@ -861,7 +931,7 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::array;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
 
         array_type ary(list.begin(), list.end());
         assigner(this->array_, std::move(ary));
@@ -875,8 +945,7 @@ class basic_value
             detail::is_container<T>
         >::value, std::nullptr_t>::type = nullptr>
     basic_value(const T& list)
-        : type_(value_t::array),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::array)
     {
         static_assert(std::is_convertible<typename T::value_type, value_type>::value,
             "elements of a container should be convertible to toml::value");
@@ -891,8 +960,7 @@ class basic_value
         >::value, std::nullptr_t>::type = nullptr>
     basic_value(const T& list, std::vector<std::string> com)
         : type_(value_t::array),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         static_assert(std::is_convertible<typename T::value_type, value_type>::value,
             "elements of a container should be convertible to toml::value");
@@ -912,7 +980,7 @@ class basic_value
 
         this->cleanup();
         this->type_ = value_t::array;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
 
         array_type ary(list.size());
         std::copy(list.begin(), list.end(), ary.begin());
@@ -923,15 +991,13 @@ class basic_value
     // table ================================================================
 
     basic_value(const table_type& tab)
-        : type_(value_t::table),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::table)
     {
         assigner(this->table_, tab);
     }
     basic_value(const table_type& tab, std::vector<std::string> com)
         : type_(value_t::table),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         assigner(this->table_, tab);
     }
@@ -939,7 +1005,7 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::table;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
         assigner(this->table_, tab);
         return *this;
     }
@@ -947,8 +1013,7 @@ class basic_value
     // initializer-list ------------------------------------------------------
 
     basic_value(std::initializer_list<std::pair<key, basic_value>> list)
-        : type_(value_t::table),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::table)
     {
         table_type tab;
         for(const auto& elem : list) {tab[elem.first] = elem.second;}
@@ -958,8 +1023,7 @@ class basic_value
     basic_value(std::initializer_list<std::pair<key, basic_value>> list,
                 std::vector<std::string> com)
         : type_(value_t::table),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         table_type tab;
         for(const auto& elem : list) {tab[elem.first] = elem.second;}
@@ -969,7 +1033,7 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::table;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
 
         table_type tab;
         for(const auto& elem : list) {tab[elem.first] = elem.second;}
@@ -984,8 +1048,7 @@ class basic_value
             detail::is_map<Map>
         >::value, std::nullptr_t>::type = nullptr>
     basic_value(const Map& mp)
-        : type_(value_t::table),
-          region_info_(std::make_shared<region_base>(region_base{}))
+        : type_(value_t::table)
     {
         table_type tab;
         for(const auto& elem : mp) {tab[elem.first] = elem.second;}
@@ -997,8 +1060,7 @@ class basic_value
         >::value, std::nullptr_t>::type = nullptr>
     basic_value(const Map& mp, std::vector<std::string> com)
         : type_(value_t::table),
-          region_info_(std::make_shared<region_base>(region_base{})),
-          comments_(std::move(com))
+          meta_(comment_type(std::move(com)))
     {
         table_type tab;
         for(const auto& elem : mp) {tab[elem.first] = elem.second;}
@@ -1012,7 +1074,7 @@ class basic_value
     {
         this->cleanup();
         this->type_ = value_t::table;
-        this->region_info_ = std::make_shared<region_base>(region_base{});
+        this->meta_.reset_region();
 
         table_type tab;
         for(const auto& elem : mp) {tab[elem.first] = elem.second;}
@@ -1062,8 +1124,7 @@ class basic_value
 
     basic_value(boolean b, detail::region reg, std::vector<std::string> cm)
         : type_(value_t::boolean),
-          region_info_(std::make_shared<detail::region>(std::move(reg))),
-          comments_(std::move(cm))
+          meta_(std::make_shared<detail::region>(std::move(reg)), comment_type(std::move(cm)))
     {
         assigner(this->boolean_, b);
     }
@@ -1073,8 +1134,7 @@ class basic_value
         >::value, std::nullptr_t>::type = nullptr>
     basic_value(T i, detail::region reg, std::vector<std::string> cm)
         : type_(value_t::integer),
-          region_info_(std::make_shared<detail::region>(std::move(reg))),
-          comments_(std::move(cm))
+          meta_(std::make_shared<detail::region>(std::move(reg)), comment_type(std::move(cm)))
     {
         assigner(this->integer_, static_cast<integer>(i));
     }
@@ -1082,67 +1142,75 @@ class basic_value
         std::is_floating_point<T>::value, std::nullptr_t>::type = nullptr>
     basic_value(T f, detail::region reg, std::vector<std::string> cm)
         : type_(value_t::floating),
-          region_info_(std::make_shared<detail::region>(std::move(reg))),
-          comments_(std::move(cm))
+          meta_(std::make_shared<detail::region>(std::move(reg)), comment_type(std::move(cm)))
     {
         assigner(this->floating_, static_cast<floating>(f));
     }
     basic_value(toml::string s, detail::region reg,
                 std::vector<std::string> cm)
         : type_(value_t::string),
-          region_info_(std::make_shared<detail::region>(std::move(reg))),
-          comments_(std::move(cm))
+          meta_(std::make_shared<detail::region>(std::move(reg)), comment_type(std::move(cm)))
     {
         assigner(this->string_, std::move(s));
     }
     basic_value(const local_date& ld, detail::region reg,
                 std::vector<std::string> cm)
         : type_(value_t::local_date),
-          region_info_(std::make_shared<detail::region>(std::move(reg))),
-          comments_(std::move(cm))
+          meta_(std::make_shared<detail::region>(std::move(reg)), comment_type(std::move(cm)))
     {
         assigner(this->local_date_, ld);
     }
     basic_value(const local_time& lt, detail::region reg,
                 std::vector<std::string> cm)
         : type_(value_t::local_time),
-          region_info_(std::make_shared<detail::region>(std::move(reg))),
-          comments_(std::move(cm))
+          meta_(std::make_shared<detail::region>(std::move(reg)), comment_type(std::move(cm)))
     {
         assigner(this->local_time_, lt);
     }
     basic_value(const local_datetime& ldt, detail::region reg,
                 std::vector<std::string> cm)
         : type_(value_t::local_datetime),
-          region_info_(std::make_shared<detail::region>(std::move(reg))),
-          comments_(std::move(cm))
+          meta_(std::make_shared<detail::region>(std::move(reg)), comment_type(std::move(cm)))
     {
         assigner(this->local_datetime_, ldt);
     }
     basic_value(const offset_datetime& odt, detail::region reg,
                 std::vector<std::string> cm)
         : type_(value_t::offset_datetime),
-          region_info_(std::make_shared<detail::region>(std::move(reg))),
-          comments_(std::move(cm))
+          meta_(std::make_shared<detail::region>(std::move(reg)), comment_type(std::move(cm)))
     {
         assigner(this->offset_datetime_, odt);
     }
     basic_value(const array_type& ary, detail::region reg,
                 std::vector<std::string> cm)
         : type_(value_t::array),
-          region_info_(std::make_shared<detail::region>(std::move(reg))),
-          comments_(std::move(cm))
+          meta_(std::make_shared<detail::region>(std::move(reg)), comment_type(std::move(cm)))
     {
         assigner(this->array_, ary);
     }
     basic_value(const table_type& tab, detail::region reg,
                 std::vector<std::string> cm)
         : type_(value_t::table),
-          region_info_(std::make_shared<detail::region>(std::move(reg))),
-          comments_(std::move(cm))
+          meta_(std::make_shared<detail::region>(std::move(reg)), comment_type(std::move(cm)))
     {
         assigner(this->table_, tab);
     }
+    basic_value(detail::packed_array ary, detail::region reg,
+                std::vector<std::string> cm)
+        : type_(value_t::array),
+          meta_(std::make_shared<detail::region>(std::move(reg)), comment_type(std::move(cm)))
+    {
+        ary.shrink_to_fit();
+        assigner(this->array_, std::move(ary));
+    }
+    // used by toml::load_binary.
+    basic_value(detail::packed_array ary, std::vector<std::string> cm)
+        : type_(value_t::array),
+          meta_(comment_type(std::move(cm)))
+    {
+        ary.shrink_to_fit();
+        assigner(this->array_, std::move(ary));
+    }
 
     template<typename T, typename std::enable_if<
         detail::is_exact_toml_type<T, value_type>::value,
@@ -1208,39 +1276,43 @@ class basic_value
 
     // ------------------------------------------------------------------------
     // nothrow version
+    //
+    // as_array is not noexcept because it might unpack a packed array. The
+    // non-const as_table and as_string are not noexcept because they clone
+    // the shared content with TOML11_COPY_ON_WRITE.
 
     boolean         const& as_boolean        (const std::nothrow_t&) const& noexcept {return this->boolean_;}
     integer         const& as_integer        (const std::nothrow_t&) const& noexcept {return this->integer_;}
     floating        const& as_floating       (const std::nothrow_t&) const& noexcept {return this->floating_;}
-    string          const& as_string         (const std::nothrow_t&) const& noexcept {return this->string_;}
+    string          const& as_string         (const std::nothrow_t&) const& noexcept {return this->string_.value();}
     offset_datetime const& as_offset_datetime(const std::nothrow_t&) const& noexcept {return this->offset_datetime_;}
     local_datetime  const& as_local_datetime (const std::nothrow_t&) const& noexcept {return this->local_datetime_;}
     local_date      const& as_local_date     (const std::nothrow_t&) const& noexcept {return this->local_date_;}
     local_time      const& as_local_time     (const std::nothrow_t&) const& noexcept {return this->local_time_;}
-    array_type      const& as_array          (const std::nothrow_t&) const& noexcept {return this->array_.value();}
+    array_type      const& as_array          (const std::nothrow_t&) const&          {return this->array_.value();}
     table_type      const& as_table          (const std::nothrow_t&) const& noexcept {return this->table_.value();}
 
     boolean        & as_boolean        (const std::nothrow_t&) & noexcept {return this->boolean_;}
     integer        & as_integer        (const std::nothrow_t&) & noexcept {return this->integer_;}
     floating       & as_floating       (const std::nothrow_t&) & noexcept {return this->floating_;}
-    string         & as_string         (const std::nothrow_t&) & noexcept {return this->string_;}
+    string         & as_string         (const std::nothrow_t&) &          {return this->string_.value();}
     offset_datetime& as_offset_datetime(const std::nothrow_t&) & noexcept {return this->offset_datetime_;}
     local_datetime & as_local_datetime (const std::nothrow_t&) & noexcept {return this->local_datetime_;}
     local_date     & as_local_date     (const std::nothrow_t&) & noexcept {return this->local_date_;}
     local_time     & as_local_time     (const std::nothrow_t&) & noexcept {return this->local_time_;}
-    array_type     & as_array          (const std::nothrow_t&) & noexcept {return this->array_.value();}
-    table_type     & as_table          (const std::nothrow_t&) & noexcept {return this->table_.value();}
+    array_type     & as_array          (const std::nothrow_t&) &          {return this->array_.value();}
+    table_type     & as_table          (const std::nothrow_t&) &          {return this->table_.value();}
 
     boolean        && as_boolean        (const std::nothrow_t&) && noexcept {return std::move(this->boolean_);}
     integer        && as_integer        (const std::nothrow_t&) && noexcept {return std::move(this->integer_);}
     floating       && as_floating       (const std::nothrow_t&) && noexcept {return std::move(this->floating_);}
-    string         && as_string         (const std::nothrow_t&) && noexcept {return std::move(this->string_);}
+    string         && as_string         (const std::nothrow_t&) &&          {return std::move(this->string_.value());}
     offset_datetime&& as_offset_datetime(const std::nothrow_t&) && noexcept {return std::move(this->offset_datetime_);}
     local_datetime && as_local_datetime (const std::nothrow_t&) && noexcept {return std::move(this->local_datetime_);}
     local_date     && as_local_date     (const std::nothrow_t&) && noexcept {return std::move(this->local_date_);}
     local_time     && as_local_time     (const std::nothrow_t&) && noexcept {return std::move(this->local_time_);}
-    array_type     && as_array          (const std::nothrow_t&) && noexcept {return std::move(this->array_.value());}
-    table_type     && as_table          (const std::nothrow_t&) && noexcept {return std::move(this->table_.value());}
+    array_type     && as_array          (const std::nothrow_t&) &&          {return std::move(this->array_.value());}
+    table_type     && as_table          (const std::nothrow_t&) &&          {return std::move(this->table_.value());}
 
     // ========================================================================
     // throw version
@@ -1281,7 +1353,7 @@ class basic_value
             detail::throw_bad_cast<value_t::string>(
                     "toml::value::as_string(): ", this->type_, *this);
         }
-        return this->string_;
+        return this->string_.value();
     }
     offset_datetime const& as_offset_datetime() const&
     {
@@ -1375,7 +1447,7 @@ class basic_value
             detail::throw_bad_cast<value_t::string>(
                     "toml::value::as_string(): ", this->type_, *this);
         }
-        return this->string_;
+        return this->string_.value();
     }
     offset_datetime & as_offset_datetime() &
     {
@@ -1470,7 +1542,7 @@ class basic_value
             detail::throw_bad_cast<value_t::string>(
                     "toml::value::as_string(): ", this->type_, *this);
         }
-        return std::move(this->string_);
+        return std::move(this->string_.value());
     }
     offset_datetime && as_offset_datetime() &&
     {
@@ -1539,11 +1611,12 @@ class basic_value
             detail::throw_bad_cast<value_t::table>(
                 "toml::value::at(key): ", this->type_, *this);
         }
-        if(this->as_table(std::nothrow).count(k) == 0)
+        const auto found = detail::find_mapped(this->as_table(std::nothrow), k);
+        if(!found)
         {
             detail::throw_key_not_found_error(*this, k);
         }
-        return this->as_table(std::nothrow).at(k);
+        return *found;
     }
     value_type const& at(const key& k) const
     {
@@ -1552,11 +1625,12 @@ class basic_value
             detail::throw_bad_cast<value_t::table>(
                 "toml::value::at(key): ", this->type_, *this);
         }
-        if(this->as_table(std::nothrow).count(k) == 0)
+        const auto found = detail::find_mapped(this->as_table(std::nothrow), k);
+        if(!found)
         {
             detail::throw_key_not_found_error(*this, k);
         }
-        return this->as_table(std::nothrow).at(k);
+        return *found;
     }
     value_type&       operator[](const key& k)
     {
@@ -1609,12 +1683,13 @@ class basic_value
         return this->as_array(std::nothrow).at(idx);
     }
 
-    value_type&       operator[](const std::size_t idx) noexcept
+    // not noexcept because a packed array is unpacked.
+    value_type&       operator[](const std::size_t idx)
     {
         // no check...
         return this->as_array(std::nothrow)[idx];
     }
-    value_type const& operator[](const std::size_t idx) const noexcept
+    value_type const& operator[](const std::size_t idx) const
     {
         // no check...
         return this->as_array(std::nothrow)[idx];
@@ -1659,7 +1734,7 @@ class basic_value
         {
             case value_t::array:
             {
-                return this->as_array(std::nothrow).size();
+                return this->array_.size(); // does not unpack packed arrays
             }
             case value_t::table:
             {
@@ -1700,23 +1775,72 @@ class basic_value
         return (this->as_table(std::nothrow).count(k) != 0);
     }
 
+    // packed array ==========================================================
+    //
+    // If TOML11_PACK_HOMOGENEOUS_ARRAYS is defined, the parser stores arrays
+    // of integers, floatings, or booleans contiguously without regions and
+    // comments. The elements can be accessed through spans without unpacking.
+    // Any non-const access to the array unpacks it. as_array(), at() and
+    // operator[] via const reference also unpack it in place because they
+    // return references to values; toml::find<T>(v, ..., idx) does not.
+
+    bool is_packed_array() const noexcept
+    {
+        return this->is_array() && this->array_.is_packed();
+    }
+
+    span<const integer> as_integer_span() const
+    {
+        return this->packed_array_of<value_t::integer>(
+                "toml::value::as_integer_span(): ").integers();
+    }
+    span<const floating> as_floating_span() const
+    {
+        return this->packed_array_of<value_t::floating>(
+                "toml::value::as_floating_span(): ").floatings();
+    }
+    span<const boolean> as_boolean_span() const
+    {
+        return this->packed_array_of<value_t::boolean>(
+                "toml::value::as_boolean_span(): ").booleans();
+    }
+
     source_location location() const
     {
-        return source_location(this->region_info_.get());
+        return source_location(this->meta_.region());
     }
 
-    comment_type const& comments() const noexcept {return this->comments_;}
-    comment_type&       comments()       noexcept {return this->comments_;}
+    comment_type const& comments() const noexcept {return this->meta_.comments();}
+    comment_type&       comments()                {return this->meta_.comments();}
 
   private:
 
+    template<value_t Expected>
+    detail::packed_array const& packed_array_of(const char* funcname) const
+    {
+        if(!this->is_array())
+        {
+            detail::throw_bad_cast<value_t::array>(funcname, this->type_, *this);
+        }
+        if(!this->array_.is_packed() ||
+           (this->array_.packed_value().kind() != Expected &&
+            !this->array_.packed_value().empty()))
+        {
+            throw type_error(detail::format_underline(concat_to_string(
+                funcname, "not a packed array of ", Expected), {
+                    {this->location(), "this array is not packed"}
+                }), this->location());
+        }
+        return this->array_.packed_value();
+    }
+
     void cleanup() noexcept
     {
         switch(this->type_)
         {
-            case value_t::string : {string_.~string();       return;}
-            case value_t::array  : {array_.~array_storage(); return;}
-            case value_t::table  : {table_.~table_storage(); return;}
+            case value_t::string : {string_.~string_storage(); return;}
+            case value_t::array  : {array_.~array_storage();   return;}
+            case value_t::table  : {table_.~table_storage();   return;}
             default              : return;
         }
     }
@@ -1728,10 +1852,27 @@ class basic_value
     template<typename Value>
     friend void detail::change_region(Value& v, detail::region reg);
 
+    template<typename Value>
+    friend void detail::change_region(Value& v, std::shared_ptr<region_base> reg);
+
+    template<typename Value>
+    friend detail::packed_array const* detail::get_packed_array(const Value& v) noexcept;
+
+    template<typename Value>
+    friend detail::metadata<typename Value::comment_type> const&
+    detail::get_metadata(const Value& v) noexcept;
+
+#ifdef TOML11_COPY_ON_WRITE
+    template<typename Value>
+    friend void detail::enable_sharing(Value& v) noexcept;
+#endif
+
   private:
 
-    using array_storage = detail::storage<array_type>;
-    using table_storage = detail::storage<table_type>;
+    using metadata_type  = detail::metadata<comment_type>;
+    using string_storage = detail::storage<string>;
+    using array_storage  = detail::array_storage<array_type>;
+    using table_storage  = detail::storage<table_type>;
 
     value_t type_;
     union
@@ -1739,7 +1880,7 @@ class basic_value
         boolean         boolean_;
         integer         integer_;
         floating        floating_;
-        string          string_;
+        string_storage  string_;
         offset_datetime offset_datetime_;
         local_datetime  local_datetime_;
         local_date      local_date_;
@@ -1747,8 +1888,10 @@ class basic_value
         array_storage   array_;
         table_storage   table_;
     };
-    std::shared_ptr<region_base> region_info_;
-    comment_type                 comments_;
+    metadata_type meta_;
+#ifdef TOML11_COUNT_LIVE_VALUES
+    detail::live_value_tracker tracker_;
+#endif
 };
 
 // default toml::value and default array/table.
@@ -1800,6 +1943,24 @@ operator==(const basic_value<C, T, A>& lhs, const basic_value<C, T, A>& rhs)
         }
         case value_t::array    :
         {
+            const auto lp = detail::get_packed_array(lhs);
+            const auto rp = detail::get_packed_array(rhs);
+            if(lp && rp) {return *lp == *rp;}
+            if(lp || rp)
+            {
+                // compare elements one by one not to unpack the packed one.
+                const auto& packed = lp ? *lp : *rp;
+                const auto& ary    = lp ? rhs.as_array() : lhs.as_array();
+                if(packed.size() != ary.size()) {return false;}
+                for(std::size_t i=0; i<ary.size(); ++i)
+                {
+                    if(!(packed.template element<basic_value<C, T, A>>(i) == ary[i]))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
             return lhs.as_array() == rhs.as_array();
         }
         case value_t::table    :
@@ -0,0 +1,341 @@
+//     Copyright Toru Niina 2019.
+// Distributed under the MIT License.
+#ifndef TOML11_WRITE_HPP
+#define TOML11_WRITE_HPP
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "serializer.hpp"
+#include "traits.hpp"
+
+namespace toml
+{
+namespace detail
+{
+
+// how a member of a struct is written.
+enum class member_kind
+{
+    key_value,       // key = value
+    table,           // [key]
+    map_of_tables,   // [key.k1], [key.k2], ...
+    array_of_tables  // [[key]]
+};
+
+template<typename T, bool = is_map<T>::value>
+struct is_map_of_fields : std::false_type{};
+template<typename T>
+struct is_map_of_fields<T, true>
+    : has_specialized_fields<typename T::mapped_type>{};
+
+template<typename T>
+struct member_kind_of : std::integral_constant<member_kind,
+    has_specialized_fields<T>::value ? member_kind::table           :
+    is_map_of_fields<T>::value       ? member_kind::map_of_tables   :
+    is_array_of_fields<T>::value     ? member_kind::array_of_tables :
+                                       member_kind::key_value>
+{};
+
+// how a value is written in an inline array or table.
+enum class inline_kind
+{
+    basic_value, // toml::value
+    scalar,      // toml::string, datetimes, and bool
+    integer,
+    floating,
+    string,      // std::string
+    fields,      // a struct with toml::fields
+    map,
+    container,
+    other        // converted into toml::value
+};
+
+template<typename T, typename Value>
+struct inline_kind_of : std::integral_constant<inline_kind,
+    is_basic_value<T>::value                    ? inline_kind::basic_value :
+    (std::is_same<T, boolean>::value         ||
+     std::is_same<T, toml::string>::value    ||
+     std::is_same<T, local_date>::value      ||
+     std::is_same<T, local_time>::value      ||
+     std::is_same<T, local_datetime>::value  ||
+     std::is_same<T, offset_datetime>::value)   ? inline_kind::scalar      :
+    std::is_integral<T>::value                  ? inline_kind::integer     :
+    std::is_floating_point<T>::value            ? inline_kind::floating    :
+    std::is_same<T, std::string>::value         ? inline_kind::string      :
+    has_specialized_fields<T>::value            ? inline_kind::fields      :
+    is_map<T>::value                            ? inline_kind::map         :
+    is_container<T>::value                      ? inline_kind::container   :
+                                                  inline_kind::other>
+{};
+
+// writes a struct that has toml::fields without constructing toml::value.
+// The formatting of each value is done by toml::serializer.
+template<typename Value>
+class struct_writer
+{
+  public:
+
+    struct_writer(std::ostream& os, const int float_prec)
+        : os_(os), wrote_(false), float_prec_(float_prec),
+          ser_((std::numeric_limits<std::size_t>::max)(), float_prec,
+               /*can_be_inlined = */ true, /*no_comment = */ true)
+    {}
+
+    // key-value pairs first, then the sub-tables.
+    template<typename T>
+    void write_table(const T& obj, std::vector<key>& keys)
+    {
+        ::toml::fields<T>::for_each(key_value_writer<T>{*this, obj});
+        ::toml::fields<T>::for_each(table_writer<T>{*this, obj, keys});
+        return;
+    }
+
+  private:
+
+    template<typename T>
+    struct key_value_writer
+    {
+        template<typename Member>
+        void operator()(const char* name, Member T::* ptr) const
+        {
+            const Member& member = obj.*ptr;
+            if(is_written_inline(member, std::integral_constant<member_kind,
+                                         member_kind_of<Member>::value>{}))
+            {
+                self.write_key_value(name, member);
+            }
+        }
+        struct_writer& self;
+        const T&       obj;
+    };
+
+    template<typename T>
+    struct table_writer
+    {
+        template<typename Member>
+        void operator()(const char* name, Member T::* ptr) const
+        {
+            keys.push_back(name);
+            self.write_tables(obj.*ptr, keys,
+                std::integral_constant<member_kind, member_kind_of<Member>::value>{});
+            keys.pop_back();
+        }
+        struct_writer&     self;
+        const T&           obj;
+        std::vector<key>&  keys;
+    };
+
+    template<typename T>
+    struct inline_member_writer
+    {
+        template<typename Member>
+        void operator()(const char* name, Member T::* ptr)
+        {
+            if(!first) {self.os_ << ", ";}
+            first = false;
+            self.os_ << format_key(std::string(name)) << " = ";
+            self.write_inline(obj.*ptr);
+        }
+        struct_writer& self;
+        const T&       obj;
+        bool           first;
+    };
+
+    // an empty array of tables is written as `key = []`, and an empty map
+    // as `key = {}`.
+    template<typename T, member_kind K>
+    static bool is_written_inline(const T&, std::integral_constant<member_kind, K>)
+    {
+        return K == member_kind::key_value;
+    }
+    template<typename T>
+    static bool is_written_inline(const T& v,
+        std::integral_constant<member_kind, member_kind::array_of_tables>)
+    {
+        return v.begin() == v.end();
+    }
+    template<typename T>
+    static bool is_written_inline(const T& v,
+        std::integral_constant<member_kind, member_kind::map_of_tables>)
+    {
+        return v.begin() == v.end();
+    }
+
+    void write_header(const std::vector<key>& keys, const bool is_array)
+    {
+        if(wrote_) {os_ << '\n';}
+        os_ << (is_array ? "[[" : "[") << format_keys(keys) << (is_array ? "]]\n" : "]\n");
+        wrote_ = true;
+    }
+
+    template<typename T>
+    void write_key_value(const char* name, const T& v)
+    {
+        os_ << format_key(std::string(name)) << " = ";
+        this->write_inline(v);
+        os_ << '\n';
+        wrote_ = true;
+    }
+
+    // ------------------------------------------------------------------------
+    // tables
+
+    template<typename T>
+    void write_tables(const T&, std::vector<key>&,
+        std::integral_constant<member_kind, member_kind::key_value>)
+    {
+        return; // already written
+    }
+    template<typename T>
+    void write_tables(const T& v, std::vector<key>& keys,
+        std::integral_constant<member_kind, member_kind::table>)
+    {
+        this->write_header(keys, false);
+        this->write_table(v, keys);
+    }
+    template<typename T>
+    void write_tables(const T& v, std::vector<key>& keys,
+        std::integral_constant<member_kind, member_kind::map_of_tables>)
+    {
+        for(const auto& kv : v)
+        {
+            keys.push_back(kv.first);
+            this->write_header(keys, false);
+            this->write_table(kv.second, keys);
+            keys.pop_back();
+        }
+    }
+    template<typename T>
+    void write_tables(const T& v, std::vector<key>& keys,
+        std::integral_constant<member_kind, member_kind::array_of_tables>)
+    {
+        for(const auto& elem : v)
+        {
+            this->write_header(keys, true);
+            this->write_table(elem, keys);
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    // inline values
+
+    template<typename T>
+    void write_inline(const T& v)
+    {
+        this->write_inline(v, std::integral_constant<inline_kind,
+                inline_kind_of<T, Value>::value>{});
+    }
+
+    template<typename T>
+    void write_inline(const T& v, std::integral_constant<inline_kind, inline_kind::basic_value>)
+    {
+        os_ << visit(serializer<T>((std::numeric_limits<std::size_t>::max)(),
+                     float_prec_, true, true), v);
+    }
+    template<typename T>
+    void write_inline(const T& v, std::integral_constant<inline_kind, inline_kind::scalar>)
+    {
+        os_ << ser_(v);
+    }
+    template<typename T>
+    void write_inline(const T& v, std::integral_constant<inline_kind, inline_kind::integer>)
+    {
+        os_ << ser_(static_cast<integer>(v));
+    }
+    void write_inline(const integer& v, std::integral_constant<inline_kind, inline_kind::integer>)
+    {
+        os_ << ser_(v);
+    }
+    template<typename T>
+    void write_inline(const T& v, std::integral_constant<inline_kind, inline_kind::floating>)
+    {
+        os_ << ser_(static_cast<floating>(v));
+    }
+    void write_inline(const floating& v, std::integral_constant<inline_kind, inline_kind::floating>)
+    {
+        os_ << ser_(v);
+    }
+    template<typename T>
+    void write_inline(const T& v, std::integral_constant<inline_kind, inline_kind::string>)
+    {
+        os_ << ser_(toml::string(v));
+    }
+    template<typename T>
+    void write_inline(const T& v, std::integral_constant<inline_kind, inline_kind::fields>)
+    {
+        os_ << '{';
+        ::toml::fields<T>::for_each(inline_member_writer<T>{*this, v, true});
+        os_ << '}';
+    }
+    template<typename T>
+    void write_inline(const T& v, std::integral_constant<inline_kind, inline_kind::map>)
+    {
+        os_ << '{';
+        bool first = true;
+        for(const auto& kv : v)
+        {
+            if(!first) {os_ << ", ";}
+            first = false;
+            os_ << format_key(kv.first) << " = ";
+            this->write_inline(kv.second);
+        }
+        os_ << '}';
+    }
+    template<typename T>
+    void write_inline(const T& v, std::integral_constant<inline_kind, inline_kind::container>)
+    {
+        os_ << '[';
+        bool first = true;
+        for(const auto& elem : v)
+        {
+            if(!first) {os_ << ", ";}
+            first = false;
+            this->write_inline(elem);
+        }
+        os_ << ']';
+    }
+    template<typename T>
+    void write_inline(const T& v, std::integral_constant<inline_kind, inline_kind::other>)
+    {
+        this->write_inline(Value(v));
+    }
+
+  private:
+    std::ostream&     os_;
+    bool              wrote_;
+    int               float_prec_;
+    serializer<Value> ser_;
+};
+
+} // detail
+
+// Write a struct in TOML format without constructing toml::value.
+//
+// The members listed in TOML11_DEFINE_CONVERSION_NON_INTRUSIVE are written in
+// the order of the list. Members that are structs with the list, maps of them,
+// and arrays of them are written as tables, and the others are written inline.
+// Members of the other types are converted into `Value` one by one.
+//
+// ```cpp
+// std::ofstream ofs("snapshot.toml");
+// toml::write(ofs, snapshot);
+// ```
+template<typename Value = ::toml::value, typename T>
+void write(std::ostream& os, const T& obj,
+           const int float_prec = std::numeric_limits<toml::floating>::max_digits10)
+{
+    static_assert(detail::has_specialized_fields<T>::value,
+        "toml::write: T should have toml::fields. "
+        "use TOML11_DEFINE_CONVERSION_NON_INTRUSIVE.");
+
+    detail::struct_writer<Value> writer(os, float_prec);
+    std::vector<key> keys;
+    writer.write_table(obj, keys);
+    return;
+}
+
+} // toml
+#endif// TOML11_WRITE_HPP